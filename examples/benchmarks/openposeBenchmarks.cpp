@@ -0,0 +1,702 @@
+// ------------------------- OpenPose Post-Processing Benchmarks -------------------------
+// Micro-benchmarks of the CPU post-processing kernels (resizeAndMergeCpu, nmsCpu, connectBodyPartsCpu,
+// uCharCvMatToFloatPtr, renderPoseKeypointsCpu, and PoseTriangulation::reconstructArray), on synthetic heat maps at
+// several resolutions and numbers of people, and on heat maps recorded with OpenPose (`--fixtures`). No GPU nor
+// models are required. Results (ns/op, throughput, and allocations per op) are printed and optionally saved as JSON
+// (`--json_output`) in order to track regressions per commit. See examples/benchmarks/README.md.
+// Optionally (`--model_folder`), it also measures the throughput of the body network with micro-batching
+// (PoseExtractorCaffe::forwardPassBatch, as with `--pose_batch_size`) for several batch sizes.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <random>
+#include <sstream>
+#include <thread>
+// Third-party dependencies
+#include <opencv2/opencv.hpp>
+// Command-line user interface
+#define OPENPOSE_FLAGS_DISABLE_POSE
+#include <openpose/flags.hpp>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+DEFINE_string(model_pose,               "BODY_25",      "Pose model whose heat maps and body part pairs are used (e.g., `BODY_25`, `COCO`,"
+                                                        " `MPI`).");
+DEFINE_string(net_resolutions,          "656x368,1312x736", "Comma-separated list of heat map (i.e., network input) resolutions of the synthetic"
+                                                        " fixtures. The network output is 8 times smaller.");
+DEFINE_string(people,                   "1,4,16",       "Comma-separated list of numbers of people of the synthetic fixtures.");
+DEFINE_string(fixtures,                 "",             "Optional directory with recorded heat maps (`.float` files), added to the synthetic"
+                                                        " fixtures. Record them with `--heatmaps_add_parts --heatmaps_add_bkg --heatmaps_add_PAFs"
+                                                        " --heatmaps_scale 3 --write_heatmaps {directory} --write_heatmaps_format float`.");
+DEFINE_bool(no_synthetic,               false,          "If true, only the recorded fixtures (`--fixtures`) are benchmarked.");
+DEFINE_string(benchmark_filter,         "",             "If not empty, only the benchmarks whose name contains this string are run.");
+DEFINE_double(min_time,                 0.5,            "Minimum time (in seconds) spent on each benchmark, split among `repetitions` samples.");
+DEFINE_int32(repetitions,               5,              "Number of timing samples of each benchmark (median, minimum, and maximum are reported).");
+DEFINE_int32(simd_level,                -1,             "Maximum SIMD instruction set used by the kernels: -1 for the best one supported by the"
+                                                        " CPU, 0 for none, 1 for SSE4.1, 2 for AVX2, 3 for AVX-512.");
+DEFINE_int32(views,                     3,              "Number of camera views for PoseTriangulation::reconstructArray.");
+DEFINE_string(json_output,              "",             "If not empty, the results are also saved in JSON format into this file path.");
+DEFINE_string(benchmark_label,          "",             "Optional label saved in the JSON file (e.g., the commit or machine name).");
+DEFINE_string(model_folder,             "",             "If not empty, folder where the models are located (e.g., `models/`). Then, the body"
+                                                        " network (and its post-processing) of `model_pose` is also benchmarked with each batch size"
+                                                        " of `batch_sizes`, at each resolution of `net_resolutions`. It requires Caffe.");
+DEFINE_string(batch_sizes,              "1,2,4,8,16",   "Comma-separated list of numbers of frames run through the body network at once (see"
+                                                        " `--pose_batch_size` in the OpenPose demo). Only used with `model_folder`.");
+DEFINE_int32(num_gpu_start,             0,              "GPU device used by the body network benchmark.");
+
+// Heap allocations of the whole process (including the OpenPose library), counted by replacing the global operator
+// new. Note: Array<T> memory is allocated with aligned_malloc rather than operator new, so it is only counted (as
+// `array_allocations`) if `--memory_pool` is enabled.
+namespace
+{
+    std::atomic<unsigned long long> sNumberAllocations{0ull};
+    std::atomic<unsigned long long> sBytesAllocated{0ull};
+}
+
+void* operator new(std::size_t bytes)
+{
+    sNumberAllocations++;
+    sBytesAllocated += bytes;
+    void* ptr = std::malloc(bytes > 0 ? bytes : 1);
+    if (ptr == nullptr)
+        throw std::bad_alloc{};
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+struct Fixture
+{
+    std::string name;
+    op::Point<int> netOutputSize;
+    op::Point<int> heatMapSize;
+    int channels;
+    int people; // -1 if unknown (recorded fixtures)
+    std::vector<float> netOutput; // channels x netOutputSize.y x netOutputSize.x
+    std::vector<float> heatMaps; // channels x heatMapSize.y x heatMapSize.x
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string fixture;
+    op::Point<int> resolution;
+    int people;
+    int detectedPeople;
+    unsigned long long iterations;
+    std::vector<double> nsPerOpSamples;
+    double itemsPerOp;
+    std::string itemName;
+    double allocationsPerOp;
+    double bytesAllocatedPerOp;
+    double arrayAllocationsPerOp; // Negative if `--memory_pool` is disabled
+};
+
+std::vector<int> splitInts(const std::string& string)
+{
+    std::vector<int> values;
+    for (const auto& value : op::splitString(string, ","))
+        values.emplace_back(std::stoi(value));
+    return values;
+}
+
+double getMedian(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return (values.empty() ? 0. : (values.size() % 2 == 1
+        ? values[values.size()/2] : 0.5*(values[values.size()/2-1] + values[values.size()/2])));
+}
+
+std::string escapeJson(const std::string& string)
+{
+    std::string escaped;
+    for (const auto character : string)
+    {
+        if (character == '"' || character == '\\')
+            escaped += '\\';
+        escaped += character;
+    }
+    return escaped;
+}
+
+// Synthetic network output of numberPeople random skeletons: a Gaussian on each body part, the background channel,
+// and unit vectors along each limb in the PAFs. The heat maps are obtained from it with resizeAndMergeCpu (as in
+// OpenPose), so both resolutions are consistent.
+Fixture getSyntheticFixture(const op::PoseModel poseModel, const op::Point<int>& heatMapSize, const int numberPeople)
+{
+    try
+    {
+        const auto numberBodyParts = (int)op::getPoseNumberBodyParts(poseModel);
+        const auto numberBodyPartsAndBkg = numberBodyParts + (op::addBkgChannel(poseModel) ? 1 : 0);
+        const auto& bodyPartPairs = op::getPosePartPairs(poseModel);
+        const auto& mapIdx = op::getPoseMapIndex(poseModel);
+        const auto stride = 8;
+        Fixture fixture;
+        fixture.name = "synthetic";
+        fixture.heatMapSize = heatMapSize;
+        fixture.netOutputSize = op::Point<int>{heatMapSize.x / stride, heatMapSize.y / stride};
+        fixture.channels = numberBodyPartsAndBkg + (int)mapIdx.size();
+        fixture.people = numberPeople;
+        const auto netOutputArea = fixture.netOutputSize.area();
+        fixture.netOutput.resize(fixture.channels * netOutputArea, 0.f);
+        // Random skeletons (heat map coordinates): each limb grows from an already placed body part
+        std::mt19937 generator{(unsigned int)(heatMapSize.area() + numberPeople)};
+        std::uniform_real_distribution<float> uniform{0.f, 1.f};
+        const auto pi = 3.14159265f;
+        std::vector<std::vector<op::Point<float>>> people(numberPeople);
+        for (auto& person : people)
+        {
+            const auto scale = heatMapSize.y * (0.15f + 0.3f*uniform(generator));
+            person.resize(numberBodyParts, op::Point<float>{-1.f, -1.f});
+            std::vector<bool> placed(numberBodyParts, false);
+            person[bodyPartPairs[0]] = op::Point<float>{
+                heatMapSize.x * (0.15f + 0.7f*uniform(generator)), heatMapSize.y * (0.15f + 0.7f*uniform(generator))};
+            placed[bodyPartPairs[0]] = true;
+            for (auto changed = true ; changed ; )
+            {
+                changed = false;
+                for (auto pair = 0u ; pair < bodyPartPairs.size() ; pair+=2)
+                {
+                    const auto partA = bodyPartPairs[pair];
+                    const auto partB = bodyPartPairs[pair+1];
+                    if (placed[partA] != placed[partB])
+                    {
+                        const auto source = (placed[partA] ? partA : partB);
+                        const auto target = (placed[partA] ? partB : partA);
+                        const auto angle = 2.f*pi*uniform(generator);
+                        const auto length = scale * (0.1f + 0.1f*uniform(generator));
+                        person[target] = op::Point<float>{
+                            person[source].x + length*std::cos(angle), person[source].y + length*std::sin(angle)};
+                        placed[target] = true;
+                        changed = true;
+                    }
+                }
+            }
+        }
+        // Heat map coordinates --> network output coordinates (same pixel-center alignment than resizeAndMergeCpu)
+        for (auto& person : people)
+            for (auto& bodyPart : person)
+                bodyPart = op::Point<float>{(bodyPart.x + 0.5f) / stride - 0.5f, (bodyPart.y + 0.5f) / stride - 0.5f};
+        // Body parts and background
+        const auto sigma = 1.f;
+        const auto radius = (int)std::ceil(3*sigma);
+        for (const auto& person : people)
+        {
+            for (auto part = 0 ; part < numberBodyParts ; part++)
+            {
+                auto* channelPtr = &fixture.netOutput[part*netOutputArea];
+                const auto& center = person[part];
+                for (auto y = op::fastMax(0, (int)center.y - radius) ;
+                     y <= op::fastMin(fixture.netOutputSize.y - 1, (int)center.y + radius) ; y++)
+                    for (auto x = op::fastMax(0, (int)center.x - radius) ;
+                         x <= op::fastMin(fixture.netOutputSize.x - 1, (int)center.x + radius) ; x++)
+                    {
+                        const auto dx = x - center.x;
+                        const auto dy = y - center.y;
+                        auto& value = channelPtr[y*fixture.netOutputSize.x + x];
+                        value = op::fastMax(value, std::exp(-(dx*dx+dy*dy)/(2*sigma*sigma)));
+                    }
+            }
+        }
+        if (numberBodyPartsAndBkg > numberBodyParts)
+        {
+            auto* bkgPtr = &fixture.netOutput[numberBodyParts*netOutputArea];
+            for (auto i = 0 ; i < netOutputArea ; i++)
+            {
+                auto maximum = 0.f;
+                for (auto part = 0 ; part < numberBodyParts ; part++)
+                    maximum = op::fastMax(maximum, fixture.netOutput[part*netOutputArea + i]);
+                bkgPtr[i] = 1.f - maximum;
+            }
+        }
+        // PAFs
+        const auto limbHalfWidth = 1.f;
+        for (const auto& person : people)
+        {
+            for (auto pair = 0u ; pair < bodyPartPairs.size()/2 ; pair++)
+            {
+                const auto& pointA = person[bodyPartPairs[2*pair]];
+                const auto& pointB = person[bodyPartPairs[2*pair+1]];
+                const auto vectorX = pointB.x - pointA.x;
+                const auto vectorY = pointB.y - pointA.y;
+                const auto length = std::sqrt(vectorX*vectorX + vectorY*vectorY);
+                if (length < 1e-3f)
+                    continue;
+                const auto unitX = vectorX / length;
+                const auto unitY = vectorY / length;
+                auto* pafXPtr = &fixture.netOutput[(numberBodyPartsAndBkg + mapIdx[2*pair])*netOutputArea];
+                auto* pafYPtr = &fixture.netOutput[(numberBodyPartsAndBkg + mapIdx[2*pair+1])*netOutputArea];
+                const auto minX = op::fastMax(0, (int)(op::fastMin(pointA.x, pointB.x) - limbHalfWidth));
+                const auto maxX = op::fastMin(fixture.netOutputSize.x - 1,
+                                              (int)(op::fastMax(pointA.x, pointB.x) + limbHalfWidth + 1));
+                const auto minY = op::fastMax(0, (int)(op::fastMin(pointA.y, pointB.y) - limbHalfWidth));
+                const auto maxY = op::fastMin(fixture.netOutputSize.y - 1,
+                                              (int)(op::fastMax(pointA.y, pointB.y) + limbHalfWidth + 1));
+                for (auto y = minY ; y <= maxY ; y++)
+                    for (auto x = minX ; x <= maxX ; x++)
+                    {
+                        const auto along = (x - pointA.x)*unitX + (y - pointA.y)*unitY;
+                        const auto across = std::abs((x - pointA.x)*unitY - (y - pointA.y)*unitX);
+                        if (along >= 0.f && along <= length && across <= limbHalfWidth)
+                        {
+                            pafXPtr[y*fixture.netOutputSize.x + x] = unitX;
+                            pafYPtr[y*fixture.netOutputSize.x + x] = unitY;
+                        }
+                    }
+            }
+        }
+        // Heat maps
+        fixture.heatMaps.resize(fixture.channels * heatMapSize.area());
+        op::resizeAndMergeCpu(
+            fixture.heatMaps.data(), {fixture.netOutput.data()},
+            std::array<int, 4>{1, fixture.channels, heatMapSize.y, heatMapSize.x},
+            {std::array<int, 4>{1, fixture.channels, fixture.netOutputSize.y, fixture.netOutputSize.x}});
+        return fixture;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return Fixture{};
+    }
+}
+
+// Heat maps saved by OpenPose with `--write_heatmaps_format float` (see saveFloatArray). The network output is
+// approximated by averaging each 8x8 block.
+Fixture loadFixture(const std::string& filePath, const int channels)
+{
+    try
+    {
+        Fixture fixture;
+        fixture.name = op::getFileNameAndExtension(filePath);
+        fixture.people = -1;
+        std::ifstream file{filePath, std::ios::binary};
+        float numberDimensions = 0.f;
+        file.read((char*)&numberDimensions, sizeof(float));
+        std::vector<float> dimensions((int)numberDimensions);
+        if (!dimensions.empty())
+            file.read((char*)dimensions.data(), dimensions.size()*sizeof(float));
+        if (!file || dimensions.size() != 3 || (int)dimensions[0] != channels)
+        {
+            op::opLog("Skipping fixture " + filePath + ": expected " + std::to_string(channels) + " x height x width"
+                      " heat maps (body parts, background, and PAFs).", op::Priority::High);
+            return Fixture{};
+        }
+        fixture.channels = channels;
+        fixture.heatMapSize = op::Point<int>{(int)dimensions[2], (int)dimensions[1]};
+        fixture.heatMaps.resize(channels * fixture.heatMapSize.area());
+        file.read((char*)fixture.heatMaps.data(), fixture.heatMaps.size()*sizeof(float));
+        if (!file)
+            op::error("Fixture " + filePath + " is truncated.", __LINE__, __FUNCTION__, __FILE__);
+        // Network output
+        const auto stride = 8;
+        fixture.netOutputSize = op::Point<int>{fixture.heatMapSize.x / stride, fixture.heatMapSize.y / stride};
+        fixture.netOutput.resize(channels * fixture.netOutputSize.area());
+        for (auto c = 0 ; c < channels ; c++)
+        {
+            const auto* heatMapPtr = &fixture.heatMaps[c*fixture.heatMapSize.area()];
+            auto* netOutputPtr = &fixture.netOutput[c*fixture.netOutputSize.area()];
+            for (auto y = 0 ; y < fixture.netOutputSize.y ; y++)
+                for (auto x = 0 ; x < fixture.netOutputSize.x ; x++)
+                {
+                    auto sum = 0.f;
+                    for (auto yBlock = 0 ; yBlock < stride ; yBlock++)
+                        for (auto xBlock = 0 ; xBlock < stride ; xBlock++)
+                            sum += heatMapPtr[(y*stride + yBlock)*fixture.heatMapSize.x + x*stride + xBlock];
+                    netOutputPtr[y*fixture.netOutputSize.x + x] = sum / (stride*stride);
+                }
+        }
+        return fixture;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return Fixture{};
+    }
+}
+
+// It runs function 1 time (warm-up: lazy initializations, thread_local buffers, etc.), and then FLAGS_repetitions
+// samples of as many iterations as required to last FLAGS_min_time / FLAGS_repetitions seconds each.
+void runBenchmark(
+    std::vector<BenchmarkResult>& results, const std::string& name, const Fixture& fixture, const int detectedPeople,
+    const double itemsPerOp, const std::string& itemName, const std::function<void()>& function)
+{
+    try
+    {
+        if (!FLAGS_benchmark_filter.empty() && name.find(FLAGS_benchmark_filter) == std::string::npos)
+            return;
+        typedef std::chrono::high_resolution_clock Clock;
+        // Warm-up and calibration
+        auto begin = Clock::now();
+        function();
+        const auto nsWarmUp = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - begin).count();
+        const auto repetitions = op::fastMax(1, FLAGS_repetitions);
+        const auto nsPerSample = 1e9 * FLAGS_min_time / repetitions;
+        const auto iterations = (unsigned long long)op::fastMax(1., nsPerSample / op::fastMax(1., nsWarmUp));
+        // Samples
+        BenchmarkResult result;
+        result.name = name;
+        result.fixture = fixture.name;
+        result.resolution = fixture.heatMapSize;
+        result.people = fixture.people;
+        result.detectedPeople = detectedPeople;
+        result.iterations = iterations * repetitions;
+        result.itemsPerOp = itemsPerOp;
+        result.itemName = itemName;
+        const auto memoryPoolEnabled = op::MemoryPool::getEnabled();
+        const auto arrayAllocationsBegin = op::MemoryPool::getStats().allocations;
+        const auto allocationsBegin = sNumberAllocations.load();
+        const auto bytesAllocatedBegin = sBytesAllocated.load();
+        for (auto repetition = 0 ; repetition < repetitions ; repetition++)
+        {
+            begin = Clock::now();
+            for (auto iteration = 0ull ; iteration < iterations ; iteration++)
+                function();
+            const auto nsSample = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - begin).count();
+            result.nsPerOpSamples.emplace_back(nsSample / iterations);
+        }
+        result.allocationsPerOp = (sNumberAllocations.load() - allocationsBegin) / (double)result.iterations;
+        result.bytesAllocatedPerOp = (sBytesAllocated.load() - bytesAllocatedBegin) / (double)result.iterations;
+        result.arrayAllocationsPerOp = (memoryPoolEnabled
+            ? (op::MemoryPool::getStats().allocations - arrayAllocationsBegin) / (double)result.iterations : -1.);
+        // Report
+        const auto nsPerOp = getMedian(result.nsPerOpSamples);
+        op::opLog(name + " [" + fixture.name + ", " + std::to_string(fixture.heatMapSize.x) + "x"
+                  + std::to_string(fixture.heatMapSize.y) + ", " + std::to_string(fixture.people) + " people]: "
+                  + std::to_string(nsPerOp*1e-6) + " ms/op, " + std::to_string(1e9/nsPerOp) + " op/s, "
+                  + std::to_string(itemsPerOp*1e3/nsPerOp) + " M" + itemName + "/s, "
+                  + std::to_string(result.allocationsPerOp) + " allocations/op", op::Priority::High);
+        results.emplace_back(result);
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+    }
+}
+
+void runBenchmarks(std::vector<BenchmarkResult>& results, const Fixture& fixture, const op::PoseModel poseModel)
+{
+    try
+    {
+        const auto numberBodyParts = (int)op::getPoseNumberBodyParts(poseModel);
+        const auto maxPeaks = (int)op::getPoseMaxPeaks();
+        const auto& heatMapSize = fixture.heatMapSize;
+        const std::array<int, 4> netOutputShape{1, fixture.channels, fixture.netOutputSize.y, fixture.netOutputSize.x};
+        const std::array<int, 4> heatMapsShape{1, fixture.channels, heatMapSize.y, heatMapSize.x};
+        const std::array<int, 4> peaksShape{1, numberBodyParts, maxPeaks+1, 3};
+        const auto nmsThreshold = op::getPoseDefaultNmsThreshold(poseModel);
+        const op::Point<float> nmsOffset{0.5f, 0.5f};
+
+        // resizeAndMergeCpu: network output --> heat maps
+        std::vector<float> heatMaps(fixture.heatMaps.size());
+        runBenchmark(
+            results, "resizeAndMergeCpu", fixture, -1, (double)heatMaps.size(), "pixel",
+            [&]
+            {
+                op::resizeAndMergeCpu(heatMaps.data(), {fixture.netOutput.data()}, heatMapsShape, {netOutputShape});
+            });
+
+        // nmsCpu: heat maps --> peaks
+        std::vector<int> kernel(fixture.heatMaps.size());
+        std::vector<float> peaks(numberBodyParts * (maxPeaks+1) * 3);
+        const auto nmsFunction = [&]
+        {
+            op::nmsCpu(peaks.data(), kernel.data(), fixture.heatMaps.data(), nmsThreshold, peaksShape, heatMapsShape,
+                       nmsOffset);
+        };
+        nmsFunction();
+        runBenchmark(
+            results, "nmsCpu", fixture, -1, (double)numberBodyParts*heatMapSize.area(), "pixel", nmsFunction);
+
+        // connectBodyPartsCpu: heat maps + peaks --> people
+        op::Array<float> poseKeypoints;
+        op::Array<float> poseScores;
+        const auto connectFunction = [&]
+        {
+            op::connectBodyPartsCpu(
+                poseKeypoints, poseScores, fixture.heatMaps.data(), peaks.data(), poseModel, heatMapSize, maxPeaks,
+                op::getPoseDefaultConnectInterMinAboveThreshold(), op::getPoseDefaultConnectInterThreshold(poseModel),
+                (int)op::getPoseDefaultMinSubsetCnt(), op::getPoseDefaultConnectMinSubsetScore(), nmsThreshold);
+        };
+        connectFunction();
+        const auto detectedPeople = (poseKeypoints.empty() ? 0 : poseKeypoints.getSize(0));
+        runBenchmark(
+            results, "connectBodyPartsCpu", fixture, detectedPeople, (double)detectedPeople, "people",
+            connectFunction);
+
+        // uCharCvMatToFloatPtr: BGR image --> normalized network input
+        cv::Mat cvImage{heatMapSize.y, heatMapSize.x, CV_8UC3};
+        cv::randu(cvImage, cv::Scalar::all(0), cv::Scalar::all(256));
+        const op::Matrix opImage = OP_CV2OPCONSTMAT(cvImage);
+        std::vector<float> netInput(3 * heatMapSize.area());
+        runBenchmark(
+            results, "uCharCvMatToFloatPtr", fixture, detectedPeople, (double)heatMapSize.area(), "pixel",
+            [&]
+            {
+                op::uCharCvMatToFloatPtr(netInput.data(), opImage, 1);
+            });
+
+        // renderPoseKeypointsCpu: people --> rendered frame
+        op::Array<float> frameArray{{heatMapSize.y, heatMapSize.x, 3}, 128.f};
+        runBenchmark(
+            results, "renderPoseKeypointsCpu", fixture, detectedPeople, (double)heatMapSize.area(), "pixel",
+            [&]
+            {
+                op::renderPoseKeypointsCpu(frameArray, poseKeypoints, poseModel, 0.05f);
+            });
+
+        // PoseTriangulation::reconstructArray: FLAGS_views projections of the people --> 3-D people
+        // Cameras on a horizontal arc 3 meters away from the origin, looking at it
+        const auto numberViews = op::fastMax(2, FLAGS_views);
+        const auto numberPeople = op::fastMax(1, fixture.people >= 0 ? fixture.people : detectedPeople);
+        const auto focal = (double)heatMapSize.x;
+        std::vector<cv::Mat> cvCameraMatrices;
+        std::vector<op::Matrix> cameraMatrices;
+        for (auto view = 0 ; view < numberViews ; view++)
+        {
+            const auto angle = 0.5 * (view / (double)(numberViews-1) - 0.5);
+            const cv::Mat intrinsics = (cv::Mat_<double>(3,3)
+                << focal, 0, heatMapSize.x/2., 0, focal, heatMapSize.y/2., 0, 0, 1);
+            const cv::Mat rotation = (cv::Mat_<double>(3,3)
+                << std::cos(angle), 0, -std::sin(angle), 0, 1, 0, std::sin(angle), 0, std::cos(angle));
+            const cv::Mat translation = (cv::Mat_<double>(3,1) << 0, 0, 3);
+            cv::Mat extrinsics;
+            cv::hconcat(rotation, translation, extrinsics);
+            cvCameraMatrices.emplace_back(intrinsics * extrinsics);
+        }
+        for (const auto& cvCameraMatrix : cvCameraMatrices)
+            cameraMatrices.emplace_back(OP_CV2OPCONSTMAT(cvCameraMatrix));
+        const std::vector<op::Point<int>> imageSizes(numberViews, heatMapSize);
+        std::mt19937 generator{0};
+        std::uniform_real_distribution<double> uniform{-0.4, 0.4};
+        std::vector<std::vector<op::Array<float>>> keypointsVectors(
+            numberPeople, std::vector<op::Array<float>>(numberViews));
+        for (auto person = 0 ; person < numberPeople ; person++)
+        {
+            for (auto view = 0 ; view < numberViews ; view++)
+                keypointsVectors[person][view].reset({1, numberBodyParts, 3}, 0.f);
+            for (auto part = 0 ; part < numberBodyParts ; part++)
+            {
+                const cv::Mat point3D = (cv::Mat_<double>(4,1) << uniform(generator), uniform(generator),
+                                         uniform(generator), 1);
+                for (auto view = 0 ; view < numberViews ; view++)
+                {
+                    const cv::Mat projection = cvCameraMatrices[view] * point3D;
+                    auto* keypointPtr = &keypointsVectors[person][view][3*part];
+                    keypointPtr[0] = (float)(projection.at<double>(0) / projection.at<double>(2));
+                    keypointPtr[1] = (float)(projection.at<double>(1) / projection.at<double>(2));
+                    keypointPtr[2] = 0.9f;
+                }
+            }
+        }
+        op::PoseTriangulation poseTriangulation{-1};
+        poseTriangulation.initializationOnThread();
+        Fixture triangulationFixture = Fixture{fixture.name, fixture.netOutputSize, heatMapSize, fixture.channels,
+                                               numberPeople, {}, {}};
+        runBenchmark(
+            results, "PoseTriangulation::reconstructArray", triangulationFixture, numberPeople,
+            (double)numberPeople*numberBodyParts, "keypoint",
+            [&]
+            {
+                poseTriangulation.reconstructArray(keypointsVectors, cameraMatrices, imageSizes);
+            });
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+    }
+}
+
+// PoseExtractorCaffe::forwardPassBatch: batchSize network inputs (random images) --> people of each frame. Each op
+// is a batch, so items (frames) per second is the throughput of a GPU (or CPU) thread with `--pose_batch_size`.
+void runNetworkBenchmarks(
+    std::vector<BenchmarkResult>& results, const op::Point<int>& netInputSize, const op::PoseModel poseModel)
+{
+    try
+    {
+        op::PoseExtractorCaffe poseExtractorCaffe{poseModel, FLAGS_model_folder, FLAGS_num_gpu_start};
+        poseExtractorCaffe.initializationOnThread();
+        // Network input
+        cv::Mat cvImage{netInputSize.y, netInputSize.x, CV_8UC3};
+        cv::randu(cvImage, cv::Scalar::all(0), cv::Scalar::all(256));
+        const op::Matrix opImage = OP_CV2OPCONSTMAT(cvImage);
+        op::Array<float> netInput{{1, 3, netInputSize.y, netInputSize.x}};
+        op::uCharCvMatToFloatPtr(netInput.getPtr(), opImage, 1);
+        const Fixture fixture{"network", netInputSize/8, netInputSize, 0, -1, {}, {}};
+        for (const auto batchSize : splitInts(FLAGS_batch_sizes))
+        {
+            const auto numberFrames = op::fastMax(1, batchSize);
+            const std::vector<std::vector<op::Array<float>>> inputNetData(numberFrames, {netInput});
+            const std::vector<op::Point<int>> inputDataSizes(numberFrames, netInputSize);
+            const std::vector<std::vector<double>> scaleInputToNetInputs(numberFrames, {1.});
+            const auto numberResults = results.size();
+            runBenchmark(
+                results, "PoseExtractorCaffe::forwardPassBatch/N=" + std::to_string(numberFrames), fixture, -1,
+                (double)numberFrames, "frame",
+                [&]
+                {
+                    poseExtractorCaffe.forwardPassBatch(
+                        inputNetData, inputDataSizes, scaleInputToNetInputs, [](const int) {});
+                });
+            if (results.size() > numberResults)
+            {
+                const auto nsPerBatch = getMedian(results.back().nsPerOpSamples);
+                op::opLog("Batch size " + std::to_string(numberFrames) + ": "
+                          + std::to_string(numberFrames*1e9/nsPerBatch) + " frames/s, "
+                          + std::to_string(nsPerBatch*1e-6) + " ms per batch", op::Priority::High);
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+    }
+}
+
+void saveJson(const std::vector<BenchmarkResult>& results, const std::string& filePath)
+{
+    try
+    {
+        std::ostringstream json;
+        json.precision(10);
+        const auto time = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&time));
+        json << "{\n"
+             << "  \"context\": {\n"
+             << "    \"openpose_version\": \"" << OPEN_POSE_VERSION_STRING << "\",\n"
+             #ifdef OPENPOSE_GIT_COMMIT
+             << "    \"git_commit\": \"" << OPENPOSE_GIT_COMMIT << "\",\n"
+             #endif
+             << "    \"label\": \"" << escapeJson(FLAGS_benchmark_label) << "\",\n"
+             << "    \"date\": \"" << date << "\",\n"
+             << "    \"simd_level\": \"" << op::simdLevelToString(op::getSimdLevel()) << "\",\n"
+             << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+             << "    \"memory_pool\": " << (op::MemoryPool::getEnabled() ? "true" : "false") << ",\n"
+             << "    \"model_pose\": \"" << escapeJson(FLAGS_model_pose) << "\",\n"
+             << "    \"min_time\": " << FLAGS_min_time << ",\n"
+             << "    \"repetitions\": " << FLAGS_repetitions << "\n"
+             << "  },\n"
+             << "  \"benchmarks\": [";
+        for (auto i = 0u ; i < results.size() ; i++)
+        {
+            const auto& result = results[i];
+            const auto nsPerOp = getMedian(result.nsPerOpSamples);
+            json << (i > 0 ? "," : "") << "\n    {\n"
+                 << "      \"name\": \"" << escapeJson(result.name) << "\",\n"
+                 << "      \"fixture\": \"" << escapeJson(result.fixture) << "\",\n"
+                 << "      \"width\": " << result.resolution.x << ",\n"
+                 << "      \"height\": " << result.resolution.y << ",\n"
+                 << "      \"people\": " << result.people << ",\n"
+                 << "      \"detected_people\": " << result.detectedPeople << ",\n"
+                 << "      \"iterations\": " << result.iterations << ",\n"
+                 << "      \"ns_per_op\": " << nsPerOp << ",\n"
+                 << "      \"ns_per_op_min\": "
+                 << *std::min_element(result.nsPerOpSamples.begin(), result.nsPerOpSamples.end()) << ",\n"
+                 << "      \"ns_per_op_max\": "
+                 << *std::max_element(result.nsPerOpSamples.begin(), result.nsPerOpSamples.end()) << ",\n"
+                 << "      \"ops_per_second\": " << 1e9/nsPerOp << ",\n"
+                 << "      \"items_per_op\": " << result.itemsPerOp << ",\n"
+                 << "      \"item\": \"" << result.itemName << "\",\n"
+                 << "      \"items_per_second\": " << result.itemsPerOp*1e9/nsPerOp << ",\n"
+                 << "      \"allocations_per_op\": " << result.allocationsPerOp << ",\n"
+                 << "      \"bytes_allocated_per_op\": " << result.bytesAllocatedPerOp << ",\n"
+                 << "      \"array_allocations_per_op\": ";
+            if (result.arrayAllocationsPerOp < 0)
+                json << "null\n";
+            else
+                json << result.arrayAllocationsPerOp << "\n";
+            json << "    }";
+        }
+        json << "\n  ]\n}\n";
+        std::ofstream file{filePath};
+        file << json.str();
+        if (!file)
+            op::error("Could not write " + filePath + ".", __LINE__, __FUNCTION__, __FILE__);
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+    }
+}
+
+int openPoseBenchmarks()
+{
+    try
+    {
+        op::opLog("Starting OpenPose benchmarks...", op::Priority::High);
+
+        // Configuring OpenPose
+        op::checkBool(
+            0 <= FLAGS_logging_level && FLAGS_logging_level <= 255, "Wrong logging_level value.",
+            __LINE__, __FUNCTION__, __FILE__);
+        op::ConfigureLog::setPriorityThreshold((op::Priority)FLAGS_logging_level);
+        op::MemoryPool::setEnabled(FLAGS_memory_pool);
+        if (FLAGS_simd_level >= 0)
+            op::setMaxSimdLevel((op::SimdLevel)op::fastMin(FLAGS_simd_level, (int)op::SimdLevel::Avx512));
+        const auto poseModel = op::flagsToPoseModel(op::String(FLAGS_model_pose));
+        op::opLog("SIMD level: " + op::simdLevelToString(op::getSimdLevel()), op::Priority::High);
+
+        // Fixtures
+        std::vector<Fixture> fixtures;
+        if (!FLAGS_no_synthetic)
+            for (const auto& netResolution : op::splitString(FLAGS_net_resolutions, ","))
+                for (const auto numberPeople : splitInts(FLAGS_people))
+                    fixtures.emplace_back(getSyntheticFixture(
+                        poseModel, op::flagsToPoint(op::String(netResolution), "656x368"), numberPeople));
+        if (!FLAGS_fixtures.empty())
+        {
+            const auto channels = (int)(op::getPoseNumberBodyParts(poseModel) + (op::addBkgChannel(poseModel) ? 1 : 0)
+                                        + op::getPoseMapIndex(poseModel).size());
+            for (const auto& filePath : op::getFilesOnDirectory(FLAGS_fixtures, "float"))
+            {
+                auto fixture = loadFixture(filePath, channels);
+                if (!fixture.heatMaps.empty())
+                    fixtures.emplace_back(std::move(fixture));
+            }
+        }
+        if (fixtures.empty())
+            op::error("No fixtures to benchmark.", __LINE__, __FUNCTION__, __FILE__);
+
+        // Benchmarks
+        std::vector<BenchmarkResult> results;
+        for (const auto& fixture : fixtures)
+            runBenchmarks(results, fixture, poseModel);
+        if (!FLAGS_model_folder.empty())
+            for (const auto& netResolution : op::splitString(FLAGS_net_resolutions, ","))
+                runNetworkBenchmarks(results, op::flagsToPoint(op::String(netResolution), "656x368"), poseModel);
+
+        // JSON output
+        if (!FLAGS_json_output.empty())
+        {
+            saveJson(results, FLAGS_json_output);
+            op::opLog("Results saved in " + FLAGS_json_output + ".", op::Priority::High);
+        }
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return -1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running openPoseBenchmarks
+    return openPoseBenchmarks();
+}
@@ -0,0 +1,203 @@
+// ------------------------- OpenPose Queue Contention Benchmark -------------------------
+// Throughput of Queue (single mutex) and LockFreeQueue (ring buffer) when N pusher threads and N popper threads share
+// the same queue, as the pose extractor threads do with `--num_gpu` N. The poppers wait as the event-driven
+// SubThreads do (tryPopFor() and isRunning()).
+
+#include <algorithm> // std::sort
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+// Command-line user interface
+#define OPENPOSE_FLAGS_DISABLE_POSE
+#include <openpose/flags.hpp>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+DEFINE_string(threads,                  "1,2,4,8,16",   "Comma-separated list with the number of pusher threads (and of popper threads) to benchmark.");
+DEFINE_int32(items,                     200000,         "Number of elements pushed (in total) for each benchmark.");
+DEFINE_int32(queue_size,                -1,             "Maximum queue size. If -1, it is max(#pushers, #poppers), as in the ThreadManager queues.");
+DEFINE_int32(repetitions,               3,              "Number of samples per benchmark (the median is reported).");
+DEFINE_string(json_output,              "",             "If not empty, the results are also saved in JSON format into this file path.");
+
+typedef std::shared_ptr<std::vector<std::shared_ptr<op::Datum>>> TDatumsSP;
+
+struct ContentionResult
+{
+    std::string queue;
+    int threads;
+    double nsPerItem;
+    double itemsPerSecond;
+};
+
+template<typename TQueue>
+double runContention(const int numberThreads, const int numberItems)
+{
+    try
+    {
+        TQueue tQueue{FLAGS_queue_size};
+        for (auto i = 0 ; i < numberThreads ; i++)
+        {
+            tQueue.addPusher();
+            tQueue.addPopper();
+        }
+        const auto tDatums = std::make_shared<std::vector<std::shared_ptr<op::Datum>>>();
+        std::atomic<long long> itemsPopped{0ll};
+        std::vector<std::thread> threads;
+        const auto begin = std::chrono::steady_clock::now();
+        for (auto i = 0 ; i < numberThreads ; i++)
+        {
+            // Pusher
+            const auto numberItemsThread = numberItems / numberThreads + (i < numberItems % numberThreads ? 1 : 0);
+            threads.emplace_back(
+                [&tQueue, &tDatums, numberItemsThread]
+                {
+                    for (auto item = 0 ; item < numberItemsThread ; item++)
+                        tQueue.waitAndPush(tDatums);
+                    tQueue.stopPusher();
+                });
+            // Popper
+            threads.emplace_back(
+                [&tQueue, &itemsPopped]
+                {
+                    TDatumsSP tDatumsPopped;
+                    while (true)
+                    {
+                        if (tQueue.tryPopFor(tDatumsPopped, std::chrono::milliseconds{10}))
+                            itemsPopped++;
+                        else if (!tQueue.isRunning())
+                            break;
+                    }
+                });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+        if (itemsPopped != numberItems)
+            op::error("Popped " + std::to_string(itemsPopped) + " elements rather than "
+                      + std::to_string(numberItems) + ".", __LINE__, __FUNCTION__, __FILE__);
+        return double(nanoseconds) / numberItems;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return 0.;
+    }
+}
+
+template<typename TQueue>
+ContentionResult runBenchmark(const std::string& queueName, const int numberThreads)
+{
+    try
+    {
+        const auto numberItems = op::fastMax(1, FLAGS_items);
+        // Warm up
+        runContention<TQueue>(numberThreads, op::fastMax(1, numberItems/10));
+        // Median of the samples
+        std::vector<double> samples;
+        for (auto repetition = 0 ; repetition < op::fastMax(1, FLAGS_repetitions) ; repetition++)
+            samples.emplace_back(runContention<TQueue>(numberThreads, numberItems));
+        std::sort(samples.begin(), samples.end());
+        ContentionResult result;
+        result.queue = queueName;
+        result.threads = numberThreads;
+        result.nsPerItem = samples[samples.size()/2];
+        result.itemsPerSecond = 1e9 / result.nsPerItem;
+        op::opLog(queueName + " (" + std::to_string(numberThreads) + " pushers + " + std::to_string(numberThreads)
+                  + " poppers): " + std::to_string(result.nsPerItem) + " ns/item, "
+                  + std::to_string(result.itemsPerSecond) + " items/s", op::Priority::High);
+        return result;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return ContentionResult{};
+    }
+}
+
+void saveJson(const std::vector<ContentionResult>& results, const std::string& filePath)
+{
+    try
+    {
+        std::ostringstream json;
+        json.precision(10);
+        json << "{\n"
+             << "  \"context\": {\n"
+             << "    \"openpose_version\": \"" << OPEN_POSE_VERSION_STRING << "\",\n"
+             #ifdef OPENPOSE_GIT_COMMIT
+             << "    \"git_commit\": \"" << OPENPOSE_GIT_COMMIT << "\",\n"
+             #endif
+             << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+             << "    \"items\": " << FLAGS_items << ",\n"
+             << "    \"queue_size\": " << FLAGS_queue_size << "\n"
+             << "  },\n"
+             << "  \"benchmarks\": [";
+        for (auto i = 0u ; i < results.size() ; i++)
+        {
+            const auto& result = results[i];
+            json << (i > 0 ? "," : "") << "\n    {\n"
+                 << "      \"queue\": \"" << result.queue << "\",\n"
+                 << "      \"threads\": " << result.threads << ",\n"
+                 << "      \"ns_per_item\": " << result.nsPerItem << ",\n"
+                 << "      \"items_per_second\": " << result.itemsPerSecond << "\n"
+                 << "    }";
+        }
+        json << "\n  ]\n}\n";
+        std::ofstream file{filePath};
+        file << json.str();
+        if (!file)
+            op::error("Could not write " + filePath + ".", __LINE__, __FUNCTION__, __FILE__);
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+    }
+}
+
+int queueContentionBenchmark()
+{
+    try
+    {
+        op::opLog("Starting queue contention benchmark...", op::Priority::High);
+
+        // Configuring OpenPose
+        op::checkBool(
+            0 <= FLAGS_logging_level && FLAGS_logging_level <= 255, "Wrong logging_level value.",
+            __LINE__, __FUNCTION__, __FILE__);
+        op::ConfigureLog::setPriorityThreshold((op::Priority)FLAGS_logging_level);
+
+        // Benchmark each queue and number of threads
+        std::vector<ContentionResult> results;
+        for (const auto& threadsString : op::splitString(FLAGS_threads, ","))
+        {
+            const auto numberThreads = op::fastMax(1, std::stoi(threadsString));
+            results.emplace_back(runBenchmark<op::Queue<TDatumsSP>>("Queue", numberThreads));
+            results.emplace_back(runBenchmark<op::LockFreeQueue<TDatumsSP>>("LockFreeQueue", numberThreads));
+        }
+
+        // JSON output
+        if (!FLAGS_json_output.empty())
+        {
+            saveJson(results, FLAGS_json_output);
+            op::opLog("Results saved in " + FLAGS_json_output + ".", op::Priority::High);
+        }
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return -1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running queueContentionBenchmark
+    return queueContentionBenchmark();
+}
@@ -0,0 +1,248 @@
+// ------------------------- OpenPose ThreadManager Latency Benchmark -------------------------
+// End-to-end per-frame latency (p50, p90, p99, max) of a ThreadManager pipeline for each ThreadSchedulingMode, and
+// the CPU usage of the pipeline while processing and while idle. Each stage busy-waits `stage_us` microseconds per
+// frame (emulating computation), so any latency above `stages` x `stage_us` is scheduling overhead.
+// Note: The CPU usage relies on std::clock(), which only measures the process CPU time on POSIX systems.
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <thread>
+// Command-line user interface
+#define OPENPOSE_FLAGS_DISABLE_POSE
+#include <openpose/flags.hpp>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+DEFINE_int32(stages,                    6,              "Number of pipeline stages (i.e., threads).");
+DEFINE_int32(stage_us,                  200,            "Busy-wait time (in microseconds) of each stage per frame.");
+DEFINE_int32(frames,                    600,            "Number of frames pushed into the pipeline for each scheduling mode.");
+DEFINE_double(fps,                      120.,           "Rate at which the frames are pushed into the pipeline.");
+DEFINE_double(idle_seconds,             1.,             "Time that the pipeline is kept idle (no frames) in order to measure its idle CPU usage.");
+DEFINE_string(scheduling_modes,         "Polling,EventDriven", "Comma-separated list of ThreadSchedulingMode values to benchmark.");
+DEFINE_string(json_output,              "",             "If not empty, the results are also saved in JSON format into this file path.");
+
+struct LatencyDatum
+{
+    unsigned long long id;
+    std::chrono::steady_clock::time_point pushTime;
+};
+typedef std::vector<std::shared_ptr<LatencyDatum>> TDatums;
+typedef std::shared_ptr<TDatums> TDatumsSP;
+
+class WBusyStage : public op::Worker<TDatumsSP>
+{
+public:
+    explicit WBusyStage(const std::chrono::microseconds& workTime) :
+        mWorkTime{workTime}
+    {
+    }
+
+    void initializationOnThread()
+    {
+    }
+
+    void work(TDatumsSP& tDatums)
+    {
+        // Busy wait rather than sleep, to emulate computation
+        if (tDatums != nullptr)
+        {
+            const auto end = std::chrono::steady_clock::now() + mWorkTime;
+            while (std::chrono::steady_clock::now() < end)
+                ;
+        }
+    }
+
+private:
+    const std::chrono::microseconds mWorkTime;
+};
+
+struct LatencyResult
+{
+    std::string schedulingMode;
+    std::vector<double> latenciesUs;
+    double cpuUsageBusy;
+    double cpuUsageIdle;
+};
+
+double getPercentile(const std::vector<double>& sortedValues, const double percentile)
+{
+    if (sortedValues.empty())
+        return 0.;
+    const auto index = (std::size_t)(percentile/100. * (sortedValues.size()-1) + 0.5);
+    return sortedValues[std::min(index, sortedValues.size()-1)];
+}
+
+LatencyResult runPipeline(const std::string& schedulingModeString)
+{
+    try
+    {
+        LatencyResult result;
+        result.schedulingMode = schedulingModeString;
+        op::ThreadSchedulingMode schedulingMode;
+        if (schedulingModeString == "Polling")
+            schedulingMode = op::ThreadSchedulingMode::Polling;
+        else if (schedulingModeString == "EventDriven")
+            schedulingMode = op::ThreadSchedulingMode::EventDriven;
+        else
+            op::error("Unknown scheduling mode: " + schedulingModeString + ".", __LINE__, __FUNCTION__, __FILE__);
+
+        // Pipeline: user --> queue 0 --> stage 0 --> queue 1 --> ... --> stage N-1 --> queue N --> user
+        op::ThreadManager<TDatumsSP> threadManager{op::ThreadManagerMode::Asynchronous};
+        threadManager.setThreadSchedulingMode(schedulingMode);
+        const auto numberStages = op::fastMax(1, FLAGS_stages);
+        for (auto stage = 0 ; stage < numberStages ; stage++)
+            threadManager.add(
+                stage, std::make_shared<WBusyStage>(std::chrono::microseconds{FLAGS_stage_us}), stage, stage+1);
+        threadManager.start();
+
+        // Producer thread: 1 frame every 1/FLAGS_fps seconds
+        const auto numberFrames = op::fastMax(1, FLAGS_frames);
+        const auto period = std::chrono::nanoseconds{(long long)(1e9 / FLAGS_fps)};
+        const auto wallBegin = std::chrono::steady_clock::now();
+        const auto cpuBegin = std::clock();
+        std::thread producer{
+            [&]
+            {
+                for (auto frame = 0 ; frame < numberFrames ; frame++)
+                {
+                    std::this_thread::sleep_until(wallBegin + frame*period);
+                    auto tDatums = std::make_shared<TDatums>(
+                        1, std::make_shared<LatencyDatum>(LatencyDatum{(unsigned long long)frame,
+                                                                       std::chrono::steady_clock::now()}));
+                    threadManager.waitAndEmplace(tDatums);
+                }
+            }};
+        // Consumer (this thread)
+        for (auto frame = 0 ; frame < numberFrames ; frame++)
+        {
+            TDatumsSP tDatums;
+            if (!threadManager.waitAndPop(tDatums) || tDatums == nullptr || tDatums->empty())
+                op::error("Pipeline stopped unexpectedly.", __LINE__, __FUNCTION__, __FILE__);
+            result.latenciesUs.emplace_back(1e-3 * std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - (*tDatums)[0]->pushTime).count());
+        }
+        producer.join();
+        const auto cpuBusy = double(std::clock() - cpuBegin) / CLOCKS_PER_SEC;
+        const auto wallBusy = 1e-9 * std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wallBegin).count();
+        result.cpuUsageBusy = cpuBusy / wallBusy;
+
+        // Idle pipeline
+        const auto cpuIdleBegin = std::clock();
+        const auto wallIdleBegin = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::nanoseconds{(long long)(1e9 * FLAGS_idle_seconds)});
+        const auto cpuIdle = double(std::clock() - cpuIdleBegin) / CLOCKS_PER_SEC;
+        const auto wallIdle = 1e-9 * std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wallIdleBegin).count();
+        result.cpuUsageIdle = cpuIdle / wallIdle;
+
+        threadManager.stop();
+
+        // Report
+        std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+        const auto computeUs = (double)numberStages * FLAGS_stage_us;
+        op::opLog(schedulingModeString + ": latency p50 = " + std::to_string(getPercentile(result.latenciesUs, 50))
+                  + " us, p90 = " + std::to_string(getPercentile(result.latenciesUs, 90))
+                  + " us, p99 = " + std::to_string(getPercentile(result.latenciesUs, 99))
+                  + " us, max = " + std::to_string(result.latenciesUs.back())
+                  + " us (computation = " + std::to_string(computeUs) + " us), CPU usage (busy / idle) = "
+                  + std::to_string(100*result.cpuUsageBusy) + "% / " + std::to_string(100*result.cpuUsageIdle)
+                  + "%", op::Priority::High);
+        return result;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return LatencyResult{};
+    }
+}
+
+void saveJson(const std::vector<LatencyResult>& results, const std::string& filePath)
+{
+    try
+    {
+        std::ostringstream json;
+        json.precision(10);
+        json << "{\n"
+             << "  \"context\": {\n"
+             << "    \"openpose_version\": \"" << OPEN_POSE_VERSION_STRING << "\",\n"
+             #ifdef OPENPOSE_GIT_COMMIT
+             << "    \"git_commit\": \"" << OPENPOSE_GIT_COMMIT << "\",\n"
+             #endif
+             << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+             << "    \"stages\": " << FLAGS_stages << ",\n"
+             << "    \"stage_us\": " << FLAGS_stage_us << ",\n"
+             << "    \"frames\": " << FLAGS_frames << ",\n"
+             << "    \"fps\": " << FLAGS_fps << "\n"
+             << "  },\n"
+             << "  \"benchmarks\": [";
+        for (auto i = 0u ; i < results.size() ; i++)
+        {
+            const auto& result = results[i];
+            json << (i > 0 ? "," : "") << "\n    {\n"
+                 << "      \"scheduling_mode\": \"" << result.schedulingMode << "\",\n"
+                 << "      \"latency_us_p50\": " << getPercentile(result.latenciesUs, 50) << ",\n"
+                 << "      \"latency_us_p90\": " << getPercentile(result.latenciesUs, 90) << ",\n"
+                 << "      \"latency_us_p99\": " << getPercentile(result.latenciesUs, 99) << ",\n"
+                 << "      \"latency_us_max\": "
+                 << (result.latenciesUs.empty() ? 0. : result.latenciesUs.back()) << ",\n"
+                 << "      \"cpu_usage_busy\": " << result.cpuUsageBusy << ",\n"
+                 << "      \"cpu_usage_idle\": " << result.cpuUsageIdle << "\n"
+                 << "    }";
+        }
+        json << "\n  ]\n}\n";
+        std::ofstream file{filePath};
+        file << json.str();
+        if (!file)
+            op::error("Could not write " + filePath + ".", __LINE__, __FUNCTION__, __FILE__);
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+    }
+}
+
+int threadLatencyBenchmark()
+{
+    try
+    {
+        op::opLog("Starting ThreadManager latency benchmark...", op::Priority::High);
+
+        // Configuring OpenPose
+        op::checkBool(
+            0 <= FLAGS_logging_level && FLAGS_logging_level <= 255, "Wrong logging_level value.",
+            __LINE__, __FUNCTION__, __FILE__);
+        op::ConfigureLog::setPriorityThreshold((op::Priority)FLAGS_logging_level);
+
+        // Benchmark each scheduling mode
+        std::vector<LatencyResult> results;
+        for (const auto& schedulingMode : op::splitString(FLAGS_scheduling_modes, ","))
+            results.emplace_back(runPipeline(schedulingMode));
+
+        // JSON output
+        if (!FLAGS_json_output.empty())
+        {
+            saveJson(results, FLAGS_json_output);
+            op::opLog("Results saved in " + FLAGS_json_output + ".", op::Priority::High);
+        }
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return -1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running threadLatencyBenchmark
+    return threadLatencyBenchmark();
+}
@@ -107,7 +107,9 @@ void configureWrapper(op::WrapperT<op::UserDatum>& opWrapperT)
         opWrapperT.configure(wrapperStructHand);
         // Extra functionality configuration (use op::WrapperStructExtra{} to disable it)
         const op::WrapperStructExtra wrapperStructExtra{
-            FLAGS_3d, FLAGS_3d_min_views, FLAGS_identification, FLAGS_tracking, FLAGS_ik_threads};
+            FLAGS_3d, FLAGS_3d_min_views, FLAGS_identification, FLAGS_tracking, FLAGS_ik_threads,
+            op::flagsToBackpressurePolicy(FLAGS_backpressure), FLAGS_latency_target, FLAGS_unordered_output,
+            op::flagsToThreadAffinities(op::String(FLAGS_thread_cores), op::String(FLAGS_thread_numa_nodes))};
         opWrapperT.configure(wrapperStructExtra);
         // Producer (use default to disable any input)
         const op::WrapperStructInput wrapperStructInput{
@@ -123,7 +125,7 @@ void configureWrapper(op::WrapperT<op::UserDatum>& opWrapperT)
             op::String(FLAGS_write_video), FLAGS_write_video_fps, FLAGS_write_video_with_audio,
             op::String(FLAGS_write_heatmaps), op::String(FLAGS_write_heatmaps_format), op::String(FLAGS_write_video_3d),
             op::String(FLAGS_write_video_adam), op::String(FLAGS_write_bvh), op::String(FLAGS_udp_host),
-            op::String(FLAGS_udp_port)};
+            op::String(FLAGS_udp_port), op::String(FLAGS_write_metrics), FLAGS_write_metrics_seconds};
         opWrapperT.configure(wrapperStructOutput);
         // GUI (comment or use default argument to disable any visual output)
         const op::WrapperStructGui wrapperStructGui{
@@ -0,0 +1,171 @@
+// ------------------------- OpenPose KeyframeTracker Testing -------------------------
+// Keyframe mode of `--face_keyframe_interval` and `--hand_keyframe_interval` on synthetic frames: a textured image
+// shifted a few pixels per frame. It checks that track() propagates the keypoints with the image motion, and that it
+// requests a new keyframe (returns false) when the keyframe interval is reached, when the ROI moves more than
+// maxRoiMotion, and when Lucas-Kanade loses too many keypoints.
+
+// Third-party dependencies
+#include <opencv2/opencv.hpp>
+// Command-line user interface
+#define OPENPOSE_FLAGS_DISABLE_POSE
+#include <openpose/flags.hpp>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+DEFINE_int32(image_width,               480,            "Width of the synthetic frames.");
+DEFINE_int32(image_height,              360,            "Height of the synthetic frames.");
+DEFINE_int32(shift_x,                   3,              "Horizontal motion per synthetic frame, in pixels.");
+DEFINE_int32(shift_y,                   2,              "Vertical motion per synthetic frame, in pixels.");
+
+// Synthetic image shifted by (shiftX, shiftY)
+cv::Mat shiftImage(const cv::Mat& image, const float shiftX, const float shiftY)
+{
+    cv::Mat shiftedImage;
+    const cv::Mat transformation = (cv::Mat_<double>(2,3) << 1, 0, shiftX, 0, 1, shiftY);
+    cv::warpAffine(image, shiftedImage, transformation, image.size(), cv::INTER_LINEAR, cv::BORDER_REFLECT);
+    return shiftedImage;
+}
+
+int keyframeTrackerTest()
+{
+    try
+    {
+        op::opLog("Starting KeyframeTracker test...", op::Priority::High);
+
+        // Synthetic texture (smooth enough to track large motion)
+        cv::Mat noise{FLAGS_image_height, FLAGS_image_width, CV_8UC3};
+        cv::setRNGSeed(0);
+        cv::randu(noise, cv::Scalar::all(0), cv::Scalar::all(256));
+        cv::Mat image;
+        cv::GaussianBlur(noise, image, cv::Size{0,0}, 8.);
+        cv::normalize(image, image, 0, 255, cv::NORM_MINMAX);
+        // Frames (ImagePyramidCache does not copy them, so they are kept until the end)
+        const auto numberFrames = 6;
+        std::vector<cv::Mat> frames(numberFrames);
+        std::vector<std::shared_ptr<op::ImagePyramidCache>> imagePyramidCaches(numberFrames);
+        for (auto frame = 0 ; frame < numberFrames ; frame++)
+        {
+            frames[frame] = shiftImage(image, float(frame*FLAGS_shift_x), float(frame*FLAGS_shift_y));
+            imagePyramidCaches[frame] = std::make_shared<op::ImagePyramidCache>(OP_CV2OPCONSTMAT(frames[frame]));
+        }
+        // Keyframe keypoints: 1 group with 1 person whose 25 keypoints lie on a grid inside its ROI
+        const auto gridSize = 5;
+        const auto gridStep = 12.f;
+        const op::Point<float> gridOrigin{0.35f*FLAGS_image_width, 0.3f*FLAGS_image_height};
+        const auto score = 0.8f;
+        std::vector<op::Array<float>> keypointsKeyframe{op::Array<float>{{1, gridSize*gridSize, 3}, 0.f}};
+        for (auto part = 0 ; part < gridSize*gridSize ; part++)
+        {
+            keypointsKeyframe[0][3*part] = gridOrigin.x + (part % gridSize)*gridStep;
+            keypointsKeyframe[0][3*part+1] = gridOrigin.y + (part / gridSize)*gridStep;
+            keypointsKeyframe[0][3*part+2] = score;
+        }
+        const auto roiSize = 100.f;
+        const auto roiCenter = gridOrigin + op::Point<float>{0.5f*(gridSize-1)*gridStep, 0.5f*(gridSize-1)*gridStep};
+        const auto getRectangles = [&](const float shiftX, const float shiftY)
+        {
+            return std::vector<std::vector<op::Rectangle<float>>>{{op::Rectangle<float>{
+                roiCenter.x - 0.5f*roiSize + shiftX, roiCenter.y - 0.5f*roiSize + shiftY, roiSize, roiSize}}};
+        };
+        const auto maxRoiMotion = 0.2f;
+        const auto maxKeypointLoss = 0.2f;
+        auto numberFailures = 0;
+        const auto check = [&numberFailures](const bool condition, const std::string& message)
+        {
+            op::opLog((condition ? "Passed: " : "FAILED: ") + message, op::Priority::High);
+            if (!condition)
+                numberFailures++;
+        };
+
+        // Propagation: the keypoints move with the image, keeping their scores
+        // Keyframe interval reached: a new keyframe is requested after numberFrames-2 tracked frames
+        op::KeyframeTracker keyframeTracker{numberFrames-1, maxRoiMotion, maxKeypointLoss};
+        keyframeTracker.setKeyframe(keypointsKeyframe, getRectangles(0.f, 0.f), 0ull, imagePyramidCaches[0]);
+        auto maxKeypointError = 0.f;
+        auto allTracked = true;
+        auto scoresKept = true;
+        for (auto frame = 1 ; frame < numberFrames-1 ; frame++)
+        {
+            const auto shiftX = float(frame*FLAGS_shift_x);
+            const auto shiftY = float(frame*FLAGS_shift_y);
+            std::vector<op::Array<float>> keypoints;
+            if (!keyframeTracker.track(keypoints, getRectangles(shiftX, shiftY), 0ull, imagePyramidCaches[frame]))
+            {
+                allTracked = false;
+                break;
+            }
+            for (auto part = 0 ; part < gridSize*gridSize ; part++)
+            {
+                const auto dx = keypoints[0][3*part] - keypointsKeyframe[0][3*part] - shiftX;
+                const auto dy = keypoints[0][3*part+1] - keypointsKeyframe[0][3*part+1] - shiftY;
+                maxKeypointError = op::fastMax(maxKeypointError, std::sqrt(dx*dx + dy*dy));
+                scoresKept &= (keypoints[0][3*part+2] == score);
+            }
+        }
+        op::opLog("Propagated keypoint error (max): " + std::to_string(maxKeypointError) + " pixels",
+                  op::Priority::High);
+        check(allTracked, "track() propagates the keypoints of the frames between keyframes.");
+        check(allTracked && maxKeypointError < 0.5f, "Propagated keypoints follow the image motion.");
+        check(allTracked && scoresKept, "Propagated keypoints keep their keyframe scores.");
+        check(keyframeTracker.getNumberFramesTracked() == numberFrames-2ull, "getNumberFramesTracked().");
+        {
+            const auto frame = numberFrames-1;
+            std::vector<op::Array<float>> keypoints;
+            check(!keyframeTracker.track(
+                keypoints, getRectangles(float(frame*FLAGS_shift_x), float(frame*FLAGS_shift_y)), 0ull,
+                imagePyramidCaches[frame]) && keypoints.empty(),
+                "track() requests a keyframe when the keyframe interval is reached.");
+        }
+
+        // ROI motion larger than maxRoiMotion (or ROI disappearing) requires a new keyframe
+        {
+            op::KeyframeTracker keyframeTrackerRoi{numberFrames, maxRoiMotion, maxKeypointLoss};
+            keyframeTrackerRoi.setKeyframe(keypointsKeyframe, getRectangles(0.f, 0.f), 0ull, imagePyramidCaches[0]);
+            std::vector<op::Array<float>> keypoints;
+            const auto roiMotion = 1.5f*maxRoiMotion*roiSize;
+            check(!keyframeTrackerRoi.track(keypoints, getRectangles(roiMotion, 0.f), 0ull, imagePyramidCaches[1]),
+                  "track() requests a keyframe when the ROI moves more than maxRoiMotion.");
+            const std::vector<std::vector<op::Rectangle<float>>> noRectangles{{op::Rectangle<float>{}}};
+            check(!keyframeTrackerRoi.track(keypoints, noRectangles, 0ull, imagePyramidCaches[1]),
+                  "track() requests a keyframe when the ROI disappears.");
+            check(!keyframeTrackerRoi.track(keypoints, getRectangles(0.f, 0.f), 1ull, imagePyramidCaches[1]),
+                  "track() requests a keyframe for image views without keyframe.");
+            check(keyframeTrackerRoi.track(keypoints, getRectangles(0.5f*roiMotion, 0.f), 0ull,
+                                           imagePyramidCaches[1]),
+                  "track() propagates the keypoints when the ROI moves less than maxRoiMotion.");
+        }
+
+        // Too many keypoints lost: image motion larger than the one LK keeps (2 x patchSize = 42 pixels), with the
+        // ROI unchanged
+        {
+            op::KeyframeTracker keyframeTrackerLoss{numberFrames, maxRoiMotion, maxKeypointLoss};
+            keyframeTrackerLoss.setKeyframe(keypointsKeyframe, getRectangles(0.f, 0.f), 0ull, imagePyramidCaches[0]);
+            const auto frameLoss = shiftImage(image, 50.f, 0.f);
+            const auto imagePyramidCacheLoss = std::make_shared<op::ImagePyramidCache>(OP_CV2OPCONSTMAT(frameLoss));
+            std::vector<op::Array<float>> keypoints;
+            check(!keyframeTrackerLoss.track(keypoints, getRectangles(0.f, 0.f), 0ull, imagePyramidCacheLoss),
+                  "track() requests a keyframe when too many keypoints are lost.");
+        }
+
+        if (numberFailures > 0)
+            op::error("KeyframeTracker test failed (" + std::to_string(numberFailures) + " failures).",
+                      __LINE__, __FUNCTION__, __FILE__);
+        op::opLog("KeyframeTracker test passed.", op::Priority::High);
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return -1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running keyframeTrackerTest
+    return keyframeTrackerTest();
+}
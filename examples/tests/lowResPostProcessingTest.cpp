@@ -0,0 +1,344 @@
+// ------------------------- OpenPose Low-Resolution Post-Processing Testing -------------------------
+// Accuracy and speed report of `--low_res_post_processing` (nmsLowResolutionCpu + on-demand PAF sampling) with
+// respect to the default full-resolution CPU post-processing (resizeAndMergeCpu + nmsCpu), on synthetic heat maps.
+// It also compares the final BODY_25 poseKeypoints (connectBodyPartsCpu) of both pipelines on synthetic people.
+
+#include <chrono>
+#include <limits>
+#include <random>
+// Command-line user interface
+#define OPENPOSE_FLAGS_DISABLE_POSE
+#include <openpose/flags.hpp>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+DEFINE_int32(source_width,              46,             "Width of the synthetic network output.");
+DEFINE_int32(source_height,             46,             "Height of the synthetic network output.");
+DEFINE_int32(channels,                  78,             "Number of channels of the synthetic network output.");
+DEFINE_int32(upsampling,                8,              "Ratio between the upsampled heat maps and the network output.");
+DEFINE_int32(peaks_per_channel,         6,              "Number of Gaussian peaks added to each channel.");
+DEFINE_int32(repetitions,               20,             "Number of repetitions to average the timing.");
+DEFINE_double(threshold,                0.05,           "NMS threshold.");
+DEFINE_int32(people,                    4,              "Number of synthetic people for the poseKeypoints comparison.");
+DEFINE_double(max_peak_miss_rate,       0.02,           "Maximum ratio of full-resolution peaks without a low-resolution peak"
+                                                        " closer than 2 pixels.");
+
+int lowResPostProcessingTest()
+{
+    try
+    {
+        op::opLog("Starting low-resolution post-processing test...", op::Priority::High);
+
+        // Synthetic network output: sum of Gaussians with sub-pixel centers and random amplitudes
+        const auto channels = FLAGS_channels;
+        const op::Point<int> sourceSize{FLAGS_source_width, FLAGS_source_height};
+        const op::Point<int> targetSize{FLAGS_upsampling*sourceSize.x, FLAGS_upsampling*sourceSize.y};
+        const auto sourceArea = sourceSize.area();
+        const auto targetArea = targetSize.area();
+        std::vector<float> source(channels*sourceArea, 0.f);
+        std::mt19937 generator{0};
+        std::uniform_real_distribution<float> xDistribution{1.f, sourceSize.x - 2.f};
+        std::uniform_real_distribution<float> yDistribution{1.f, sourceSize.y - 2.f};
+        std::uniform_real_distribution<float> amplitudeDistribution{0.1f, 1.f};
+        std::uniform_real_distribution<float> sigmaDistribution{0.6f, 1.5f};
+        for (auto c = 0 ; c < channels ; c++)
+        {
+            auto* channelPtr = &source[c*sourceArea];
+            for (auto p = 0 ; p < FLAGS_peaks_per_channel ; p++)
+            {
+                const auto xCenter = xDistribution(generator);
+                const auto yCenter = yDistribution(generator);
+                const auto amplitude = amplitudeDistribution(generator);
+                const auto sigma = sigmaDistribution(generator);
+                for (auto y = 0 ; y < sourceSize.y ; y++)
+                    for (auto x = 0 ; x < sourceSize.x ; x++)
+                    {
+                        const auto dx = x - xCenter;
+                        const auto dy = y - yCenter;
+                        channelPtr[y*sourceSize.x + x] = op::fastMax(
+                            channelPtr[y*sourceSize.x + x], amplitude*std::exp(-(dx*dx+dy*dy)/(2*sigma*sigma)));
+                    }
+            }
+        }
+
+        // Shapes
+        const auto maxPeaks = (int)op::getPoseMaxPeaks();
+        const std::array<int, 4> sourceShape{1, channels, sourceSize.y, sourceSize.x};
+        const std::array<int, 4> heatMapsShape{1, channels, targetSize.y, targetSize.x};
+        const std::array<int, 4> peaksShape{1, channels, maxPeaks+1, 3};
+        const auto peaksOffset = 3*(maxPeaks+1);
+        const auto threshold = (float)FLAGS_threshold;
+        const op::Point<float> offset{0.5f, 0.5f};
+        std::vector<float> heatMaps(channels*targetArea);
+        std::vector<int> kernel(channels*targetArea);
+        std::vector<float> peaks(channels*peaksOffset);
+        std::vector<float> peaksLowRes(channels*peaksOffset);
+
+        // Default post-processing
+        const auto beginFull = std::chrono::high_resolution_clock::now();
+        for (auto r = 0 ; r < FLAGS_repetitions ; r++)
+        {
+            op::resizeAndMergeCpu(heatMaps.data(), {source.data()}, heatMapsShape, {sourceShape});
+            op::nmsCpu(peaks.data(), kernel.data(), heatMaps.data(), threshold, peaksShape, heatMapsShape, offset);
+        }
+        const auto msFull = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now()-beginFull).count() * 1e-6 / FLAGS_repetitions;
+        // Low-resolution post-processing
+        const auto beginLowRes = std::chrono::high_resolution_clock::now();
+        for (auto r = 0 ; r < FLAGS_repetitions ; r++)
+            op::nmsLowResolutionCpu(
+                peaksLowRes.data(), source.data(), threshold, peaksShape, sourceShape, targetSize, offset);
+        const auto msLowRes = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now()-beginLowRes).count() * 1e-6 / FLAGS_repetitions;
+
+        // Peak accuracy: each full-resolution peak is matched with the closest low-resolution one
+        const auto maxMatchDistance = 2.f;
+        auto numberPeaks = 0;
+        auto numberPeaksLowRes = 0;
+        auto matched = 0;
+        auto sumDistance = 0.;
+        auto maxDistance = 0.f;
+        auto sumScoreDelta = 0.;
+        auto maxScoreDelta = 0.f;
+        for (auto c = 0 ; c < channels ; c++)
+        {
+            const auto* peaksPtr = &peaks[c*peaksOffset];
+            const auto* peaksLowResPtr = &peaksLowRes[c*peaksOffset];
+            numberPeaks += (int)peaksPtr[0];
+            numberPeaksLowRes += (int)peaksLowResPtr[0];
+            for (auto p = 1 ; p <= (int)peaksPtr[0] ; p++)
+            {
+                auto bestDistance = std::numeric_limits<float>::max();
+                auto bestScoreDelta = 0.f;
+                for (auto q = 1 ; q <= (int)peaksLowResPtr[0] ; q++)
+                {
+                    const auto distance = std::sqrt(
+                        (peaksPtr[3*p] - peaksLowResPtr[3*q])*(peaksPtr[3*p] - peaksLowResPtr[3*q])
+                        + (peaksPtr[3*p+1] - peaksLowResPtr[3*q+1])*(peaksPtr[3*p+1] - peaksLowResPtr[3*q+1]));
+                    if (bestDistance > distance)
+                    {
+                        bestDistance = distance;
+                        bestScoreDelta = std::abs(peaksPtr[3*p+2] - peaksLowResPtr[3*q+2]);
+                    }
+                }
+                if (bestDistance <= maxMatchDistance)
+                {
+                    matched++;
+                    sumDistance += bestDistance;
+                    maxDistance = op::fastMax(maxDistance, bestDistance);
+                    sumScoreDelta += bestScoreDelta;
+                    maxScoreDelta = op::fastMax(maxScoreDelta, bestScoreDelta);
+                }
+            }
+        }
+
+        // PAF sampling accuracy: on-demand pixels vs. the full-resolution resized heat maps
+        auto maxSampleDelta = 0.f;
+        std::uniform_int_distribution<int> cDistribution{0, channels-1};
+        std::uniform_int_distribution<int> xTargetDistribution{0, targetSize.x-1};
+        std::uniform_int_distribution<int> yTargetDistribution{0, targetSize.y-1};
+        for (auto i = 0 ; i < 100000 ; i++)
+        {
+            const auto c = cDistribution(generator);
+            const auto x = xTargetDistribution(generator);
+            const auto y = yTargetDistribution(generator);
+            const auto sample = op::resizeCubicPixelCpu(&source[c*sourceArea], sourceSize, targetSize, x, y);
+            const auto delta = std::abs(sample - heatMaps[c*targetArea + y*targetSize.x + x]);
+            maxSampleDelta = op::fastMax(maxSampleDelta, delta);
+        }
+
+        // Body part connector: synthetic BODY_25 network output with people (Gaussian parts and PAFs along each
+        // limb), connected from the full-resolution heat maps vs. from the network output (heatMapSourceSize)
+        const auto poseModel = op::PoseModel::BODY_25;
+        const auto numberBodyParts = (int)op::getPoseNumberBodyParts(poseModel);
+        const auto& bodyPartPairs = op::getPosePartPairs(poseModel);
+        const auto& mapIdx = op::getPoseMapIndex(poseModel);
+        const auto numberBodyPartsAndBkg = numberBodyParts + (op::addBkgChannel(poseModel) ? 1 : 0);
+        const auto channelsPeople = numberBodyPartsAndBkg + (int)bodyPartPairs.size();
+        const std::array<int, 4> sourcePeopleShape{1, channelsPeople, sourceSize.y, sourceSize.x};
+        const std::array<int, 4> heatMapsPeopleShape{1, channelsPeople, targetSize.y, targetSize.x};
+        const std::array<int, 4> peaksPeopleShape{1, numberBodyParts, maxPeaks+1, 3};
+        std::vector<float> sourcePeople(channelsPeople*sourceArea, 0.f);
+        // People in a grid of cells, each body part randomly placed inside its person cell
+        const auto cellsPerRow = (int)std::ceil(std::sqrt(FLAGS_people));
+        const op::Point<float> cellSize{sourceSize.x / float(cellsPerRow), sourceSize.y / float(cellsPerRow)};
+        std::uniform_real_distribution<float> cellDistribution{0.15f, 0.85f};
+        for (auto person = 0 ; person < FLAGS_people ; person++)
+        {
+            std::vector<op::Point<float>> parts(numberBodyParts);
+            for (auto& part : parts)
+                part = op::Point<float>{(person % cellsPerRow + cellDistribution(generator)) * cellSize.x,
+                                        (person / cellsPerRow + cellDistribution(generator)) * cellSize.y};
+            // Body parts
+            for (auto part = 0 ; part < numberBodyParts ; part++)
+            {
+                auto* channelPtr = &sourcePeople[part*sourceArea];
+                for (auto y = 0 ; y < sourceSize.y ; y++)
+                    for (auto x = 0 ; x < sourceSize.x ; x++)
+                    {
+                        const auto dx = x - parts[part].x;
+                        const auto dy = y - parts[part].y;
+                        channelPtr[y*sourceSize.x + x] = op::fastMax(
+                            channelPtr[y*sourceSize.x + x], 0.9f*std::exp(-(dx*dx+dy*dy)/2.f));
+                    }
+            }
+            // PAFs: unit vector from part A to part B within 1 pixel of the limb
+            for (auto pair = 0u ; pair < bodyPartPairs.size()/2 ; pair++)
+            {
+                const auto& partA = parts[bodyPartPairs[2*pair]];
+                const auto& partB = parts[bodyPartPairs[2*pair+1]];
+                const auto limbX = partB.x - partA.x;
+                const auto limbY = partB.y - partA.y;
+                const auto limbNorm = std::sqrt(limbX*limbX + limbY*limbY);
+                if (limbNorm < 1e-3f)
+                    continue;
+                auto* mapX = &sourcePeople[(numberBodyPartsAndBkg + mapIdx[2*pair])*sourceArea];
+                auto* mapY = &sourcePeople[(numberBodyPartsAndBkg + mapIdx[2*pair+1])*sourceArea];
+                for (auto y = 0 ; y < sourceSize.y ; y++)
+                    for (auto x = 0 ; x < sourceSize.x ; x++)
+                    {
+                        const auto alongLimb = ((x - partA.x)*limbX + (y - partA.y)*limbY) / limbNorm;
+                        const auto acrossLimb = std::abs((x - partA.x)*limbY - (y - partA.y)*limbX) / limbNorm;
+                        if (alongLimb >= 0.f && alongLimb <= limbNorm && acrossLimb <= 1.f)
+                        {
+                            mapX[y*sourceSize.x + x] = limbX / limbNorm;
+                            mapY[y*sourceSize.x + x] = limbY / limbNorm;
+                        }
+                    }
+            }
+        }
+        // Connector parameters
+        const auto nmsThresholdPeople = op::getPoseDefaultNmsThreshold(poseModel);
+        const auto interMinAboveThreshold = op::getPoseDefaultConnectInterMinAboveThreshold();
+        const auto interThreshold = op::getPoseDefaultConnectInterThreshold(poseModel);
+        const auto minSubsetCnt = (int)op::getPoseDefaultMinSubsetCnt();
+        const auto minSubsetScore = op::getPoseDefaultConnectMinSubsetScore();
+        // Full-resolution pipeline
+        std::vector<float> heatMapsPeople(channelsPeople*targetArea);
+        std::vector<int> kernelPeople(numberBodyParts*targetArea);
+        std::vector<float> peaksPeople(numberBodyParts*peaksOffset);
+        op::Array<float> poseKeypoints;
+        op::Array<float> poseScores;
+        op::resizeAndMergeCpu(heatMapsPeople.data(), {sourcePeople.data()}, heatMapsPeopleShape, {sourcePeopleShape});
+        op::nmsCpu(peaksPeople.data(), kernelPeople.data(), heatMapsPeople.data(), nmsThresholdPeople,
+                   peaksPeopleShape, heatMapsPeopleShape, offset);
+        op::connectBodyPartsCpu(
+            poseKeypoints, poseScores, heatMapsPeople.data(), peaksPeople.data(), poseModel, targetSize, maxPeaks,
+            interMinAboveThreshold, interThreshold, minSubsetCnt, minSubsetScore, nmsThresholdPeople);
+        // Low-resolution pipeline
+        std::vector<float> peaksPeopleLowRes(numberBodyParts*peaksOffset);
+        op::Array<float> poseKeypointsLowRes;
+        op::Array<float> poseScoresLowRes;
+        op::nmsLowResolutionCpu(peaksPeopleLowRes.data(), sourcePeople.data(), nmsThresholdPeople, peaksPeopleShape,
+                                sourcePeopleShape, targetSize, offset);
+        op::connectBodyPartsCpu(
+            poseKeypointsLowRes, poseScoresLowRes, sourcePeople.data(), peaksPeopleLowRes.data(), poseModel,
+            targetSize, maxPeaks, interMinAboveThreshold, interThreshold, minSubsetCnt, minSubsetScore,
+            nmsThresholdPeople, 1.f, false, sourceSize);
+        // poseKeypoints accuracy: each full-resolution person is matched with the closest low-resolution one
+        const auto numberPeople = poseKeypoints.getSize(0);
+        const auto numberPeopleLowRes = poseKeypointsLowRes.getSize(0);
+        auto keypointsVisibilityMismatch = 0;
+        auto sumKeypointDistance = 0.;
+        auto maxKeypointDistance = 0.f;
+        auto maxKeypointScoreDelta = 0.f;
+        auto numberKeypoints = 0;
+        for (auto person = 0 ; person < numberPeople ; person++)
+        {
+            auto bestPerson = -1;
+            auto bestDistance = std::numeric_limits<float>::max();
+            for (auto personLowRes = 0 ; personLowRes < numberPeopleLowRes ; personLowRes++)
+            {
+                // Distance between their common keypoints, plus a penalty for each keypoint found only by one
+                auto distance = 0.f;
+                for (auto part = 0 ; part < numberBodyParts ; part++)
+                {
+                    const auto index = 3*(person*numberBodyParts + part);
+                    const auto indexLowRes = 3*(personLowRes*numberBodyParts + part);
+                    if ((poseKeypoints[index+2] > 0.f) != (poseKeypointsLowRes[indexLowRes+2] > 0.f))
+                        distance += (float)targetSize.x;
+                    else
+                        distance += std::abs(poseKeypoints[index] - poseKeypointsLowRes[indexLowRes])
+                                  + std::abs(poseKeypoints[index+1] - poseKeypointsLowRes[indexLowRes+1]);
+                }
+                if (bestDistance > distance)
+                {
+                    bestDistance = distance;
+                    bestPerson = personLowRes;
+                }
+            }
+            for (auto part = 0 ; bestPerson >= 0 && part < numberBodyParts ; part++)
+            {
+                const auto index = 3*(person*numberBodyParts + part);
+                const auto indexLowRes = 3*(bestPerson*numberBodyParts + part);
+                if ((poseKeypoints[index+2] > 0.f) != (poseKeypointsLowRes[indexLowRes+2] > 0.f))
+                    keypointsVisibilityMismatch++;
+                else if (poseKeypoints[index+2] > 0.f)
+                {
+                    const auto dx = poseKeypoints[index] - poseKeypointsLowRes[indexLowRes];
+                    const auto dy = poseKeypoints[index+1] - poseKeypointsLowRes[indexLowRes+1];
+                    const auto distance = std::sqrt(dx*dx + dy*dy);
+                    numberKeypoints++;
+                    sumKeypointDistance += distance;
+                    maxKeypointDistance = op::fastMax(maxKeypointDistance, distance);
+                    maxKeypointScoreDelta = op::fastMax(
+                        maxKeypointScoreDelta, std::abs(poseKeypoints[index+2] - poseKeypointsLowRes[indexLowRes+2]));
+                }
+            }
+        }
+
+        // Report
+        op::opLog("Network output: " + std::to_string(channels) + "x" + std::to_string(sourceSize.y) + "x"
+                  + std::to_string(sourceSize.x) + ", upsampled: " + std::to_string(targetSize.y) + "x"
+                  + std::to_string(targetSize.x), op::Priority::High);
+        op::opLog("Time (full-resolution resize + NMS): " + std::to_string(msFull) + " ms", op::Priority::High);
+        op::opLog("Time (low-resolution NMS): " + std::to_string(msLowRes) + " ms", op::Priority::High);
+        op::opLog("Peaks (full-resolution / low-resolution / matched): " + std::to_string(numberPeaks) + " / "
+                  + std::to_string(numberPeaksLowRes) + " / " + std::to_string(matched), op::Priority::High);
+        const auto peakMissRate = 1. - matched / (double)op::fastMax(1, numberPeaks);
+        op::opLog("Peak miss rate: " + std::to_string(peakMissRate), op::Priority::High);
+        op::opLog("Peak position delta (mean / max): " + std::to_string(sumDistance / op::fastMax(1, matched)) + " / "
+                  + std::to_string(maxDistance) + " pixels", op::Priority::High);
+        op::opLog("Peak score delta (mean / max): " + std::to_string(sumScoreDelta / op::fastMax(1, matched)) + " / "
+                  + std::to_string(maxScoreDelta), op::Priority::High);
+        op::opLog("PAF sample delta (max): " + std::to_string(maxSampleDelta), op::Priority::High);
+        op::opLog("People (synthetic / full-resolution / low-resolution): " + std::to_string(FLAGS_people) + " / "
+                  + std::to_string(numberPeople) + " / " + std::to_string(numberPeopleLowRes), op::Priority::High);
+        op::opLog("poseKeypoints position delta (mean / max): "
+                  + std::to_string(sumKeypointDistance / op::fastMax(1, numberKeypoints)) + " / "
+                  + std::to_string(maxKeypointDistance) + " pixels", op::Priority::High);
+        op::opLog("poseKeypoints score delta (max): " + std::to_string(maxKeypointScoreDelta), op::Priority::High);
+        op::opLog("poseKeypoints found only by one of them: " + std::to_string(keypointsVisibilityMismatch),
+                  op::Priority::High);
+
+        // Peaks must match (up to max_peak_miss_rate)
+        if (numberPeaks == 0 || peakMissRate > FLAGS_max_peak_miss_rate)
+            op::error("Low-resolution peaks miss " + std::to_string(numberPeaks - matched) + " out of "
+                      + std::to_string(numberPeaks) + " full-resolution peaks.", __LINE__, __FUNCTION__, __FILE__);
+        // Both pipelines must find every synthetic person
+        if (numberPeople != FLAGS_people)
+            op::error("Full-resolution post-processing found " + std::to_string(numberPeople) + " people instead of "
+                      + std::to_string(FLAGS_people) + ".", __LINE__, __FUNCTION__, __FILE__);
+        // poseKeypoints must be equivalent
+        if (numberPeople != numberPeopleLowRes || keypointsVisibilityMismatch > 0
+            || maxKeypointDistance > maxMatchDistance)
+            op::error("Low-resolution post-processing poseKeypoints differ from the full-resolution ones.",
+                      __LINE__, __FUNCTION__, __FILE__);
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return -1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running lowResPostProcessingTest
+    return lowResPostProcessingTest();
+}
@@ -298,6 +298,15 @@ namespace op
          */
         int getStride(const int index) const;
 
+        /**
+         * Return the alignment (in bytes) of the data pointer, i.e., the largest power of 2 (up to 64) that divides
+         * its address. Memory allocated by Array<T> (or by the MemoryPool) is always aligned to 64 bytes, so this is
+         * only smaller for an Array<T> wrapping an external pointer.
+         * SIMD code can use it to choose between aligned and unaligned loads/stores.
+         * @return The alignment of the data, or 0 if no memory is allocated.
+         */
+        std::size_t getAlignment() const;
+
 
 
         // ------------------------------ Data Access Functions And Operators ------------------------------ //
@@ -16,6 +16,7 @@
 #include <openpose/core/string.hpp>
 #include <openpose/utilities/errorAndLog.hpp>
 #include <openpose/utilities/profiler.hpp>
+#include <openpose/utilities/tracer.hpp>
 // Datum at the end, otherwise circular dependency with array, point & rectangle
 #include <openpose/core/datum.hpp>
 
@@ -10,6 +10,8 @@
 
 namespace op
 {
+    class ImagePyramidCache;
+
     /**
      * Datum: The OpenPose Basic Piece of Information Between Threads
      * Datum is one the main OpenPose classes/structs. The workers and threads share by default a
@@ -243,12 +245,26 @@ namespace op
          */
         double scaleNetToOutput;
 
+        /**
+         * Scale ratio between the input Datum::cvInputData and the original image it was decoded from, e.g., 2, 4 or 8
+         * for images decoded at a reduced resolution (`--image_dir_reduced_decoding`), 1 otherwise. With
+         * ScaleMode::InputResolution, the keypoints are rescaled by it, so they are relative to the original image.
+         */
+        double scaleInputToOriginal;
+
         /**
          * Pair with the element key id POSE_BODY_PART_MAPPING on `pose/poseParameters.hpp` and its mapped value (e.g.
          * 1 and "Neck").
          */
         std::pair<int, std::string> elementRendered;
 
+        /**
+         * Gaussian pyramids of cvInputData, shared by all its Lucas-Kanade consumers (person tracking and
+         * identification), so they are built once per frame. It is created (empty) by the pose extractor worker, and
+         * each pyramid is lazily built the first time one of them requests it.
+         */
+        std::shared_ptr<ImagePyramidCache> imagePyramidCache;
+
         // 3D/Adam parameters (experimental code not meant to be publicly used)
         #ifdef USE_3D_ADAM_MODEL
             // Adam/Unity params
@@ -13,14 +13,21 @@ namespace op
 
         virtual ~KeypointScaler();
 
+        /**
+         * @param scaleInputToOriginal Scale ratio between the input image and the original one it was decoded from
+         * (Datum::scaleInputToOriginal). Only used with ScaleMode::InputResolution, so the keypoints are relative to
+         * the original image.
+         */
         void scale(Array<float>& arrayToScale, const double scaleInputToOutput, const double scaleNetToOutput,
-                   const Point<int>& producerSize) const;
+                   const Point<int>& producerSize, const double scaleInputToOriginal = 1.) const;
 
         void scale(std::vector<Array<float>>& arraysToScale, const double scaleInputToOutput,
-                   const double scaleNetToOutput, const Point<int>& producerSize) const;
+                   const double scaleNetToOutput, const Point<int>& producerSize,
+                   const double scaleInputToOriginal = 1.) const;
 
         void scale(std::vector<std::vector<std::array<float,3>>>& poseCandidates, const double scaleInputToOutput,
-                   const double scaleNetToOutput, const Point<int>& producerSize) const;
+                   const double scaleNetToOutput, const Point<int>& producerSize,
+                   const double scaleInputToOriginal = 1.) const;
 
     private:
         const ScaleMode mScaleMode;
@@ -59,6 +59,8 @@ namespace op
             {
                 // Debugging log
                 opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                // Tracing
+                OP_TRACE_SCOPE_FRAME("WCvMatToOpInput", (*tDatums)[0]->id);
                 // Profiling speed
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
                 // cv::Mat -> float*
@@ -62,6 +62,8 @@ namespace op
                 opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
                 // T* to T
                 auto& tDatumsNoPtr = *tDatums;
+                // Tracing
+                OP_TRACE_SCOPE_FRAME("WCvMatToOpOutput", (*tDatums)[0]->id);
                 // Profiling speed
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
                 // cv::Mat -> float*
@@ -57,6 +57,8 @@ namespace op
             {
                 // Debugging log
                 opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                // Tracing
+                OP_TRACE_SCOPE_FRAME("WKeypointScaler", (*tDatums)[0]->id);
                 // Profiling speed
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
                 // Rescale pose data
@@ -67,11 +69,13 @@ namespace op
                         tDatumPtr->handKeypoints[1], tDatumPtr->faceKeypoints};
                     spKeypointScaler->scale(
                         arraysToScale, tDatumPtr->scaleInputToOutput, tDatumPtr->scaleNetToOutput,
-                        Point<int>{tDatumPtr->cvInputData.cols(), tDatumPtr->cvInputData.rows()});
+                        Point<int>{tDatumPtr->cvInputData.cols(), tDatumPtr->cvInputData.rows()},
+                        tDatumPtr->scaleInputToOriginal);
                     // Rescale part candidates
                     spKeypointScaler->scale(
                         tDatumPtr->poseCandidates, tDatumPtr->scaleInputToOutput, tDatumPtr->scaleNetToOutput,
-                        Point<int>{tDatumPtr->cvInputData.cols(), tDatumPtr->cvInputData.rows()});
+                        Point<int>{tDatumPtr->cvInputData.cols(), tDatumPtr->cvInputData.rows()},
+                        tDatumPtr->scaleInputToOriginal);
                 }
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
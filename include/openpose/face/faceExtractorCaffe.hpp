@@ -34,6 +34,8 @@ namespace op
 
         /**
          * This function extracts the face keypoints for each detected face in the image.
+         * All the face crops are warped (in parallel) into a single network input, and processed together (in
+         * batches of up to FACE_MAX_BATCH_SIZE faces).
          * @param faceRectangles location of the faces in the image. It is a length-variable std::vector, where
          * each index corresponds to a different person in the image. Internally, a op::Rectangle<float>
          * (similar to cv::Rect for floating values) with the position of that face (or 0,0,0,0 if
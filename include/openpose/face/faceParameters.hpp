@@ -22,6 +22,8 @@ namespace op
 
     // Constant parameters
     const auto FACE_CCN_DECREASE_FACTOR = 8.f;
+    // Maximum number of face crops run through the network at once (it bounds the network and heat map memory)
+    const auto FACE_MAX_BATCH_SIZE = 8;
     const std::string FACE_PROTOTXT{"face/pose_deploy.prototxt"};
     const std::string FACE_TRAINED_MODEL{"face/pose_iter_116000.caffemodel"};
 
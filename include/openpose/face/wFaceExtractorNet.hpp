@@ -4,14 +4,20 @@
 #include <openpose/core/common.hpp>
 #include <openpose/face/faceRenderer.hpp>
 #include <openpose/thread/worker.hpp>
+#include <openpose/tracking/keyframeTracker.hpp>
 
 namespace op
 {
+    /**
+     * It runs FaceExtractorNet on each frame. If a KeyframeTracker is given, the network only runs on keyframes,
+     * and the face keypoints of the other frames are propagated from the previous frame (without heat maps).
+     */
     template<typename TDatums>
     class WFaceExtractorNet : public Worker<TDatums>
     {
     public:
-        explicit WFaceExtractorNet(const std::shared_ptr<FaceExtractorNet>& faceExtractorNet);
+        explicit WFaceExtractorNet(const std::shared_ptr<FaceExtractorNet>& faceExtractorNet,
+                                   const std::shared_ptr<KeyframeTracker>& keyframeTracker = nullptr);
 
         virtual ~WFaceExtractorNet();
 
@@ -21,6 +27,7 @@ namespace op
 
     private:
         std::shared_ptr<FaceExtractorNet> spFaceExtractorNet;
+        std::shared_ptr<KeyframeTracker> spKeyframeTracker;
 
         DELETE_COPY(WFaceExtractorNet);
     };
@@ -35,8 +42,10 @@ namespace op
 namespace op
 {
     template<typename TDatums>
-    WFaceExtractorNet<TDatums>::WFaceExtractorNet(const std::shared_ptr<FaceExtractorNet>& faceExtractorNet) :
-        spFaceExtractorNet{faceExtractorNet}
+    WFaceExtractorNet<TDatums>::WFaceExtractorNet(const std::shared_ptr<FaceExtractorNet>& faceExtractorNet,
+                                                  const std::shared_ptr<KeyframeTracker>& keyframeTracker) :
+        spFaceExtractorNet{faceExtractorNet},
+        spKeyframeTracker{keyframeTracker}
     {
     }
 
@@ -60,14 +69,35 @@ namespace op
             {
                 // Debugging log
                 opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                // Tracing
+                OP_TRACE_SCOPE_FRAME("WFaceExtractorNet", (*tDatums)[0]->id);
                 // Profiling speed
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
                 // Extract people face
-                for (auto& tDatumPtr : *tDatums)
+                for (auto i = 0u ; i < tDatums->size() ; i++)
                 {
+                    auto& tDatumPtr = (*tDatums)[i];
+                    // Keyframe mode: propagate the previous keypoints if possible
+                    if (spKeyframeTracker != nullptr)
+                    {
+                        if (tDatumPtr->imagePyramidCache == nullptr)
+                            tDatumPtr->imagePyramidCache = std::make_shared<ImagePyramidCache>(tDatumPtr->cvInputData);
+                        std::vector<Array<float>> faceKeypoints;
+                        if (spKeyframeTracker->track(
+                            faceKeypoints, {tDatumPtr->faceRectangles}, i, tDatumPtr->imagePyramidCache))
+                        {
+                            tDatumPtr->faceHeatMaps.reset();
+                            tDatumPtr->faceKeypoints = faceKeypoints[0];
+                            continue;
+                        }
+                    }
+                    // Face network
                     spFaceExtractorNet->forwardPass(tDatumPtr->faceRectangles, tDatumPtr->cvInputData);
                     tDatumPtr->faceHeatMaps = spFaceExtractorNet->getHeatMaps().clone();
                     tDatumPtr->faceKeypoints = spFaceExtractorNet->getFaceKeypoints().clone();
+                    if (spKeyframeTracker != nullptr)
+                        spKeyframeTracker->setKeyframe(
+                            {tDatumPtr->faceKeypoints}, {tDatumPtr->faceRectangles}, i, tDatumPtr->imagePyramidCache);
                 }
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
@@ -22,9 +22,18 @@ DEFINE_int32(logging_level,             3,              "The logging level. Inte
 DEFINE_bool(disable_multi_thread,       false,          "It would slightly reduce the frame rate in order to highly reduce the lag. Mainly useful"
                                                         " for 1) Cases where it is needed a low latency (e.g., webcam in real-time scenarios with"
                                                         " low-range GPU devices); and 2) Debugging OpenPose when it is crashing to locate the"
-                                                        " error.");
+                                                        " error. It also disables the thread pool that parallelizes the CPU post-processing.");
 DEFINE_int32(profile_speed,             1000,           "If PROFILER_ENABLED was set in CMake or Makefile.config files, OpenPose will show some"
                                                         " runtime statistics at this frame number.");
+DEFINE_string(trace_output,             "",             "If not empty, OpenPose records when each worker (e.g., pose extraction, rendering, etc.)"
+                                                        " starts and finishes each frame, and it saves this timeline at the end as a Chrome"
+                                                        " trace-event JSON file in this path (open it with chrome://tracing or"
+                                                        " https://ui.perfetto.dev). Unlike `PROFILER_ENABLED`, it does not require recompiling"
+                                                        " and its overhead is negligible.");
+DEFINE_bool(memory_pool,                false,          "If enabled, the Array<T> memory (e.g., heat maps, keypoints, and network input and output"
+                                                        " arrays) will be allocated from a memory pool and reused across frames, rather than"
+                                                        " being allocated and released on each frame. It reduces heap churn and allocation"
+                                                        " stalls in exchange for keeping the freed memory cached.");
 #ifndef OPENPOSE_FLAGS_DISABLE_POSE
 #ifndef OPENPOSE_FLAGS_DISABLE_PRODUCER
 // Producer
@@ -37,11 +46,28 @@ DEFINE_string(video,                    "",             "Use a video file instea
                                                         " example video.");
 DEFINE_string(image_dir,                "",             "Process a directory of images. Use `examples/media/` for our default example folder with 20"
                                                         " images. Read all standard formats (jpg, png, bmp, etc.).");
+DEFINE_int32(image_dir_decoder_threads, 0,              "Only for `--image_dir`. Number of threads reading and decoding the images ahead of time (in"
+                                                        " parallel), while keeping their order. Useful when image decoding is the bottleneck"
+                                                        " (e.g., large JPEGs and/or fast GPUs). 0 (default) decodes each image when needed.");
+DEFINE_int32(image_dir_prefetch_depth,  16,             "Only if `--image_dir_decoder_threads` > 0. Maximum number of images decoded ahead of time."
+                                                        " The greater, the more RAM memory but the better it absorbs the decoding time variance.");
+DEFINE_bool(image_dir_reduced_decoding, false,          "Only for `--image_dir`. If enabled, JPEG images at least 2, 4, or 8 times bigger than"
+                                                        " `--net_resolution` are decoded at 1/2, 1/4, or 1/8 of their resolution (much faster"
+                                                        " decoding). The output keypoints are rescaled to the original image resolution (with"
+                                                        " `--keypoint_scale 0`), while the rendered images keep the reduced resolution. Face"
+                                                        " and hand detection might be less accurate.");
 DEFINE_bool(flir_camera,                false,          "Whether to use FLIR (Point-Grey) stereo camera.");
 DEFINE_int32(flir_camera_index,         -1,             "Select -1 (default) to run on all detected flir cameras at once. Otherwise, select the flir"
                                                         " camera index to run, where 0 corresponds to the detected flir camera with the lowest"
                                                         " serial number, and `n` to the `n`-th lowest serial number camera.");
 DEFINE_string(ip_camera,                "",             "String with the IP camera URL. It supports protocols like RTSP and HTTP.");
+DEFINE_int32(capture_buffer_size,       0,              "Only for `--video` and `--ip_camera`. Number of frames decoded ahead of time on a background"
+                                                        " thread (into a ring of preallocated frames), so decoding overlaps with the network. 0"
+                                                        " (default) decodes each frame when needed.");
+DEFINE_int32(capture_backpressure,      -1,             "Only if `--capture_buffer_size` > 0. What to do when the capture buffer is full. -1 (default)"
+                                                        " for 0 with `--video` and 1 with `--ip_camera`. 0 to wait (no frame is lost), 1 to"
+                                                        " overwrite the oldest decoded frame (low latency for live streams), and 2 to discard the"
+                                                        " new frame.");
 DEFINE_uint64(frame_first,              0,              "Start on desired frame number. Indexes are 0-based, i.e., the first frame has index 0.");
 DEFINE_uint64(frame_step,               1,              "Step or gap between processed frames. E.g., `--frame_step 5` would read and process frames"
                                                         " 0, 5, 10, etc..");
@@ -69,6 +95,10 @@ DEFINE_string(output_resolution,        "-1x-1",        "The image resolution (d
 DEFINE_int32(num_gpu,                   -1,             "The number of GPU devices to use. If negative, it will use all the available GPUs in your"
                                                         " machine.");
 DEFINE_int32(num_gpu_start,             0,              "GPU device start number.");
+DEFINE_int32(num_cpu_workers,           1,              "CPU-only version. Number of independent body (and face and hand) extractors, each one on"
+                                                        " its own thread and sharing a single copy of the network weights (analogous to `num_gpu`"
+                                                        " for the GPU version). Frames are distributed among them and sorted again afterwards"
+                                                        " (unless `--unordered_output`). Ignored with `--disable_multi_thread`.");
 DEFINE_int32(keypoint_scale,            0,              "Scaling of the (x,y) coordinates of the final pose data array, i.e., the scale of the (x,y)"
                                                         " coordinates that will be saved with the `write_json` & `write_keypoint` flags."
                                                         " Select `0` to scale it to the original source resolution; `1`to scale it to the net output"
@@ -88,6 +118,30 @@ DEFINE_bool(maximize_positives,         false,          "It reduces the threshol
 DEFINE_double(fps_max,                  -1.,            "Maximum processing frame rate. By default (-1), OpenPose will process frames as fast as"
                                                         " possible. Example usage: If OpenPose is displaying images too quickly, this can reduce"
                                                         " the speed so the user can analyze better each frame from the GUI.");
+DEFINE_int32(backpressure,              0,              "What to do when frames arrive faster than OpenPose processes them. 0 (default) to wait"
+                                                        " (no frame is lost, recommended for videos and images), 1 to discard the oldest queued"
+                                                        " frame and 2 to discard the new frame (both bound the latency of live feeds, e.g.,"
+                                                        " webcams), and 3 to adapt the queue sizes to keep the time that frames wait in queues"
+                                                        " under `latency_target`.");
+DEFINE_double(latency_target,           0.1,            "Target (in seconds) for the total time that each frame waits in the OpenPose queues with"
+                                                        " `--backpressure 3`.");
+DEFINE_bool(unordered_output,           false,          "If enabled, the frames processed in parallel (e.g., with several GPUs) reach the outputs as"
+                                                        " soon as they are processed rather than sorted by frame number, reducing the latency. Each"
+                                                        " frame keeps its frame number (e.g., in the JSON file names), so it is useful for outputs"
+                                                        " that do not need them in order (e.g., `--write_json` or `--udp_host`). Warning: the"
+                                                        " display, `--write_video` and `--write_images` also receive the frames out of order (e.g.,"
+                                                        " the video might jump back and forth). Multi-view systems (e.g., 3-D reconstruction) still"
+                                                        " sort the views.");
+DEFINE_string(thread_cores,             "",             "Linux only. Cores where each OpenPose thread runs, separated by `;` and indexed by thread"
+                                                        " ID (e.g., `0;1-3;4,5` pins thread 0 to core 0, thread 1 to cores 1 to 3, and thread 2 to"
+                                                        " cores 4 and 5). An empty entry or a missing one leaves that thread unpinned. The threads"
+                                                        " are named `op<ID>:<worker>` (e.g., `op1:PoseExtract`), as shown by `top -H` or `perf`,"
+                                                        " and thread 0 is the producer. The last thread ID runs on the main thread (it is not"
+                                                        " created by OpenPose), so it is never pinned. By default (empty), no thread is pinned.");
+DEFINE_string(thread_numa_nodes,        "",             "Linux only. NUMA node of each OpenPose thread, separated by `;` and indexed by thread ID"
+                                                        " as `--thread_cores`. The memory that the thread allocates (e.g., its network buffers) is"
+                                                        " bound to that node, and if `--thread_cores` does not pin it, it runs on the cores of that"
+                                                        " node. By default (empty), no binding.");
 // OpenPose Body Pose
 DEFINE_int32(body,                      1,              "Select 0 to disable body keypoint detection (e.g., for faster but less accurate face"
                                                         " keypoint detection, custom hand detector, etc.), 1 (default) for body keypoint"
@@ -135,6 +189,17 @@ DEFINE_bool(part_candidates,            false,          "Also enable `write_json
                                                         " use this information.");
 DEFINE_double(upsampling_ratio,         0.,             "Upsampling ratio between the `net_resolution` and the output net results. A value less"
                                                         " or equal than 0 (default) will use the network default value (recommended).");
+DEFINE_bool(low_res_post_processing,    false,          "CPU-only. If enabled, NMS and body part connection will work directly on the network output"
+                                                        " resolution, only upsampling the small areas that are actually read, rather than resizing"
+                                                        " the whole heat maps to `net_resolution`. Faster, but keypoints might slightly differ."
+                                                        " Ignored if `scale_number` > 1 or any `heatmaps_add_X` is enabled.");
+DEFINE_int32(pose_batch_size,           1,              "Maximum number of frames run through the body network at once (micro-batching). It"
+                                                        " increases the throughput of each GPU (or CPU) thread at the cost of latency, as frames"
+                                                        " wait for the rest of their batch (see `pose_batch_window`). Only for single-view and"
+                                                        " `scale_number` 1, and disabled with GPU rendering (e.g., use `--render_pose 1` or"
+                                                        " `--display 0 --render_pose 0`). 1 for no batching.");
+DEFINE_double(pose_batch_window,        0.005,          "Maximum time (in seconds) that the first frame of a batch waits for the rest of it with"
+                                                        " `--pose_batch_size` > 1, then the partial batch is processed.");
 // OpenPose Face
 DEFINE_bool(face,                       false,          "Enables face keypoint detection. It will share some parameters from the body pose, e.g."
                                                         " `model_folder`. Note that this will considerable slow down the performance and increase"
@@ -150,6 +215,13 @@ DEFINE_int32(face_detector,             0,              "Kind of face rectangle
 DEFINE_string(face_net_resolution,      "368x368",      "Multiples of 16 and squared. Analogous to `net_resolution` but applied to the face keypoint"
                                                         " detector. 320x320 usually works fine while giving a substantial speed up when multiple"
                                                         " faces on the image.");
+DEFINE_int32(face_keyframe_interval,    1,              "Maximum number of frames between face network keyframes. 1 runs the face network on every"
+                                                        " frame. With N > 1, the face keypoints of the frames in between are tracked from the"
+                                                        " previous frame with pyramidal Lucas-Kanade (considerably faster for video and webcam), and"
+                                                        " a keyframe is forced earlier if the faces move (see `keyframe_max_roi_motion`) or tracking"
+                                                        " loses keypoints (see `keyframe_max_keypoint_loss`). Ignored if face heat maps are saved or"
+                                                        " if more than 1 GPU/CPU worker is used (each worker would only see non-consecutive frames)."
+                                                        " Not recommended for unrelated consecutive images (e.g., `image_dir`).");
 // OpenPose Hand
 DEFINE_bool(hand,                       false,          "Enables hand keypoint detection. It will share some parameters from the body pose, e.g."
                                                         " `model_folder`. Analogously to `--face`, it will also slow down the performance, increase"
@@ -162,6 +234,15 @@ DEFINE_int32(hand_scale_number,         1,              "Analogous to `scale_num
 DEFINE_double(hand_scale_range,         0.4,            "Analogous purpose than `scale_gap` but applied to the hand keypoint detector. Total range"
                                                         " between smallest and biggest scale. The scales will be centered in ratio 1. E.g., if"
                                                         " scaleRange = 0.4 and scalesNumber = 2, then there will be 2 scales, 0.8 and 1.2.");
+DEFINE_int32(hand_batch_size,           8,              "Maximum number of hand crops (both hands of all people, at all `hand_scale_number` scales)"
+                                                        " run through the hand network at once. The greater, the fewer network calls but the"
+                                                        " more GPU (or RAM for CPU version) memory. 1 runs each crop individually.");
+DEFINE_int32(hand_keyframe_interval,    1,              "Analogous to `face_keyframe_interval` but applied to the hand keypoint detector.");
+DEFINE_double(keyframe_max_roi_motion,  0.2,            "Only if `face_keyframe_interval` or `hand_keyframe_interval` > 1. Maximum motion of any face or"
+                                                        " hand rectangle since its keyframe (center displacement or width change, relative to its"
+                                                        " keyframe width) before a new keyframe is forced.");
+DEFINE_double(keyframe_max_keypoint_loss, 0.2,          "Only if `face_keyframe_interval` or `hand_keyframe_interval` > 1. Maximum ratio of the"
+                                                        " keyframe keypoints that tracking can lose before a new keyframe is forced.");
 // OpenPose 3-D Reconstruction
 DEFINE_bool(3d,                         false,          "Running OpenPose 3-D reconstruction demo: 1) Reading from a stereo camera system."
                                                         " 2) Performing 3-D reconstruction from the multiple views. 3) Displaying 3-D reconstruction"
@@ -275,6 +356,11 @@ DEFINE_string(write_bvh,                "",             "Experimental, not avail
 // UDP Communication
 DEFINE_string(udp_host,                 "",             "Experimental, not available yet. IP for UDP communication. E.g., `192.168.0.1`.");
 DEFINE_string(udp_port,                 "8051",         "Experimental, not available yet. Port number for UDP communication.");
+// Pipeline Metrics
+DEFINE_string(write_metrics,            "",             "File path to periodically write the pipeline metrics (size and counters of each queue and"
+                                                        " service time histogram of each worker) in the Prometheus text format (e.g., into the"
+                                                        " textfile collector folder of the Prometheus node_exporter). Leave empty to disable it.");
+DEFINE_double(write_metrics_seconds,    5.,             "Period (in seconds) between `write_metrics` updates.");
 #endif // OPENPOSE_FLAGS_DISABLE_POSE
 
 #endif // OPENPOSE_FLAGS_HPP
@@ -22,13 +22,15 @@ namespace op
          * @param numberScales Number of scales to run. The more scales, the slower it will be but possibly also more
          * accurate.
          * @param rangeScales The range between the smaller and bigger scale.
+         * @param maxBatchSize Maximum number of hand crops (of any person, hand side and scale) run through the network
+         * at once. The greater, the fewer network calls but the more memory it will be needed.
          */
         HandExtractorCaffe(const Point<int>& netInputSize, const Point<int>& netOutputSize,
                            const std::string& modelFolder, const int gpuId,
                            const int numberScales = 1, const float rangeScales = 0.4f,
                            const std::vector<HeatMapType>& heatMapTypes = {},
                            const ScaleMode heatMapScaleMode = ScaleMode::ZeroToOneFixedAspect,
-                           const bool enableGoogleLogging = true);
+                           const bool enableGoogleLogging = true, const int maxBatchSize = 8);
 
         /**
          * Virtual destructor of the HandExtractor class.
@@ -50,6 +52,8 @@ namespace op
          * op::Rectangle<float> (similar to cv::Rect for floating values) with the position of that hand (or 0,0,0,0 if
          * some hand is missing, e.g., if a specific person has only half of the body inside the image).
          * @param inputData Original image in Mat format and BGR format.
+         * All the hand crops (both hands of all people, at all scales) are warped (in parallel) and processed together,
+         * in batches of up to maxBatchSize crops.
          */
         void forwardPass(const std::vector<std::array<Rectangle<float>, 2>> handRectangles, const Matrix& inputData);
 
@@ -4,14 +4,20 @@
 #include <openpose/core/common.hpp>
 #include <openpose/hand/handRenderer.hpp>
 #include <openpose/thread/worker.hpp>
+#include <openpose/tracking/keyframeTracker.hpp>
 
 namespace op
 {
+    /**
+     * It runs HandExtractorNet on each frame. If a KeyframeTracker is given, the network only runs on keyframes,
+     * and the hand keypoints of the other frames are propagated from the previous frame (without heat maps).
+     */
     template<typename TDatums>
     class WHandExtractorNet : public Worker<TDatums>
     {
     public:
-        explicit WHandExtractorNet(const std::shared_ptr<HandExtractorNet>& handExtractorNet);
+        explicit WHandExtractorNet(const std::shared_ptr<HandExtractorNet>& handExtractorNet,
+                                   const std::shared_ptr<KeyframeTracker>& keyframeTracker = nullptr);
 
         virtual ~WHandExtractorNet();
 
@@ -21,6 +27,7 @@ namespace op
 
     private:
         std::shared_ptr<HandExtractorNet> spHandExtractorNet;
+        std::shared_ptr<KeyframeTracker> spKeyframeTracker;
 
         DELETE_COPY(WHandExtractorNet);
     };
@@ -35,8 +42,10 @@ namespace op
 namespace op
 {
     template<typename TDatums>
-    WHandExtractorNet<TDatums>::WHandExtractorNet(const std::shared_ptr<HandExtractorNet>& handExtractorNet) :
-        spHandExtractorNet{handExtractorNet}
+    WHandExtractorNet<TDatums>::WHandExtractorNet(const std::shared_ptr<HandExtractorNet>& handExtractorNet,
+                                                  const std::shared_ptr<KeyframeTracker>& keyframeTracker) :
+        spHandExtractorNet{handExtractorNet},
+        spKeyframeTracker{keyframeTracker}
     {
     }
 
@@ -60,17 +69,46 @@ namespace op
             {
                 // Debugging log
                 opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                // Tracing
+                OP_TRACE_SCOPE_FRAME("WHandExtractorNet", (*tDatums)[0]->id);
                 // Profiling speed
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
                 // Extract people hands
-                for (auto& tDatumPtr : *tDatums)
+                for (auto i = 0u ; i < tDatums->size() ; i++)
                 {
+                    auto& tDatumPtr = (*tDatums)[i];
+                    // Keyframe mode: propagate the previous keypoints if possible
+                    std::vector<std::vector<Rectangle<float>>> handRectangles;
+                    if (spKeyframeTracker != nullptr)
+                    {
+                        if (tDatumPtr->imagePyramidCache == nullptr)
+                            tDatumPtr->imagePyramidCache = std::make_shared<ImagePyramidCache>(tDatumPtr->cvInputData);
+                        handRectangles.resize(2);
+                        for (const auto& personHandRectangles : tDatumPtr->handRectangles)
+                            for (auto hand = 0 ; hand < 2 ; hand++)
+                                handRectangles[hand].emplace_back(personHandRectangles[hand]);
+                        std::vector<Array<float>> handKeypoints;
+                        if (spKeyframeTracker->track(handKeypoints, handRectangles, i, tDatumPtr->imagePyramidCache))
+                        {
+                            for (auto hand = 0 ; hand < 2 ; hand++)
+                            {
+                                tDatumPtr->handHeatMaps[hand].reset();
+                                tDatumPtr->handKeypoints[hand] = handKeypoints[hand];
+                            }
+                            continue;
+                        }
+                    }
+                    // Hand network
                     spHandExtractorNet->forwardPass(tDatumPtr->handRectangles, tDatumPtr->cvInputData);
                     for (auto hand = 0 ; hand < 2 ; hand++)
                     {
                         tDatumPtr->handHeatMaps[hand] = spHandExtractorNet->getHeatMaps()[hand].clone();
                         tDatumPtr->handKeypoints[hand] = spHandExtractorNet->getHandKeypoints()[hand].clone();
                     }
+                    if (spKeyframeTracker != nullptr)
+                        spKeyframeTracker->setKeyframe(
+                            {tDatumPtr->handKeypoints[0], tDatumPtr->handKeypoints[1]}, handRectangles, i,
+                            tDatumPtr->imagePyramidCache);
                 }
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
@@ -6,12 +6,17 @@
 
 namespace op
 {
+    /**
+     * @param heatMapSourceSize If not empty, heatMapPtr is not at heatMapSize resolution but at this (lower) one
+     * (e.g., the raw network output), and the PAFs are bicubically upsampled to heatMapSize on demand.
+     */
     template <typename T>
     void connectBodyPartsCpu(
         Array<T>& poseKeypoints, Array<T>& poseScores, const T* const heatMapPtr, const T* const peaksPtr,
         const PoseModel poseModel, const Point<int>& heatMapSize, const int maxPeaks, const T interMinAboveThreshold,
         const T interThreshold, const int minSubsetCnt, const T minSubsetScore, const T defaultNmsThreshold,
-        const T scaleFactor = 1.f, const bool maximizePositives = false);
+        const T scaleFactor = 1.f, const bool maximizePositives = false,
+        const Point<int>& heatMapSourceSize = Point<int>{});
 
     // Windows: Cuda functions do not include OP_API
     template <typename T>
@@ -33,27 +38,66 @@ namespace op
         const unsigned int* const bodyPartPairsGpuPtr = nullptr, const unsigned int* const mapIdxGpuPtr = nullptr,
         const T* const peaksGpuPtr = nullptr, const int gpuID = 0);
 
+    /**
+     * Flat table of person candidates used by the body part connector. Its storage is kept across reset() calls, so
+     * no memory is allocated once it has grown to the usual number of people.
+     * For the person p, indexes[p*numberBodyParts + part] is the position of the score of its body part `part` in
+     * peaksPtr (or 0 if not found), counters[p] its number of body parts found, and scores[p] its total score.
+     */
+    template <typename T>
+    struct PeopleTable
+    {
+        unsigned int numberBodyParts;
+        std::vector<int> indexes;
+        std::vector<int> counters;
+        std::vector<T> scores;
+
+        explicit PeopleTable(const unsigned int numberBodyParts = 0);
+
+        /**
+         * It removes all people (but keeps the allocated memory) and sets the number of body parts.
+         */
+        void reset(const unsigned int numberBodyParts);
+
+        /**
+         * It adds a person with no body parts, and returns its index.
+         */
+        int emplaceBack(const int counter, const T score);
+
+        /**
+         * It removes the people for which removed[person] != 0, keeping the order of the remaining ones.
+         */
+        void erase(const std::vector<char>& removed);
+
+        unsigned int size() const;
+
+        bool empty() const;
+
+        int* operator[](const unsigned int person);
+
+        const int* operator[](const unsigned int person) const;
+    };
+
     // Private functions used by the 2 above functions
     template <typename T>
-    std::vector<std::pair<std::vector<int>, T>> createPeopleVector(
-        const T* const heatMapPtr, const T* const peaksPtr, const PoseModel poseModel, const Point<int>& heatMapSize,
-        const int maxPeaks, const T interThreshold, const T interMinAboveThreshold,
+    void createPeopleVector(
+        PeopleTable<T>& peopleVector, const T* const heatMapPtr, const T* const peaksPtr, const PoseModel poseModel,
+        const Point<int>& heatMapSize, const int maxPeaks, const T interThreshold, const T interMinAboveThreshold,
         const std::vector<unsigned int>& bodyPartPairs, const unsigned int numberBodyParts,
         const unsigned int numberBodyPartPairs, const T defaultNmsThreshold,
-        const Array<T>& precomputedPAFs = Array<T>());
+        const Array<T>& precomputedPAFs = Array<T>(), const Point<int>& heatMapSourceSize = Point<int>{});
 
     template <typename T>
     void removePeopleBelowThresholdsAndFillFaces(
-        std::vector<int>& validSubsetIndexes, int& numberPeople,
-        std::vector<std::pair<std::vector<int>, T>>& subsets, const unsigned int numberBodyParts,
-        const int minSubsetCnt, const T minSubsetScore, const bool maximizePositives, const T* const peaksPtr);
+        std::vector<int>& validSubsetIndexes, int& numberPeople, PeopleTable<T>& subsets,
+        const unsigned int numberBodyParts, const int minSubsetCnt, const T minSubsetScore,
+        const bool maximizePositives, const T* const peaksPtr);
 
     template <typename T>
     void peopleVectorToPeopleArray(
-        Array<T>& poseKeypoints, Array<T>& poseScores, const T scaleFactor,
-        const std::vector<std::pair<std::vector<int>, T>>& subsets, const std::vector<int>& validSubsetIndexes,
-        const T* const peaksPtr, const int numberPeople, const unsigned int numberBodyParts,
-        const unsigned int numberBodyPartPairs);
+        Array<T>& poseKeypoints, Array<T>& poseScores, const T scaleFactor, const PeopleTable<T>& subsets,
+        const std::vector<int>& validSubsetIndexes, const T* const peaksPtr, const int numberPeople,
+        const unsigned int numberBodyParts, const unsigned int numberBodyPartPairs);
 
     template <typename T>
     std::vector<std::tuple<T, T, int, int, int>> pafPtrIntoVector(
@@ -61,9 +105,10 @@ namespace op
         const std::vector<unsigned int>& bodyPartPairs, const unsigned int numberBodyPartPairs);
 
     template <typename T>
-    std::vector<std::pair<std::vector<int>, T>> pafVectorIntoPeopleVector(
-        const std::vector<std::tuple<T, T, int, int, int>>& pairScores, const T* const peaksPtr, const int maxPeaks,
-        const std::vector<unsigned int>& bodyPartPairs, const unsigned int numberBodyParts);
+    void pafVectorIntoPeopleVector(
+        PeopleTable<T>& peopleVector, const std::vector<std::tuple<T, T, int, int, int>>& pairScores,
+        const T* const peaksPtr, const int maxPeaks, const std::vector<unsigned int>& bodyPartPairs,
+        const unsigned int numberBodyParts);
 }
 
 #endif // OPENPOSE_POSE_BODY_PARTS_CONNECTOR_HPP
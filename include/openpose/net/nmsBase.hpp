@@ -10,6 +10,16 @@ namespace op
       T* targetPtr, int* kernelPtr, const T* const sourcePtr, const T threshold, const std::array<int, 4>& targetSize,
       const std::array<int, 4>& sourceSize, const Point<T>& offset);
 
+    /**
+     * Analogous to nmsCpu, but sourcePtr is the network output (i.e., before resizeAndMergeCpu). Peaks are found on
+     * it, and only a small window around each of them is upsampled to upsampledSize in order to refine its position.
+     * Output peaks are in upsampledSize coordinates, as if nmsCpu had been applied on the resized heat maps.
+     */
+    template <typename T>
+    void nmsLowResolutionCpu(
+      T* targetPtr, const T* const sourcePtr, const T threshold, const std::array<int, 4>& targetSize,
+      const std::array<int, 4>& sourceSize, const Point<int>& upsampledSize, const Point<T>& offset);
+
     // Windows: Cuda functions do not include OP_API
     template <typename T>
     void nmsGpu(
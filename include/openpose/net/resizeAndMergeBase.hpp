@@ -5,11 +5,26 @@
 
 namespace op
 {
+    /**
+     * Bicubic resize of each source scale to targetSize and average of all of them (multi-scale merging).
+     * It uses the same cubic kernel (A = -0.75) and border replication than cv::resize(..., INTER_CUBIC), but
+     * separable and accumulating all scales in a single pass, so results might differ from OpenCV by float rounding
+     * (~1e-6 for heat maps in the [0, 1] range).
+     */
     template <typename T>
     void resizeAndMergeCpu(
         T* targetPtr, const std::vector<const T*>& sourcePtrs, const std::array<int, 4>& targetSize,
         const std::vector<std::array<int, 4>>& sourceSizes, const std::vector<T>& scaleInputToNetInputs = {1.f});
 
+    /**
+     * Value that resizeAndMergeCpu would output at the target pixel (x, y) for a single scale, without resizing the
+     * whole source. Used to sample low-resolution network outputs on demand.
+     */
+    template <typename T>
+    T resizeCubicPixelCpu(
+        const T* const sourcePtr, const Point<int>& sourceSize, const Point<int>& targetSize, const int x,
+        const int y);
+
     // Windows: Cuda functions do not include OP_API
     template <typename T>
     void resizeAndMergeGpu(
@@ -24,6 +39,20 @@ namespace op
         const std::vector<T>& scaleInputToNetInputs = {1.f}, const int gpuID = 0);
 
     // Functions for cvMatToOpInput/cvMatToOpOutput
+    /**
+     * CPU counterpart of resizeAndPadRbgGpu for 8-bit 3-channel (BGR) images, for all scales at once. For each scale,
+     * it resizes srcPtr by scaleFactors[i] (zero-padded to targetSizes[i]), de-interleaves it into the planar
+     * (3 x height x width) targetPtrs[i], and normalizes it (`normalize` as in uCharCvMatToFloatPtr), in a single
+     * pass. Same output than resizeFixedAspectRatio (cv::warpAffine) followed by uCharCvMatToFloatPtr with the
+     * fixed-point interpolation of OpenCV 3 and 4 (newer OpenCV versions interpolating in floating point might differ
+     * by a few 8-bit levels).
+     */
+    template <typename T>
+    void resizeAndPadRbgCpu(
+        const std::vector<T*>& targetPtrs, const unsigned char* const srcPtr, const int sourceWidth,
+        const int sourceHeight, const std::vector<Point<int>>& targetSizes, const std::vector<double>& scaleFactors,
+        const int normalize);
+
     template <typename T>
     void resizeAndPadRbgGpu(
         T* targetPtr, const T* const srcPtr, const int sourceWidth, const int sourceHeight,
@@ -30,6 +30,16 @@ namespace op
                          const Array<float>& poseNetOutput = Array<float>{},
                          const long long frameId = -1ll);
 
+        /**
+         * Analogous to forwardPass(), but for several frames at once (see PoseExtractorNet::forwardPassBatch()). With
+         * tracking, it runs one frame at a time (only some of them use the network).
+         */
+        void forwardPassBatch(const std::vector<std::vector<Array<float>>>& inputNetData,
+                              const std::vector<Point<int>>& inputDataSizes,
+                              const std::vector<std::vector<double>>& scaleInputToNetInputs,
+                              const std::vector<long long>& frameIds,
+                              const std::function<void(const int)>& frameProcessed);
+
         // PoseExtractorNet functions
         Array<float> getHeatMapsCopy() const;
 
@@ -45,23 +55,29 @@ namespace op
         void keepTopPeople(Array<float>& poseKeypoints, const Array<float>& poseScores) const;
 
         // PersonIdExtractor functions
+        // The optional imagePyramidCache (e.g., Datum::imagePyramidCache) lets the ID extractor and the tracker share
+        // the Gaussian pyramids of cvMatInput
         // Not thread-safe
         Array<long long> extractIds(const Array<float>& poseKeypoints, const Matrix& cvMatInput,
-                                    const unsigned long long imageIndex = 0ull);
+                                    const unsigned long long imageIndex = 0ull,
+                                    const std::shared_ptr<ImagePyramidCache>& imagePyramidCache = nullptr);
 
         // Same than extractIds but thread-safe
         Array<long long> extractIdsLockThread(const Array<float>& poseKeypoints, const Matrix& cvMatInput,
                                               const unsigned long long imageIndex,
-                                              const long long frameId);
+                                              const long long frameId,
+                                              const std::shared_ptr<ImagePyramidCache>& imagePyramidCache = nullptr);
 
         // PersonTracker functions
         void track(Array<float>& poseKeypoints, Array<long long>& poseIds,
-                   const Matrix& cvMatInput, const unsigned long long imageViewIndex = 0ull);
+                   const Matrix& cvMatInput, const unsigned long long imageViewIndex = 0ull,
+                   const std::shared_ptr<ImagePyramidCache>& imagePyramidCache = nullptr);
 
         void trackLockThread(Array<float>& poseKeypoints, Array<long long>& poseIds,
                              const Matrix& cvMatInput,
                              const unsigned long long imageViewIndex,
-                             const long long frameId);
+                             const long long frameId,
+                             const std::shared_ptr<ImagePyramidCache>& imagePyramidCache = nullptr);
 
     private:
         const int mNumberPeopleMax;
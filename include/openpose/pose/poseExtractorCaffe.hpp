@@ -23,7 +23,7 @@ namespace op
             const bool addPartCandidates = false, const bool maximizePositives = false,
             const std::string& protoTxtPath = "", const std::string& caffeModelPath = "",
             const float upsamplingRatio = 0.f, const bool enableNet = true,
-            const bool enableGoogleLogging = true);
+            const bool enableGoogleLogging = true, const bool lowResPostProcessing = false);
 
         virtual ~PoseExtractorCaffe();
 
@@ -41,6 +41,17 @@ namespace op
             const std::vector<double>& scaleInputToNetInputs = {1.f},
             const Array<float>& poseNetOutput = Array<float>{});
 
+        /**
+         * If all frames have a single scale of the same size, they are concatenated into a single N x 3 x H x W
+         * network input and run with one network forward pass. The post-processing (resize, NMS, and body part
+         * connection) of each frame then reads its slice of the network output in place. Otherwise (or with OpenCL),
+         * one frame at a time.
+         */
+        virtual void forwardPassBatch(
+            const std::vector<std::vector<Array<float>>>& inputNetData, const std::vector<Point<int>>& inputDataSizes,
+            const std::vector<std::vector<double>>& scaleInputToNetInputs,
+            const std::function<void(const int)>& frameProcessed);
+
         const float* getCandidatesCpuConstPtr() const;
 
         const float* getCandidatesGpuConstPtr() const;
@@ -63,6 +74,7 @@ namespace op
         const float mUpsamplingRatio;
         const bool mEnableNet;
         const bool mEnableGoogleLogging;
+        const bool mLowResPostProcessing;
         // General parameters
         std::vector<std::shared_ptr<Net>> spNets;
         std::shared_ptr<ResizeAndMergeCaffe<float>> spResizeAndMergeCaffe;
@@ -75,6 +87,14 @@ namespace op
         std::shared_ptr<ArrayCpuGpu<float>> spHeatMapsBlob;
         std::shared_ptr<ArrayCpuGpu<float>> spPeaksBlob;
         std::shared_ptr<ArrayCpuGpu<float>> spMaximumPeaksBlob;
+        // Batching
+        Array<float> mBatchInputData;
+        std::shared_ptr<ArrayCpuGpu<float>> spBatchFrameBlob;
+
+        // Resize + NMS + body part connection of the network output(s) in spCaffeNetOutputBlobs
+        void processNetOutput(
+            const std::vector<Array<float>>& inputNetData, const Point<int>& inputDataSize,
+            const std::vector<double>& scaleInputToNetInputs);
 
         DELETE_COPY(PoseExtractorCaffe);
     };
@@ -2,6 +2,7 @@
 #define OPENPOSE_POSE_POSE_EXTRACTOR_NET_HPP
 
 #include <atomic>
+#include <functional>
 #include <openpose/core/common.hpp>
 #include <openpose/core/enumClasses.hpp>
 #include <openpose/pose/poseParameters.hpp>
@@ -25,6 +26,17 @@ namespace op
             const std::vector<Array<float>>& inputNetData, const Point<int>& inputDataSize,
             const std::vector<double>& scaleRatios = {1.f}, const Array<float>& poseNetOutput = Array<float>{}) = 0;
 
+        /**
+         * Analogous to forwardPass(), but for several frames at once (e.g., to run them through the network as a
+         * single batch). After each frame i is processed, frameProcessed(i) is called, while the getters (e.g.,
+         * getPoseKeypoints() or getHeatMapsCopy()) return the results of that frame. By default, it calls
+         * forwardPass() on each frame.
+         */
+        virtual void forwardPassBatch(
+            const std::vector<std::vector<Array<float>>>& inputNetData, const std::vector<Point<int>>& inputDataSizes,
+            const std::vector<std::vector<double>>& scaleInputToNetInputs,
+            const std::function<void(const int)>& frameProcessed);
+
         virtual const float* getCandidatesCpuConstPtr() const = 0;
 
         virtual const float* getCandidatesGpuConstPtr() const = 0;
@@ -1,17 +1,27 @@
 #ifndef OPENPOSE_POSE_W_POSE_EXTRACTOR_HPP
 #define OPENPOSE_POSE_W_POSE_EXTRACTOR_HPP
 
+#include <chrono>
+#include <deque>
 #include <openpose/core/common.hpp>
 #include <openpose/pose/poseExtractor.hpp>
 #include <openpose/thread/worker.hpp>
 
 namespace op
 {
+    /**
+     * It runs PoseExtractor on each frame. With batchSize > 1, it micro-batches the frames: Up to batchSize frames
+     * (of a single view and without custom poseNetOutput) are gathered and run through the network at once (see
+     * PoseExtractor::forwardPassBatch()). A batch is processed once full, once batchWindow seconds passed since its
+     * first frame arrived, or when stopping. The processed frames are then returned one by one, in their input
+     * order. Frames that cannot be batched are processed individually (after the current batch).
+     */
     template<typename TDatums>
     class WPoseExtractor : public Worker<TDatums>
     {
     public:
-        explicit WPoseExtractor(const std::shared_ptr<PoseExtractor>& poseExtractorSharedPtr);
+        explicit WPoseExtractor(const std::shared_ptr<PoseExtractor>& poseExtractorSharedPtr,
+                                const int batchSize = 1, const double batchWindow = 0.005);
 
         virtual ~WPoseExtractor();
 
@@ -19,8 +29,28 @@ namespace op
 
         void work(TDatums& tDatums);
 
+        void tryStop();
+
+        bool hasPendingOutput() const;
+
+        std::chrono::steady_clock::time_point getDeadline() const;
+
     private:
         std::shared_ptr<PoseExtractor> spPoseExtractor;
+        const unsigned int mBatchSize;
+        const std::chrono::nanoseconds mBatchWindow;
+        bool mStopWhenEmpty;
+        std::chrono::steady_clock::time_point mBatchDeadline;
+        // Frames waiting for the rest of their batch
+        std::vector<TDatums> mBatchTDatums;
+        // Frames already processed, ready to be returned
+        std::deque<TDatums> mReadyTDatums;
+
+        void processTDatums(TDatums& tDatums);
+
+        void processBatch();
+
+        void fillDatum(TDatums& tDatums, const unsigned int viewIndex);
 
         DELETE_COPY(WPoseExtractor);
     };
@@ -31,12 +61,17 @@ namespace op
 
 
 // Implementation
+#include <algorithm> // std::max
 #include <openpose/utilities/pointerContainer.hpp>
 namespace op
 {
     template<typename TDatums>
-    WPoseExtractor<TDatums>::WPoseExtractor(const std::shared_ptr<PoseExtractor>& poseExtractorSharedPtr) :
-        spPoseExtractor{poseExtractorSharedPtr}
+    WPoseExtractor<TDatums>::WPoseExtractor(const std::shared_ptr<PoseExtractor>& poseExtractorSharedPtr,
+                                            const int batchSize, const double batchWindow) :
+        spPoseExtractor{poseExtractorSharedPtr},
+        mBatchSize{(unsigned int)std::max(1, batchSize)},
+        mBatchWindow{(long long)(1e9 * std::max(0., batchWindow))},
+        mStopWhenEmpty{false}
     {
     }
 
@@ -64,35 +99,160 @@ namespace op
         try
         {
             if (checkNoNullNorEmpty(tDatums))
+            {
+                // Batchable frame -> enqueue it into the current batch
+                if (mBatchSize > 1u && tDatums->size() == 1u && (*tDatums)[0]->poseNetOutput.empty())
+                {
+                    if (mBatchTDatums.empty())
+                        mBatchDeadline = std::chrono::steady_clock::now() + mBatchWindow;
+                    mBatchTDatums.emplace_back(tDatums);
+                    tDatums = nullptr;
+                }
+                // Otherwise -> process it now (after the current batch, to keep the frame order)
+                else
+                {
+                    processBatch();
+                    processTDatums(tDatums);
+                    if (!mReadyTDatums.empty())
+                    {
+                        mReadyTDatums.emplace_back(tDatums);
+                        tDatums = nullptr;
+                    }
+                }
+            }
+            // Batch full, its window expired, or stopping -> process it
+            if (!mBatchTDatums.empty()
+                && (mBatchTDatums.size() >= mBatchSize || mStopWhenEmpty
+                    || std::chrono::steady_clock::now() >= mBatchDeadline))
+                processBatch();
+            // Return the processed frames one by one
+            if (tDatums == nullptr && !mReadyTDatums.empty())
+            {
+                tDatums = mReadyTDatums.front();
+                mReadyTDatums.pop_front();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            this->stop();
+            tDatums = nullptr;
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void WPoseExtractor<TDatums>::tryStop()
+    {
+        try
+        {
+            // Close if no frame is waiting to be processed or returned
+            if (mBatchTDatums.empty() && mReadyTDatums.empty())
+                this->stop();
+            mStopWhenEmpty = true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    bool WPoseExtractor<TDatums>::hasPendingOutput() const
+    {
+        try
+        {
+            return !mReadyTDatums.empty() || (mStopWhenEmpty && !mBatchTDatums.empty());
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    std::chrono::steady_clock::time_point WPoseExtractor<TDatums>::getDeadline() const
+    {
+        try
+        {
+            return (mBatchTDatums.empty() ? std::chrono::steady_clock::time_point::max() : mBatchDeadline);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return std::chrono::steady_clock::time_point::max();
+        }
+    }
+
+    template<typename TDatums>
+    void WPoseExtractor<TDatums>::processTDatums(TDatums& tDatums)
+    {
+        try
+        {
+            // Debugging log
+            opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            // Tracing
+            OP_TRACE_SCOPE_FRAME("WPoseExtractor", (*tDatums)[0]->id);
+            // Profiling speed
+            const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
+            // Extract people pose
+            for (auto i = 0u ; i < tDatums->size() ; i++)
+            // for (auto& tDatum : *tDatums)
+            {
+                auto& tDatumPtr = (*tDatums)[i];
+                // OpenPose net forward pass
+                spPoseExtractor->forwardPass(
+                    tDatumPtr->inputNetData, Point<int>{tDatumPtr->cvInputData.cols(), tDatumPtr->cvInputData.rows()},
+                    tDatumPtr->scaleInputToNetInputs, tDatumPtr->poseNetOutput, tDatumPtr->id);
+                fillDatum(tDatums, i);
+            }
+            // Profiling speed
+            Profiler::timerEnd(profilerKey);
+            Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
+            // Debugging log
+            opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void WPoseExtractor<TDatums>::processBatch()
+    {
+        try
+        {
+            if (!mBatchTDatums.empty())
             {
                 // Debugging log
                 opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                // Tracing
+                OP_TRACE_SCOPE_FRAME("WPoseExtractor", (*mBatchTDatums[0])[0]->id);
                 // Profiling speed
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
-                // Extract people pose
-                for (auto i = 0u ; i < tDatums->size() ; i++)
-                // for (auto& tDatum : *tDatums)
+                // Network inputs (Array copies only share the data)
+                std::vector<std::vector<Array<float>>> inputNetData;
+                std::vector<Point<int>> inputDataSizes;
+                std::vector<std::vector<double>> scaleInputToNetInputs;
+                std::vector<long long> frameIds;
+                for (const auto& batchTDatums : mBatchTDatums)
                 {
-                    auto& tDatumPtr = (*tDatums)[i];
-                    // OpenPose net forward pass
-                    spPoseExtractor->forwardPass(
-                        tDatumPtr->inputNetData, Point<int>{tDatumPtr->cvInputData.cols(), tDatumPtr->cvInputData.rows()},
-                        tDatumPtr->scaleInputToNetInputs, tDatumPtr->poseNetOutput, tDatumPtr->id);
-                    // OpenPose keypoint detector
-                    tDatumPtr->poseCandidates = spPoseExtractor->getCandidatesCopy();
-                    tDatumPtr->poseHeatMaps = spPoseExtractor->getHeatMapsCopy();
-                    tDatumPtr->poseKeypoints = spPoseExtractor->getPoseKeypoints().clone();
-                    tDatumPtr->poseScores = spPoseExtractor->getPoseScores().clone();
-                    tDatumPtr->scaleNetToOutput = spPoseExtractor->getScaleNetToOutput();
-                    // Keep desired top N people
-                    spPoseExtractor->keepTopPeople(tDatumPtr->poseKeypoints, tDatumPtr->poseScores);
-                    // ID extractor (experimental)
-                    tDatumPtr->poseIds = spPoseExtractor->extractIdsLockThread(
-                        tDatumPtr->poseKeypoints, tDatumPtr->cvInputData, i, tDatumPtr->id);
-                    // Tracking (experimental)
-                    spPoseExtractor->trackLockThread(
-                        tDatumPtr->poseKeypoints, tDatumPtr->poseIds, tDatumPtr->cvInputData, i, tDatumPtr->id);
+                    const auto& tDatumPtr = (*batchTDatums)[0];
+                    inputNetData.emplace_back(tDatumPtr->inputNetData);
+                    inputDataSizes.emplace_back(
+                        Point<int>{tDatumPtr->cvInputData.cols(), tDatumPtr->cvInputData.rows()});
+                    scaleInputToNetInputs.emplace_back(tDatumPtr->scaleInputToNetInputs);
+                    frameIds.emplace_back(tDatumPtr->id);
                 }
+                // OpenPose net forward pass + keypoint detector
+                spPoseExtractor->forwardPassBatch(
+                    inputNetData, inputDataSizes, scaleInputToNetInputs, frameIds,
+                    [this](const int frame) { fillDatum(mBatchTDatums[frame], 0u); });
+                // Move them to the output
+                for (auto& batchTDatums : mBatchTDatums)
+                    mReadyTDatums.emplace_back(batchTDatums);
+                mBatchTDatums.clear();
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
                 Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
@@ -102,8 +262,38 @@ namespace op
         }
         catch (const std::exception& e)
         {
-            this->stop();
-            tDatums = nullptr;
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void WPoseExtractor<TDatums>::fillDatum(TDatums& tDatums, const unsigned int viewIndex)
+    {
+        try
+        {
+            auto& tDatumPtr = (*tDatums)[viewIndex];
+            // OpenPose keypoint detector
+            tDatumPtr->poseCandidates = spPoseExtractor->getCandidatesCopy();
+            tDatumPtr->poseHeatMaps = spPoseExtractor->getHeatMapsCopy();
+            tDatumPtr->poseKeypoints = spPoseExtractor->getPoseKeypoints().clone();
+            tDatumPtr->poseScores = spPoseExtractor->getPoseScores().clone();
+            tDatumPtr->scaleNetToOutput = spPoseExtractor->getScaleNetToOutput();
+            // Keep desired top N people
+            spPoseExtractor->keepTopPeople(tDatumPtr->poseKeypoints, tDatumPtr->poseScores);
+            // Frame pyramids shared by the ID extractor and the tracker (only built if any of them uses it)
+            if (tDatumPtr->imagePyramidCache == nullptr)
+                tDatumPtr->imagePyramidCache = std::make_shared<ImagePyramidCache>(tDatumPtr->cvInputData);
+            // ID extractor (experimental)
+            tDatumPtr->poseIds = spPoseExtractor->extractIdsLockThread(
+                tDatumPtr->poseKeypoints, tDatumPtr->cvInputData, viewIndex, tDatumPtr->id,
+                tDatumPtr->imagePyramidCache);
+            // Tracking (experimental)
+            spPoseExtractor->trackLockThread(
+                tDatumPtr->poseKeypoints, tDatumPtr->poseIds, tDatumPtr->cvInputData, viewIndex, tDatumPtr->id,
+                tDatumPtr->imagePyramidCache);
+        }
+        catch (const std::exception& e)
+        {
             error(e.what(), __LINE__, __FUNCTION__, __FILE__);
         }
     }
@@ -6,6 +6,7 @@
 #include <openpose/core/common.hpp>
 #include <openpose/core/datum.hpp>
 #include <openpose/utilities/fastMath.hpp>
+#include <openpose/utilities/memoryPool.hpp>
 #include <openpose/producer/producer.hpp>
 
 namespace op
@@ -130,6 +131,7 @@ namespace op
                     std::swap(datumPtr->name, nextFrameName);
                     datumPtr->frameNumber = nextFrameNumber;
                     datumPtr->cvInputData = matrices[0];
+                    datumPtr->scaleInputToOriginal = spProducer->get(ProducerProperty::DecodingScale);
                     datumProducerConstructorRunningAndGetDatumFrameIntegrity(datumPtr->cvInputData);
                     if (!cameraMatrices.empty())
                     {
@@ -150,6 +152,7 @@ namespace op
                             datumIPtr->name = datumPtr->name;
                             datumIPtr->frameNumber = datumPtr->frameNumber;
                             datumIPtr->cvInputData = matrices[i];
+                            datumIPtr->scaleInputToOriginal = datumPtr->scaleInputToOriginal;
                             datumProducerConstructorRunningAndGetDatumFrameIntegrity(datumPtr->cvInputData);
                             datumIPtr->cvOutputData = datumIPtr->cvInputData;
                             if (cameraMatrices.size() > i)
@@ -165,7 +168,11 @@ namespace op
                         datums = nullptr;
                     // Increase counter if successful image
                     if (datums != nullptr)
+                    {
                         mGlobalCounter += mFrameStep;
+                        // Per-frame counters of the Array<T> memory pool
+                        MemoryPool::markFrame();
+                    }
                 }
             }
             // Return result
@@ -18,6 +18,8 @@ namespace op
         Rotation,
         FrameStep,
         NumberViews,
+        DecodingScale, /**< Ratio between the original image and the last frame (e.g., 2, 4 or 8 if decoded at a
+                            reduced resolution), so its keypoints can be rescaled to the original resolution. */
         Size,
     };
 
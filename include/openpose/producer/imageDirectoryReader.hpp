@@ -1,6 +1,11 @@
 #ifndef OPENPOSE_PRODUCER_IMAGE_DIRECTORY_READER_HPP
 #define OPENPOSE_PRODUCER_IMAGE_DIRECTORY_READER_HPP
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <openpose/core/common.hpp>
 #include <openpose/producer/producer.hpp>
 
@@ -10,6 +15,8 @@ namespace op
      * ImageDirectoryReader is an abstract class to extract frames from a image directory. Its interface imitates the
      * cv::VideoCapture class, so it can be used quite similarly to the cv::VideoCapture class. Thus,
      * it is quite similar to VideoReader and WebcamReader.
+     * With decoderThreads > 0, the images are read and decoded ahead of time by a pool of decoder threads (in any
+     * order) into a buffer of up to prefetchDepth images, and returned in order by getRawFrame().
      */
     class OP_API ImageDirectoryReader : public Producer
     {
@@ -22,10 +29,20 @@ namespace op
          * parameters (only required if imageDirectorystereo > 1).
          * @param numberViews const int parameter with the number of images per iteration (>1 would represent
          * stereo processing).
+         * @param decoderThreads const int parameter with the number of threads reading and decoding images ahead of
+         * time. 0 decodes each image synchronously when requested.
+         * @param prefetchDepth const int parameter with the maximum number of images decoded (or being decoded)
+         * ahead of time. Only used if decoderThreads > 0.
+         * @param reducedDecodingSize const Point<int> parameter with the minimum size of the decoded images. If any
+         * of its dimensions is positive, JPEG images at least 2, 4, or 8 times bigger than it (in both orientations)
+         * are decoded at 1/2, 1/4, or 1/8 of their resolution (cv::IMREAD_REDUCED_COLOR_X). -1 in both dimensions
+         * (default) always decodes the full resolution. The scale of each frame is given by
+         * get(ProducerProperty::DecodingScale), and used to rescale the keypoints to the original image resolution.
          */
         explicit ImageDirectoryReader(
             const std::string& imageDirectoryPath, const std::string& cameraParameterPath = "",
-            const bool undistortImage = false, const int numberViews = -1);
+            const bool undistortImage = false, const int numberViews = -1, const int decoderThreads = 0,
+            const int prefetchDepth = 16, const Point<int>& reducedDecodingSize = Point<int>{-1,-1});
 
         virtual ~ImageDirectoryReader();
 
@@ -50,11 +67,29 @@ namespace op
         const std::vector<std::string> mFilePaths;
         Point<int> mResolution;
         long long mFrameNameCounter;
+        const Point<int> mReducedDecodingSize;
+        // Prefetching (only if decoderThreads > 0)
+        const unsigned long long mPrefetchDepth;
+        std::vector<std::thread> mDecoderThreads;
+        std::mutex mPrefetchMutex;
+        std::condition_variable mConditionDecoders;
+        std::condition_variable mConditionFrames;
+        bool mCloseDecoders;
+        unsigned long long mPrefetchGeneration;
+        long long mPrefetchNext;
+        long long mPrefetchStep;
+        std::set<long long> mFramesDecoding;
+        // Frame and its decoding scale (1, 2, 4 or 8)
+        std::map<long long, std::pair<Matrix, int>> mFramesDecoded;
 
         Matrix getRawFrame();
 
         std::vector<Matrix> getRawFrames();
 
+        Matrix getPrefetchedFrame(int& decodingScale, const long long frameIndex, const long long frameStep);
+
+        void decoderThread();
+
         DELETE_COPY(ImageDirectoryReader);
     };
 }
@@ -15,9 +15,14 @@ namespace op
         /**
          * Constructor of IpCameraReader. It opens the IP camera as a wrapper of cv::VideoCapture.
          * @param cameraPath const std::string parameter with the full camera IP link.
+         * @param bufferSize const int parameter with the number of frames decoded ahead of time on a background
+         * thread (0 for no background decoding).
+         * @param bufferPolicy const BackpressurePolicy parameter with the policy once the frame buffer is full
+         * (DropOldest keeps the latency low for live streams).
          */
         explicit IpCameraReader(const std::string& cameraPath, const std::string& cameraParameterPath = "",
-                                const bool undistortImage = false);
+                                const bool undistortImage = false, const int bufferSize = 0,
+                                const BackpressurePolicy bufferPolicy = BackpressurePolicy::DropOldest);
 
         virtual ~IpCameraReader();
 
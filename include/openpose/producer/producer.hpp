@@ -4,6 +4,7 @@
 #include <openpose/3d/cameraParameterReader.hpp>
 #include <openpose/core/common.hpp>
 #include <openpose/producer/enumClasses.hpp>
+#include <openpose/thread/enumClasses.hpp>
 
 namespace op
 {
@@ -178,12 +179,16 @@ namespace op
 
     /**
      * This function returns the desired producer given the input parameters.
+     * decoderThreads, prefetchDepth and reducedDecodingSize are only used by ImageDirectoryReader.
+     * captureBufferSize and captureBufferPolicy are only used by VideoReader and IpCameraReader.
      */
     OP_API std::shared_ptr<Producer> createProducer(
         const ProducerType producerType = ProducerType::None, const std::string& producerString = "",
         const Point<int>& cameraResolution = Point<int>{-1,-1},
         const std::string& cameraParameterPath = "models/cameraParameters/", const bool undistortImage = true,
-        const int numberViews = -1);
+        const int numberViews = -1, const int decoderThreads = 0, const int prefetchDepth = 16,
+        const Point<int>& reducedDecodingSize = Point<int>{-1,-1}, const int captureBufferSize = 0,
+        const BackpressurePolicy captureBufferPolicy = BackpressurePolicy::Block);
 }
 
 #endif // OPENPOSE_PRODUCER_PRODUCER_HPP
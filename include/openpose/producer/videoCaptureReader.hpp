@@ -9,6 +9,10 @@ namespace op
     /**
      *  VideoCaptureReader is an abstract class to extract frames from a cv::VideoCapture source (video file,
      * webcam stream, etc.). It has the basic and common functions of the cv::VideoCapture class (e.g., get, set, etc.).
+     * With bufferSize > 0 (video and IP camera), frames are decoded on a background thread into a ring of bufferSize
+     * frames, so decoding overlaps with the rest of the pipeline. The ring frames are allocated once and reused as
+     * soon as the frames returned by getRawFrame() are released.
+     * An empty read ends a video, while for IP cameras the empty frame is returned and decoding is retried.
      */
     class OP_API VideoCaptureReader : public Producer
     {
@@ -25,10 +29,16 @@ namespace op
          * This constructor of VideoCaptureReader wraps cv::VideoCapture(const std::string).
          * @param path const std::string indicating the cv::VideoCapture constructor string argument.
          * @param producerType const std::string indicating whether the frame source is an IP camera or video.
+         * @param bufferSize const int indicating the number of frames decoded ahead of time on a background thread.
+         * 0 decodes each frame synchronously when requested.
+         * @param bufferPolicy const BackpressurePolicy indicating what to do when the ring is full: Block (wait,
+         * lossless, e.g., for videos), DropOldest (overwrite the oldest frame, e.g., for live sources), or
+         * DropNewest (discard the new frame).
          */
         explicit VideoCaptureReader(const std::string& path, const ProducerType producerType,
                                     const std::string& cameraParameterPath, const bool undistortImage,
-                                    const int numberViews);
+                                    const int numberViews, const int bufferSize = 0,
+                                    const BackpressurePolicy bufferPolicy = BackpressurePolicy::Block);
 
         /**
          * Destructor of VideoCaptureReader. It releases the cv::VideoCapture member. It is virtual so that
@@ -59,6 +69,12 @@ namespace op
         struct ImplVideoCaptureReader;
         std::unique_ptr<ImplVideoCaptureReader> upImpl;
 
+        void startDecoding();
+
+        void stopDecoding();
+
+        void decodingThread();
+
         DELETE_COPY(VideoCaptureReader);
     };
 }
@@ -21,10 +21,14 @@ namespace op
          * parameters (only required if imageDirectorystereo > 1).
          * @param numberViews const int parameter with the number of images per iteration (>1 would represent
          * stereo processing).
+         * @param bufferSize const int parameter with the number of frames decoded ahead of time on a background
+         * thread (0 for no background decoding).
+         * @param bufferPolicy const BackpressurePolicy parameter with the policy once the frame buffer is full.
          */
         explicit VideoReader(
             const std::string& videoPath, const std::string& cameraParameterPath = "",
-            const bool undistortImage = false, const int numberViews = -1);
+            const bool undistortImage = false, const int numberViews = -1, const int bufferSize = 0,
+            const BackpressurePolicy bufferPolicy = BackpressurePolicy::Block);
 
         virtual ~VideoReader();
 
@@ -62,6 +62,8 @@ namespace op
         {
             // Debugging log
             opLogIfDebug("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            // Tracing
+            OP_TRACE_SCOPE("WDatumProducer");
             // Profiling speed
             const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
             // Create and fill final shared pointer
@@ -22,6 +22,48 @@ namespace op
          */
         Synchronous,
     };
+
+    /**
+     * How the ThreadManager threads wait for their input queue to have elements (and for their output queue to have
+     * room for them).
+     */
+    enum class ThreadSchedulingMode : unsigned char
+    {
+        /**
+         * Each thread briefly spins and then blocks on its queue until it is notified (i.e., it wakes up as soon as
+         * an element arrives), with a timeout so its workers are still called periodically while idle.
+         * Threads running more than 1 SubThread (e.g., with `--disable_multi_thread`) keep using Polling, given that
+         * blocking on one of their queues would stall the others.
+         */
+        EventDriven,
+        /**
+         * Each thread sleeps 100 usec whenever its input queue is empty or its output queue is full (behavior up to
+         * OpenPose 1.7.0). It adds up to 100 usec of latency per thread, and it keeps the CPU awake while idle.
+         */
+        Polling,
+    };
+
+    /**
+     * What happens when a frame is pushed into a full queue (see ThreadManager::setBackpressurePolicy()).
+     */
+    enum class BackpressurePolicy : unsigned char
+    {
+        /**
+         * The producer waits until there is room, so no frame is lost (maximum throughput, e.g., for videos).
+         */
+        Block,
+        /**
+         * The oldest frame in the queue is discarded, so the pipeline always processes the latest frames (e.g., for
+         * live camera feeds).
+         */
+        DropOldest,
+        DropNewest,         /**< The new frame is discarded. */
+        /**
+         * As Block, but the maximum size of each queue shrinks while its frames wait longer than its share of a
+         * latency target, and it grows back (up to its initial size) while they wait less than half of it.
+         */
+        LatencyTarget,
+    };
 }
 
 #endif // OPENPOSE_THREAD_ENUM_CLASSES_HPP
@@ -3,6 +3,8 @@
 
 // thread module
 #include <openpose/thread/enumClasses.hpp>
+#include <openpose/thread/lockFreeQueue.hpp>
+#include <openpose/thread/pipelineStatistics.hpp>
 #include <openpose/thread/priorityQueue.hpp>
 #include <openpose/thread/queue.hpp>
 #include <openpose/thread/queueBase.hpp>
@@ -12,6 +14,7 @@
 #include <openpose/thread/subThreadQueueInOut.hpp>
 #include <openpose/thread/subThreadQueueOut.hpp>
 #include <openpose/thread/thread.hpp>
+#include <openpose/thread/threadAffinity.hpp>
 #include <openpose/thread/threadManager.hpp>
 #include <openpose/thread/worker.hpp>
 #include <openpose/thread/workerProducer.hpp>
@@ -0,0 +1,945 @@
+#ifndef OPENPOSE_THREAD_LOCK_FREE_QUEUE_HPP
+#define OPENPOSE_THREAD_LOCK_FREE_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory> // std::unique_ptr
+#include <mutex>
+#include <openpose/core/common.hpp>
+#include <openpose/thread/enumClasses.hpp>
+#include <openpose/thread/pipelineStatistics.hpp>
+
+namespace op
+{
+    /**
+     * Bounded multi-producer multi-consumer ring-buffer queue (one sequence number per cell), with the same interface
+     * and stop/pusher/popper semantics as Queue. It is mutex-free but, despite its name, not strictly lock-free:
+     * pushing and popping never block on a mutex, so many threads can share it without contending on a single lock
+     * (e.g., the pose extractor threads when `--num_gpu` > 1), but a pusher that claims a cell whose previous element
+     * is still being moved out by a popper yields until that popper releases it. It can be used with
+     * ThreadManager<TDatums, TWorker, LockFreeQueue<TDatums>>.
+     * The blocking functions (waitAndPush(), waitAndPop(), tryPopFor(), etc.) spin for a few microseconds and then park
+     * on a condition variable, which is only notified if some thread is actually waiting.
+     * Unlike Queue, its capacity is fixed at construction: `maxSize` (rounded up to a power of 2) if `maxSize` > 0,
+     * or 64 otherwise (with the same automatic logical size as Queue, i.e., max(#poppers, #pushers)).
+     */
+    template<typename TDatums>
+    class LockFreeQueue
+    {
+    public:
+        explicit LockFreeQueue(const long long maxSize = -1);
+
+        virtual ~LockFreeQueue();
+
+        bool forceEmplace(TDatums& tDatums);
+
+        bool tryEmplace(TDatums& tDatums);
+
+        bool waitAndEmplace(TDatums& tDatums);
+
+        bool forcePush(const TDatums& tDatums);
+
+        bool tryPush(const TDatums& tDatums);
+
+        bool waitAndPush(const TDatums& tDatums);
+
+        /**
+         * Analogous to QueueBase::setBackpressurePolicy().
+         */
+        void setBackpressurePolicy(
+            const BackpressurePolicy backpressurePolicy, const double latencyTargetSeconds = 0.);
+
+        BackpressurePolicy getBackpressurePolicy() const;
+
+        /**
+         * Analogous to QueueBase::setDroppedCallback(), but it is called right after the element is discarded (no
+         * lock is held), so a concurrent popper might pop a later element before it is reported.
+         */
+        void setDroppedCallback(const std::function<void(const TDatums&)>& droppedCallback);
+
+        /**
+         * Analogous to QueueBase::emplaceByPolicy().
+         */
+        bool emplaceByPolicy(TDatums& tDatums);
+
+        bool tryPop(TDatums& tDatums);
+
+        bool tryPop();
+
+        bool waitAndPop(TDatums& tDatums);
+
+        bool waitAndPop();
+
+        bool tryPopFor(TDatums& tDatums, const std::chrono::microseconds& timeout);
+
+        bool waitUntilNotFull(const std::chrono::microseconds& timeout);
+
+        bool empty() const;
+
+        void stop();
+
+        void stopPusher();
+
+        void addPopper();
+
+        void addPusher();
+
+        bool isRunning() const;
+
+        bool isFull() const;
+
+        size_t size() const;
+
+        void clear();
+
+        /**
+         * Counters of this queue (its queueId is left to 0). Thread-safe, but not an atomic snapshot.
+         */
+        QueueStatistics getStatistics() const;
+
+        /**
+         * It returns a copy of the next element to be popped (or an empty TDatums if none). Not thread-safe with
+         * concurrent poppers.
+         */
+        TDatums front() const;
+
+    private:
+        struct Cell
+        {
+            std::atomic<unsigned long long> sequence;
+            TDatums tDatums;
+            // Only for BackpressurePolicy::LatencyTarget
+            std::chrono::steady_clock::time_point pushTime;
+        };
+
+        const long long mMaxSize;
+        const unsigned long long mCapacity;
+        std::unique_ptr<Cell[]> upCells;
+        // Padding avoids false sharing between the pushers and the poppers positions
+        char mPadding0[64];
+        std::atomic<unsigned long long> mPushPosition;
+        char mPadding1[64];
+        std::atomic<unsigned long long> mPopPosition;
+        char mPadding2[64];
+        // Elements pushed (or being pushed) and not popped yet
+        std::atomic<long long> mSize;
+        std::atomic<long long> mPoppers;
+        std::atomic<long long> mPushers;
+        std::atomic<long long> mMaxPoppersPushers;
+        std::atomic<bool> mPopIsStopped;
+        std::atomic<bool> mPushIsStopped;
+        // Only used to park the threads waiting on the queue
+        std::atomic<int> mWaiters;
+        std::mutex mWaitMutex;
+        std::condition_variable mConditionVariable;
+        // Statistics (pushed and popped are given by mPushPosition and mPopPosition)
+        std::atomic<unsigned long long> mDropped;
+        // Dropped by emplaceByPolicy() without being pushed (so not included in mPopPosition)
+        std::atomic<unsigned long long> mRejected;
+        std::atomic<unsigned long long> mHighWaterMark;
+        std::atomic<unsigned long long> mPushBlockedNanoseconds;
+        std::atomic<unsigned long long> mPopBlockedNanoseconds;
+        std::atomic<unsigned long long> mMaxSizeDecreases;
+        std::atomic<unsigned long long> mMaxSizeIncreases;
+        // Backpressure (mLatencyNanoseconds and mNextMaxSizeUpdate are only modified while holding mBackpressureMutex,
+        // which the poppers only try to lock)
+        std::atomic<BackpressurePolicy> mBackpressurePolicy;
+        std::chrono::nanoseconds mLatencyTarget;
+        std::atomic<long long> mAdaptiveMaxSize;
+        std::atomic<double> mLatencyNanoseconds;
+        std::chrono::steady_clock::time_point mNextMaxSizeUpdate;
+        std::mutex mBackpressureMutex;
+        std::function<void(const TDatums&)> mDroppedCallback;
+
+        static unsigned long long getCapacity(const long long maxSize);
+
+        unsigned long long getMaxSize() const;
+
+        bool push(const TDatums& tDatums);
+
+        bool pop(TDatums& tDatums, const bool ignoreStop);
+
+        void updateMaxPoppersPushers();
+
+        void notifyWaiters(const bool forceNotify = false);
+
+        void updateLatency(const std::chrono::steady_clock::time_point& pushTime);
+
+        template<typename TPredicate>
+        bool waitFor(
+            const std::chrono::microseconds& timeout, TPredicate predicate,
+            std::atomic<unsigned long long>& blockedNanoseconds);
+
+        DELETE_COPY(LockFreeQueue);
+    };
+}
+
+
+
+
+
+// Implementation
+#include <thread> // std::this_thread
+#include <openpose/core/datum.hpp>
+#include <openpose/utilities/fastMath.hpp>
+namespace op
+{
+    template<typename TDatums>
+    LockFreeQueue<TDatums>::LockFreeQueue(const long long maxSize) :
+        mMaxSize{maxSize},
+        mCapacity{getCapacity(maxSize)},
+        upCells{new Cell[mCapacity]},
+        mPushPosition{0ull},
+        mPopPosition{0ull},
+        mSize{0ll},
+        mPoppers{0ll},
+        mPushers{0ll},
+        mMaxPoppersPushers{0ll},
+        mPopIsStopped{false},
+        mPushIsStopped{false},
+        mWaiters{0},
+        mDropped{0ull},
+        mRejected{0ull},
+        mHighWaterMark{0ull},
+        mPushBlockedNanoseconds{0ull},
+        mPopBlockedNanoseconds{0ull},
+        mMaxSizeDecreases{0ull},
+        mMaxSizeIncreases{0ull},
+        mBackpressurePolicy{BackpressurePolicy::Block},
+        mLatencyTarget{0},
+        mAdaptiveMaxSize{-1ll},
+        mLatencyNanoseconds{0.}
+    {
+        try
+        {
+            for (auto i = 0ull ; i < mCapacity ; i++)
+                upCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    // Virtual destructor
+    template<typename TDatums>
+    LockFreeQueue<TDatums>::~LockFreeQueue()
+    {
+        try
+        {
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            stop();
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::forceEmplace(TDatums& tDatums)
+    {
+        try
+        {
+            return forcePush(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::tryEmplace(TDatums& tDatums)
+    {
+        try
+        {
+            return push(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::waitAndEmplace(TDatums& tDatums)
+    {
+        try
+        {
+            return waitAndPush(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::forcePush(const TDatums& tDatums)
+    {
+        try
+        {
+            // Discard the oldest elements until it fits
+            TDatums tDatumsDiscarded;
+            while (!push(tDatums))
+            {
+                if (mPushIsStopped)
+                    return false;
+                if (pop(tDatumsDiscarded, true))
+                {
+                    mDropped++;
+                    if (mDroppedCallback)
+                        mDroppedCallback(tDatumsDiscarded);
+                }
+            }
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::tryPush(const TDatums& tDatums)
+    {
+        try
+        {
+            return push(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::waitAndPush(const TDatums& tDatums)
+    {
+        try
+        {
+            while (!push(tDatums))
+            {
+                if (mPushIsStopped)
+                    return false;
+                waitFor(std::chrono::milliseconds{100},
+                        [this]{ return (unsigned long long)mSize.load() < getMaxSize() || mPushIsStopped; },
+                        mPushBlockedNanoseconds);
+            }
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::setBackpressurePolicy(
+        const BackpressurePolicy backpressurePolicy, const double latencyTargetSeconds)
+    {
+        try
+        {
+            if (backpressurePolicy == BackpressurePolicy::LatencyTarget && latencyTargetSeconds <= 0.)
+                error("BackpressurePolicy::LatencyTarget requires a positive latency target.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            const std::lock_guard<std::mutex> lock{mBackpressureMutex};
+            mLatencyTarget = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::duration<double>{latencyTargetSeconds});
+            mAdaptiveMaxSize = -1ll;
+            mBackpressurePolicy = backpressurePolicy;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    BackpressurePolicy LockFreeQueue<TDatums>::getBackpressurePolicy() const
+    {
+        try
+        {
+            return mBackpressurePolicy.load(std::memory_order_relaxed);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return BackpressurePolicy::Block;
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::setDroppedCallback(const std::function<void(const TDatums&)>& droppedCallback)
+    {
+        try
+        {
+            mDroppedCallback = {droppedCallback};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::emplaceByPolicy(TDatums& tDatums)
+    {
+        try
+        {
+            const auto backpressurePolicy = getBackpressurePolicy();
+            if (backpressurePolicy == BackpressurePolicy::DropOldest)
+                return forcePush(tDatums);
+            else if (backpressurePolicy == BackpressurePolicy::DropNewest)
+            {
+                if (push(tDatums))
+                    return true;
+                if (!mPushIsStopped)
+                {
+                    mRejected++;
+                    if (mDroppedCallback)
+                        mDroppedCallback(tDatums);
+                }
+                return false;
+            }
+            else
+                return waitAndPush(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::tryPop(TDatums& tDatums)
+    {
+        try
+        {
+            return pop(tDatums, false);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::tryPop()
+    {
+        try
+        {
+            TDatums tDatums;
+            return pop(tDatums, false);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::waitAndPop(TDatums& tDatums)
+    {
+        try
+        {
+            while (!pop(tDatums, false))
+            {
+                if (mPopIsStopped)
+                    return false;
+                waitFor(std::chrono::milliseconds{100}, [this]{ return mSize.load() > 0 || mPopIsStopped; },
+                        mPopBlockedNanoseconds);
+            }
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::waitAndPop()
+    {
+        try
+        {
+            TDatums tDatums;
+            return waitAndPop(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::tryPopFor(TDatums& tDatums, const std::chrono::microseconds& timeout)
+    {
+        try
+        {
+            if (pop(tDatums, false))
+                return true;
+            // No more elements will arrive if the pushers are stopped
+            waitFor(timeout, [this]{ return mSize.load() > 0 || mPopIsStopped || mPushIsStopped; },
+                    mPopBlockedNanoseconds);
+            return pop(tDatums, false);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::waitUntilNotFull(const std::chrono::microseconds& timeout)
+    {
+        try
+        {
+            waitFor(timeout, [this]{ return (unsigned long long)mSize.load() < getMaxSize() || mPushIsStopped; },
+                    mPushBlockedNanoseconds);
+            return !isFull();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::empty() const
+    {
+        try
+        {
+            return mSize.load() <= 0;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::stop()
+    {
+        try
+        {
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            mPopIsStopped = {true};
+            mPushIsStopped = {true};
+            clear();
+            notifyWaiters(true);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::stopPusher()
+    {
+        try
+        {
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            if (--mPushers == 0)
+            {
+                mPushIsStopped = {true};
+                if (empty())
+                    mPopIsStopped = {true};
+                notifyWaiters(true);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::addPopper()
+    {
+        try
+        {
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            mPoppers++;
+            updateMaxPoppersPushers();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::addPusher()
+    {
+        try
+        {
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            mPushers++;
+            updateMaxPoppersPushers();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::isRunning() const
+    {
+        try
+        {
+            return !(mPushIsStopped && (mPopIsStopped || empty()));
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return true;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::isFull() const
+    {
+        try
+        {
+            return size() >= getMaxSize();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    size_t LockFreeQueue<TDatums>::size() const
+    {
+        try
+        {
+            return (size_t)fastMax(0ll, mSize.load());
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0;
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::clear()
+    {
+        try
+        {
+            TDatums tDatums;
+            while (pop(tDatums, true))
+                mDropped++;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    QueueStatistics LockFreeQueue<TDatums>::getStatistics() const
+    {
+        try
+        {
+            QueueStatistics queueStatistics;
+            queueStatistics.size = size();
+            queueStatistics.maxSize = getMaxSize();
+            queueStatistics.highWaterMark = mHighWaterMark.load(std::memory_order_relaxed);
+            queueStatistics.pushed = mPushPosition.load(std::memory_order_relaxed);
+            const auto dropped = mDropped.load(std::memory_order_relaxed);
+            queueStatistics.dropped = dropped + mRejected.load(std::memory_order_relaxed);
+            queueStatistics.popped = mPopPosition.load(std::memory_order_relaxed) - dropped;
+            queueStatistics.pushBlockedSeconds = 1e-9 * mPushBlockedNanoseconds.load(std::memory_order_relaxed);
+            queueStatistics.popBlockedSeconds = 1e-9 * mPopBlockedNanoseconds.load(std::memory_order_relaxed);
+            queueStatistics.maxSizeDecreases = mMaxSizeDecreases.load(std::memory_order_relaxed);
+            queueStatistics.maxSizeIncreases = mMaxSizeIncreases.load(std::memory_order_relaxed);
+            queueStatistics.latencySeconds = 1e-9 * mLatencyNanoseconds.load(std::memory_order_relaxed);
+            return queueStatistics;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return QueueStatistics{};
+        }
+    }
+
+    template<typename TDatums>
+    TDatums LockFreeQueue<TDatums>::front() const
+    {
+        try
+        {
+            const auto position = mPopPosition.load(std::memory_order_relaxed);
+            const auto& cell = upCells[position & (mCapacity-1)];
+            if (cell.sequence.load(std::memory_order_acquire) == position+1)
+                return cell.tDatums;
+            return TDatums{};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return TDatums{};
+        }
+    }
+
+    template<typename TDatums>
+    unsigned long long LockFreeQueue<TDatums>::getCapacity(const long long maxSize)
+    {
+        try
+        {
+            // Power of 2 (so the position of a cell is a mask rather than a modulo)
+            auto capacity = 1ull;
+            while (capacity < (maxSize > 0 ? (unsigned long long)maxSize : 64ull))
+                capacity <<= 1;
+            return capacity;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 1ull;
+        }
+    }
+
+    template<typename TDatums>
+    unsigned long long LockFreeQueue<TDatums>::getMaxSize() const
+    {
+        try
+        {
+            auto maxSize = (mMaxSize > 0 ? mMaxSize : fastMax(1ll, mMaxPoppersPushers.load()));
+            const auto adaptiveMaxSize = mAdaptiveMaxSize.load(std::memory_order_relaxed);
+            if (adaptiveMaxSize > 0)
+                maxSize = fastMin(adaptiveMaxSize, maxSize);
+            return fastMin(mCapacity, (unsigned long long)maxSize);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::push(const TDatums& tDatums)
+    {
+        try
+        {
+            if (mPushIsStopped)
+                return false;
+            // Reserve 1 element of the (logical) size
+            const auto maxSize = (long long)getMaxSize();
+            auto size = mSize.load();
+            do
+            {
+                if (size >= maxSize)
+                    return false;
+            } while (!mSize.compare_exchange_weak(size, size+1));
+            auto highWaterMark = mHighWaterMark.load(std::memory_order_relaxed);
+            while ((unsigned long long)size+1 > highWaterMark
+                   && !mHighWaterMark.compare_exchange_weak(highWaterMark, size+1, std::memory_order_relaxed))
+                ;
+            // Claim a cell. It is (or is about to be) free: at most mCapacity elements are reserved, so its previous
+            // element was already claimed by a popper, which might still be moving it out
+            const auto position = mPushPosition.fetch_add(1ull, std::memory_order_relaxed);
+            auto& cell = upCells[position & (mCapacity-1)];
+            while (cell.sequence.load(std::memory_order_acquire) != position)
+                std::this_thread::yield();
+            cell.tDatums = tDatums;
+            if (mBackpressurePolicy.load(std::memory_order_relaxed) == BackpressurePolicy::LatencyTarget)
+                cell.pushTime = std::chrono::steady_clock::now();
+            cell.sequence.store(position+1, std::memory_order_release);
+            notifyWaiters();
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    bool LockFreeQueue<TDatums>::pop(TDatums& tDatums, const bool ignoreStop)
+    {
+        try
+        {
+            if (mPopIsStopped && !ignoreStop)
+                return false;
+            // Claim the next cell (if already pushed)
+            auto position = mPopPosition.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true)
+            {
+                cell = &upCells[position & (mCapacity-1)];
+                const auto sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto difference = (long long)(sequence - (position+1));
+                if (difference == 0)
+                {
+                    if (mPopPosition.compare_exchange_weak(position, position+1, std::memory_order_relaxed))
+                        break;
+                }
+                // Empty (or its next element is still being pushed)
+                else if (difference < 0)
+                    return false;
+                else
+                    position = mPopPosition.load(std::memory_order_relaxed);
+            }
+            tDatums = {std::move(cell->tDatums)};
+            cell->tDatums = TDatums{};
+            const auto pushTime = cell->pushTime;
+            // Release the cell for the pusher of the next lap
+            cell->sequence.store(position+mCapacity, std::memory_order_release);
+            mSize--;
+            notifyWaiters();
+            // Discarded elements (ignoreStop) do not count for the latency
+            if (!ignoreStop && mBackpressurePolicy.load(std::memory_order_relaxed) == BackpressurePolicy::LatencyTarget)
+                updateLatency(pushTime);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::updateMaxPoppersPushers()
+    {
+        try
+        {
+            mMaxPoppersPushers = fastMax(mPoppers.load(), mPushers.load());
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::notifyWaiters(const bool forceNotify)
+    {
+        try
+        {
+            // The waiters increase mWaiters before checking their predicate (and the pushers/poppers modify mSize
+            // before reading mWaiters), so either the waiter sees the new state or the mutex is locked here
+            if (forceNotify || mWaiters.load() > 0)
+            {
+                const std::lock_guard<std::mutex> lock{mWaitMutex};
+                mConditionVariable.notify_all();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void LockFreeQueue<TDatums>::updateLatency(const std::chrono::steady_clock::time_point& pushTime)
+    {
+        try
+        {
+            // Same algorithm as QueueBase. Samples are skipped while other popper holds the lock
+            std::unique_lock<std::mutex> lock{mBackpressureMutex, std::try_to_lock};
+            if (!lock.owns_lock() || pushTime == std::chrono::steady_clock::time_point{})
+                return;
+            const auto now = std::chrono::steady_clock::now();
+            const auto latencyNanoseconds = double(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - pushTime).count());
+            const auto previousLatencyNanoseconds = mLatencyNanoseconds.load(std::memory_order_relaxed);
+            const auto averageLatencyNanoseconds = (previousLatencyNanoseconds == 0.
+                ? latencyNanoseconds : 0.9 * previousLatencyNanoseconds + 0.1 * latencyNanoseconds);
+            mLatencyNanoseconds.store(averageLatencyNanoseconds, std::memory_order_relaxed);
+            // At most 1 update per latency target
+            if (now < mNextMaxSizeUpdate)
+                return;
+            mNextMaxSizeUpdate = now + fastMax(mLatencyTarget, std::chrono::nanoseconds{std::chrono::milliseconds{1}});
+            const auto maxSize = (long long)getMaxSize();
+            const auto initialMaxSize = (long long)fastMin(
+                mCapacity, (unsigned long long)(mMaxSize > 0 ? mMaxSize : fastMax(1ll, mMaxPoppersPushers.load())));
+            if (averageLatencyNanoseconds > mLatencyTarget.count() && maxSize > 1)
+            {
+                mAdaptiveMaxSize = fastMax(1ll, fastMin(maxSize, mSize.load()+1ll) / 2ll);
+                mMaxSizeDecreases++;
+            }
+            else if (averageLatencyNanoseconds < 0.5 * mLatencyTarget.count() && maxSize < initialMaxSize)
+            {
+                mAdaptiveMaxSize = maxSize + 1ll;
+                mMaxSizeIncreases++;
+                lock.unlock();
+                notifyWaiters();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    template<typename TPredicate>
+    bool LockFreeQueue<TDatums>::waitFor(
+        const std::chrono::microseconds& timeout, TPredicate predicate,
+        std::atomic<unsigned long long>& blockedNanoseconds)
+    {
+        try
+        {
+            if (predicate())
+                return true;
+            const auto begin = std::chrono::steady_clock::now();
+            const auto addBlockedTime = [&]
+            {
+                blockedNanoseconds += (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - begin).count();
+            };
+            // Spin first (as QueueBase)
+            const auto spinEnd = std::chrono::steady_clock::now() + fastMin(timeout, std::chrono::microseconds{20});
+            while (!predicate() && std::chrono::steady_clock::now() < spinEnd)
+                std::this_thread::yield();
+            if (predicate())
+            {
+                addBlockedTime();
+                return true;
+            }
+            // Park
+            std::unique_lock<std::mutex> lock{mWaitMutex};
+            mWaiters++;
+            const auto result = mConditionVariable.wait_for(lock, timeout, predicate);
+            mWaiters--;
+            addBlockedTime();
+            return result;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    COMPILE_TEMPLATE_DATUM(LockFreeQueue);
+}
+
+#endif // OPENPOSE_THREAD_LOCK_FREE_QUEUE_HPP
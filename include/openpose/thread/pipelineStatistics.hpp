@@ -0,0 +1,119 @@
+#ifndef OPENPOSE_THREAD_PIPELINE_STATISTICS_HPP
+#define OPENPOSE_THREAD_PIPELINE_STATISTICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include <openpose/core/macros.hpp>
+
+namespace op
+{
+    /**
+     * Counters of a ThreadManager queue (Queue, PriorityQueue or LockFreeQueue) since it was created.
+     * Rates (e.g., pushes per second) are obtained by dividing the difference of 2 readings by their time difference
+     * (e.g., `rate()` in Prometheus).
+     */
+    struct OP_API QueueStatistics
+    {
+        unsigned long long queueId;     /**< Queue ID (as given to ThreadManager::add()). */
+        unsigned long long size;        /**< Current number of elements. */
+        unsigned long long maxSize;     /**< Current maximum number of elements. */
+        unsigned long long highWaterMark; /**< Maximum number of elements it has held at once. */
+        unsigned long long pushed;      /**< Number of elements pushed or emplaced. */
+        unsigned long long popped;      /**< Number of elements popped. */
+        /**
+         * Number of elements discarded by forceEmplace(), forcePush(), clear(), or emplaceByPolicy() (with
+         * BackpressurePolicy::DropOldest or DropNewest).
+         */
+        unsigned long long dropped;
+        double pushBlockedSeconds;      /**< Time that the pushers waited because it was full. */
+        double popBlockedSeconds;       /**< Time that the poppers waited because it was empty. */
+        /**
+         * Number of times that BackpressurePolicy::LatencyTarget decreased or increased its maximum size.
+         */
+        unsigned long long maxSizeDecreases;
+        unsigned long long maxSizeIncreases;
+        /**
+         * Average time (exponential moving average) that its elements waited (only measured with
+         * BackpressurePolicy::LatencyTarget).
+         */
+        double latencySeconds;
+
+        QueueStatistics();
+    };
+
+    /**
+     * Service time of a Worker (i.e., time spent in its work() function with a non-empty frame).
+     */
+    struct OP_API WorkerStatistics
+    {
+        unsigned long long threadId;    /**< ID of the thread running it (as given to ThreadManager::add()). */
+        std::string name;               /**< Worker class name (e.g., "WPoseExtractor"). */
+        unsigned long long count;       /**< Number of frames processed. */
+        double serviceSeconds;          /**< Total time processing them. */
+        /**
+         * Number of frames whose service time was in each bucket of getServiceTimeBucketsSeconds() (i.e., in
+         * (bucket[i-1], bucket[i]]), plus a last element for the ones slower than the last bucket.
+         */
+        std::vector<unsigned long long> histogram;
+
+        WorkerStatistics();
+    };
+
+    struct OP_API PipelineStatistics
+    {
+        std::vector<QueueStatistics> queues;
+        std::vector<WorkerStatistics> workers;
+    };
+
+    /**
+     * Upper bounds (in seconds) of the WorkerStatistics histogram buckets, from 100 usec to 2.5 seconds.
+     */
+    OP_API const std::vector<double>& getServiceTimeBucketsSeconds();
+
+    /**
+     * It returns the statistics in the Prometheus text exposition format (`openpose_queue_*` and
+     * `openpose_worker_*` metrics, labeled by queue and thread IDs and worker name).
+     */
+    OP_API std::string pipelineStatisticsToPrometheus(const PipelineStatistics& pipelineStatistics);
+
+    /**
+     * It saves pipelineStatisticsToPrometheus() into filePath. It writes a temporary file and renames it, so readers
+     * (e.g., the textfile collector of the Prometheus node_exporter) never see a partial file.
+     */
+    OP_API void savePipelineStatistics(const PipelineStatistics& pipelineStatistics, const std::string& filePath);
+
+    /**
+     * Class name without namespace nor template arguments (e.g., "WPoseExtractor" for
+     * `typeid(op::WPoseExtractor<...>)`).
+     */
+    OP_API std::string getClassName(const std::type_info& typeInfo);
+
+    /**
+     * Lock-free accumulator of the service times of a Worker. record() must be called from a single thread, while
+     * fill() can be called from any thread.
+     */
+    class OP_API ServiceTimeRecorder
+    {
+    public:
+        ServiceTimeRecorder();
+
+        void record(const std::chrono::nanoseconds& serviceTime);
+
+        void fill(WorkerStatistics& workerStatistics) const;
+
+    private:
+        // getServiceTimeBucketsSeconds().size() + 1
+        static const auto NUMBER_BUCKETS = 15u;
+        std::atomic<unsigned long long> mCount;
+        std::atomic<unsigned long long> mNanoseconds;
+        std::array<std::atomic<unsigned long long>, NUMBER_BUCKETS> mHistogram;
+
+        DELETE_COPY(ServiceTimeRecorder);
+    };
+}
+
+#endif // OPENPOSE_THREAD_PIPELINE_STATISTICS_HPP
@@ -72,7 +72,7 @@ namespace op
 
             tDatums = {std::move(this->mTQueue.top())};
             this->mTQueue.pop();
-            this->mConditionVariable.notify_one();
+            this->mConditionVariable.notify_all();
             return true;
         }
         catch (const std::exception& e)
@@ -1,10 +1,15 @@
 #ifndef OPENPOSE_THREAD_QUEUE_BASE_HPP
 #define OPENPOSE_THREAD_QUEUE_BASE_HPP
 
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
 #include <queue> // std::queue & std::priority_queue
 #include <openpose/core/common.hpp>
+#include <openpose/thread/enumClasses.hpp>
+#include <openpose/thread/pipelineStatistics.hpp>
 
 namespace op
 {
@@ -28,6 +33,34 @@ namespace op
 
         bool waitAndPush(const TDatums& tDatums);
 
+        /**
+         * It sets what emplaceByPolicy() does when the queue is full (BackpressurePolicy::Block by default). With
+         * BackpressurePolicy::LatencyTarget, the maximum size adapts (between 1 and its initial value) so the
+         * average time an element waits in this queue stays under `latencyTargetSeconds`. It must be called before
+         * the queue is used.
+         */
+        void setBackpressurePolicy(
+            const BackpressurePolicy backpressurePolicy, const double latencyTargetSeconds = 0.);
+
+        BackpressurePolicy getBackpressurePolicy() const;
+
+        /**
+         * Function called with each element discarded to make room for a new one (forceEmplace(), forcePush(), and
+         * emplaceByPolicy() with BackpressurePolicy::DropOldest) or rejected by emplaceByPolicy() with DropNewest,
+         * e.g., so WQueueOrderer does not wait for their frame IDs. It is not called by clear(). It is called from the
+         * pushing thread while holding the queue mutex (so no later element can be popped before it is reported), so
+         * it must be fast and it must not use this queue. It must be called before the queue is used.
+         */
+        void setDroppedCallback(const std::function<void(const TDatums&)>& droppedCallback);
+
+        /**
+         * It emplaces tDatums following the BackpressurePolicy: waitAndEmplace() for Block and LatencyTarget,
+         * forceEmplace() for DropOldest, and tryEmplace() for DropNewest (counting tDatums as dropped if the queue
+         * is full).
+         * @return Whether tDatums was emplaced.
+         */
+        bool emplaceByPolicy(TDatums& tDatums);
+
         bool tryPop(TDatums& tDatums);
 
         bool tryPop();
@@ -36,6 +69,20 @@ namespace op
 
         bool waitAndPop();
 
+        /**
+         * Event-driven alternative to tryPop() (see ThreadSchedulingMode::EventDriven). It briefly spins and then
+         * blocks until an element is available, the queue is stopped, or `timeout` expires.
+         * @return Whether an element was popped.
+         */
+        bool tryPopFor(TDatums& tDatums, const std::chrono::microseconds& timeout);
+
+        /**
+         * Analogous to tryPopFor(), but it waits until the queue is not full (i.e., until an element could be
+         * pushed).
+         * @return Whether the queue is not full.
+         */
+        bool waitUntilNotFull(const std::chrono::microseconds& timeout);
+
         bool empty() const;
 
         void stop();
@@ -54,6 +101,11 @@ namespace op
 
         void clear();
 
+        /**
+         * Counters of this queue (its queueId is left to 0). Thread-safe.
+         */
+        QueueStatistics getStatistics() const;
+
         virtual TDatums front() const = 0;
 
     protected:
@@ -72,6 +124,24 @@ namespace op
 
     private:
         const long long mMaxSize;
+        // Statistics (protected by mMutex)
+        unsigned long long mPushed;
+        unsigned long long mPopped;
+        unsigned long long mDropped;
+        unsigned long long mHighWaterMark;
+        unsigned long long mPushBlockedNanoseconds;
+        unsigned long long mPopBlockedNanoseconds;
+        unsigned long long mMaxSizeDecreases;
+        unsigned long long mMaxSizeIncreases;
+        // Backpressure (protected by mMutex)
+        BackpressurePolicy mBackpressurePolicy;
+        std::chrono::nanoseconds mLatencyTarget;
+        long long mAdaptiveMaxSize;
+        double mLatencyNanoseconds;
+        std::chrono::steady_clock::time_point mNextMaxSizeUpdate;
+        // Push time of each queued element (only for BackpressurePolicy::LatencyTarget)
+        std::deque<std::chrono::steady_clock::time_point> mPushTimes;
+        std::function<void(const TDatums&)> mDroppedCallback;
 
         bool emplace(TDatums& tDatums);
 
@@ -79,8 +149,27 @@ namespace op
 
         bool pop();
 
+        // It discards the oldest element (the queue must not be empty) and reports it to mDroppedCallback
+        void dropOldest();
+
+        bool popAndCount(TDatums& tDatums);
+
+        void recordPush();
+
+        void recordPop(const bool dropped);
+
+        void updateMaxSize(const std::chrono::steady_clock::time_point& now);
+
         void updateMaxPoppersPushers();
 
+        template<typename TPredicate>
+        void wait(std::unique_lock<std::mutex>& lock, TPredicate predicate, unsigned long long& blockedNanoseconds);
+
+        template<typename TPredicate>
+        bool spinAndWait(
+            std::unique_lock<std::mutex>& lock, const std::chrono::microseconds& timeout, TPredicate predicate,
+            unsigned long long& blockedNanoseconds);
+
         DELETE_COPY(QueueBase);
     };
 }
@@ -90,6 +179,7 @@ namespace op
 
 
 // Implementation
+#include <thread> // std::this_thread
 #include <openpose/core/datum.hpp>
 #include <openpose/utilities/fastMath.hpp>
 namespace op
@@ -100,7 +190,19 @@ namespace op
         mPushers{0ll},
         mPopIsStopped{false},
         mPushIsStopped{false},
-        mMaxSize{maxSize}
+        mMaxSize{maxSize},
+        mPushed{0ull},
+        mPopped{0ull},
+        mDropped{0ull},
+        mHighWaterMark{0ull},
+        mPushBlockedNanoseconds{0ull},
+        mPopBlockedNanoseconds{0ull},
+        mMaxSizeDecreases{0ull},
+        mMaxSizeIncreases{0ull},
+        mBackpressurePolicy{BackpressurePolicy::Block},
+        mLatencyTarget{0},
+        mAdaptiveMaxSize{-1ll},
+        mLatencyNanoseconds{0.}
     {
     }
 
@@ -127,7 +229,7 @@ namespace op
         {
             const std::lock_guard<std::mutex> lock{mMutex};
             if (mTQueue.size() >= getMaxSize())
-                mTQueue.pop();
+                dropOldest();
             return emplace(tDatums);
         }
         catch (const std::exception& e)
@@ -160,7 +262,7 @@ namespace op
         try
         {
             std::unique_lock<std::mutex> lock{mMutex};
-            mConditionVariable.wait(lock, [this]{return mTQueue.size() < getMaxSize() || mPushIsStopped; });
+            wait(lock, [this]{return mTQueue.size() < getMaxSize() || mPushIsStopped; }, mPushBlockedNanoseconds);
             return emplace(tDatums);
         }
         catch (const std::exception& e)
@@ -177,7 +279,7 @@ namespace op
         {
             const std::lock_guard<std::mutex> lock{mMutex};
             if (mTQueue.size() >= getMaxSize())
-                mTQueue.pop();
+                dropOldest();
             return push(tDatums);
         }
         catch (const std::exception& e)
@@ -210,7 +312,7 @@ namespace op
         try
         {
             std::unique_lock<std::mutex> lock{mMutex};
-            mConditionVariable.wait(lock, [this]{return mTQueue.size() < getMaxSize() || mPushIsStopped; });
+            wait(lock, [this]{return mTQueue.size() < getMaxSize() || mPushIsStopped; }, mPushBlockedNanoseconds);
             return push(tDatums);
         }
         catch (const std::exception& e)
@@ -220,13 +322,94 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TQueue>
+    void QueueBase<TDatums, TQueue>::setBackpressurePolicy(
+        const BackpressurePolicy backpressurePolicy, const double latencyTargetSeconds)
+    {
+        try
+        {
+            if (backpressurePolicy == BackpressurePolicy::LatencyTarget && latencyTargetSeconds <= 0.)
+                error("BackpressurePolicy::LatencyTarget requires a positive latency target.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            const std::lock_guard<std::mutex> lock{mMutex};
+            mBackpressurePolicy = {backpressurePolicy};
+            mLatencyTarget = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::duration<double>{latencyTargetSeconds});
+            mAdaptiveMaxSize = -1ll;
+            mPushTimes.clear();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    BackpressurePolicy QueueBase<TDatums, TQueue>::getBackpressurePolicy() const
+    {
+        try
+        {
+            const std::lock_guard<std::mutex> lock{mMutex};
+            return mBackpressurePolicy;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return BackpressurePolicy::Block;
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    void QueueBase<TDatums, TQueue>::setDroppedCallback(const std::function<void(const TDatums&)>& droppedCallback)
+    {
+        try
+        {
+            const std::lock_guard<std::mutex> lock{mMutex};
+            mDroppedCallback = {droppedCallback};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    bool QueueBase<TDatums, TQueue>::emplaceByPolicy(TDatums& tDatums)
+    {
+        try
+        {
+            const auto backpressurePolicy = getBackpressurePolicy();
+            if (backpressurePolicy == BackpressurePolicy::DropOldest)
+                return forceEmplace(tDatums);
+            else if (backpressurePolicy == BackpressurePolicy::DropNewest)
+            {
+                const std::lock_guard<std::mutex> lock{mMutex};
+                if (mTQueue.size() >= getMaxSize())
+                {
+                    mDropped++;
+                    if (mDroppedCallback)
+                        mDroppedCallback(tDatums);
+                    return false;
+                }
+                return emplace(tDatums);
+            }
+            else
+                return waitAndEmplace(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
     template<typename TDatums, typename TQueue>
     bool QueueBase<TDatums, TQueue>::tryPop(TDatums& tDatums)
     {
         try
         {
             const std::lock_guard<std::mutex> lock{mMutex};
-            return pop(tDatums);
+            return popAndCount(tDatums);
         }
         catch (const std::exception& e)
         {
@@ -256,8 +439,8 @@ namespace op
         try
         {
             std::unique_lock<std::mutex> lock{mMutex};
-            mConditionVariable.wait(lock, [this]{return !mTQueue.empty() || mPopIsStopped; });
-            return pop(tDatums);
+            wait(lock, [this]{return !mTQueue.empty() || mPopIsStopped; }, mPopBlockedNanoseconds);
+            return popAndCount(tDatums);
         }
         catch (const std::exception& e)
         {
@@ -272,7 +455,7 @@ namespace op
         try
         {
             std::unique_lock<std::mutex> lock{mMutex};
-            mConditionVariable.wait(lock, [this]{return !mTQueue.empty() || mPopIsStopped; });
+            wait(lock, [this]{return !mTQueue.empty() || mPopIsStopped; }, mPopBlockedNanoseconds);
             return pop();
         }
         catch (const std::exception& e)
@@ -282,6 +465,41 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TQueue>
+    bool QueueBase<TDatums, TQueue>::tryPopFor(TDatums& tDatums, const std::chrono::microseconds& timeout)
+    {
+        try
+        {
+            std::unique_lock<std::mutex> lock{mMutex};
+            // No more elements will arrive if the pushers are stopped
+            spinAndWait(lock, timeout, [this]{ return !mTQueue.empty() || mPopIsStopped || mPushIsStopped; },
+                        mPopBlockedNanoseconds);
+            return popAndCount(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    bool QueueBase<TDatums, TQueue>::waitUntilNotFull(const std::chrono::microseconds& timeout)
+    {
+        try
+        {
+            std::unique_lock<std::mutex> lock{mMutex};
+            spinAndWait(lock, timeout, [this]{ return mTQueue.size() < getMaxSize() || mPushIsStopped; },
+                        mPushBlockedNanoseconds);
+            return mTQueue.size() < getMaxSize();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
     template<typename TDatums, typename TQueue>
     bool QueueBase<TDatums, TQueue>::empty() const
     {
@@ -422,11 +640,41 @@ namespace op
         {
             const std::lock_guard<std::mutex> lock{mMutex};
             while (!mTQueue.empty())
+            {
                 mTQueue.pop();
+                recordPop(true);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    QueueStatistics QueueBase<TDatums, TQueue>::getStatistics() const
+    {
+        try
+        {
+            const std::lock_guard<std::mutex> lock{mMutex};
+            QueueStatistics queueStatistics;
+            queueStatistics.size = mTQueue.size();
+            queueStatistics.maxSize = getMaxSize();
+            queueStatistics.highWaterMark = mHighWaterMark;
+            queueStatistics.pushed = mPushed;
+            queueStatistics.popped = mPopped;
+            queueStatistics.dropped = mDropped;
+            queueStatistics.pushBlockedSeconds = 1e-9 * mPushBlockedNanoseconds;
+            queueStatistics.popBlockedSeconds = 1e-9 * mPopBlockedNanoseconds;
+            queueStatistics.maxSizeDecreases = mMaxSizeDecreases;
+            queueStatistics.maxSizeIncreases = mMaxSizeIncreases;
+            queueStatistics.latencySeconds = 1e-9 * mLatencyNanoseconds;
+            return queueStatistics;
         }
         catch (const std::exception& e)
         {
             error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return QueueStatistics{};
         }
     }
 
@@ -435,7 +683,8 @@ namespace op
     {
         try
         {
-            return (mMaxSize > 0 ? mMaxSize : fastMax(1ll, mMaxPoppersPushers));
+            const auto maxSize = (mMaxSize > 0 ? mMaxSize : fastMax(1ll, mMaxPoppersPushers));
+            return (mAdaptiveMaxSize > 0 ? fastMin(mAdaptiveMaxSize, maxSize) : maxSize);
         }
         catch (const std::exception& e)
         {
@@ -453,6 +702,7 @@ namespace op
                 return false;
 
             mTQueue.emplace(tDatums);
+            recordPush();
             mConditionVariable.notify_all();
             return true;
         }
@@ -472,6 +722,7 @@ namespace op
                 return false;
 
             mTQueue.push(tDatums);
+            recordPush();
             mConditionVariable.notify_all();
             return true;
         }
@@ -491,6 +742,7 @@ namespace op
                 return false;
 
             mTQueue.pop();
+            recordPop(false);
             mConditionVariable.notify_all();
             return true;
         }
@@ -501,6 +753,123 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TQueue>
+    void QueueBase<TDatums, TQueue>::dropOldest()
+    {
+        try
+        {
+            TDatums tDatumsDropped;
+            // pop(tDatums) fails if the poppers were stopped
+            if (!pop(tDatumsDropped))
+                mTQueue.pop();
+            recordPop(true);
+            if (mDroppedCallback)
+                mDroppedCallback(tDatumsDropped);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    bool QueueBase<TDatums, TQueue>::popAndCount(TDatums& tDatums)
+    {
+        try
+        {
+            const auto popped = pop(tDatums);
+            if (popped)
+                recordPop(false);
+            return popped;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    void QueueBase<TDatums, TQueue>::recordPush()
+    {
+        try
+        {
+            mPushed++;
+            mHighWaterMark = fastMax(mHighWaterMark, (unsigned long long)mTQueue.size());
+            if (mBackpressurePolicy == BackpressurePolicy::LatencyTarget)
+                mPushTimes.emplace_back(std::chrono::steady_clock::now());
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    void QueueBase<TDatums, TQueue>::recordPop(const bool dropped)
+    {
+        try
+        {
+            if (dropped)
+                mDropped++;
+            else
+                mPopped++;
+            // Waiting time (for PriorityQueue, it assumes that the popped element is the oldest one, which holds as
+            // long as the frame IDs increase with time)
+            if (!mPushTimes.empty())
+            {
+                const auto pushTime = mPushTimes.front();
+                mPushTimes.pop_front();
+                if (!dropped)
+                {
+                    const auto now = std::chrono::steady_clock::now();
+                    const auto latencyNanoseconds = double(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(now - pushTime).count());
+                    // Exponential moving average
+                    mLatencyNanoseconds = (mLatencyNanoseconds == 0.
+                        ? latencyNanoseconds : 0.9 * mLatencyNanoseconds + 0.1 * latencyNanoseconds);
+                    updateMaxSize(now);
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    void QueueBase<TDatums, TQueue>::updateMaxSize(const std::chrono::steady_clock::time_point& now)
+    {
+        try
+        {
+            // At most 1 update per latency target, so the effect of the previous one is already measured
+            if (now < mNextMaxSizeUpdate)
+                return;
+            mNextMaxSizeUpdate = now + fastMax(mLatencyTarget, std::chrono::nanoseconds{std::chrono::milliseconds{1}});
+            const auto maxSize = (long long)getMaxSize();
+            const auto initialMaxSize = (mMaxSize > 0 ? mMaxSize : fastMax(1ll, mMaxPoppersPushers));
+            // Too slow: multiplicative decrease (from the current number of elements if lower, e.g., if the initial
+            // maximum size is huge)
+            if (mLatencyNanoseconds > mLatencyTarget.count() && maxSize > 1)
+            {
+                mAdaptiveMaxSize = fastMax(1ll, fastMin(maxSize, (long long)mTQueue.size()+1ll) / 2ll);
+                mMaxSizeDecreases++;
+            }
+            // Fast enough: additive increase
+            else if (mLatencyNanoseconds < 0.5 * mLatencyTarget.count() && maxSize < initialMaxSize)
+            {
+                mAdaptiveMaxSize = maxSize + 1ll;
+                mMaxSizeIncreases++;
+                mConditionVariable.notify_all();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template<typename TDatums, typename TQueue>
     void QueueBase<TDatums, TQueue>::updateMaxPoppersPushers()
     {
@@ -514,6 +883,61 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TQueue>
+    template<typename TPredicate>
+    void QueueBase<TDatums, TQueue>::wait(
+        std::unique_lock<std::mutex>& lock, TPredicate predicate, unsigned long long& blockedNanoseconds)
+    {
+        try
+        {
+            if (!predicate())
+            {
+                const auto begin = std::chrono::steady_clock::now();
+                mConditionVariable.wait(lock, predicate);
+                blockedNanoseconds += (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - begin).count();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TQueue>
+    template<typename TPredicate>
+    bool QueueBase<TDatums, TQueue>::spinAndWait(
+        std::unique_lock<std::mutex>& lock, const std::chrono::microseconds& timeout, TPredicate predicate,
+        unsigned long long& blockedNanoseconds)
+    {
+        try
+        {
+            if (predicate())
+                return true;
+            const auto begin = std::chrono::steady_clock::now();
+            // Spin: under load, the next element usually arrives within a few microseconds, and parking and waking
+            // up a thread costs about that much
+            const auto spinEnd = std::chrono::steady_clock::now()
+                + fastMin(timeout, std::chrono::microseconds{20});
+            while (!predicate() && std::chrono::steady_clock::now() < spinEnd)
+            {
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+            // Park until notified (push, pop or stop) or timeout
+            const auto result = mConditionVariable.wait_for(lock, timeout, predicate);
+            blockedNanoseconds += (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+            return result;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
     extern template class QueueBase<BASE_DATUMS_SH, std::queue<BASE_DATUMS_SH>>;
     extern template class QueueBase<
         BASE_DATUMS_SH,
@@ -1,7 +1,12 @@
 #ifndef OPENPOSE_THREAD_SUB_THREAD_HPP
 #define OPENPOSE_THREAD_SUB_THREAD_HPP
 
+#include <algorithm> // std::max, std::min
+#include <chrono>
+#include <thread> // std::this_thread
 #include <openpose/core/common.hpp>
+#include <openpose/thread/enumClasses.hpp>
+#include <openpose/thread/pipelineStatistics.hpp>
 #include <openpose/thread/worker.hpp>
 
 namespace op
@@ -19,6 +24,17 @@ namespace op
 
         virtual bool work() = 0;
 
+        /**
+         * ThreadSchedulingMode::Polling by default. ThreadSchedulingMode::EventDriven must only be set if this is the
+         * only SubThread of its Thread, as it blocks on its queues.
+         */
+        void setThreadSchedulingMode(const ThreadSchedulingMode threadSchedulingMode);
+
+        /**
+         * Service time statistics of each TWorker (with threadId left to 0). Thread-safe.
+         */
+        std::vector<WorkerStatistics> getWorkerStatistics() const;
+
     protected:
         inline size_t getTWorkersSize() const
         {
@@ -27,8 +43,29 @@ namespace op
 
         bool workTWorkers(TDatums& tDatums, const bool inputIsRunning);
 
+        /**
+         * It pops an element from tQueueIn. Polling: It sleeps 100 usec first if the queue is empty. EventDriven: It
+         * waits until an element is available (or the queue is stopped, or a timeout expires, or the earliest TWorker
+         * getDeadline() is reached). It does not wait if any TWorker hasPendingOutput().
+         * @return Whether an element was popped.
+         */
+        template<typename TQueue>
+        bool popFromQueue(TQueue& tQueueIn, TDatums& tDatums);
+
+        /**
+         * Polling: If tQueueOut is full, it sleeps 100 usec. EventDriven: It waits until tQueueOut is not full (or
+         * it is stopped, or a timeout expires). It does not wait if the tQueueOut BackpressurePolicy drops frames
+         * (i.e., the TWorkers keep producing, and tQueueOut discards the frames that do not fit).
+         * @return Whether tQueueOut is not full (or it drops frames).
+         */
+        template<typename TQueue>
+        bool waitUntilQueueNotFull(TQueue& tQueueOut);
+
     private:
         std::vector<TWorker> mTWorkers;
+        ThreadSchedulingMode mThreadSchedulingMode;
+        std::vector<std::string> mTWorkerNames;
+        std::vector<std::unique_ptr<ServiceTimeRecorder>> mServiceTimeRecorders;
 
         DELETE_COPY(SubThread);
     };
@@ -43,8 +80,21 @@ namespace op
 {
     template<typename TDatums, typename TWorker>
     SubThread<TDatums, TWorker>::SubThread(const std::vector<TWorker>& tWorkers) :
-        mTWorkers{tWorkers}
+        mTWorkers{tWorkers},
+        mThreadSchedulingMode{ThreadSchedulingMode::Polling}
     {
+        try
+        {
+            for (const auto& tWorker : mTWorkers)
+            {
+                mTWorkerNames.emplace_back(getClassName(typeid(*tWorker)));
+                mServiceTimeRecorders.emplace_back(new ServiceTimeRecorder{});
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
     }
 
     template<typename TDatums, typename TWorker>
@@ -52,6 +102,39 @@ namespace op
     {
     }
 
+    template<typename TDatums, typename TWorker>
+    void SubThread<TDatums, TWorker>::setThreadSchedulingMode(const ThreadSchedulingMode threadSchedulingMode)
+    {
+        try
+        {
+            mThreadSchedulingMode = {threadSchedulingMode};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TWorker>
+    std::vector<WorkerStatistics> SubThread<TDatums, TWorker>::getWorkerStatistics() const
+    {
+        try
+        {
+            std::vector<WorkerStatistics> workerStatistics(mTWorkers.size());
+            for (auto i = 0u ; i < workerStatistics.size() ; i++)
+            {
+                workerStatistics[i].name = mTWorkerNames[i];
+                mServiceTimeRecorders[i]->fill(workerStatistics[i]);
+            }
+            return workerStatistics;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
     template<typename TDatums, typename TWorker>
     bool SubThread<TDatums, TWorker>::workTWorkers(TDatums& tDatums, const bool inputIsRunning)
     {
@@ -74,12 +157,20 @@ namespace op
                 // Iterate over all workers and check whether some of them stopped
                 auto allRunning = true;
                 auto lastOneStopped = false;
-                for (auto& worker : mTWorkers)
+                for (auto i = 0u ; i < mTWorkers.size() ; i++)
                 {
+                    auto& worker = mTWorkers[i];
                     if (lastOneStopped)
                         worker->tryStop();
 
-                    if (!worker->checkAndWork(tDatums))
+                    // Service time statistics (only for the calls that consumed or produced a frame)
+                    const auto hadDatums = (tDatums != nullptr);
+                    const auto begin = std::chrono::steady_clock::now();
+                    const auto workerIsRunning = worker->checkAndWork(tDatums);
+                    if (hadDatums || tDatums != nullptr)
+                        mServiceTimeRecorders[i]->record(std::chrono::steady_clock::now() - begin);
+
+                    if (!workerIsRunning)
                     {
                         allRunning = false;
                         lastOneStopped = true;
@@ -151,6 +242,67 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TWorker>
+    template<typename TQueue>
+    bool SubThread<TDatums, TWorker>::popFromQueue(TQueue& tQueueIn, TDatums& tDatums)
+    {
+        try
+        {
+            // A TWorker already has frames to return (e.g., WQueueOrderer) -> do not wait for new ones
+            for (const auto& tWorker : mTWorkers)
+                if (tWorker->hasPendingOutput())
+                    return tQueueIn.tryPop(tDatums);
+            // Blocking wait. The timeout keeps calling the workers (with empty TDatums) while idle, as some of them
+            // rely on it (e.g., WQueueOrderer releasing its buffer when stopping). It is shortened if any TWorker
+            // has an earlier deadline (e.g., WPoseExtractor batch window)
+            if (mThreadSchedulingMode == ThreadSchedulingMode::EventDriven)
+            {
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{10};
+                for (const auto& tWorker : mTWorkers)
+                    deadline = std::min(deadline, tWorker->getDeadline());
+                const auto timeout = std::chrono::duration_cast<std::chrono::microseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                return tQueueIn.tryPopFor(tDatums, std::max(timeout, std::chrono::microseconds{0}));
+            }
+            // Polling
+            if (tQueueIn.empty())
+                std::this_thread::sleep_for(std::chrono::microseconds{100});
+            return tQueueIn.tryPop(tDatums);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums, typename TWorker>
+    template<typename TQueue>
+    bool SubThread<TDatums, TWorker>::waitUntilQueueNotFull(TQueue& tQueueOut)
+    {
+        try
+        {
+            // No wait (tQueueOut.emplaceByPolicy() will drop a frame if full)
+            const auto backpressurePolicy = tQueueOut.getBackpressurePolicy();
+            if (backpressurePolicy == BackpressurePolicy::DropOldest
+                || backpressurePolicy == BackpressurePolicy::DropNewest)
+                return true;
+            // Blocking wait
+            if (mThreadSchedulingMode == ThreadSchedulingMode::EventDriven)
+                return tQueueOut.waitUntilNotFull(std::chrono::milliseconds{10});
+            // Polling
+            if (!tQueueOut.isFull())
+                return true;
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+            return false;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
     COMPILE_TEMPLATE_DATUM(SubThread);
 }
 
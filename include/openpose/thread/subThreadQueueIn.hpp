@@ -52,10 +52,8 @@ namespace op
         try
         {
             // Pop TDatums
-            if (spTQueueIn->empty())
-                std::this_thread::sleep_for(std::chrono::microseconds{100});
             TDatums tDatums;
-            bool queueIsRunning = spTQueueIn->tryPop(tDatums);
+            bool queueIsRunning = this->popFromQueue(*spTQueueIn, tDatums);
             // Check queue not empty
             if (!queueIsRunning)
                 queueIsRunning = spTQueueIn->isRunning();
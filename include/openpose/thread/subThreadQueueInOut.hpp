@@ -67,13 +67,11 @@ namespace op
             {
                 // Don't work until next queue is not full
                 // This reduces latency to half
-                if (!spTQueueOut->isFull())
+                if (this->waitUntilQueueNotFull(*spTQueueOut))
                 {
                     // Pop TDatums
-                    if (spTQueueIn->empty())
-                        std::this_thread::sleep_for(std::chrono::microseconds{100});
                     TDatums tDatums;
-                    bool workersAreRunning = spTQueueIn->tryPop(tDatums);
+                    bool workersAreRunning = this->popFromQueue(*spTQueueIn, tDatums);
                     // Check queue not stopped
                     if (!workersAreRunning)
                         workersAreRunning = spTQueueIn->isRunning();
@@ -83,7 +81,7 @@ namespace op
                     if (workersAreRunning)
                     {
                         if (tDatums != nullptr)
-                            spTQueueOut->waitAndEmplace(tDatums);
+                            spTQueueOut->emplaceByPolicy(tDatums);
                     }
                     // Close both queues otherwise
                     else
@@ -94,10 +92,7 @@ namespace op
                     return workersAreRunning;
                 }
                 else
-                {
-                    std::this_thread::sleep_for(std::chrono::microseconds{100});
                     return true;
-                }
             }
         }
         catch (const std::exception& e)
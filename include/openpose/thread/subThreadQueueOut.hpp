@@ -58,7 +58,7 @@ namespace op
             {
                 // Don't work until next queue is not full
                 // This reduces latency to half
-                if (!spTQueueOut->isFull())
+                if (this->waitUntilQueueNotFull(*spTQueueOut))
                 {
                     // Process TDatums
                     TDatums tDatums;
@@ -67,7 +67,7 @@ namespace op
                     if (workersAreRunning)
                     {
                         if (tDatums != nullptr)
-                            spTQueueOut->waitAndEmplace(tDatums);
+                            spTQueueOut->emplaceByPolicy(tDatums);
                     }
                     // Close queue otherwise
                     else
@@ -75,10 +75,7 @@ namespace op
                     return workersAreRunning;
                 }
                 else
-                {
-                    std::this_thread::sleep_for(std::chrono::microseconds{100});
                     return true;
-                }
             }
         }
         catch (const std::exception& e)
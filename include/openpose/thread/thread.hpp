@@ -4,6 +4,7 @@
 #include <atomic>
 #include <openpose/core/common.hpp>
 #include <openpose/thread/subThread.hpp>
+#include <openpose/thread/threadAffinity.hpp>
 #include <openpose/thread/worker.hpp>
 
 namespace op
@@ -27,12 +28,26 @@ namespace op
 
         void add(const std::shared_ptr<SubThread<TDatums, TWorker>>& subThread);
 
+        /**
+         * Name (for the OS and Tracer) and affinity applied when the thread starts. Neither the OS name nor the
+         * affinity are applied in exec(), as it runs on the calling thread (e.g., the main one), which is only renamed
+         * in Tracer.
+         */
+        void setName(const std::string& name);
+
+        void setThreadAffinity(const ThreadAffinity& threadAffinity);
+
         void exec(const std::shared_ptr<std::atomic<bool>>& isRunningSharedPtr);
 
         void startInThread();
 
         void stopAndJoin();
 
+        /**
+         * Service time statistics of all its TWorkers (with threadId left to 0). Thread-safe.
+         */
+        std::vector<WorkerStatistics> getWorkerStatistics() const;
+
         inline bool isRunning() const
         {
             return *spIsRunning;
@@ -42,10 +57,12 @@ namespace op
         std::shared_ptr<std::atomic<bool>> spIsRunning;
         std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>> mSubThreads;
         std::thread mThread;
+        std::string mName;
+        ThreadAffinity mThreadAffinity;
 
         void initializationOnThread();
 
-        void threadFunction();
+        void threadFunction(const bool ownThread);
 
         void stop();
 
@@ -74,6 +91,8 @@ namespace op
     {
         std::swap(mSubThreads, t.mSubThreads);
         std::swap(mThread, t.mThread);
+        std::swap(mName, t.mName);
+        std::swap(mThreadAffinity, t.mThreadAffinity);
     }
 
     template<typename TDatums, typename TWorker>
@@ -81,6 +100,8 @@ namespace op
     {
         std::swap(mSubThreads, t.mSubThreads);
         std::swap(mThread, t.mThread);
+        std::swap(mName, t.mName);
+        std::swap(mThreadAffinity, t.mThreadAffinity);
         spIsRunning = {std::make_shared<std::atomic<bool>>(t.spIsRunning->load())};
         return *this;
     }
@@ -113,6 +134,39 @@ namespace op
         add(std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>>{subThread});
     }
 
+    template<typename TDatums, typename TWorker>
+    void Thread<TDatums, TWorker>::setName(const std::string& name)
+    {
+        mName = name;
+    }
+
+    template<typename TDatums, typename TWorker>
+    void Thread<TDatums, TWorker>::setThreadAffinity(const ThreadAffinity& threadAffinity)
+    {
+        mThreadAffinity = threadAffinity;
+    }
+
+    template<typename TDatums, typename TWorker>
+    std::vector<WorkerStatistics> Thread<TDatums, TWorker>::getWorkerStatistics() const
+    {
+        try
+        {
+            std::vector<WorkerStatistics> workerStatistics;
+            for (const auto& subThread : mSubThreads)
+            {
+                const auto subThreadStatistics = subThread->getWorkerStatistics();
+                workerStatistics.insert(
+                    workerStatistics.end(), subThreadStatistics.begin(), subThreadStatistics.end());
+            }
+            return workerStatistics;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
     template<typename TDatums, typename TWorker>
     void Thread<TDatums, TWorker>::exec(const std::shared_ptr<std::atomic<bool>>& isRunningSharedPtr)
     {
@@ -121,7 +175,7 @@ namespace op
             stopAndJoin();
             spIsRunning = isRunningSharedPtr;
             *spIsRunning = true;
-            threadFunction();
+            threadFunction(false);
         }
         catch (const std::exception& e)
         {
@@ -137,7 +191,7 @@ namespace op
             opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
             stopAndJoin();
             *spIsRunning = true;
-            mThread = {std::thread{&Thread::threadFunction, this}};
+            mThread = {std::thread{&Thread::threadFunction, this, true}};
         }
         catch (const std::exception& e)
         {
@@ -175,11 +229,27 @@ namespace op
     }
 
     template<typename TDatums, typename TWorker>
-    void Thread<TDatums, TWorker>::threadFunction()
+    void Thread<TDatums, TWorker>::threadFunction(const bool ownThread)
     {
         try
         {
             opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            // Name and affinity (before initializationOnThread(), so the memory it allocates follows the NUMA binding)
+            // In exec(), the calling thread keeps its OS name and affinity, as it is not owned by this class
+            if (ownThread)
+            {
+                if (!mName.empty())
+                    setCurrentThreadName(mName);
+                setCurrentThreadAffinity(mThreadAffinity);
+            }
+            else
+            {
+                if (!mName.empty())
+                    Tracer::setThreadName(mName);
+                if (mThreadAffinity.enabled())
+                    opLog("Thread " + mName + " runs on the thread that called exec(), so it is not pinned.",
+                          Priority::High);
+            }
             initializationOnThread();
 
             opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
@@ -0,0 +1,65 @@
+#ifndef OPENPOSE_THREAD_THREAD_AFFINITY_HPP
+#define OPENPOSE_THREAD_THREAD_AFFINITY_HPP
+
+#include <string>
+#include <vector>
+#include <openpose/core/macros.hpp>
+
+namespace op
+{
+    /**
+     * Where a ThreadManager thread runs (see ThreadManager::setThreadAffinities()). By default, it is not pinned.
+     * It is only applied on Linux (ignored with a warning otherwise).
+     */
+    struct OP_API ThreadAffinity
+    {
+        /**
+         * Logical cores where the thread can run (e.g., {0,1,2,3}). Empty (default) for any core (or the cores of
+         * numaNode if set).
+         */
+        std::vector<int> cores;
+
+        /**
+         * NUMA node to which the memory that the thread allocates afterwards (e.g., the buffers its workers create in
+         * their initializationOnThread()) is bound. If cores is empty, the thread is also pinned to the cores of this
+         * node. -1 (default) for no binding.
+         */
+        int numaNode;
+
+        ThreadAffinity(const std::vector<int>& cores = {}, const int numaNode = -1);
+
+        /**
+         * Whether it pins or binds anything.
+         */
+        bool enabled() const;
+    };
+
+    /**
+     * It parses a Linux-style core list, e.g., "0-3,8,10-11" into {0,1,2,3,8,10,11}. Empty string for no cores.
+     */
+    OP_API std::vector<int> stringToCores(const std::string& coreList);
+
+    /**
+     * It parses a NUMA node index, e.g., "1". Negative or partially numeric values (e.g., "1x") are errors.
+     */
+    OP_API int stringToNumaNode(const std::string& numaNode);
+
+    /**
+     * Logical cores of a NUMA node (read from /sys/devices/system/node). Empty if unknown (e.g., not on Linux).
+     */
+    OP_API std::vector<int> getNumaNodeCores(const int numaNode);
+
+    /**
+     * It applies threadAffinity to the calling thread. Failures (e.g., a core or NUMA node that does not exist) are
+     * logged as warnings rather than errors, so the pipeline keeps running unpinned.
+     */
+    OP_API void setCurrentThreadAffinity(const ThreadAffinity& threadAffinity);
+
+    /**
+     * It names the calling thread, both for the OS (shown by top -H, perf, gdb, etc., truncated to 15 characters
+     * on Linux) and for Tracer.
+     */
+    OP_API void setCurrentThreadName(const std::string& threadName);
+}
+
+#endif // OPENPOSE_THREAD_THREAD_AFFINITY_HPP
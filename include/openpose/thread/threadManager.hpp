@@ -2,12 +2,16 @@
 #define OPENPOSE_THREAD_THREAD_MANAGER_HPP
 
 #include <atomic>
+#include <functional>
+#include <mutex>
 #include <set> // std::multiset
 #include <tuple>
 #include <openpose/core/common.hpp>
 #include <openpose/thread/enumClasses.hpp>
+#include <openpose/thread/pipelineStatistics.hpp>
 #include <openpose/thread/queue.hpp>
 #include <openpose/thread/thread.hpp>
+#include <openpose/thread/threadAffinity.hpp>
 #include <openpose/thread/worker.hpp>
 
 namespace op
@@ -32,6 +36,40 @@ namespace op
          */
         void setDefaultMaxSizeQueues(const long long defaultMaxSizeQueues = -1);
 
+        /**
+         * It sets how the threads wait for their queues (ThreadSchedulingMode::Polling by default, while the OpenPose
+         * Wrapper uses EventDriven). It must be called before start() or exec().
+         */
+        void setThreadSchedulingMode(const ThreadSchedulingMode threadSchedulingMode);
+
+        /**
+         * It sets what happens when frames arrive faster than the pipeline processes them (BackpressurePolicy::Block
+         * by default). DropOldest and DropNewest only apply to the first queue (the one after the producer or the
+         * one filled with waitAndEmplace() or waitAndPush()), so no frame is discarded after being (partially)
+         * processed. LatencyTarget applies to every queue, each one with an equal share of latencyTargetSeconds
+         * (the target for the total time that each frame waits in the queues). It must be called before start() or
+         * exec().
+         */
+        void setBackpressurePolicy(
+            const BackpressurePolicy backpressurePolicy, const double latencyTargetSeconds = 0.);
+
+        /**
+         * Function called with each frame that the first queue discards (see setBackpressurePolicy() and
+         * QueueBase::setDroppedCallback()). Frames are discarded after the producer thread gave them an ID (e.g.,
+         * WIdGenerator), so the WQueueOrderer workers must skip those IDs (WQueueOrderer::skip()) rather than wait
+         * for them. It must be called before start() or exec().
+         */
+        void setDroppedCallback(const std::function<void(const TDatums&)>& droppedCallback);
+
+        /**
+         * It pins the thread with ID i (as given to add()) to threadAffinities[i] (see ThreadAffinity). Threads with
+         * no element (i >= threadAffinities.size()) are not pinned. It must be called before start() or exec().
+         * With exec(), the last thread ID runs on the calling thread, so it is not pinned.
+         * Regardless of it, each thread is named "op<ID>:<first worker>" (e.g., "op1:PoseExtractor", truncated to 15
+         * characters by the OS), so it can be identified in top -H, perf or gdb, and in Tracer.
+         */
+        void setThreadAffinities(const std::vector<ThreadAffinity>& threadAffinities);
+
         void add(const unsigned long long threadId, const std::vector<TWorker>& tWorkers,
                  const unsigned long long queueInId, const unsigned long long queueOutId);
 
@@ -58,23 +96,45 @@ namespace op
 
         bool tryEmplace(TDatums& tDatums);
 
+        /**
+         * It follows the BackpressurePolicy (see setBackpressurePolicy()), i.e., it does not wait but drops a frame
+         * if the queue is full and the policy is DropOldest or DropNewest.
+         * @return Whether tDatums was emplaced (false if stopped or if DropNewest discarded it).
+         */
         bool waitAndEmplace(TDatums& tDatums);
 
         bool tryPush(const TDatums& tDatums);
 
+        /**
+         * Analogous to waitAndEmplace().
+         */
         bool waitAndPush(const TDatums& tDatums);
 
         bool tryPop(TDatums& tDatums);
 
         bool waitAndPop(TDatums& tDatums);
 
+        /**
+         * Queue (labeled with the queue IDs given to add()) and worker (labeled with their thread IDs) statistics.
+         * They are empty before start() or exec(), and reflect the last run after stop(). It can be called from any
+         * thread.
+         */
+        PipelineStatistics getStatistics() const;
+
     private:
         const ThreadManagerMode mThreadManagerMode;
         std::shared_ptr<std::atomic<bool>> spIsRunning;
         long long mDefaultMaxSizeQueues;
+        ThreadSchedulingMode mThreadSchedulingMode;
+        BackpressurePolicy mBackpressurePolicy;
+        double mLatencyTargetSeconds;
+        std::function<void(const TDatums&)> mDroppedCallback;
+        std::vector<ThreadAffinity> mThreadAffinities;
         std::multiset<std::tuple<unsigned long long, std::vector<TWorker>, unsigned long long, unsigned long long>> mThreadWorkerQueues;
         std::vector<std::shared_ptr<Thread<TDatums, TWorker>>> mThreads;
         std::vector<std::shared_ptr<TQueue>> mTQueues;
+        // It protects mThreads and mTQueues from getStatistics() while they are created or reset
+        mutable std::mutex mStatisticsMutex;
 
         void add(const std::vector<std::tuple<unsigned long long, std::vector<TWorker>, unsigned long long, unsigned long long>>& threadWorkerQueues);
 
@@ -95,6 +155,7 @@ namespace op
 
 
 // Implementation
+#include <cctype> // std::isupper
 #include <utility> // std::pair
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose/thread/subThread.hpp>
@@ -108,7 +169,10 @@ namespace op
     ThreadManager<TDatums, TWorker, TQueue>::ThreadManager(const ThreadManagerMode threadManagerMode) :
         mThreadManagerMode{threadManagerMode},
         spIsRunning{std::make_shared<std::atomic<bool>>(false)},
-        mDefaultMaxSizeQueues{-1ll}
+        mDefaultMaxSizeQueues{-1ll},
+        mThreadSchedulingMode{ThreadSchedulingMode::Polling},
+        mBackpressurePolicy{BackpressurePolicy::Block},
+        mLatencyTargetSeconds{0.}
     {
     }
 
@@ -130,6 +194,66 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TWorker, typename TQueue>
+    void ThreadManager<TDatums, TWorker, TQueue>::setThreadSchedulingMode(
+        const ThreadSchedulingMode threadSchedulingMode)
+    {
+        try
+        {
+            mThreadSchedulingMode = {threadSchedulingMode};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TWorker, typename TQueue>
+    void ThreadManager<TDatums, TWorker, TQueue>::setBackpressurePolicy(
+        const BackpressurePolicy backpressurePolicy, const double latencyTargetSeconds)
+    {
+        try
+        {
+            if (backpressurePolicy == BackpressurePolicy::LatencyTarget && latencyTargetSeconds <= 0.)
+                error("BackpressurePolicy::LatencyTarget requires a positive latency target.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            mBackpressurePolicy = {backpressurePolicy};
+            mLatencyTargetSeconds = {latencyTargetSeconds};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TWorker, typename TQueue>
+    void ThreadManager<TDatums, TWorker, TQueue>::setDroppedCallback(
+        const std::function<void(const TDatums&)>& droppedCallback)
+    {
+        try
+        {
+            mDroppedCallback = {droppedCallback};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TWorker, typename TQueue>
+    void ThreadManager<TDatums, TWorker, TQueue>::setThreadAffinities(
+        const std::vector<ThreadAffinity>& threadAffinities)
+    {
+        try
+        {
+            mThreadAffinities = {threadAffinities};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template<typename TDatums, typename TWorker, typename TQueue>
     void ThreadManager<TDatums, TWorker, TQueue>::add(const unsigned long long threadId,
                                                       const std::vector<TWorker>& tWorkers,
@@ -167,6 +291,7 @@ namespace op
     {
         try
         {
+            const std::lock_guard<std::mutex> lock{mStatisticsMutex};
             mThreadWorkerQueues.clear();
             mThreads.clear();
             mTQueues.clear();
@@ -273,7 +398,7 @@ namespace op
                 error("Not available for this ThreadManagerMode.", __LINE__, __FUNCTION__, __FILE__);
             if (mTQueues.empty())
                 error("ThreadManager already stopped or not started yet.", __LINE__, __FUNCTION__, __FILE__);
-            return mTQueues[0]->waitAndEmplace(tDatums);
+            return mTQueues[0]->emplaceByPolicy(tDatums);
         }
         catch (const std::exception& e)
         {
@@ -311,7 +436,8 @@ namespace op
                 error("Not available for this ThreadManagerMode.", __LINE__, __FUNCTION__, __FILE__);
             if (mTQueues.empty())
                 error("ThreadManager already stopped or not started yet.", __LINE__, __FUNCTION__, __FILE__);
-            return mTQueues[0]->waitAndPush(tDatums);
+            auto tDatumsCopy = tDatums;
+            return mTQueues[0]->emplaceByPolicy(tDatumsCopy);
         }
         catch (const std::exception& e)
         {
@@ -358,6 +484,38 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TWorker, typename TQueue>
+    PipelineStatistics ThreadManager<TDatums, TWorker, TQueue>::getStatistics() const
+    {
+        try
+        {
+            const std::lock_guard<std::mutex> lock{mStatisticsMutex};
+            PipelineStatistics pipelineStatistics;
+            // If !Asynchronous && !AsynchronousIn -> queue indexes - 1 (see multisetToThreads())
+            const auto queueIdOffset = (mThreadManagerMode == ThreadManagerMode::Asynchronous
+                                        || mThreadManagerMode == ThreadManagerMode::AsynchronousIn ? 0ull : 1ull);
+            for (auto i = 0ull ; i < mTQueues.size() ; i++)
+            {
+                pipelineStatistics.queues.emplace_back(mTQueues[i]->getStatistics());
+                pipelineStatistics.queues.back().queueId = i + queueIdOffset;
+            }
+            for (auto i = 0ull ; i < mThreads.size() ; i++)
+            {
+                for (auto& workerStatistics : mThreads[i]->getWorkerStatistics())
+                {
+                    workerStatistics.threadId = i;
+                    pipelineStatistics.workers.emplace_back(workerStatistics);
+                }
+            }
+            return pipelineStatistics;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return PipelineStatistics{};
+        }
+    }
+
     template<typename TDatums, typename TWorker, typename TQueue>
     void ThreadManager<TDatums, TWorker, TQueue>::add(const std::vector<std::tuple<unsigned long long, std::vector<TWorker>,
                                                                                    unsigned long long, unsigned long long>>& threadWorkerQueues)
@@ -398,6 +556,8 @@ namespace op
         {
             if (!mThreadWorkerQueues.empty())
             {
+                const std::lock_guard<std::mutex> lock{mStatisticsMutex};
+
                 // This avoids extra std::cout if errors occur on different threads
                 setMainThread();
 
@@ -411,9 +571,11 @@ namespace op
                 const auto maxQueueIdSynchronous = mTQueues.size()+1;
 
                 // Set up threads
+                std::vector<std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>>> subThreadsPerThread(
+                    mThreads.size());
                 for (const auto& threadWorkerQueue : mThreadWorkerQueues)
                 {
-                    auto& thread = mThreads[std::get<0>(threadWorkerQueue)];
+                    auto& subThreads = subThreadsPerThread[std::get<0>(threadWorkerQueue)];
                     const auto& tWorkers = std::get<1>(threadWorkerQueue);
                     const auto queueIn = std::get<2>(threadWorkerQueue);
                     const auto queueOut = std::get<3>(threadWorkerQueue);
@@ -450,7 +612,22 @@ namespace op
                     // Case no queue
                     else // if (queueIn == 0 && queueOut == maxQueueIdSynchronous)
                         subThread = {std::make_shared<SubThreadNoQueue<TDatums, TWorker>>(tWorkers)};
-                    thread->add(subThread);
+                    subThreads.emplace_back(subThread);
+                }
+                // Blocking waits only if the thread does not have to alternate among several SubThreads
+                for (auto i = 0u ; i < mThreads.size() ; i++)
+                {
+                    if (subThreadsPerThread[i].size() == 1)
+                        subThreadsPerThread[i][0]->setThreadSchedulingMode(mThreadSchedulingMode);
+                    mThreads[i]->add(subThreadsPerThread[i]);
+                    // Name (e.g., "op1:PoseExtractor" for WPoseExtractor) and affinity
+                    const auto workerStatistics = mThreads[i]->getWorkerStatistics();
+                    auto workerName = (workerStatistics.empty() ? std::string{} : workerStatistics[0].name);
+                    if (workerName.size() > 1 && workerName[0] == 'W' && std::isupper((unsigned char)workerName[1]))
+                        workerName = workerName.substr(1);
+                    mThreads[i]->setName("op" + std::to_string(i) + ":" + workerName);
+                    if (i < mThreadAffinities.size())
+                        mThreads[i]->setThreadAffinity(mThreadAffinities[i]);
                 }
             }
             else
@@ -540,6 +717,18 @@ namespace op
                     error("Unknown ThreadManagerMode", __LINE__, __FUNCTION__, __FILE__);
                 for (auto& tQueue : mTQueues)
                     tQueue = std::make_shared<TQueue>(mDefaultMaxSizeQueues);
+
+                // Backpressure
+                if (mBackpressurePolicy == BackpressurePolicy::LatencyTarget)
+                {
+                    for (auto& tQueue : mTQueues)
+                        tQueue->setBackpressurePolicy(
+                            mBackpressurePolicy, mLatencyTargetSeconds / double(mTQueues.size()));
+                }
+                else if (!mTQueues.empty())
+                    mTQueues[0]->setBackpressurePolicy(mBackpressurePolicy);
+                if (mDroppedCallback && !mTQueues.empty())
+                    mTQueues[0]->setDroppedCallback(mDroppedCallback);
             }
         }
         catch (const std::exception& e)
@@ -59,6 +59,8 @@ namespace op
     {
         try
         {
+            // Tracing
+            OP_TRACE_SCOPE("WQueueAssembler");
             // Profiling speed
             const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
             // Input TDatums -> enqueue it
@@ -94,9 +96,6 @@ namespace op
                 else
                     tDatums = nullptr;
             }
-            // Sleep if no new tDatums to either pop or push
-            else
-                std::this_thread::sleep_for(std::chrono::milliseconds{1});
         }
         catch (const std::exception& e)
         {
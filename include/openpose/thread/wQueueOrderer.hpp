@@ -1,13 +1,24 @@
 #ifndef OPENPOSE_THREAD_W_QUEUE_ORDERER_HPP
 #define OPENPOSE_THREAD_W_QUEUE_ORDERER_HPP
 
-#include <queue> // std::priority_queue
+#include <algorithm> // std::max, std::min
+#include <deque>
+#include <mutex>
+#include <set>
 #include <openpose/core/common.hpp>
 #include <openpose/thread/worker.hpp>
 #include <openpose/utilities/pointerContainer.hpp>
 
 namespace op
 {
+    /**
+     * It returns the frames sorted by id (and subId for multi-view systems), e.g., after several threads (one per GPU)
+     * processed them in parallel. Out-of-order frames wait in a reorder window of maxBufferSize frames (a ring indexed
+     * by frame number, so inserting and releasing a frame is O(1)). Frames discarded before reaching it (e.g., by
+     * the BackpressurePolicy of the first queue) must be reported with skip(), so it does not wait for them. If a
+     * frame is still missing when a frame maxBufferSize positions after it arrives, it is skipped as well. Frames
+     * arriving after being skipped are returned immediately.
+     */
     template<typename TDatums>
     class WQueueOrderer : public Worker<TDatums>
     {
@@ -22,12 +33,35 @@ namespace op
 
         void tryStop();
 
+        bool hasPendingOutput() const;
+
+        /**
+         * It reports frames that will never arrive (e.g., discarded by the first queue, see
+         * ThreadManager::setDroppedCallback()), so the frames after them are not held back. Thread-safe, it can be
+         * called from any thread.
+         */
+        void skip(const TDatums& tDatums);
+
     private:
-        const unsigned int mMaxBufferSize;
         bool mStopWhenEmpty;
-        unsigned long long mNextExpectedId;
-        unsigned long long mNextExpectedSubId;
-        std::priority_queue<TDatums, std::vector<TDatums>, PointerContainerGreater<TDatums>> mPriorityQueueBuffer;
+        unsigned long long mNextSequence;
+        unsigned long long mBufferedSize;
+        // Sequences reported by skip() (filled by any thread, protected by mSkipMutex), and the ones not reached yet
+        // (only used by the worker thread)
+        std::mutex mSkipMutex;
+        std::vector<unsigned long long> mReportedSkippedSequences;
+        std::set<unsigned long long> mSkippedSequences;
+        // Frame with sequence number s is stored in mRingBuffer[s % mRingBuffer.size()]
+        std::vector<TDatums> mRingBuffer;
+        // Frames already out of the reorder window, ready to be returned
+        std::deque<TDatums> mReadyTDatums;
+
+        unsigned long long getSequence(const TDatums& tDatums) const;
+
+        // It moves mNextSequence past the skipped sequences
+        void skipReportedSequences();
+
+        void popNextTDatums(TDatums& tDatums);
 
         DELETE_COPY(WQueueOrderer);
     };
@@ -42,10 +76,10 @@ namespace op
 {
     template<typename TDatums>
     WQueueOrderer<TDatums>::WQueueOrderer(const unsigned int maxBufferSize) :
-        mMaxBufferSize{maxBufferSize},
         mStopWhenEmpty{false},
-        mNextExpectedId{0},
-        mNextExpectedSubId{0}
+        mNextSequence{0ull},
+        mBufferedSize{0ull},
+        mRingBuffer(std::max(1u, maxBufferSize))
     {
     }
 
@@ -64,79 +98,58 @@ namespace op
     {
         try
         {
+            // Tracing
+            OP_TRACE_SCOPE("WQueueOrderer");
             // Profiling speed
             const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
             bool profileSpeed = (tDatums != nullptr);
-            // Input TDatum -> enqueue or return it back
+            // Input TDatum -> return it back if it is the next expected one (or if it was already skipped), or
+            // enqueue it otherwise
+            skipReportedSequences();
             if (checkNoNullNorEmpty(tDatums))
             {
-                // T* to T
-                auto& tDatumsNoPtr = *tDatums;
+                const auto sequence = getSequence(tDatums);
                 // tDatums is the next expected, update counter
-                if (tDatumsNoPtr[0]->id == mNextExpectedId && tDatumsNoPtr[0]->subId == mNextExpectedSubId)
+                if (sequence == mNextSequence && mReadyTDatums.empty())
                 {
-                    // If single-view
-                    if (tDatumsNoPtr[0]->subIdMax == 0)
-                        mNextExpectedId++;
-                    // If muilti-view system
-                    else
+                    mNextSequence++;
+                    skipReportedSequences();
+                }
+                // Else push it to our reorder window
+                else if (sequence >= mNextSequence)
+                {
+                    // If out of the window -> slide it, releasing (or skipping if missing) the oldest frames
+                    const auto ringSize = (unsigned long long)mRingBuffer.size();
+                    if (sequence >= mNextSequence + ringSize)
                     {
-                        mNextExpectedSubId++;
-                        if (mNextExpectedSubId > tDatumsNoPtr[0]->subIdMax)
+                        const auto nextSequence = sequence - ringSize + 1;
+                        const auto numberReleased = std::min(nextSequence - mNextSequence, ringSize);
+                        for (auto i = 0ull ; i < numberReleased ; i++)
                         {
-                            mNextExpectedSubId = 0;
-                            mNextExpectedId++;
+                            auto& slot = mRingBuffer[(mNextSequence + i) % ringSize];
+                            if (slot != nullptr)
+                            {
+                                mReadyTDatums.emplace_back(slot);
+                                slot = nullptr;
+                                mBufferedSize--;
+                            }
                         }
+                        mNextSequence = nextSequence;
+                        skipReportedSequences();
                     }
-                }
-                // Else push it to our buffered queue
-                else
-                {
-                    // Enqueue current tDatums
-                    mPriorityQueueBuffer.emplace(tDatums);
+                    // Enqueue current tDatums (a repeated sequence would release the previous one)
+                    auto& slot = mRingBuffer[sequence % ringSize];
+                    if (slot != nullptr)
+                        mReadyTDatums.emplace_back(slot);
+                    else
+                        mBufferedSize++;
+                    slot = tDatums;
                     tDatums = nullptr;
-                    // Else if buffer full -> remove one tDatums
-                    if (mPriorityQueueBuffer.size() > mMaxBufferSize)
-                    {
-                        tDatums = mPriorityQueueBuffer.top();
-                        mPriorityQueueBuffer.pop();
-                    }
                 }
             }
             // If input TDatum enqueued -> check if previously enqueued next desired frame and pop it
             if (!checkNoNullNorEmpty(tDatums))
-            {
-                // Retrieve frame if next is desired frame or if we want to stop this worker
-                if (!mPriorityQueueBuffer.empty()
-                    && (mStopWhenEmpty ||
-                        ((*mPriorityQueueBuffer.top())[0]->id == mNextExpectedId
-                          && (*mPriorityQueueBuffer.top())[0]->subId == mNextExpectedSubId)))
-                {
-                    tDatums = { mPriorityQueueBuffer.top() };
-                    mPriorityQueueBuffer.pop();
-                }
-            }
-            // If TDatum ready to be returned -> updated next expected id
-            if (checkNoNullNorEmpty(tDatums))
-            {
-                const auto& tDatumsNoPtr = *tDatums;
-                // If single-view
-                if (tDatumsNoPtr[0]->subIdMax == 0)
-                    mNextExpectedId = tDatumsNoPtr[0]->id + 1;
-                // If muilti-view system
-                else
-                {
-                    mNextExpectedSubId = tDatumsNoPtr[0]->subId + 1;
-                    if (mNextExpectedSubId > tDatumsNoPtr[0]->subIdMax)
-                    {
-                        mNextExpectedSubId = 0;
-                        mNextExpectedId = tDatumsNoPtr[0]->id + 1;
-                    }
-                }
-            }
-            // Sleep if no new tDatums to either pop or push
-            if (!checkNoNullNorEmpty(tDatums) && mPriorityQueueBuffer.size() < mMaxBufferSize / 2u)
-                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                popNextTDatums(tDatums);
             // If TDatum popped and/or pushed
             if (profileSpeed || tDatums != nullptr)
             {
@@ -161,7 +174,7 @@ namespace op
         try
         {
             // Close if all frames were retrieved from the queue
-            if (mPriorityQueueBuffer.empty())
+            if (mBufferedSize == 0 && mReadyTDatums.empty())
                 this->stop();
             mStopWhenEmpty = true;
 
@@ -172,6 +185,118 @@ namespace op
         }
     }
 
+    template<typename TDatums>
+    bool WQueueOrderer<TDatums>::hasPendingOutput() const
+    {
+        try
+        {
+            return !mReadyTDatums.empty()
+                || (mBufferedSize > 0
+                    && (mStopWhenEmpty || mRingBuffer[mNextSequence % mRingBuffer.size()] != nullptr));
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums>
+    void WQueueOrderer<TDatums>::skip(const TDatums& tDatums)
+    {
+        try
+        {
+            if (checkNoNullNorEmpty(tDatums))
+            {
+                const std::lock_guard<std::mutex> lock{mSkipMutex};
+                for (const auto& tDatumPtr : *tDatums)
+                    mReportedSkippedSequences.emplace_back(
+                        tDatumPtr->id * (tDatumPtr->subIdMax + 1) + tDatumPtr->subId);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    void WQueueOrderer<TDatums>::skipReportedSequences()
+    {
+        try
+        {
+            {
+                const std::lock_guard<std::mutex> lock{mSkipMutex};
+                mSkippedSequences.insert(mReportedSkippedSequences.begin(), mReportedSkippedSequences.end());
+                mReportedSkippedSequences.clear();
+            }
+            // Sequences already passed are forgotten, and the next expected one is skipped (only if missing)
+            while (!mSkippedSequences.empty() && *mSkippedSequences.begin() <= mNextSequence)
+            {
+                if (*mSkippedSequences.begin() == mNextSequence
+                    && mRingBuffer[mNextSequence % mRingBuffer.size()] == nullptr)
+                    mNextSequence++;
+                mSkippedSequences.erase(mSkippedSequences.begin());
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums>
+    unsigned long long WQueueOrderer<TDatums>::getSequence(const TDatums& tDatums) const
+    {
+        try
+        {
+            // Single-view: id. Multi-view system: all views of id, followed by all views of id+1, etc.
+            const auto& tDatum = *(*tDatums)[0];
+            return tDatum.id * (tDatum.subIdMax + 1) + tDatum.subId;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0ull;
+        }
+    }
+
+    template<typename TDatums>
+    void WQueueOrderer<TDatums>::popNextTDatums(TDatums& tDatums)
+    {
+        try
+        {
+            // Frames that left the reorder window go first
+            if (!mReadyTDatums.empty())
+            {
+                tDatums = mReadyTDatums.front();
+                mReadyTDatums.pop_front();
+            }
+            else if (mBufferedSize > 0)
+            {
+                // If stopping -> do not wait for the missing frames
+                const auto ringSize = mRingBuffer.size();
+                if (mStopWhenEmpty)
+                    while (mRingBuffer[mNextSequence % ringSize] == nullptr)
+                        mNextSequence++;
+                // Retrieve frame if next is desired frame
+                auto& slot = mRingBuffer[mNextSequence % ringSize];
+                if (slot != nullptr)
+                {
+                    tDatums = slot;
+                    slot = nullptr;
+                    mBufferedSize--;
+                    mNextSequence++;
+                    skipReportedSequences();
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     COMPILE_TEMPLATE_DATUM(WQueueOrderer);
 }
 
@@ -1,6 +1,7 @@
 #ifndef OPENPOSE_THREAD_WORKER_HPP
 #define OPENPOSE_THREAD_WORKER_HPP
 
+#include <chrono>
 #include <openpose/core/common.hpp>
 
 namespace op
@@ -34,6 +35,22 @@ namespace op
             stop();
         }
 
+        // Virtual in case some function buffers frames and can return more than one per input frame (e.g.,
+        // WQueueOrderer once a missing frame arrives). If true, the SubThread calls it again without waiting for a
+        // new input frame
+        inline virtual bool hasPendingOutput() const
+        {
+            return false;
+        }
+
+        // Virtual in case some function buffers frames until a time limit (e.g., WPoseExtractor gathering a batch).
+        // The SubThread does not wait for new input frames beyond it, so the TWorker is called (with empty TDatums)
+        // once it expires
+        inline virtual std::chrono::steady_clock::time_point getDeadline() const
+        {
+            return std::chrono::steady_clock::time_point::max();
+        }
+
     protected:
         virtual void initializationOnThread() = 0;
 
@@ -2,6 +2,8 @@
 #define OPENPOSE_TRACKING_HEADERS_HPP
 
 // tracking module
+#include <openpose/tracking/imagePyramidCache.hpp>
+#include <openpose/tracking/keyframeTracker.hpp>
 #include <openpose/tracking/personIdExtractor.hpp>
 #include <openpose/tracking/personTracker.hpp>
 #include <openpose/tracking/wPersonIdExtractor.hpp>
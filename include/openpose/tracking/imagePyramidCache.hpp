@@ -0,0 +1,61 @@
+#ifndef OPENPOSE_TRACKING_IMAGE_PYRAMID_CACHE_HPP
+#define OPENPOSE_TRACKING_IMAGE_PYRAMID_CACHE_HPP
+
+#include <openpose/core/common.hpp>
+
+namespace op
+{
+    /**
+     * Gaussian pyramids of a single frame, shared by all the Lucas-Kanade consumers of that frame (PersonTracker,
+     * PersonIdExtractor). Nothing is computed on construction: the grayscale image and each pyramid are built the
+     * first time they are requested, and any later request (from any consumer or thread) reuses them.
+     * It is attached to the frame with a std::shared_ptr (Datum::imagePyramidCache), and the LK consumers keep the
+     * one of the previous frame, so each frame pyramid is built once and released when no one references it.
+     * This class is thread-safe.
+     */
+    class OP_API ImagePyramidCache
+    {
+    public:
+        /**
+         * @param cvMatInput BGR (or grayscale) frame. It is not copied, so it must not be modified afterwards.
+         */
+        explicit ImagePyramidCache(const Matrix& cvMatInput);
+
+        virtual ~ImagePyramidCache();
+
+        /**
+         * Size of the input frame.
+         */
+        Point<int> getSize() const;
+
+        /**
+         * Grayscale (CV_8UC1) frame, resized to `size` with bicubic interpolation if it does not match getSize().
+         * @param size Desired size. {0,0} (default) means getSize().
+         */
+        Matrix getGrayImage(const Point<int>& size = Point<int>{0,0});
+
+        /**
+         * Gaussian pyramid of getGrayImage(size) (cv::buildOpticalFlowPyramid without derivatives), with
+         * maxLevel + 1 images. Each image has at least `border` pixels of border around it, as required by
+         * cv::calcOpticalFlowPyrLK for a window size of `border` pixels.
+         * If a pyramid with at least that many levels and that border was already built for `size`, it returns the
+         * first maxLevel + 1 images of that one.
+         */
+        std::vector<Matrix> getPyramid(const Point<int>& size, const int maxLevel, const int border);
+
+        /**
+         * Number of pyramids built so far (i.e., the requests not served from the cache).
+         */
+        unsigned long long getNumberPyramidsBuilt() const;
+
+    private:
+        // PIMPL idiom
+        // http://www.cppsamples.com/common-tasks/pimpl.html
+        struct ImplImagePyramidCache;
+        std::shared_ptr<ImplImagePyramidCache> spImpl;
+
+        DELETE_COPY(ImagePyramidCache);
+    };
+}
+
+#endif // OPENPOSE_TRACKING_IMAGE_PYRAMID_CACHE_HPP
@@ -0,0 +1,63 @@
+#ifndef OPENPOSE_TRACKING_KEYFRAME_TRACKER_HPP
+#define OPENPOSE_TRACKING_KEYFRAME_TRACKER_HPP
+
+#include <openpose/core/common.hpp>
+#include <openpose/tracking/imagePyramidCache.hpp>
+
+namespace op
+{
+    /**
+     * Keyframe-based propagation of the keypoints estimated inside regions of interest (ROIs), e.g., the face or hand
+     * rectangles. The network only needs to run on keyframes. Between them, the keypoints of the previous frame are
+     * propagated to the current one with pyramidal Lucas-Kanade (pyramidalLKOcv), keeping their keyframe scores.
+     * A new keyframe is requested every keyframeInterval frames, when any ROI moves or resizes more than
+     * maxRoiMotion (relative to its keyframe size), when the ROIs appear or disappear, or when LK loses more than
+     * maxKeypointLoss of the keypoints of the keyframe.
+     * The ROIs are split into groups (e.g., 1 for face, 2 for left and right hands), each one with its keypoints
+     * Array (with the pose structure, i.e., [#people x #parts x 3]).
+     * Each image view (imageViewIndex) is tracked independently. This class is not thread-safe.
+     */
+    class OP_API KeyframeTracker
+    {
+    public:
+        /**
+         * @param keyframeInterval Maximum number of frames between keyframes (1 means every frame is a keyframe).
+         * @param maxRoiMotion Maximum displacement of any ROI center, or change of its width, since its keyframe
+         * (relative to its keyframe width).
+         * @param maxKeypointLoss Maximum ratio of the keypoints of the keyframe lost by LK.
+         */
+        KeyframeTracker(const int keyframeInterval, const float maxRoiMotion = 0.2f,
+                        const float maxKeypointLoss = 0.2f, const int levels = 3, const int patchSize = 21);
+
+        virtual ~KeyframeTracker();
+
+        /**
+         * It propagates the keypoints of the previous frame into keypoints (one Array per group of ROIs).
+         * @return Whether they were propagated. If false, keypoints is not modified and this frame must be a keyframe,
+         * i.e., the network must be run on it and its results given to setKeyframe().
+         */
+        bool track(std::vector<Array<float>>& keypoints, const std::vector<std::vector<Rectangle<float>>>& rectangles,
+                   const unsigned long long imageViewIndex,
+                   const std::shared_ptr<ImagePyramidCache>& imagePyramidCache);
+
+        void setKeyframe(const std::vector<Array<float>>& keypoints,
+                         const std::vector<std::vector<Rectangle<float>>>& rectangles,
+                         const unsigned long long imageViewIndex,
+                         const std::shared_ptr<ImagePyramidCache>& imagePyramidCache);
+
+        /**
+         * Number of frames whose keypoints were propagated (i.e., non-keyframes) so far.
+         */
+        unsigned long long getNumberFramesTracked() const;
+
+    private:
+        // PIMPL idiom
+        // http://www.cppsamples.com/common-tasks/pimpl.html
+        struct ImplKeyframeTracker;
+        std::shared_ptr<ImplKeyframeTracker> spImpl;
+
+        DELETE_COPY(KeyframeTracker);
+    };
+}
+
+#endif // OPENPOSE_TRACKING_KEYFRAME_TRACKER_HPP
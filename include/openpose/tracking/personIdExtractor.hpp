@@ -2,6 +2,7 @@
 #define OPENPOSE_TRACKING_PERSON_ID_EXTRACTOR_HPP
 
 #include <openpose/core/common.hpp>
+#include <openpose/tracking/imagePyramidCache.hpp>
 
 namespace op
 {
@@ -13,12 +14,18 @@ namespace op
 
         virtual ~PersonIdExtractor();
 
+        /**
+         * @param imagePyramidCache Optional ImagePyramidCache of cvMatInput (e.g., Datum::imagePyramidCache), so its
+         * pyramids are shared with the other LK consumers of the frame. If nullptr, a new one is created.
+         */
         Array<long long> extractIds(const Array<float>& poseKeypoints, const Matrix& cvMatInput,
-                                    const unsigned long long imageViewIndex = 0ull);
+                                    const unsigned long long imageViewIndex = 0ull,
+                                    const std::shared_ptr<ImagePyramidCache>& imagePyramidCache = nullptr);
 
         Array<long long> extractIdsLockThread(const Array<float>& poseKeypoints, const Matrix& cvMatInput,
                                               const unsigned long long imageViewIndex,
-                                              const long long frameId);
+                                              const long long frameId,
+                                              const std::shared_ptr<ImagePyramidCache>& imagePyramidCache = nullptr);
 
     private:
         // PIMPL idiom
@@ -2,6 +2,7 @@
 #define OPENPOSE_OPENPOSE_PRIVATE_TRACKING_PERSON_TRACKER_HPP
 
 #include <openpose/core/common.hpp>
+#include <openpose/tracking/imagePyramidCache.hpp>
 
 namespace op
 {
@@ -14,10 +15,16 @@ namespace op
 
         virtual ~PersonTracker();
 
-        void track(Array<float>& poseKeypoints, Array<long long>& poseIds, const Matrix& cvMatInput);
+        /**
+         * @param imagePyramidCache Optional ImagePyramidCache of cvMatInput (e.g., Datum::imagePyramidCache), so its
+         * pyramids are shared with the other LK consumers of the frame. If nullptr, a new one is created.
+         */
+        void track(Array<float>& poseKeypoints, Array<long long>& poseIds, const Matrix& cvMatInput,
+                   const std::shared_ptr<ImagePyramidCache>& imagePyramidCache = nullptr);
 
         void trackLockThread(Array<float>& poseKeypoints, Array<long long>& poseIds, const Matrix& cvMatInput,
-                             const long long frameId);
+                             const long long frameId,
+                             const std::shared_ptr<ImagePyramidCache>& imagePyramidCache = nullptr);
 
         bool getMergeResults() const;
 
@@ -33,6 +33,15 @@ namespace op
         Images, // jpg, png, ...
         Size
     };
+
+    // Ordered from the least to the most capable instruction set
+    enum class SimdLevel : unsigned char
+    {
+        None = 0,
+        Sse4 = 1,   // SSE4.1
+        Avx2 = 2,   // AVX2 + FMA
+        Avx512 = 3, // AVX-512 F + BW
+    };
 }
 
 #endif // OPENPOSE_UTILITIES_ENUM_CLASSES_HPP
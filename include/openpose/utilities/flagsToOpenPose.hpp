@@ -6,6 +6,8 @@
 #include <openpose/gui/enumClasses.hpp>
 #include <openpose/pose/enumClasses.hpp>
 #include <openpose/producer/enumClasses.hpp>
+#include <openpose/thread/enumClasses.hpp>
+#include <openpose/thread/threadAffinity.hpp>
 #include <openpose/wrapper/enumClasses.hpp>
 
 namespace op
@@ -20,6 +22,22 @@ namespace op
 
     OP_API Detector flagsToDetector(const int detector);
 
+    OP_API BackpressurePolicy flagsToBackpressurePolicy(const int backpressure);
+
+    /**
+     * Negative captureBackpressure (auto) means DropOldest for IP cameras and Block otherwise.
+     */
+    OP_API BackpressurePolicy flagsToCaptureBackpressurePolicy(
+        const int captureBackpressure, const ProducerType producerType);
+
+    /**
+     * E.g., flagsToThreadAffinities("0;1-3;;8-11", "0;0;;1") pins thread 0 to core 0, thread 1 to cores 1-3 and
+     * thread 3 to cores 8-11, binds the memory of threads 0 and 1 to NUMA node 0 and the one of thread 3 to node 1,
+     * and leaves the other threads unpinned.
+     */
+    OP_API std::vector<ThreadAffinity> flagsToThreadAffinities(
+        const String& threadCores, const String& threadNumaNodes);
+
     // Determine type of frame source
     OP_API ProducerType flagsToProducerType(
         const String& imageDirectory, const String& videoPath, const String& ipCameraPath,
@@ -9,10 +9,14 @@
 #include <openpose/utilities/fileSystem.hpp>
 #include <openpose/utilities/flagsToOpenPose.hpp>
 #include <openpose/utilities/keypoint.hpp>
+#include <openpose/utilities/memoryPool.hpp>
 #include <openpose/utilities/openCv.hpp>
 #include <openpose/utilities/pointerContainer.hpp>
 #include <openpose/utilities/profiler.hpp>
+#include <openpose/utilities/simd.hpp>
 #include <openpose/utilities/standard.hpp>
 #include <openpose/utilities/string.hpp>
+#include <openpose/utilities/threadPool.hpp>
+#include <openpose/utilities/tracer.hpp>
 
 #endif // OPENPOSE_UTILITIES_HEADERS_HPP
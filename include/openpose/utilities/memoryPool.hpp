@@ -0,0 +1,113 @@
+#ifndef OPENPOSE_UTILITIES_MEMORY_POOL_HPP
+#define OPENPOSE_UTILITIES_MEMORY_POOL_HPP
+
+#include <cstddef> // std::size_t
+#include <openpose/core/macros.hpp>
+
+namespace op
+{
+    /**
+     * Counters of the MemoryPool, accumulated since the program started (or since the last resetStats() call).
+     * Allocations per frame: allocationsLastFrame for the last frame, or allocations / frames on average.
+     */
+    struct OP_API MemoryPoolStats
+    {
+        unsigned long long allocations; // Blocks requested to the pool
+        unsigned long long deallocations; // Blocks returned to the pool
+        unsigned long long systemAllocations; // Blocks that had to be allocated with malloc (i.e., pool misses)
+        unsigned long long bytesInUse; // Bytes of the blocks currently used
+        unsigned long long bytesCached; // Bytes of the free blocks kept by the pool for future allocations
+        unsigned long long frames; // Frames marked with markFrame()
+        unsigned long long allocationsLastFrame; // Blocks requested between the last 2 markFrame() calls
+        unsigned long long systemAllocationsLastFrame; // Pool misses between the last 2 markFrame() calls
+    };
+
+    /**
+     * Size-class memory pool used by Array<T> (if enabled) to avoid allocating and freeing memory on every frame.
+     * Blocks are rounded up to the next power of 2 and aligned to 64 bytes (cache line, AVX/AVX-512). Each thread
+     * keeps a few free blocks of each size (up to 128 MB in total), and the rest are shared among all threads (up to
+     * 1 GB), so memory allocated in one thread and released in another one (e.g., the Datum of a producer and a
+     * consumer thread) is also reused.
+     * These functions are thread-safe.
+     */
+    namespace MemoryPool
+    {
+        /**
+         * Whether Array<T> allocates its memory from the pool. Disabled by default.
+         * It can be changed at any time, memory is always returned to the allocator it came from.
+         */
+        OP_API bool getEnabled();
+
+        OP_API void setEnabled(const bool enabled);
+
+        /**
+         * Alignment (in bytes) of the memory returned by allocate().
+         */
+        OP_API std::size_t getAlignment();
+
+        OP_API void* allocate(const std::size_t bytes);
+
+        /**
+         * It returns a block obtained with allocate() to the pool.
+         */
+        OP_API void deallocate(void* ptr);
+
+        /**
+         * It frees all the cached blocks that are not being used.
+         */
+        OP_API void releaseCachedMemory();
+
+        /**
+         * It marks the start of a new frame for the per-frame counters of MemoryPoolStats. DatumProducer calls it
+         * for each frame it produces.
+         */
+        OP_API void markFrame();
+
+        OP_API MemoryPoolStats getStats();
+
+        /**
+         * It resets the allocation, deallocation and frame counters (bytesInUse and bytesCached are kept).
+         */
+        OP_API void resetStats();
+    }
+
+    /**
+     * Standard allocator on top of the MemoryPool (e.g., for the control block of std::shared_ptr).
+     */
+    template <typename T>
+    struct MemoryPoolAllocator
+    {
+        typedef T value_type;
+
+        MemoryPoolAllocator() = default;
+
+        template <typename U>
+        MemoryPoolAllocator(const MemoryPoolAllocator<U>&)
+        {
+        }
+
+        T* allocate(const std::size_t n)
+        {
+            return static_cast<T*>(MemoryPool::allocate(n*sizeof(T)));
+        }
+
+        void deallocate(T* ptr, const std::size_t)
+        {
+            MemoryPool::deallocate(ptr);
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const MemoryPoolAllocator<T>&, const MemoryPoolAllocator<U>&)
+    {
+        return true;
+    }
+
+    template <typename T, typename U>
+    bool operator!=(const MemoryPoolAllocator<T>&, const MemoryPoolAllocator<U>&)
+    {
+        return false;
+    }
+}
+
+#endif // OPENPOSE_UTILITIES_MEMORY_POOL_HPP
@@ -0,0 +1,32 @@
+#ifndef OPENPOSE_UTILITIES_SIMD_HPP
+#define OPENPOSE_UTILITIES_SIMD_HPP
+
+#include <string>
+#include <openpose/core/macros.hpp>
+#include <openpose/utilities/enumClasses.hpp>
+
+namespace op
+{
+    /**
+     * SIMD instruction set used by the CPU kernels (NMS, resize, input normalization, LK tracking, etc.). It is the
+     * best one supported by both the CPU and the operating system (detected once at runtime), limited by
+     * setMaxSimdLevel(). Kernels are compiled for all of them and dispatch on this value, so the same binary runs the
+     * fastest implementation on each machine, regardless of the INSTRUCTION_SET used to compile it.
+     */
+    OP_API SimdLevel getSimdLevel();
+
+    /**
+     * Best SIMD instruction set supported by the CPU and the operating system, ignoring setMaxSimdLevel().
+     */
+    OP_API SimdLevel getCpuSimdLevel();
+
+    /**
+     * It limits the SIMD instruction set used by the kernels (e.g., to compare implementations or to debug them).
+     * By default, SimdLevel::Avx512 (i.e., no limit). This function is thread-safe.
+     */
+    OP_API void setMaxSimdLevel(const SimdLevel simdLevel);
+
+    OP_API std::string simdLevelToString(const SimdLevel simdLevel);
+}
+
+#endif // OPENPOSE_UTILITIES_SIMD_HPP
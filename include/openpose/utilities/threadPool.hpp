@@ -0,0 +1,61 @@
+#ifndef OPENPOSE_UTILITIES_THREAD_POOL_HPP
+#define OPENPOSE_UTILITIES_THREAD_POOL_HPP
+
+#include <functional>
+#include <openpose/core/macros.hpp>
+
+namespace op
+{
+    /**
+     * Process-wide work-stealing thread pool for the data-parallel CPU kernels (NMS, resize and merge, body part
+     * connection, net input resize, etc.). It is independent of the ThreadManager: a Worker running on any pipeline
+     * thread calls parallelFor(), and its loop is split into chunks that the calling thread and the idle pool threads
+     * process concurrently (so a busy stage can use the cores of the idle ones).
+     * Each pool thread owns a task deque and steals from the others (nearest indexes first) when its own is empty.
+     * The threads are only created the first time parallelFor() needs them.
+     * parallelFor() can be called from several threads at the same time (each call waits only for its own loop).
+     */
+    namespace ThreadPool
+    {
+        /**
+         * Whether parallelFor() uses the pool. Enabled by default, disabled by `--disable_multi_thread` (then
+         * parallelFor() runs the whole loop on the calling thread).
+         */
+        OP_API bool getEnabled();
+
+        OP_API void setEnabled(const bool enabled);
+
+        /**
+         * Number of pool threads (the thread calling parallelFor() also processes chunks, so up to
+         * getNumberThreads()+1 threads work on each loop).
+         * If numberThreads < 0 (default), it is set to std::thread::hardware_concurrency() - 1.
+         * Changing it closes the current threads (after their pending tasks), the new ones are created on demand.
+         */
+        OP_API int getNumberThreads();
+
+        OP_API void setNumberThreads(const int numberThreads = -1);
+
+        /**
+         * If enabled, pool thread i is pinned to logical core (i+1) % #cores (Linux only, ignored otherwise). Disabled
+         * by default. As setNumberThreads(), it re-creates the threads.
+         */
+        OP_API bool getPinThreads();
+
+        OP_API void setPinThreads(const bool pinThreads);
+
+        /**
+         * It runs function(chunkBegin, chunkEnd) over [begin, end), split into chunks of grainSize elements (the last
+         * one might be smaller), or over the whole range at once if the pool is disabled or has no threads. The chunks
+         * are processed concurrently and in any order, so function must be thread-safe across different chunks.
+         * It returns once all chunks are done. If any chunk throws, the first exception is re-thrown in the calling
+         * thread.
+         * While waiting for the last chunks, the calling thread runs other pending pool tasks, so nested calls (e.g.,
+         * parallelFor() inside a parallelFor() chunk) cannot deadlock, and it sleeps once there are none left.
+         */
+        OP_API void parallelFor(
+            const int begin, const int end, const std::function<void(const int, const int)>& function,
+            const int grainSize = 1);
+    }
+}
+
+#endif // OPENPOSE_UTILITIES_THREAD_POOL_HPP
@@ -0,0 +1,115 @@
+#ifndef OPENPOSE_UTILITIES_TRACER_HPP
+#define OPENPOSE_UTILITIES_TRACER_HPP
+
+#include <string>
+#include <openpose/core/macros.hpp>
+
+namespace op
+{
+    /**
+     * Low-overhead tracer that records when each instrumented scope (e.g., the work() function of each Worker) starts
+     * and ends, in which thread and for which frame, and exports them as a Chrome trace-event JSON file (open it with
+     * chrome://tracing or https://ui.perfetto.dev) to see every stage of every frame on a timeline.
+     * Unlike Profiler, it does not need to be enabled at compile time, and its hot path does not lock nor allocate:
+     * each probe name is registered once (static probe ID), and each thread writes its events into its own ring buffer
+     * (keeping the last getBufferSize() events per thread). Disabled by default (then each probe costs a single
+     * atomic load).
+     * Usage example:
+     *     void WMyWorker<TDatums>::work(TDatums& tDatums)
+     *     {
+     *         OP_TRACE_SCOPE_FRAME("WMyWorker", (*tDatums)[0]->id);
+     *         // [Some code in here]
+     *     }
+     *     ...
+     *     Tracer::setEnabled(true);
+     *     // [Run OpenPose]
+     *     Tracer::saveChromeTrace("trace.json");
+     */
+    namespace Tracer
+    {
+        /**
+         * Frame ID of the events not associated to any frame.
+         */
+        const unsigned long long NO_FRAME = ~0ull;
+
+        OP_API bool getEnabled();
+
+        OP_API void setEnabled(const bool enabled);
+
+        /**
+         * Maximum number of events kept per thread (the oldest ones are overwritten). It is rounded up to a power of 2
+         * (default: 65536, i.e., 2 MB per thread). It only applies to the threads that record their first event after
+         * calling it.
+         */
+        OP_API unsigned int getBufferSize();
+
+        OP_API void setBufferSize(const unsigned int bufferSize);
+
+        /**
+         * It returns the ID of the probe with that name and category, registering it the first time. Used by the
+         * OP_TRACE_SCOPE macros, which call it once per probe (function-local static).
+         */
+        OP_API unsigned int registerProbe(const std::string& name, const std::string& category = "");
+
+        /**
+         * Monotonic timestamp used by the events, in clock ticks (the x86 time-stamp counter if available, which is
+         * cheaper to read than std::chrono::steady_clock, or steady_clock nanoseconds otherwise). saveChromeTrace()
+         * converts them into time.
+         */
+        OP_API unsigned long long now();
+
+        /**
+         * It records an event of the probe probeId on the calling thread's ring buffer. Lock-free (the buffer is only
+         * allocated the first time each thread records an event).
+         */
+        OP_API void record(
+            const unsigned int probeId, const unsigned long long beginTicks, const unsigned long long endTicks,
+            const unsigned long long frameId = NO_FRAME);
+
+        /**
+         * Thread name shown in the trace for the calling thread (by default, "Thread N").
+         */
+        OP_API void setThreadName(const std::string& threadName);
+
+        /**
+         * It discards all the recorded events.
+         */
+        OP_API void clear();
+
+        /**
+         * It saves the recorded events in Chrome trace-event JSON format. It can be called while the other threads
+         * keep recording (the events overwritten during the copy are skipped).
+         */
+        OP_API void saveChromeTrace(const std::string& filePath);
+    }
+
+    /**
+     * RAII helper of the OP_TRACE_SCOPE macros: it records an event from its construction until its destruction.
+     */
+    class OP_API TraceScope
+    {
+    public:
+        explicit TraceScope(const unsigned int probeId, const unsigned long long frameId = Tracer::NO_FRAME);
+
+        ~TraceScope();
+
+    private:
+        const unsigned int mProbeId;
+        const unsigned long long mFrameId;
+        unsigned long long mBeginTicks;
+
+        DELETE_COPY(TraceScope);
+    };
+
+    #define OP_TRACE_CONCATENATE_IMPL(a, b) a##b
+    #define OP_TRACE_CONCATENATE(a, b) OP_TRACE_CONCATENATE_IMPL(a, b)
+    // Trace the current scope, associating it to the frame frameId
+    #define OP_TRACE_SCOPE_FRAME(name, frameId) \
+        static const auto OP_TRACE_CONCATENATE(opTraceProbeId, __LINE__) = op::Tracer::registerProbe(name); \
+        const op::TraceScope OP_TRACE_CONCATENATE(opTraceScope, __LINE__){ \
+            OP_TRACE_CONCATENATE(opTraceProbeId, __LINE__), (frameId)}
+    // Trace the current scope
+    #define OP_TRACE_SCOPE(name) OP_TRACE_SCOPE_FRAME(name, op::Tracer::NO_FRAME)
+}
+
+#endif // OPENPOSE_UTILITIES_TRACER_HPP
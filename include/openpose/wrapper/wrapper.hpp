@@ -1,6 +1,9 @@
 #ifndef OPENPOSE_WRAPPER_WRAPPER_HPP
 #define OPENPOSE_WRAPPER_WRAPPER_HPP
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <openpose/core/common.hpp>
 #include <openpose/thread/headers.hpp>
 #include <openpose/wrapper/enumClasses.hpp>
@@ -144,6 +147,14 @@ namespace op
          */
         void setDefaultMaxSizeQueues(const long long defaultMaxSizeQueues = -1);
 
+        /**
+         * Queue and per-worker statistics of the pipeline (see ThreadManager::getStatistics()). It can be called from
+         * any thread while the WrapperT is running. WrapperStructOutput::writeMetrics periodically saves them into a
+         * file.
+         * @return PipelineStatistics with the current counters.
+         */
+        PipelineStatistics getStatistics() const;
+
         /**
          * Emplace (move) an element on the first (input) queue.
          * Only valid if ThreadManagerMode::Asynchronous or ThreadManagerMode::AsynchronousIn.
@@ -241,6 +252,15 @@ namespace op
         // User configurable workers
         std::array<bool, int(WorkerType::Size)> mUserWsOnNewThread;
         std::array<std::vector<TWorker>, int(WorkerType::Size)> mUserWs;
+        // Metrics writer (WrapperStructOutput::writeMetrics)
+        bool mMetricsWriterRunning;
+        std::mutex mMetricsWriterMutex;
+        std::condition_variable mMetricsWriterConditionVariable;
+        std::thread mMetricsWriterThread;
+
+        void startMetricsWriter();
+
+        void stopMetricsWriter();
 
         DELETE_COPY(WrapperT);
     };
@@ -261,7 +281,8 @@ namespace op
     WrapperT<TDatum, TDatums, TDatumsSP, TWorker>::WrapperT(const ThreadManagerMode threadManagerMode) :
         mThreadManagerMode{threadManagerMode},
         mThreadManager{threadManagerMode},
-        mMultiThreadEnabled{true}
+        mMultiThreadEnabled{true},
+        mMetricsWriterRunning{false}
     {
     }
 
@@ -417,7 +438,9 @@ namespace op
                 mWrapperStructHand, mWrapperStructExtra, mWrapperStructInput, mWrapperStructOutput, mWrapperStructGui,
                 mUserWs, mUserWsOnNewThread);
             opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            startMetricsWriter();
             mThreadManager.exec();
+            stopMetricsWriter();
         }
         catch (const std::exception& e)
         {
@@ -435,6 +458,7 @@ namespace op
                 mWrapperStructHand, mWrapperStructExtra, mWrapperStructInput, mWrapperStructOutput, mWrapperStructGui,
                 mUserWs, mUserWsOnNewThread);
             opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            startMetricsWriter();
             mThreadManager.start();
         }
         catch (const std::exception& e)
@@ -449,6 +473,7 @@ namespace op
         try
         {
             mThreadManager.stop();
+            stopMetricsWriter();
         }
         catch (const std::exception& e)
         {
@@ -470,6 +495,20 @@ namespace op
         }
     }
 
+    template<typename TDatum, typename TDatums, typename TDatumsSP, typename TWorker>
+    PipelineStatistics WrapperT<TDatum, TDatums, TDatumsSP, TWorker>::getStatistics() const
+    {
+        try
+        {
+            return mThreadManager.getStatistics();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return PipelineStatistics{};
+        }
+    }
+
     template<typename TDatum, typename TDatums, typename TDatumsSP, typename TWorker>
     void WrapperT<TDatum, TDatums, TDatumsSP, TWorker>::setDefaultMaxSizeQueues(const long long defaultMaxSizeQueues)
     {
@@ -710,6 +749,65 @@ namespace op
         }
     }
 
+    template<typename TDatum, typename TDatums, typename TDatumsSP, typename TWorker>
+    void WrapperT<TDatum, TDatums, TDatumsSP, TWorker>::startMetricsWriter()
+    {
+        try
+        {
+            if (mWrapperStructOutput.writeMetrics.empty() || mMetricsWriterThread.joinable())
+                return;
+            mMetricsWriterRunning = true;
+            mMetricsWriterThread = std::thread{[this]
+            {
+                const auto filePath = mWrapperStructOutput.writeMetrics.getStdString();
+                const auto period = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::duration<double>{mWrapperStructOutput.writeMetricsSeconds});
+                std::unique_lock<std::mutex> lock{mMetricsWriterMutex};
+                while (!mMetricsWriterConditionVariable.wait_for(
+                    lock, period, [this]{ return !mMetricsWriterRunning; }))
+                {
+                    lock.unlock();
+                    // A failed write (e.g., missing folder) must not stop the processing
+                    try
+                    {
+                        savePipelineStatistics(getStatistics(), filePath);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        opLog(e.what(), Priority::High, __LINE__, __FUNCTION__, __FILE__);
+                    }
+                    lock.lock();
+                }
+            }};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatum, typename TDatums, typename TDatumsSP, typename TWorker>
+    void WrapperT<TDatum, TDatums, TDatumsSP, TWorker>::stopMetricsWriter()
+    {
+        try
+        {
+            if (!mMetricsWriterThread.joinable())
+                return;
+            {
+                const std::lock_guard<std::mutex> lock{mMetricsWriterMutex};
+                mMetricsWriterRunning = false;
+            }
+            mMetricsWriterConditionVariable.notify_all();
+            mMetricsWriterThread.join();
+            // Final counters
+            savePipelineStatistics(getStatistics(), mWrapperStructOutput.writeMetrics.getStdString());
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     extern template class WrapperT<BASE_DATUM>;
 }
 
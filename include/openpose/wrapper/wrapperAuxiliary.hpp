@@ -91,7 +91,9 @@ namespace op
 #include <openpose/producer/headers.hpp>
 #include <openpose/tracking/headers.hpp>
 #include <openpose/utilities/fileSystem.hpp>
+#include <openpose/utilities/memoryPool.hpp>
 #include <openpose/utilities/standard.hpp>
+#include <openpose/utilities/threadPool.hpp>
 namespace op
 {
     template<typename TDatum, typename TDatums, typename TDatumsSP, typename TWorker>
@@ -109,14 +111,23 @@ namespace op
             opLog("Running configureThreadManager...", Priority::Normal);
 
             // Create producer
+            const auto reducedDecodingSize = (wrapperStructInput.reducedDecoding
+                ? wrapperStructPoseTemp.netInputSize : Point<int>{-1,-1});
             auto producerSharedPtr = createProducer(
                 wrapperStructInput.producerType, wrapperStructInput.producerString.getStdString(),
                 wrapperStructInput.cameraResolution, wrapperStructInput.cameraParameterPath.getStdString(),
-                wrapperStructInput.undistortImage, wrapperStructInput.numberViews);
+                wrapperStructInput.undistortImage, wrapperStructInput.numberViews, wrapperStructInput.decoderThreads,
+                wrapperStructInput.prefetchDepth, reducedDecodingSize, wrapperStructInput.captureBufferSize,
+                wrapperStructInput.captureBufferPolicy);
 
             // Editable arguments
             auto wrapperStructPose = wrapperStructPoseTemp;
             auto multiThreadEnabled = multiThreadEnabledTemp;
+            // `--disable_multi_thread` also runs the CPU kernels (NMS, resize, etc.) on their calling thread. Unlike
+            // multiThreadEnabled, it is not modified below for CPU-only mode, where the ThreadPool matters the most
+            ThreadPool::setEnabled(multiThreadEnabledTemp);
+            // Array<T> memory pool
+            MemoryPool::setEnabled(wrapperStructExtra.memoryPool);
 
             // User custom workers
             const auto& userInputWs = userWs[int(WorkerType::Input)];
@@ -182,15 +193,20 @@ namespace op
             auto gpuNumberStart = wrapperStructPose.gpuNumberStart;
             opLog("numberGpuThreads = " + std::to_string(numberGpuThreads), Priority::Normal);
             opLog("gpuNumberStart = " + std::to_string(gpuNumberStart), Priority::Normal);
-            // CPU --> 1 thread or no pose extraction
+            // CPU --> 1 thread per CPU worker (1 by default) or no pose extraction
             if (gpuMode == GpuMode::NoGpu)
             {
-                numberGpuThreads = (wrapperStructPose.gpuNumber == 0 ? 0 : 1);
+                numberGpuThreads = (wrapperStructPose.gpuNumber == 0
+                    ? 0 : (multiThreadEnabled ? fastMax(1, wrapperStructPose.cpuWorkerNumber) : 1));
                 gpuNumberStart = 0;
                 // Disabling multi-thread makes the code 400 ms faster (2.3 sec vs. 2.7 in i7-6850K)
                 // and fixes the bug that the screen was not properly displayed and only refreshed sometimes
                 // Note: The screen bug could be also fixed by using waitKey(30) rather than waitKey(1)
-                multiThreadEnabled = false;
+                // Several CPU workers need their own threads
+                if (numberGpuThreads < 2)
+                    multiThreadEnabled = false;
+                else
+                    opLog("Using " + std::to_string(numberGpuThreads) + " CPU workers.", Priority::High);
             }
             // GPU --> user picks (<= #GPUs)
             else
@@ -333,7 +349,7 @@ namespace op
                             wrapperStructPose.protoTxtPath.getStdString(),
                             wrapperStructPose.caffeModelPath.getStdString(),
                             wrapperStructPose.upsamplingRatio, wrapperStructPose.poseMode == PoseMode::Enabled,
-                            wrapperStructPose.enableGoogleLogging
+                            wrapperStructPose.enableGoogleLogging, wrapperStructPose.lowResPostProcessing
                         ));
 
                     // Pose renderers
@@ -382,6 +398,22 @@ namespace op
                     const auto keepTopNPeople = (wrapperStructPose.numberPeopleMax > 0 ?
                         std::make_shared<KeepTopNPeople>(wrapperStructPose.numberPeopleMax)
                         : nullptr);
+                    // Micro-batching (disabled with GPU rendering, which reads the network output of the last
+                    // processed frame)
+                    auto poseBatchSize = wrapperStructPose.poseBatchSize;
+                    if (poseBatchSize > 1 && renderOutputGpu)
+                    {
+                        opLog("Pose micro-batching (`--pose_batch_size`) is disabled because the GPU rendering reads"
+                              " the network output of the last processed frame. Use `--render_pose 1` (CPU"
+                              " rendering) or disable the display and rendering to enable it.", Priority::High);
+                        poseBatchSize = 1;
+                    }
+                    else if (poseBatchSize > 1 && wrapperStructPose.scalesNumber > 1)
+                    {
+                        opLog("Pose micro-batching (`--pose_batch_size`) is disabled because it requires"
+                              " `--scale_number 1`.", Priority::High);
+                        poseBatchSize = 1;
+                    }
                     // Person tracker
                     auto personTrackers = std::make_shared<std::vector<std::shared_ptr<PersonTracker>>>();
                     if (wrapperStructExtra.tracking > -1)
@@ -412,7 +444,8 @@ namespace op
                                 std::make_shared<WCvMatToOpOutput<TDatumsSP>>(cvMatToOpOutputs.back()));
                         }
                         poseExtractorsWs.at(i).emplace_back(
-                            std::make_shared<WPoseExtractor<TDatumsSP>>(poseExtractor));
+                            std::make_shared<WPoseExtractor<TDatumsSP>>(
+                                poseExtractor, poseBatchSize, wrapperStructPose.poseBatchWindow));
                         // poseExtractorsWs.at(i) = {std::make_shared<WPoseExtractor<TDatumsSP>>(poseExtractor)};
                         // // Just OpenPose keypoint detector
                         // poseExtractorsWs.at(i) = {std::make_shared<WPoseExtractorNet<TDatumsSP>>(
@@ -487,6 +520,22 @@ namespace op
                     else if (wrapperStructFace.detector != Detector::Provided)
                         error("Unknown face Detector. Select a valid face Detector (`--face_detector`).",
                               __LINE__, __FUNCTION__, __FILE__);
+                    // Keyframe mode (tracked frames have no heat maps)
+                    auto faceKeyframeInterval = wrapperStructFace.keyframeInterval;
+                    if (faceKeyframeInterval > 1 && !wrapperStructPose.heatMapTypes.empty())
+                    {
+                        opLog("Face keyframe mode (`--face_keyframe_interval`) disabled because heat maps are"
+                              " requested.", Priority::High);
+                        faceKeyframeInterval = 1;
+                    }
+                    // Each KeyframeTracker keeps the state of its own thread, so with several pose workers it would
+                    // only see non-consecutive frames
+                    if (faceKeyframeInterval > 1 && poseExtractorsWs.size() > 1)
+                    {
+                        opLog("Face keyframe mode (`--face_keyframe_interval`) disabled because it requires a single"
+                              " GPU/CPU worker (`--num_gpu 1`).", Priority::High);
+                        faceKeyframeInterval = 1;
+                    }
                     // Face keypoint extractor
                     for (auto gpu = 0u; gpu < poseExtractorsWs.size(); gpu++)
                     {
@@ -498,8 +547,14 @@ namespace op
                             wrapperStructPose.enableGoogleLogging
                         );
                         faceExtractorNets.emplace_back(faceExtractorNet);
+                        // 1 KeyframeTracker (keyframe mode implies a single thread), it keeps the state of the frames
+                        const auto keyframeTracker = (faceKeyframeInterval > 1
+                            ? std::make_shared<KeyframeTracker>(
+                                faceKeyframeInterval, wrapperStructFace.keyframeMaxRoiMotion,
+                                wrapperStructFace.keyframeMaxKeypointLoss)
+                            : nullptr);
                         poseExtractorsWs.at(gpu).emplace_back(
-                            std::make_shared<WFaceExtractorNet<TDatumsSP>>(faceExtractorNet));
+                            std::make_shared<WFaceExtractorNet<TDatumsSP>>(faceExtractorNet, keyframeTracker));
                     }
                 }
                 opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
@@ -509,6 +564,22 @@ namespace op
                 {
                     opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
                     const auto handDetector = std::make_shared<HandDetector>(wrapperStructPose.poseModel);
+                    // Keyframe mode (tracked frames have no heat maps)
+                    auto handKeyframeInterval = wrapperStructHand.keyframeInterval;
+                    if (handKeyframeInterval > 1 && !wrapperStructPose.heatMapTypes.empty())
+                    {
+                        opLog("Hand keyframe mode (`--hand_keyframe_interval`) disabled because heat maps are"
+                              " requested.", Priority::High);
+                        handKeyframeInterval = 1;
+                    }
+                    // Each KeyframeTracker keeps the state of its own thread, so with several pose workers it would
+                    // only see non-consecutive frames
+                    if (handKeyframeInterval > 1 && poseExtractorsWs.size() > 1)
+                    {
+                        opLog("Hand keyframe mode (`--hand_keyframe_interval`) disabled because it requires a single"
+                              " GPU/CPU worker (`--num_gpu 1`).", Priority::High);
+                        handKeyframeInterval = 1;
+                    }
                     for (auto gpu = 0u; gpu < poseExtractorsWs.size(); gpu++)
                     {
                         // Sanity check
@@ -542,12 +613,17 @@ namespace op
                             wrapperStructHand.netInputSize, netOutputSize, modelFolder,
                             gpu + gpuNumberStart, wrapperStructHand.scalesNumber, wrapperStructHand.scaleRange,
                             wrapperStructPose.heatMapTypes, wrapperStructPose.heatMapScaleMode,
-                            wrapperStructPose.enableGoogleLogging
+                            wrapperStructPose.enableGoogleLogging, wrapperStructHand.batchSize
                         );
                         handExtractorNets.emplace_back(handExtractorNet);
+                        // 1 KeyframeTracker (keyframe mode implies a single thread), it keeps the state of the frames
+                        const auto keyframeTracker = (handKeyframeInterval > 1
+                            ? std::make_shared<KeyframeTracker>(
+                                handKeyframeInterval, wrapperStructHand.keyframeMaxRoiMotion,
+                                wrapperStructHand.keyframeMaxKeypointLoss)
+                            : nullptr);
                         poseExtractorsWs.at(gpu).emplace_back(
-                            std::make_shared<WHandExtractorNet<TDatumsSP>>(handExtractorNet)
-                            );
+                            std::make_shared<WHandExtractorNet<TDatumsSP>>(handExtractorNet, keyframeTracker));
                         // If OpenPose body-based hand detector with tracking
                         if (wrapperStructHand.detector == Detector::BodyWithTracking)
                             poseExtractorsWs.at(gpu).emplace_back(
@@ -697,14 +773,17 @@ namespace op
                 }
                 opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
                 // Re-scale pose if desired
-                // If desired scale is not the current input
-                if (wrapperStructPose.keypointScaleMode != ScaleMode::InputResolution
-                    // and desired scale is not output when size(input) = size(output)
-                    && !(wrapperStructPose.keypointScaleMode == ScaleMode::OutputResolution &&
-                         (finalOutputSize == producerSize || finalOutputSize.x <= 0 || finalOutputSize.y <= 0))
-                    // and desired scale is not net output when size(input) = size(net output)
-                    && !(wrapperStructPose.keypointScaleMode == ScaleMode::NetOutputResolution
-                         && producerSize == wrapperStructPose.netInputSize))
+                // If images decoded at a reduced resolution (keypoints rescaled to the original image resolution)
+                if ((wrapperStructInput.reducedDecoding
+                     && wrapperStructInput.producerType == ProducerType::ImageDirectory)
+                    // or if desired scale is not the current input
+                    || (wrapperStructPose.keypointScaleMode != ScaleMode::InputResolution
+                        // and desired scale is not output when size(input) = size(output)
+                        && !(wrapperStructPose.keypointScaleMode == ScaleMode::OutputResolution &&
+                             (finalOutputSize == producerSize || finalOutputSize.x <= 0 || finalOutputSize.y <= 0))
+                        // and desired scale is not net output when size(input) = size(net output)
+                        && !(wrapperStructPose.keypointScaleMode == ScaleMode::NetOutputResolution
+                             && producerSize == wrapperStructPose.netInputSize)))
                 {
                     // Then we must rescale the keypoints
                     auto keypointScaler = std::make_shared<KeypointScaler>(wrapperStructPose.keypointScaleMode);
@@ -991,9 +1070,22 @@ namespace op
             // Thread Manager
             // Clean previous thread manager (avoid configure to crash the program if used more than once)
             threadManager.reset();
+            threadManager.setBackpressurePolicy(
+                wrapperStructExtra.backpressurePolicy, wrapperStructExtra.latencyTarget);
+            threadManager.setThreadAffinities(wrapperStructExtra.threadAffinities);
+            threadManager.setThreadSchedulingMode(ThreadSchedulingMode::EventDriven);
             unsigned long long threadId = 0ull;
             auto queueIn = 0ull;
             auto queueOut = 1ull;
+            // Sort frames after the parallel stages (always for multi-view systems, as WQueueAssembler requires it)
+            const auto multiView = (wrapperStructExtra.reconstruct3d || (producerSharedPtr != nullptr
+                && positiveIntRound(producerSharedPtr->get(ProducerProperty::NumberViews)) > 1));
+            const auto sortFrames = (!wrapperStructExtra.unorderedOutput || multiView);
+            // Frames discarded by the backpressure policy already have an ID, so the orderers must skip them
+            std::vector<std::shared_ptr<WQueueOrderer<TDatumsSP>>> wQueueOrderers;
+            if (wrapperStructExtra.unorderedOutput && multiView)
+                opLog("Unordered output is not applied to the pose estimation of multi-view systems (their views"
+                      " must be sorted before assembling them).", Priority::High);
             // After producer
             // ID generator (before any multi-threading or any function that requires the ID)
             const auto wIdGenerator = std::make_shared<WIdGenerator<TDatumsSP>>();
@@ -1058,9 +1150,10 @@ namespace op
                     queueIn++;
                     queueOut++;
                     // Sort frames - Required own thread
-                    if (poseExtractorsWs.size() > 1u)
+                    if (poseExtractorsWs.size() > 1u && sortFrames)
                     {
                         const auto wQueueOrderer = std::make_shared<WQueueOrderer<TDatumsSP>>();
+                        wQueueOrderers.emplace_back(wQueueOrderer);
                         opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
                         threadManager.add(threadId, wQueueOrderer, queueIn++, queueOut++);
                         threadIdPP(threadId, multiThreadEnabled);
@@ -1097,9 +1190,10 @@ namespace op
                     queueIn++;
                     queueOut++;
                     // Sort frames
-                    if (poseTriangulationsWs.size() > 1u)
+                    if (poseTriangulationsWs.size() > 1u && !wrapperStructExtra.unorderedOutput)
                     {
                         const auto wQueueOrderer = std::make_shared<WQueueOrderer<TDatumsSP>>();
+                        wQueueOrderers.emplace_back(wQueueOrderer);
                         opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
                         threadManager.add(threadId, wQueueOrderer, queueIn++, queueOut++);
                         threadIdPP(threadId, multiThreadEnabled);
@@ -1130,9 +1224,10 @@ namespace op
                     queueIn++;
                     queueOut++;
                     // Sort frames
-                    if (jointAngleEstimationsWs.size() > 1)
+                    if (jointAngleEstimationsWs.size() > 1 && !wrapperStructExtra.unorderedOutput)
                     {
                         const auto wQueueOrderer = std::make_shared<WQueueOrderer<TDatumsSP>>();
+                        wQueueOrderers.emplace_back(wQueueOrderer);
                         opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
                         threadManager.add(threadId, wQueueOrderer, queueIn++, queueOut++);
                         threadIdPP(threadId, multiThreadEnabled);
@@ -1215,6 +1310,16 @@ namespace op
                 threadManager.add(threadId, wFpsMax, queueIn++, queueOut++);
                 threadIdPP(threadId, multiThreadEnabled);
             }
+            // Frames discarded by the first queue are reported to the orderers
+            if (wQueueOrderers.empty())
+                threadManager.setDroppedCallback(nullptr);
+            else
+                threadManager.setDroppedCallback(
+                    [wQueueOrderers](const TDatumsSP& tDatums)
+                    {
+                        for (const auto& wQueueOrderer : wQueueOrderers)
+                            wQueueOrderer->skip(tDatums);
+                    });
         }
         catch (const std::exception& e)
         {
@@ -2,6 +2,8 @@
 #define OPENPOSE_WRAPPER_WRAPPER_STRUCT_EXTRA_HPP
 
 #include <openpose/core/common.hpp>
+#include <openpose/thread/enumClasses.hpp>
+#include <openpose/thread/threadAffinity.hpp>
 
 namespace op
 {
@@ -46,6 +48,40 @@ namespace op
          */
         int ikThreads;
 
+        /**
+         * What happens when frames arrive faster than they are processed (see ThreadManager::setBackpressurePolicy()).
+         * BackpressurePolicy::Block (default) processes every frame (e.g., for videos), DropOldest or DropNewest
+         * bound the latency of live feeds (e.g., webcams), and LatencyTarget adapts the queue sizes to keep the time
+         * frames wait in queues under `latencyTarget`.
+         */
+        BackpressurePolicy backpressurePolicy;
+
+        /**
+         * Target (in seconds) for BackpressurePolicy::LatencyTarget.
+         */
+        double latencyTarget;
+
+        /**
+         * Whether to skip sorting the frames after the stages that run in parallel (e.g., one pose extractor thread per
+         * GPU). If true, frames reach the output workers in processing order (with their original id), reducing the
+         * latency of outputs that do not need them sorted (e.g., JSON or UDP). The GUI, video and image outputs also
+         * receive them out of order. Multi-view systems still sort the views before assembling them.
+         */
+        bool unorderedOutput;
+
+        /**
+         * Core pinning and NUMA memory binding of each pipeline thread (see ThreadManager::setThreadAffinities()),
+         * indexed by thread ID. E.g., on a 2-socket machine, to keep the producer and the first GPU thread on the
+         * first socket. Empty (default) to let the OS schedule them.
+         */
+        std::vector<ThreadAffinity> threadAffinities;
+
+        /**
+         * Whether Array<T> allocates its memory from the MemoryPool (see MemoryPool::setEnabled()), reusing it across
+         * frames rather than allocating and releasing it on each frame.
+         */
+        bool memoryPool;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -53,7 +89,10 @@ namespace op
          */
         WrapperStructExtra(
             const bool reconstruct3d = false, const int minViews3d = -1, const bool identification = false,
-            const int tracking = -1, const int ikThreads = 0);
+            const int tracking = -1, const int ikThreads = 0,
+            const BackpressurePolicy backpressurePolicy = BackpressurePolicy::Block, const double latencyTarget = 0.1,
+            const bool unorderedOutput = false, const std::vector<ThreadAffinity>& threadAffinities = {},
+            const bool memoryPool = false);
     };
 }
 
@@ -61,6 +61,27 @@ namespace op
          */
         float renderThreshold;
 
+        /**
+         * Maximum number of frames between face network keyframes. 1 (default) runs the network on every frame. With
+         * N > 1, the face keypoints of the frames in between are propagated from the previous frame with pyramidal
+         * Lucas-Kanade (see KeyframeTracker), and a new keyframe is forced earlier if the face rectangles move or the
+         * tracking loses too many keypoints. It is ignored if face heat maps are requested or if more than 1 GPU/CPU
+         * worker is used (each worker would only see non-consecutive frames).
+         */
+        int keyframeInterval;
+
+        /**
+         * Maximum motion of any face rectangle (center displacement or width change, relative to its keyframe width)
+         * before a new keyframe is forced. Only used if keyframeInterval > 1.
+         */
+        float keyframeMaxRoiMotion;
+
+        /**
+         * Maximum ratio of keyframe keypoints that tracking can lose before a new keyframe is forced. Only used if
+         * keyframeInterval > 1.
+         */
+        float keyframeMaxKeypointLoss;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -70,7 +91,9 @@ namespace op
             const bool enable = false, const Detector detector = Detector::Body,
             const Point<int>& netInputSize = Point<int>{368, 368}, const RenderMode renderMode = RenderMode::Auto,
             const float alphaKeypoint = FACE_DEFAULT_ALPHA_KEYPOINT,
-            const float alphaHeatMap = FACE_DEFAULT_ALPHA_HEAT_MAP, const float renderThreshold = 0.4f);
+            const float alphaHeatMap = FACE_DEFAULT_ALPHA_HEAT_MAP, const float renderThreshold = 0.4f,
+            const int keyframeInterval = 1, const float keyframeMaxRoiMotion = 0.2f,
+            const float keyframeMaxKeypointLoss = 0.2f);
     };
 }
 
@@ -80,6 +80,34 @@ namespace op
          */
         float renderThreshold;
 
+        /**
+         * Maximum number of hand crops (both hands of all people, at all scales) run through the hand network at once.
+         * The greater, the fewer network calls (faster) but the more memory it will be needed. 1 processes each crop
+         * individually.
+         */
+        int batchSize;
+
+        /**
+         * Maximum number of frames between hand network keyframes. 1 (default) runs the network on every frame. With
+         * N > 1, the hand keypoints of the frames in between are propagated from the previous frame with pyramidal
+         * Lucas-Kanade (see KeyframeTracker), and a new keyframe is forced earlier if the hand rectangles move or the
+         * tracking loses too many keypoints. It is ignored if hand heat maps are requested or if more than 1 GPU/CPU
+         * worker is used (each worker would only see non-consecutive frames).
+         */
+        int keyframeInterval;
+
+        /**
+         * Maximum motion of any hand rectangle (center displacement or width change, relative to its keyframe width)
+         * before a new keyframe is forced. Only used if keyframeInterval > 1.
+         */
+        float keyframeMaxRoiMotion;
+
+        /**
+         * Maximum ratio of keyframe keypoints that tracking can lose before a new keyframe is forced. Only used if
+         * keyframeInterval > 1.
+         */
+        float keyframeMaxKeypointLoss;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -90,7 +118,9 @@ namespace op
             const Point<int>& netInputSize = Point<int>{368, 368}, const int scalesNumber = 1,
             const float scaleRange = 0.4f, const RenderMode renderMode = RenderMode::Auto,
             const float alphaKeypoint = HAND_DEFAULT_ALPHA_KEYPOINT,
-            const float alphaHeatMap = HAND_DEFAULT_ALPHA_HEAT_MAP, const float renderThreshold = 0.2f);
+            const float alphaHeatMap = HAND_DEFAULT_ALPHA_HEAT_MAP, const float renderThreshold = 0.2f,
+            const int batchSize = 8, const int keyframeInterval = 1, const float keyframeMaxRoiMotion = 0.2f,
+            const float keyframeMaxKeypointLoss = 0.2f);
     };
 }
 
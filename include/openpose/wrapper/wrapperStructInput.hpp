@@ -91,6 +91,37 @@ namespace op
          */
         int numberViews;
 
+        /**
+         * Number of threads reading and decoding the images of `--image_dir` ahead of time (in parallel and in any
+         * order), while they are still returned in order. 0 (default) decodes each image synchronously when needed.
+         */
+        int decoderThreads;
+
+        /**
+         * Maximum number of images decoded ahead of time. Only used if decoderThreads > 0.
+         */
+        int prefetchDepth;
+
+        /**
+         * Whether to decode the JPEG images of `--image_dir` at 1/2, 1/4, or 1/8 of their resolution when they are
+         * at least that many times bigger than the body network input resolution (WrapperStructPose::netInputSize).
+         * The output keypoints are rescaled to the original image resolution (Datum::scaleInputToOriginal), while
+         * Datum::cvInputData and the rendered Datum::cvOutputData keep the reduced one.
+         */
+        bool reducedDecoding;
+
+        /**
+         * Number of frames of `--video` or `--ip_camera` decoded ahead of time on a background thread. 0 (default)
+         * decodes each frame synchronously when needed.
+         */
+        int captureBufferSize;
+
+        /**
+         * What to do when the captureBufferSize frames are decoded but not consumed yet: Block (wait, lossless),
+         * DropOldest (overwrite the oldest frame, recommended for live streams) or DropNewest.
+         */
+        BackpressurePolicy captureBufferPolicy;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -103,7 +134,9 @@ namespace op
             const bool realTimeProcessing = false, const bool frameFlip = false, const int frameRotate = 0,
             const bool framesRepeat = false, const Point<int>& cameraResolution = Point<int>{-1,-1},
             const String& cameraParameterPath = "models/cameraParameters/",
-            const bool undistortImage = false, const int numberViews = -1);
+            const bool undistortImage = false, const int numberViews = -1, const int decoderThreads = 0,
+            const int prefetchDepth = 16, const bool reducedDecoding = false, const int captureBufferSize = 0,
+            const BackpressurePolicy captureBufferPolicy = BackpressurePolicy::Block);
     };
 }
 
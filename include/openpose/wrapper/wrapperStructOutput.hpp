@@ -142,6 +142,18 @@ namespace op
          */
         String udpPort;
 
+        /**
+         * Pipeline metrics file path (queue sizes and counters, and per-worker service time histograms) in the
+         * Prometheus text format (see ThreadManager::getStatistics()). It is rewritten every `writeMetricsSeconds`
+         * seconds (and when the wrapper stops). Empty to disable it.
+         */
+        String writeMetrics;
+
+        /**
+         * Period (in seconds) between `writeMetrics` updates.
+         */
+        double writeMetricsSeconds;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -157,7 +169,8 @@ namespace op
             const String& writeHeatMaps = "", const String& writeHeatMapsFormat = "png",
             const String& writeVideo3D = "", const String& writeVideoAdam = "",
             const String& writeBvh = "", const String& udpHost = "",
-            const String& udpPort = "8051");
+            const String& udpPort = "8051", const String& writeMetrics = "",
+            const double writeMetricsSeconds = 5.);
     };
 }
 
@@ -213,6 +213,36 @@ namespace op
          */
         bool enableGoogleLogging;
 
+        /**
+         * Whether to run NMS and the PAF scoring directly on the network output resolution (CPU version only).
+         * Only small windows around each peak candidate and the PAF samples are upsampled, rather than the whole
+         * heat maps. It is faster, but it is only applied when a single scale is used and no heat maps are
+         * requested, and results might slightly differ from the default full-resolution post-processing.
+         */
+        bool lowResPostProcessing;
+
+        /**
+         * Maximum number of frames run through the pose network at once (micro-batching). Only frames of a single
+         * view and a single scale of the same size are batched, and it is disabled with GPU rendering (which reads
+         * the network output of the last frame). It increases the throughput of each GPU (or CPU) thread, at the
+         * cost of the latency of waiting for the rest of the batch. 1 (default) for no batching.
+         */
+        int poseBatchSize;
+
+        /**
+         * Maximum time (in seconds) that the first frame of a batch waits for the rest of it (see poseBatchSize). If
+         * it expires, the partial batch is processed.
+         */
+        double poseBatchWindow;
+
+        /**
+         * CPU-only version: Number of independent pose (and face and hand) extractors, each one running on its own
+         * thread and sharing a single read-only copy of the network weights (analogous to gpuNumber for the GPU
+         * version). The frames are distributed among them and sorted again afterwards (unless
+         * WrapperStructExtra::unorderedOutput). Ignored in the GPU versions and if multi-threading is disabled.
+         */
+        int cpuWorkerNumber;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -231,7 +261,9 @@ namespace op
             const ScaleMode heatMapScaleMode = ScaleMode::UnsignedChar, const bool addPartCandidates = false,
             const float renderThreshold = 0.05f, const int numberPeopleMax = -1, const bool maximizePositives = false,
             const double fpsMax = -1., const String& protoTxtPath = "", const String& caffeModelPath = "",
-            const float upsamplingRatio = 0.f, const bool enableGoogleLogging = true);
+            const float upsamplingRatio = 0.f, const bool enableGoogleLogging = true,
+            const bool lowResPostProcessing = false, const int poseBatchSize = 1,
+            const double poseBatchWindow = 0.005, const int cpuWorkerNumber = 1);
     };
 }
 
@@ -150,23 +150,32 @@ namespace op
                     (float)FLAGS_alpha_pose, (float)FLAGS_alpha_heatmap, FLAGS_part_to_show, op::String(FLAGS_model_folder),
                     heatMapTypes, heatMapScaleMode, FLAGS_part_candidates, (float)FLAGS_render_threshold,
                     FLAGS_number_people_max, FLAGS_maximize_positives, FLAGS_fps_max, op::String(FLAGS_prototxt_path),
-                    op::String(FLAGS_caffemodel_path), (float)FLAGS_upsampling_ratio, enableGoogleLogging};
+                    op::String(FLAGS_caffemodel_path), (float)FLAGS_upsampling_ratio, enableGoogleLogging,
+                    FLAGS_low_res_post_processing, FLAGS_pose_batch_size, FLAGS_pose_batch_window,
+                    FLAGS_num_cpu_workers};
                 opWrapper->configure(wrapperStructPose);
                 // Face configuration (use WrapperStructFace{} to disable it)
                 const WrapperStructFace wrapperStructFace{
                     FLAGS_face, faceDetector, faceNetInputSize,
                     flagsToRenderMode(FLAGS_face_render, multipleView, FLAGS_render_pose),
-                    (float)FLAGS_face_alpha_pose, (float)FLAGS_face_alpha_heatmap, (float)FLAGS_face_render_threshold};
+                    (float)FLAGS_face_alpha_pose, (float)FLAGS_face_alpha_heatmap, (float)FLAGS_face_render_threshold,
+                    FLAGS_face_keyframe_interval, (float)FLAGS_keyframe_max_roi_motion,
+                    (float)FLAGS_keyframe_max_keypoint_loss};
                 opWrapper->configure(wrapperStructFace);
                 // Hand configuration (use WrapperStructHand{} to disable it)
                 const WrapperStructHand wrapperStructHand{
                     FLAGS_hand, handDetector, handNetInputSize, FLAGS_hand_scale_number, (float)FLAGS_hand_scale_range,
                     flagsToRenderMode(FLAGS_hand_render, multipleView, FLAGS_render_pose), (float)FLAGS_hand_alpha_pose,
-                    (float)FLAGS_hand_alpha_heatmap, (float)FLAGS_hand_render_threshold};
+                    (float)FLAGS_hand_alpha_heatmap, (float)FLAGS_hand_render_threshold, FLAGS_hand_batch_size,
+                    FLAGS_hand_keyframe_interval, (float)FLAGS_keyframe_max_roi_motion,
+                    (float)FLAGS_keyframe_max_keypoint_loss};
                 opWrapper->configure(wrapperStructHand);
                 // Extra functionality configuration (use WrapperStructExtra{} to disable it)
                 const WrapperStructExtra wrapperStructExtra{
-                    FLAGS_3d, FLAGS_3d_min_views, FLAGS_identification, FLAGS_tracking, FLAGS_ik_threads};
+                    FLAGS_3d, FLAGS_3d_min_views, FLAGS_identification, FLAGS_tracking, FLAGS_ik_threads,
+                    op::flagsToBackpressurePolicy(FLAGS_backpressure), FLAGS_latency_target, FLAGS_unordered_output,
+                    op::flagsToThreadAffinities(op::String(FLAGS_thread_cores), op::String(FLAGS_thread_numa_nodes)),
+                    FLAGS_memory_pool};
                 opWrapper->configure(wrapperStructExtra);
                 // Output (comment or use default argument to disable any output)
                 const WrapperStructOutput wrapperStructOutput{
@@ -176,7 +185,7 @@ namespace op
                     op::String(FLAGS_write_video), FLAGS_write_video_fps, FLAGS_write_video_with_audio,
                     op::String(FLAGS_write_heatmaps), op::String(FLAGS_write_heatmaps_format), op::String(FLAGS_write_video_3d),
                     op::String(FLAGS_write_video_adam), op::String(FLAGS_write_bvh), op::String(FLAGS_udp_host),
-                    op::String(FLAGS_udp_port)};
+                    op::String(FLAGS_udp_port), op::String(FLAGS_write_metrics), FLAGS_write_metrics_seconds};
                 opWrapper->configure(wrapperStructOutput);
                 if (synchronousIn) {
                     // SynchronousIn => We need a producer
@@ -191,7 +200,10 @@ namespace op
                     const WrapperStructInput wrapperStructInput{
                         producerType, producerString, FLAGS_frame_first, FLAGS_frame_step, FLAGS_frame_last,
                         FLAGS_process_real_time, FLAGS_frame_flip, FLAGS_frame_rotate, FLAGS_frames_repeat,
-                        cameraSize, op::String(FLAGS_camera_parameter_path), FLAGS_frame_undistort, FLAGS_3d_views};
+                        cameraSize, op::String(FLAGS_camera_parameter_path), FLAGS_frame_undistort, FLAGS_3d_views,
+                        FLAGS_image_dir_decoder_threads, FLAGS_image_dir_prefetch_depth,
+                        FLAGS_image_dir_reduced_decoding, FLAGS_capture_buffer_size,
+                        op::flagsToCaptureBackpressurePolicy(FLAGS_capture_backpressure, producerType)};
                     opWrapper->configure(wrapperStructInput);
                 }
                 // No GUI. Equivalent to: opWrapper.configure(WrapperStructGui{});
@@ -2,6 +2,7 @@
 #include <typeinfo> // typeid
 #include <numeric> // std::accumulate
 #include <opencv2/core/core.hpp> // cv::Mat
+#include <openpose/utilities/memoryPool.hpp>
 #include <openpose_private/utilities/avx.hpp>
 
 // Note: std::shared_ptr not (fully) supported for array pointers:
@@ -534,6 +535,25 @@ namespace op
         }
     }
 
+    template<typename T>
+    std::size_t Array<T>::getAlignment() const
+    {
+        try
+        {
+            if (pData == nullptr)
+                return 0;
+            auto alignment = SIMD_ALIGNMENT;
+            while ((std::uintptr_t)pData % alignment != 0)
+                alignment /= 2;
+            return alignment;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0;
+        }
+    }
+
     template<typename T>
     const Matrix& Array<T>::getConstCvMat() const
     {
@@ -670,11 +690,14 @@ namespace op
                 // Prepare shared_ptr
                 if (dataPtr == nullptr)
                 {
-                    #ifdef WITH_AVX
+                    // Memory pool (it also allocates the shared_ptr control block)
+                    if (MemoryPool::getEnabled())
+                        spData = std::shared_ptr<T>(
+                            static_cast<T*>(MemoryPool::allocate(sizeof(T)*mVolume)), &MemoryPool::deallocate,
+                            MemoryPoolAllocator<T>{});
+                    // Aligned to SIMD_ALIGNMENT bytes, so the SIMD kernels can use aligned loads and stores
+                    else
                         spData = aligned_shared_ptr<T>(mVolume);
-                    #else
-                        spData.reset(new T[mVolume], std::default_delete<T[]>());
-                    #endif
                     pData = spData.get();
                     // Sanity check
                     if (pData == nullptr)
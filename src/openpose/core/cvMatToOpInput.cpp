@@ -1,9 +1,9 @@
 #include <openpose/core/cvMatToOpInput.hpp>
 #ifdef USE_CUDA
     #include <openpose/gpu/cuda.hpp>
-    #include <openpose/net/resizeAndMergeBase.hpp>
     #include <openpose_private/gpu/cuda.hu>
 #endif
+#include <openpose/net/resizeAndMergeBase.hpp>
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/openCv.hpp>
 #include <openpose_private/utilities/openCvPrivate.hpp>
@@ -77,10 +77,27 @@ namespace op
             const auto numberScales = (int)scaleInputToNetInputs.size();
             std::vector<Array<float>> inputNetData(numberScales);
             cv::Mat cvInputData = OP_OP2CVCONSTMAT(inputData);
-            for (auto i = 0u ; i < inputNetData.size() ; i++)
+            // CPU version (faster if #Gpus <= 3 and relatively small images), fused for 8-bit 3-channel images
+            if (!mGpuResize && cvInputData.depth() == CV_8U && cvInputData.channels() == 3)
             {
-                // CPU version (faster if #Gpus <= 3 and relatively small images)
-                if (!mGpuResize)
+                // Resize, HWC to CHW and normalization of all scales in a single pass (equivalent to
+                // resizeFixedAspectRatio + uCharCvMatToFloatPtr on each scale)
+                std::vector<float*> inputNetPtrs(numberScales);
+                for (auto i = 0 ; i < numberScales ; i++)
+                {
+                    inputNetData[i].reset({1, 3, netInputSizes.at(i).y, netInputSizes.at(i).x});
+                    inputNetPtrs[i] = inputNetData[i].getPtr();
+                }
+                if (!cvInputData.isContinuous())
+                    cvInputData = cvInputData.clone();
+                resizeAndPadRbgCpu(
+                    inputNetPtrs, cvInputData.data, cvInputData.cols, cvInputData.rows, netInputSizes,
+                    scaleInputToNetInputs, (mPoseModel == PoseModel::BODY_19N ? 2 : 1));
+            }
+            // CPU version for any other image type
+            else if (!mGpuResize)
+            {
+                for (auto i = 0u ; i < inputNetData.size() ; i++)
                 {
                     cv::Mat frameWithNetSize;
                     resizeFixedAspectRatio(frameWithNetSize, cvInputData, scaleInputToNetInputs[i], netInputSizes[i]);
@@ -89,19 +106,12 @@ namespace op
                     uCharCvMatToFloatPtr(
                         inputNetData[i].getPtr(), OP_CV2OPMAT(frameWithNetSize),
                         (mPoseModel == PoseModel::BODY_19N ? 2 : 1));
-
-                    // // OpenCV equivalent
-                    // const auto scale = 1/255.;
-                    // const cv::Scalar mean{128,128,128};
-                    // const cv::Size outputSize{netInputSizes[i].x, netInputSizes[i].y};
-                    // // cv::Mat cvMat;
-                    // cv::dnn::blobFromImage(
-                    //     // frameWithNetSize, cvMat, scale, outputSize, mean);
-                    //     frameWithNetSize, inputNetData[i].getCvMat(), scale, outputSize, mean);
-                    // // opLog(cv::norm(cvMat - inputNetData[i].getCvMat())); // ~0.25
                 }
-                // CUDA version (if #Gpus > n)
-                else
+            }
+            // CUDA version (if #Gpus > n)
+            else
+            {
+                for (auto i = 0u ; i < inputNetData.size() ; i++)
                 {
                     // Note: This version reduces the global accuracy about 0.1%, so it is disabled for now
                     error("This version reduces the global accuracy about 0.1%, so it is disabled for now.",
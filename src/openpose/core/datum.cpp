@@ -7,7 +7,8 @@ namespace op
         id{std::numeric_limits<unsigned long long>::max()},
         subId{0},
         subIdMax{0},
-        poseIds{-1}
+        poseIds{-1},
+        scaleInputToOriginal{1.}
     {
     }
 
@@ -46,7 +47,9 @@ namespace op
         netInputSizes{datum.netInputSizes},
         scaleInputToOutput{datum.scaleInputToOutput},
         scaleNetToOutput{datum.scaleNetToOutput},
-        elementRendered{datum.elementRendered}
+        scaleInputToOriginal{datum.scaleInputToOriginal},
+        elementRendered{datum.elementRendered},
+        imagePyramidCache{datum.imagePyramidCache}
         // 3D/Adam parameters
         #ifdef USE_3D_ADAM_MODEL
             ,
@@ -113,7 +116,9 @@ namespace op
             netInputSizes = datum.netInputSizes;
             scaleInputToOutput = datum.scaleInputToOutput;
             scaleNetToOutput = datum.scaleNetToOutput;
+            scaleInputToOriginal = datum.scaleInputToOriginal;
             elementRendered = datum.elementRendered;
+            imagePyramidCache = datum.imagePyramidCache;
             // 3D/Adam parameters
             #ifdef USE_3D_ADAM_MODEL
                 // Adam/Unity params
@@ -156,7 +161,8 @@ namespace op
         frameNumber{datum.frameNumber},
         // Other parameters
         scaleInputToOutput{datum.scaleInputToOutput},
-        scaleNetToOutput{datum.scaleNetToOutput}
+        scaleNetToOutput{datum.scaleNetToOutput},
+        scaleInputToOriginal{datum.scaleInputToOriginal}
     {
         try
         {
@@ -188,6 +194,7 @@ namespace op
             std::swap(scaleInputToNetInputs, datum.scaleInputToNetInputs);
             std::swap(netInputSizes, datum.netInputSizes);
             std::swap(elementRendered, datum.elementRendered);
+            std::swap(imagePyramidCache, datum.imagePyramidCache);
             // 3D/Adam parameters
             #ifdef USE_3D_ADAM_MODEL
                 // Adam/Unity params
@@ -254,7 +261,9 @@ namespace op
             // Other parameters
             std::swap(scaleInputToNetInputs, datum.scaleInputToNetInputs);
             std::swap(netInputSizes, datum.netInputSizes);
+            scaleInputToOriginal = datum.scaleInputToOriginal;
             std::swap(elementRendered, datum.elementRendered);
+            std::swap(imagePyramidCache, datum.imagePyramidCache);
             // 3D/Adam parameters
             #ifdef USE_3D_ADAM_MODEL
                 // Adam/Unity params
@@ -336,7 +345,9 @@ namespace op
             datum.netInputSizes = netInputSizes;
             datum.scaleInputToOutput = scaleInputToOutput;
             datum.scaleNetToOutput = scaleNetToOutput;
+            datum.scaleInputToOriginal = scaleInputToOriginal;
             datum.elementRendered = elementRendered;
+            datum.imagePyramidCache = imagePyramidCache;
             // 3D/Adam parameters
             #ifdef USE_3D_ADAM_MODEL
                 // Adam/Unity params
@@ -5,7 +5,8 @@
 namespace op
 {
     Rectangle<float> getScaleAndOffset(const ScaleMode scaleMode, const double scaleInputToOutput,
-                                       const double scaleNetToOutput, const Point<int>& producerSize)
+                                       const double scaleNetToOutput, const Point<int>& producerSize,
+                                       const double scaleInputToOriginal)
     {
         try
         {
@@ -36,9 +37,9 @@ namespace op
                 const float invMaxProducerSize = 2.f / ((float)fastMax(producerSize.x, producerSize.y) - 1.f);
                 return Rectangle<float>{-1.f, -1.f, invMaxProducerSize, invMaxProducerSize};
             }
-            // InputResolution
+            // InputResolution (i.e., the original image one if the input was decoded at a reduced resolution)
             else if (scaleMode == ScaleMode::InputResolution)
-                return Rectangle<float>{0.f, 0.f, 1.f, 1.f};
+                return Rectangle<float>{0.f, 0.f, float(scaleInputToOriginal), float(scaleInputToOriginal)};
             // Unknown
             error("Unknown ScaleMode selected.", __LINE__, __FUNCTION__, __FILE__);
             return Rectangle<float>{};
@@ -61,12 +62,13 @@ namespace op
     }
 
     void KeypointScaler::scale(Array<float>& arrayToScale, const double scaleInputToOutput,
-                               const double scaleNetToOutput, const Point<int>& producerSize) const
+                               const double scaleNetToOutput, const Point<int>& producerSize,
+                               const double scaleInputToOriginal) const
     {
         try
         {
             std::vector<Array<float>> arrayToScalesToScale{arrayToScale};
-            scale(arrayToScalesToScale, scaleInputToOutput, scaleNetToOutput, producerSize);
+            scale(arrayToScalesToScale, scaleInputToOutput, scaleNetToOutput, producerSize, scaleInputToOriginal);
         }
         catch (const std::exception& e)
         {
@@ -75,15 +77,16 @@ namespace op
     }
 
     void KeypointScaler::scale(std::vector<Array<float>>& arrayToScalesToScale, const double scaleInputToOutput,
-                               const double scaleNetToOutput, const Point<int>& producerSize) const
+                               const double scaleNetToOutput, const Point<int>& producerSize,
+                               const double scaleInputToOriginal) const
     {
         try
         {
-            if (mScaleMode != ScaleMode::InputResolution)
+            if (mScaleMode != ScaleMode::InputResolution || scaleInputToOriginal != 1.)
             {
                 // Get scale and offset
                 const auto scaleAndOffset = getScaleAndOffset(mScaleMode, scaleInputToOutput, scaleNetToOutput,
-                                                              producerSize);
+                                                              producerSize, scaleInputToOriginal);
                 // Only scaling
                 if (scaleAndOffset.x == 0 && scaleAndOffset.y == 0)
                     for (auto& arrayToScale : arrayToScalesToScale)
@@ -103,15 +106,15 @@ namespace op
 
     void KeypointScaler::scale(std::vector<std::vector<std::array<float,3>>>& poseCandidates,
                                const double scaleInputToOutput, const double scaleNetToOutput,
-                               const Point<int>& producerSize) const
+                               const Point<int>& producerSize, const double scaleInputToOriginal) const
     {
         try
         {
-            if (mScaleMode != ScaleMode::InputResolution)
+            if (mScaleMode != ScaleMode::InputResolution || scaleInputToOriginal != 1.)
             {
                 // Get scale and offset
                 const auto scaleAndOffset = getScaleAndOffset(mScaleMode, scaleInputToOutput, scaleNetToOutput,
-                                                              producerSize);
+                                                              producerSize, scaleInputToOriginal);
                 // Only scaling
                 if (scaleAndOffset.x == 0 && scaleAndOffset.y == 0)
                 {
@@ -9,6 +9,7 @@
 #include <openpose/net/resizeAndMergeCaffe.hpp>
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/openCv.hpp>
+#include <openpose/utilities/threadPool.hpp>
 #include <openpose_private/utilities/openCvMultiversionHeaders.hpp>
 
 namespace op
@@ -16,7 +17,7 @@ namespace op
     struct FaceExtractorCaffe::ImplFaceExtractorCaffe
     {
         #ifdef USE_CAFFE
-            bool netInitialized;
+            int netBatchSize;
             const int mGpuId;
             std::shared_ptr<NetCaffe> spNetCaffe;
             std::shared_ptr<ResizeAndMergeCaffe<float>> spResizeAndMergeCaffe;
@@ -25,9 +26,12 @@ namespace op
             std::shared_ptr<ArrayCpuGpu<float>> spCaffeNetOutputBlob;
             std::shared_ptr<ArrayCpuGpu<float>> spHeatMapsBlob;
             std::shared_ptr<ArrayCpuGpu<float>> spPeaksBlob;
+            // Views of a single face of spCaffeNetOutputBlob and spHeatMapsBlob
+            std::shared_ptr<ArrayCpuGpu<float>> spFaceNetOutputBlob;
+            std::shared_ptr<ArrayCpuGpu<float>> spFaceHeatMapsBlob;
 
             ImplFaceExtractorCaffe(const std::string& modelFolder, const int gpuId, const bool enableGoogleLogging) :
-                netInitialized{false},
+                netBatchSize{0},
                 mGpuId{gpuId},
                 spNetCaffe{std::make_shared<NetCaffe>(modelFolder + FACE_PROTOTXT, modelFolder + FACE_TRAINED_MODEL,
                                                       gpuId, enableGoogleLogging)},
@@ -82,17 +86,24 @@ namespace op
                                               std::shared_ptr<ArrayCpuGpu<float>>& caffeNetOutputBlob,
                                               std::shared_ptr<ArrayCpuGpu<float>>& heatMapsBlob,
                                               std::shared_ptr<ArrayCpuGpu<float>>& peaksBlob,
+                                              std::shared_ptr<ArrayCpuGpu<float>>& faceNetOutputBlob,
+                                              std::shared_ptr<ArrayCpuGpu<float>>& faceHeatMapsBlob,
                                               const int gpuID)
         {
             try
             {
-                // HeatMaps extractor blob and layer
+                // HeatMaps extractor blob and layer (it resizes one face at a time)
+                faceNetOutputBlob->Reshape(
+                    1, caffeNetOutputBlob->shape(1), caffeNetOutputBlob->shape(2), caffeNetOutputBlob->shape(3));
                 const bool mergeFirstDimension = true;
                 resizeAndMergeCaffe->Reshape(
-                    std::vector<ArrayCpuGpu<float>*>{caffeNetOutputBlob.get()},
-                    std::vector<ArrayCpuGpu<float>*>{heatMapsBlob.get()},
+                    std::vector<ArrayCpuGpu<float>*>{faceNetOutputBlob.get()},
+                    std::vector<ArrayCpuGpu<float>*>{faceHeatMapsBlob.get()},
                     FACE_CCN_DECREASE_FACTOR, 1.f, mergeFirstDimension, gpuID);
-                // Pose extractor blob and layer
+                auto heatMapsShape = faceHeatMapsBlob->shape();
+                heatMapsShape[0] = caffeNetOutputBlob->shape(0);
+                heatMapsBlob->Reshape(heatMapsShape);
+                // Pose extractor blob and layer (it processes the whole batch at once)
                 maximumCaffe->Reshape({heatMapsBlob.get()}, {peaksBlob.get()});
                 // Cuda check
                 #ifdef USE_CUDA
@@ -159,6 +170,8 @@ namespace op
                 upImpl->spCaffeNetOutputBlob = upImpl->spNetCaffe->getOutputBlobArray();
                 upImpl->spHeatMapsBlob = {std::make_shared<ArrayCpuGpu<float>>(1,1,1,1)};
                 upImpl->spPeaksBlob = {std::make_shared<ArrayCpuGpu<float>>(1,1,1,1)};
+                upImpl->spFaceNetOutputBlob = {std::make_shared<ArrayCpuGpu<float>>(1,1,1,1)};
+                upImpl->spFaceHeatMapsBlob = {std::make_shared<ArrayCpuGpu<float>>(1,1,1,1)};
                 #ifdef USE_CUDA
                     cudaCheck(__LINE__, __FUNCTION__, __FILE__);
                 #endif
@@ -199,7 +212,9 @@ namespace op
 
                     // // Debugging
                     // cv::Mat cvInputDataCopy = cvInputData.clone();
-                    // Extract face keypoints for each person
+                    // Faces to process and their crop-to-image transformations
+                    std::vector<int> facePeople;
+                    std::vector<cv::Mat> faceTransformations;
                     for (auto person = 0 ; person < numberPeople ; person++)
                     {
                         const auto& faceRectangle = faceRectangles.at(person);
@@ -235,42 +250,102 @@ namespace op
                             Mscaling.at<double>(1,1) = scaleFace;
                             Mscaling.at<double>(0,2) = faceRectangle.x;
                             Mscaling.at<double>(1,2) = faceRectangle.y;
+                            facePeople.emplace_back(person);
+                            faceTransformations.emplace_back(Mscaling);
+                        }
+                    }
 
-                            cv::Mat faceImage;
-                            cv::warpAffine(cvInputData, faceImage, Mscaling,
-                                           cv::Size{mNetOutputSize.x, mNetOutputSize.y},
-                                           CV_INTER_LINEAR | CV_WARP_INVERSE_MAP,
-                                           cv::BORDER_CONSTANT, cv::Scalar(0,0,0));
-
-                            // cv::Mat -> float*
-                            uCharCvMatToFloatPtr(mFaceImageCrop.getPtr(), OP_CV2OPMAT(faceImage), true);
+                    // Run the faces through the network in batches
+                    #ifdef USE_OPENCL
+                        // OpenCL buffers cannot be offset, so the single face views cannot be used
+                        const auto maxBatchSize = 1;
+                    #else
+                        const auto maxBatchSize = FACE_MAX_BATCH_SIZE;
+                    #endif
+                    const auto numberFaces = (int)facePeople.size();
+                    for (auto batchBegin = 0 ; batchBegin < numberFaces ; batchBegin += maxBatchSize)
+                    {
+                        const auto batchSize = fastMin(maxBatchSize, numberFaces - batchBegin);
 
-                            // // Debugging
-                            // if (person < 5)
-                            // cv::imshow("faceImage" + std::to_string(person), faceImage);
+                        // Warp all face crops (in parallel) into the [batchSize x 3 x H x W] network input
+                        if (mFaceImageCrop.getSize(0) != batchSize)
+                            mFaceImageCrop.reset({batchSize, 3, mNetOutputSize.y, mNetOutputSize.x});
+                        const auto faceImageCropVolume = mFaceImageCrop.getVolume(1, 3);
+                        ThreadPool::parallelFor(
+                            0, batchSize,
+                            [&](const int faceBegin, const int faceEnd)
+                            {
+                                for (auto face = faceBegin ; face < faceEnd ; face++)
+                                {
+                                    cv::Mat faceImage;
+                                    cv::warpAffine(cvInputData, faceImage, faceTransformations[batchBegin+face],
+                                                   cv::Size{mNetOutputSize.x, mNetOutputSize.y},
+                                                   CV_INTER_LINEAR | CV_WARP_INVERSE_MAP,
+                                                   cv::BORDER_CONSTANT, cv::Scalar(0,0,0));
+                                    // cv::Mat -> float*
+                                    uCharCvMatToFloatPtr(
+                                        mFaceImageCrop.getPtr() + face * faceImageCropVolume, OP_CV2OPMAT(faceImage),
+                                        true);
+                                    // // Debugging
+                                    // if (facePeople[batchBegin+face] < 5)
+                                    // cv::imshow("faceImage" + std::to_string(facePeople[batchBegin+face]), faceImage);
+                                }
+                            });
 
-                            // 1. Caffe deep network
-                            upImpl->spNetCaffe->forwardPass(mFaceImageCrop);
+                        // 1. Caffe deep network (the net is reshaped whenever the batch size changes)
+                        upImpl->spNetCaffe->forwardPass(mFaceImageCrop);
 
-                            // Reshape blobs
-                            if (!upImpl->netInitialized)
-                            {
-                                upImpl->netInitialized = true;
-                                reshapeFaceExtractorCaffe(
-                                    upImpl->spResizeAndMergeCaffe, upImpl->spMaximumCaffe,
-                                    upImpl->spCaffeNetOutputBlob, upImpl->spHeatMapsBlob,
-                                    upImpl->spPeaksBlob, upImpl->mGpuId);
-                            }
+                        // Reshape blobs
+                        if (upImpl->netBatchSize != batchSize)
+                        {
+                            upImpl->netBatchSize = batchSize;
+                            reshapeFaceExtractorCaffe(
+                                upImpl->spResizeAndMergeCaffe, upImpl->spMaximumCaffe,
+                                upImpl->spCaffeNetOutputBlob, upImpl->spHeatMapsBlob,
+                                upImpl->spPeaksBlob, upImpl->spFaceNetOutputBlob, upImpl->spFaceHeatMapsBlob,
+                                upImpl->mGpuId);
+                        }
 
-                            // 2. Resize heat maps + merge different scales
+                        // 2. Resize heat maps + merge different scales
+                        const auto heatMapsVolume = upImpl->spHeatMapsBlob->count(1);
+                        if (batchSize == 1)
                             upImpl->spResizeAndMergeCaffe->Forward(
                                 {upImpl->spCaffeNetOutputBlob.get()}, {upImpl->spHeatMapsBlob.get()});
+                        // One face at a time, through views of the batch blobs
+                        else
+                        {
+                            const auto netOutputVolume = upImpl->spCaffeNetOutputBlob->count(1);
+                            #ifdef USE_CUDA
+                                auto* netOutputPtr = upImpl->spCaffeNetOutputBlob->mutable_gpu_data();
+                                auto* heatMapsPtr = upImpl->spHeatMapsBlob->mutable_gpu_data();
+                            #else
+                                auto* netOutputPtr = upImpl->spCaffeNetOutputBlob->mutable_cpu_data();
+                                auto* heatMapsPtr = upImpl->spHeatMapsBlob->mutable_cpu_data();
+                            #endif
+                            for (auto face = 0 ; face < batchSize ; face++)
+                            {
+                                #ifdef USE_CUDA
+                                    upImpl->spFaceNetOutputBlob->set_gpu_data(netOutputPtr + face * netOutputVolume);
+                                    upImpl->spFaceHeatMapsBlob->set_gpu_data(heatMapsPtr + face * heatMapsVolume);
+                                #else
+                                    upImpl->spFaceNetOutputBlob->set_cpu_data(netOutputPtr + face * netOutputVolume);
+                                    upImpl->spFaceHeatMapsBlob->set_cpu_data(heatMapsPtr + face * heatMapsVolume);
+                                #endif
+                                upImpl->spResizeAndMergeCaffe->Forward(
+                                    {upImpl->spFaceNetOutputBlob.get()}, {upImpl->spFaceHeatMapsBlob.get()});
+                            }
+                        }
 
-                            // 3. Get peaks by Non-Maximum Suppression
-                            upImpl->spMaximumCaffe->Forward(
-                                {upImpl->spHeatMapsBlob.get()}, {upImpl->spPeaksBlob.get()});
+                        // 3. Get peaks by Non-Maximum Suppression (whole batch at once)
+                        upImpl->spMaximumCaffe->Forward(
+                            {upImpl->spHeatMapsBlob.get()}, {upImpl->spPeaksBlob.get()});
 
-                            const auto* facePeaksPtr = upImpl->spPeaksBlob->mutable_cpu_data();
+                        const auto* facePeaksBatchPtr = upImpl->spPeaksBlob->mutable_cpu_data();
+                        for (auto face = 0 ; face < batchSize ; face++)
+                        {
+                            const auto person = facePeople[batchBegin+face];
+                            const auto& Mscaling = faceTransformations[batchBegin+face];
+                            const auto* facePeaksPtr = facePeaksBatchPtr + face * upImpl->spPeaksBlob->count(1);
                             for (auto part = 0 ; part < mFaceKeypoints.getSize(1) ; part++)
                             {
                                 const auto xyIndex = part * mFaceKeypoints.getSize(2);
@@ -293,9 +368,9 @@ namespace op
                                 updateFaceHeatMapsForPerson(
                                     mHeatMaps, person, mHeatMapScaleMode,
                                     #ifdef USE_CUDA
-                                        upImpl->spHeatMapsBlob->gpu_data()
+                                        upImpl->spHeatMapsBlob->gpu_data() + face * heatMapsVolume
                                     #else
-                                        upImpl->spHeatMapsBlob->cpu_data()
+                                        upImpl->spHeatMapsBlob->cpu_data() + face * heatMapsVolume
                                     #endif
                                 );
                             }
@@ -10,6 +10,7 @@
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/keypoint.hpp>
 #include <openpose/utilities/openCv.hpp>
+#include <openpose/utilities/threadPool.hpp>
 #include <openpose_private/utilities/openCvMultiversionHeaders.hpp>
 
 namespace op
@@ -17,8 +18,9 @@ namespace op
     struct HandExtractorCaffe::ImplHandExtractorCaffe
     {
         #ifdef USE_CAFFE
-            bool mNetInitialized;
+            int mNetBatchSize;
             const int mGpuId;
+            const int mMaxBatchSize;
             std::shared_ptr<NetCaffe> spNetCaffe;
             std::shared_ptr<ResizeAndMergeCaffe<float>> spResizeAndMergeCaffe;
             std::shared_ptr<MaximumCaffe<float>> spMaximumCaffe;
@@ -26,11 +28,15 @@ namespace op
             std::shared_ptr<ArrayCpuGpu<float>> spCaffeNetOutputBlob;
             std::shared_ptr<ArrayCpuGpu<float>> spHeatMapsBlob;
             std::shared_ptr<ArrayCpuGpu<float>> spPeaksBlob;
+            // Views of a single crop of spCaffeNetOutputBlob and spHeatMapsBlob
+            std::shared_ptr<ArrayCpuGpu<float>> spCropNetOutputBlob;
+            std::shared_ptr<ArrayCpuGpu<float>> spCropHeatMapsBlob;
 
             ImplHandExtractorCaffe(const std::string& modelFolder, const int gpuId,
-                                   const bool enableGoogleLogging) :
-                mNetInitialized{false},
+                                   const bool enableGoogleLogging, const int maxBatchSize) :
+                mNetBatchSize{0},
                 mGpuId{gpuId},
+                mMaxBatchSize{fastMax(1, maxBatchSize)},
                 spNetCaffe{std::make_shared<NetCaffe>(modelFolder + HAND_PROTOTXT, modelFolder + HAND_TRAINED_MODEL,
                                                       gpuId, enableGoogleLogging)},
                 spResizeAndMergeCaffe{std::make_shared<ResizeAndMergeCaffe<float>>()},
@@ -41,7 +47,7 @@ namespace op
     };
 
     #ifdef USE_CAFFE
-        void cropFrame(Array<float>& handImageCrop, cv::Mat& affineMatrix, const cv::Mat& cvInputData,
+        void cropFrame(float* handImageCropPtr, cv::Mat& affineMatrix, const cv::Mat& cvInputData,
                        const Rectangle<float>& handRectangle, const int netInputSide,
                        const Point<int>& netOutputSize, const bool mirrorImage)
         {
@@ -65,7 +71,7 @@ namespace op
                                CV_INTER_LINEAR | CV_WARP_INVERSE_MAP, cv::BORDER_CONSTANT, cv::Scalar{0,0,0});
                                // CV_INTER_CUBIC | CV_WARP_INVERSE_MAP, cv::BORDER_CONSTANT, cv::Scalar{0,0,0});
                 // cv::Mat -> float*
-                uCharCvMatToFloatPtr(handImageCrop.getPtr(), OP_CV2OPMAT(handImage), true);
+                uCharCvMatToFloatPtr(handImageCropPtr, OP_CV2OPMAT(handImage), true);
             }
             catch (const std::exception& e)
             {
@@ -166,17 +172,24 @@ namespace op
                                               std::shared_ptr<ArrayCpuGpu<float>>& caffeNetOutputBlob,
                                               std::shared_ptr<ArrayCpuGpu<float>>& heatMapsBlob,
                                               std::shared_ptr<ArrayCpuGpu<float>>& peaksBlob,
+                                              std::shared_ptr<ArrayCpuGpu<float>>& cropNetOutputBlob,
+                                              std::shared_ptr<ArrayCpuGpu<float>>& cropHeatMapsBlob,
                                               const int gpuID)
         {
             try
             {
-                // HeatMaps extractor blob and layer
+                // HeatMaps extractor blob and layer (it resizes one crop at a time)
+                cropNetOutputBlob->Reshape(
+                    1, caffeNetOutputBlob->shape(1), caffeNetOutputBlob->shape(2), caffeNetOutputBlob->shape(3));
                 const bool mergeFirstDimension = true;
                 resizeAndMergeCaffe->Reshape(
-                    std::vector<ArrayCpuGpu<float>*>{caffeNetOutputBlob.get()},
-                    std::vector<ArrayCpuGpu<float>*>{heatMapsBlob.get()},
+                    std::vector<ArrayCpuGpu<float>*>{cropNetOutputBlob.get()},
+                    std::vector<ArrayCpuGpu<float>*>{cropHeatMapsBlob.get()},
                     HAND_CCN_DECREASE_FACTOR, 1.f, mergeFirstDimension, gpuID);
-                // Pose extractor blob and layer
+                auto heatMapsShape = cropHeatMapsBlob->shape();
+                heatMapsShape[0] = caffeNetOutputBlob->shape(0);
+                heatMapsBlob->Reshape(heatMapsShape);
+                // Pose extractor blob and layer (it processes the whole batch at once)
                 maximumCaffe->Reshape({heatMapsBlob.get()}, {peaksBlob.get()});
                 // Cuda check
                 #ifdef USE_CUDA
@@ -188,52 +201,6 @@ namespace op
                 error(e.what(), __LINE__, __FUNCTION__, __FILE__);
             }
         }
-
-        void detectHandKeypoints(
-            Array<float>& handCurrent, std::shared_ptr<NetCaffe>& netCaffe, std::shared_ptr<ResizeAndMergeCaffe<float>>& resizeAndMergeCaffe,
-            std::shared_ptr<MaximumCaffe<float>>& maximumCaffe, std::shared_ptr<ArrayCpuGpu<float>>& caffeNetOutputBlob,
-            std::shared_ptr<ArrayCpuGpu<float>>& heatMapsBlob, std::shared_ptr<ArrayCpuGpu<float>>& peaksBlob, bool& netInitialized,
-            Array<float>& handImageCrop, const int person, const cv::Mat& affineMatrix, const int gpuId)
-        {
-            try
-            {
-                #ifdef USE_CAFFE
-                    // 1. Deep net
-                    netCaffe->forwardPass(handImageCrop);
-
-                    // Reshape blobs
-                    if (!netInitialized)
-                    {
-                        netInitialized = true;
-                        reshapeHandExtractorCaffe(
-                            resizeAndMergeCaffe, maximumCaffe, caffeNetOutputBlob, heatMapsBlob, peaksBlob, gpuId);
-                    }
-
-                    // 2. Resize heat maps + merge different scales
-                    resizeAndMergeCaffe->Forward({caffeNetOutputBlob.get()}, {heatMapsBlob.get()});
-
-                    // 3. Get peaks by Non-Maximum Suppression
-                    maximumCaffe->Forward({heatMapsBlob.get()}, {peaksBlob.get()});
-
-                    // Estimate keypoint locations
-                    connectKeypoints(
-                        handCurrent, person, affineMatrix, peaksBlob->mutable_cpu_data());
-
-                    // 5. CUDA sanity check
-                    #ifdef USE_CUDA
-                        cudaCheck(__LINE__, __FUNCTION__, __FILE__);
-                    #endif
-                #else
-                    UNUSED(handCurrent);
-                    UNUSED(person);
-                    UNUSED(affineMatrix);
-                #endif
-            }
-            catch (const std::exception& e)
-            {
-                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
-            }
-        }
     #endif
 
     HandExtractorCaffe::HandExtractorCaffe(const Point<int>& netInputSize, const Point<int>& netOutputSize,
@@ -241,10 +208,10 @@ namespace op
                                            const int numberScales,
                                            const float rangeScales, const std::vector<HeatMapType>& heatMapTypes,
                                            const ScaleMode heatMapScaleMode,
-                                           const bool enableGoogleLogging) :
+                                           const bool enableGoogleLogging, const int maxBatchSize) :
         HandExtractorNet{netInputSize, netOutputSize, numberScales, rangeScales, heatMapTypes, heatMapScaleMode}
         #ifdef USE_CAFFE
-        , upImpl{new ImplHandExtractorCaffe{modelFolder, gpuId, enableGoogleLogging}}
+        , upImpl{new ImplHandExtractorCaffe{modelFolder, gpuId, enableGoogleLogging, maxBatchSize}}
         #endif
     {
         try
@@ -259,6 +226,7 @@ namespace op
                 UNUSED(heatMapTypes);
                 UNUSED(heatMapScaleMode);
                 UNUSED(enableGoogleLogging);
+                UNUSED(maxBatchSize);
                 error("OpenPose must be compiled with the `USE_CAFFE` & `USE_CUDA` macro definitions in order to run"
                       " this functionality.", __LINE__, __FUNCTION__, __FILE__);
             #endif
@@ -289,6 +257,8 @@ namespace op
                 upImpl->spCaffeNetOutputBlob = upImpl->spNetCaffe->getOutputBlobArray();
                 upImpl->spHeatMapsBlob = {std::make_shared<ArrayCpuGpu<float>>(1,1,1,1)};
                 upImpl->spPeaksBlob = {std::make_shared<ArrayCpuGpu<float>>(1,1,1,1)};
+                upImpl->spCropNetOutputBlob = {std::make_shared<ArrayCpuGpu<float>>(1,1,1,1)};
+                upImpl->spCropHeatMapsBlob = {std::make_shared<ArrayCpuGpu<float>>(1,1,1,1)};
                 #ifdef USE_CUDA
                     cudaCheck(__LINE__, __FUNCTION__, __FILE__);
                 #endif
@@ -333,12 +303,14 @@ namespace op
 
                     // // Debugging
                     // cv::Mat cvInputDataCopied = cvInputData.clone();
-                    // Extract hand keypoints for each person
+                    // Hand crops of both hands of all people at all scales (in this order)
+                    const auto numberScales = mMultiScaleNumberAndRange.first;
+                    std::vector<int> cropHands;
+                    std::vector<int> cropPeople;
+                    std::vector<int> cropScales;
+                    std::vector<Rectangle<float>> cropRectangles;
                     for (auto hand = 0 ; hand < 2 ; hand++)
                     {
-                        // Parameters
-                        auto& handCurrent = mHandKeypoints[hand];
-                        const bool mirrorImage = (hand == 0);
                         for (auto person = 0 ; person < numberPeople ; person++)
                         {
                             const auto& handRectangle = handRectangles.at(person).at(hand);
@@ -362,44 +334,22 @@ namespace op
                             if (minHandSize > 1 && handRectangle.area() > 10)
                             {
                                 // Single-scale detection
-                                if (mMultiScaleNumberAndRange.first == 1)
+                                if (numberScales == 1)
                                 {
-                                    // // Debugging -> green rectangle overwriting red one
-                                    // if (handRectangle.width > 0)
-                                    //     cv::rectangle(
-                                    //         cvInputDataCopied,
-                                    //         cv::Point{positiveIntRound(handRectangle.x),
-                                    //                   positiveIntRound(handRectangle.y)},
-                                    //         cv::Point{positiveIntRound(handRectangle.x + handRectangle.width),
-                                    //                   positiveIntRound(handRectangle.y + handRectangle.height)},
-                                    //         cv::Scalar{(hand * 255.f),255.f,0.f}, 2);
-                                    // Parameters
-                                    cv::Mat affineMatrix;
-                                    // Resize image to hands positions + cv::Mat -> float*
-                                    cropFrame(mHandImageCrop, affineMatrix, cvInputData, handRectangle, netInputSide,
-                                              mNetOutputSize, mirrorImage);
-                                    // Deep net + Estimate keypoint locations
-                                    detectHandKeypoints(
-                                        handCurrent, upImpl->spNetCaffe, upImpl->spResizeAndMergeCaffe,
-                                        upImpl->spMaximumCaffe, upImpl->spCaffeNetOutputBlob,
-                                        upImpl->spHeatMapsBlob, upImpl->spPeaksBlob, upImpl->mNetInitialized,
-                                        mHandImageCrop, person, affineMatrix, upImpl->mGpuId);
+                                    cropHands.emplace_back(hand);
+                                    cropPeople.emplace_back(person);
+                                    cropScales.emplace_back(0);
+                                    cropRectangles.emplace_back(handRectangle);
                                 }
                                 // Multi-scale detection
                                 else
                                 {
-                                    const auto handPtrArea = handCurrent.getSize(1) * handCurrent.getSize(2);
-                                    auto* handCurrentPtr = handCurrent.getPtr() + person * handPtrArea;
-                                    const auto numberScales = mMultiScaleNumberAndRange.first;
                                     const auto initScale = 1.f - mMultiScaleNumberAndRange.second / 2.f;
                                     for (auto i = 0 ; i < numberScales ; i++)
                                     {
                                         // Get current scale
                                         const auto scale = initScale
                                                          + mMultiScaleNumberAndRange.second * i / (numberScales-1.f);
-                                        // Process hand
-                                        Array<float> handEstimated(
-                                            {1, handCurrent.getSize(1), handCurrent.getSize(2)}, 0.f);
                                         const auto handRectangleScale = recenter(
                                             handRectangle,
                                             (float)(positiveIntRound(handRectangle.width * scale) / 2 * 2),
@@ -414,36 +364,138 @@ namespace op
                                         //                         positiveIntRound(handRectangleScale.y
                                         //                                  + handRectangleScale.height)},
                                         //               cv::Scalar{255,0,0}, 2);
-                                        // Parameters
-                                        cv::Mat affineMatrix;
-                                        // Resize image to hands positions + cv::Mat -> float*
-                                        cropFrame(mHandImageCrop, affineMatrix, cvInputData, handRectangleScale,
-                                                  netInputSide, mNetOutputSize, mirrorImage);
-                                        // Deep net + Estimate keypoint locations
-                                        detectHandKeypoints(
-                                            handEstimated, upImpl->spNetCaffe, upImpl->spResizeAndMergeCaffe,
-                                            upImpl->spMaximumCaffe, upImpl->spCaffeNetOutputBlob,
-                                            upImpl->spHeatMapsBlob, upImpl->spPeaksBlob, upImpl->mNetInitialized,
-                                            mHandImageCrop, 0, affineMatrix, upImpl->mGpuId);
-                                        if (i == 0
-                                            || getAverageScore(handEstimated,0) > getAverageScore(handCurrent,person))
-                                            std::copy(handEstimated.getConstPtr(),
-                                                      handEstimated.getConstPtr() + handPtrArea, handCurrentPtr);
+                                        cropHands.emplace_back(hand);
+                                        cropPeople.emplace_back(person);
+                                        cropScales.emplace_back(i);
+                                        cropRectangles.emplace_back(handRectangleScale);
                                     }
                                 }
-                                // HeatMaps: storing
-                                if (!mHeatMapTypes.empty()){
-                                    #ifdef USE_CUDA
-                                        updateHandHeatMapsForPerson(mHeatMaps[hand], person, mHeatMapScaleMode,
-                                                                    upImpl->spHeatMapsBlob->gpu_data());
-                                    #else
-                                        updateHandHeatMapsForPerson(mHeatMaps[hand], person, mHeatMapScaleMode,
-                                                                    upImpl->spHeatMapsBlob->cpu_data());
-                                    #endif
+                            }
+                        }
+                    }
+
+                    // Run the crops through the network in batches
+                    #ifdef USE_OPENCL
+                        // OpenCL buffers cannot be offset, so the single crop views cannot be used
+                        const auto maxBatchSize = 1;
+                    #else
+                        const auto maxBatchSize = upImpl->mMaxBatchSize;
+                    #endif
+                    const auto numberCrops = (int)cropRectangles.size();
+                    std::vector<cv::Mat> affineMatrices(numberCrops);
+                    // Multi-scale detection: keypoints of the current scale, compared against the best scale so far
+                    Array<float> handEstimated;
+                    if (numberScales > 1)
+                        handEstimated.reset({1, (int)HAND_NUMBER_PARTS, 3}, 0.f);
+                    for (auto batchBegin = 0 ; batchBegin < numberCrops ; batchBegin += maxBatchSize)
+                    {
+                        const auto batchSize = fastMin(maxBatchSize, numberCrops - batchBegin);
+
+                        // Resize image to hands positions + cv::Mat -> float* (all crops in parallel, into the
+                        // [batchSize x 3 x H x W] network input)
+                        if (mHandImageCrop.getSize(0) != batchSize)
+                            mHandImageCrop.reset({batchSize, 3, mNetOutputSize.y, mNetOutputSize.x});
+                        const auto handImageCropVolume = mHandImageCrop.getVolume(1, 3);
+                        ThreadPool::parallelFor(
+                            0, batchSize,
+                            [&](const int cropBegin, const int cropEnd)
+                            {
+                                for (auto crop = batchBegin + cropBegin ; crop < batchBegin + cropEnd ; crop++)
+                                {
+                                    const bool mirrorImage = (cropHands[crop] == 0);
+                                    cropFrame(mHandImageCrop.getPtr() + (crop - batchBegin) * handImageCropVolume,
+                                              affineMatrices[crop], cvInputData, cropRectangles[crop],
+                                              netInputSide, mNetOutputSize, mirrorImage);
                                 }
+                            });
+
+                        // 1. Deep net (the net is reshaped whenever the batch size changes)
+                        upImpl->spNetCaffe->forwardPass(mHandImageCrop);
+
+                        // Reshape blobs
+                        if (upImpl->mNetBatchSize != batchSize)
+                        {
+                            upImpl->mNetBatchSize = batchSize;
+                            reshapeHandExtractorCaffe(
+                                upImpl->spResizeAndMergeCaffe, upImpl->spMaximumCaffe, upImpl->spCaffeNetOutputBlob,
+                                upImpl->spHeatMapsBlob, upImpl->spPeaksBlob, upImpl->spCropNetOutputBlob,
+                                upImpl->spCropHeatMapsBlob, upImpl->mGpuId);
+                        }
+
+                        // 2. Resize heat maps + merge different scales
+                        const auto heatMapsVolume = upImpl->spHeatMapsBlob->count(1);
+                        if (batchSize == 1)
+                            upImpl->spResizeAndMergeCaffe->Forward(
+                                {upImpl->spCaffeNetOutputBlob.get()}, {upImpl->spHeatMapsBlob.get()});
+                        // One crop at a time, through views of the batch blobs
+                        else
+                        {
+                            const auto netOutputVolume = upImpl->spCaffeNetOutputBlob->count(1);
+                            #ifdef USE_CUDA
+                                auto* netOutputPtr = upImpl->spCaffeNetOutputBlob->mutable_gpu_data();
+                                auto* heatMapsPtr = upImpl->spHeatMapsBlob->mutable_gpu_data();
+                            #else
+                                auto* netOutputPtr = upImpl->spCaffeNetOutputBlob->mutable_cpu_data();
+                                auto* heatMapsPtr = upImpl->spHeatMapsBlob->mutable_cpu_data();
+                            #endif
+                            for (auto crop = 0 ; crop < batchSize ; crop++)
+                            {
+                                #ifdef USE_CUDA
+                                    upImpl->spCropNetOutputBlob->set_gpu_data(netOutputPtr + crop * netOutputVolume);
+                                    upImpl->spCropHeatMapsBlob->set_gpu_data(heatMapsPtr + crop * heatMapsVolume);
+                                #else
+                                    upImpl->spCropNetOutputBlob->set_cpu_data(netOutputPtr + crop * netOutputVolume);
+                                    upImpl->spCropHeatMapsBlob->set_cpu_data(heatMapsPtr + crop * heatMapsVolume);
+                                #endif
+                                upImpl->spResizeAndMergeCaffe->Forward(
+                                    {upImpl->spCropNetOutputBlob.get()}, {upImpl->spCropHeatMapsBlob.get()});
+                            }
+                        }
+
+                        // 3. Get peaks by Non-Maximum Suppression (whole batch at once)
+                        upImpl->spMaximumCaffe->Forward({upImpl->spHeatMapsBlob.get()}, {upImpl->spPeaksBlob.get()});
+
+                        // Estimate keypoint locations
+                        const auto* handPeaksBatchPtr = upImpl->spPeaksBlob->mutable_cpu_data();
+                        for (auto crop = batchBegin ; crop < batchBegin + batchSize ; crop++)
+                        {
+                            const auto hand = cropHands[crop];
+                            const auto person = cropPeople[crop];
+                            auto& handCurrent = mHandKeypoints[hand];
+                            const auto* handPeaksPtr = handPeaksBatchPtr
+                                                     + (crop - batchBegin) * upImpl->spPeaksBlob->count(1);
+                            // Single-scale detection
+                            if (numberScales == 1)
+                                connectKeypoints(handCurrent, person, affineMatrices[crop], handPeaksPtr);
+                            // Multi-scale detection: keep the scale with the highest average score
+                            else
+                            {
+                                connectKeypoints(handEstimated, 0, affineMatrices[crop], handPeaksPtr);
+                                const auto handPtrArea = handCurrent.getSize(1) * handCurrent.getSize(2);
+                                if (cropScales[crop] == 0
+                                    || getAverageScore(handEstimated,0) > getAverageScore(handCurrent,person))
+                                    std::copy(handEstimated.getConstPtr(), handEstimated.getConstPtr() + handPtrArea,
+                                              handCurrent.getPtr() + person * handPtrArea);
+                            }
+                            // HeatMaps: storing (the ones of the last scale)
+                            if (!mHeatMapTypes.empty() && cropScales[crop] == numberScales - 1)
+                            {
+                                #ifdef USE_CUDA
+                                    updateHandHeatMapsForPerson(
+                                        mHeatMaps[hand], person, mHeatMapScaleMode,
+                                        upImpl->spHeatMapsBlob->gpu_data() + (crop - batchBegin) * heatMapsVolume);
+                                #else
+                                    updateHandHeatMapsForPerson(
+                                        mHeatMaps[hand], person, mHeatMapScaleMode,
+                                        upImpl->spHeatMapsBlob->cpu_data() + (crop - batchBegin) * heatMapsVolume);
+                                #endif
                             }
                         }
                     }
+                    // 5. CUDA sanity check
+                    #ifdef USE_CUDA
+                        cudaCheck(__LINE__, __FUNCTION__, __FILE__);
+                    #endif
                     // // Debugging
                     // cv::imshow("cvInputDataCopied", cvInputDataCopied);
                 }
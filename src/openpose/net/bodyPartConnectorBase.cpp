@@ -1,19 +1,120 @@
 #include <openpose/net/bodyPartConnectorBase.hpp>
 #include <algorithm> // std::sort
 #include <cmath> // std::sqrt
-#include <set>
+#include <openpose/net/resizeAndMergeBase.hpp>
 #include <openpose/utilities/check.hpp>
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/keypoint.hpp>
+#include <openpose/utilities/threadPool.hpp>
 #include <openpose/pose/poseParameters.hpp>
 
 namespace op
 {
+    template <typename T>
+    PeopleTable<T>::PeopleTable(const unsigned int numberBodyParts_) :
+        numberBodyParts{numberBodyParts_}
+    {
+    }
+
+    template <typename T>
+    void PeopleTable<T>::reset(const unsigned int numberBodyParts_)
+    {
+        try
+        {
+            numberBodyParts = numberBodyParts_;
+            // clear() keeps the capacity
+            indexes.clear();
+            counters.clear();
+            scores.clear();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template <typename T>
+    int PeopleTable<T>::emplaceBack(const int counter, const T score)
+    {
+        try
+        {
+            indexes.resize(indexes.size() + numberBodyParts, 0);
+            counters.emplace_back(counter);
+            scores.emplace_back(score);
+            return (int)counters.size()-1;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return -1;
+        }
+    }
+
+    template <typename T>
+    void PeopleTable<T>::erase(const std::vector<char>& removed)
+    {
+        try
+        {
+            auto newSize = 0u;
+            for (auto person = 0u ; person < size() ; person++)
+            {
+                if (!removed[person])
+                {
+                    if (newSize != person)
+                    {
+                        std::copy(
+                            indexes.begin() + person*numberBodyParts, indexes.begin() + (person+1)*numberBodyParts,
+                            indexes.begin() + newSize*numberBodyParts);
+                        counters[newSize] = counters[person];
+                        scores[newSize] = scores[person];
+                    }
+                    newSize++;
+                }
+            }
+            indexes.resize(newSize*numberBodyParts);
+            counters.resize(newSize);
+            scores.resize(newSize);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template <typename T>
+    unsigned int PeopleTable<T>::size() const
+    {
+        return (unsigned int)counters.size();
+    }
+
+    template <typename T>
+    bool PeopleTable<T>::empty() const
+    {
+        return counters.empty();
+    }
+
+    template <typename T>
+    int* PeopleTable<T>::operator[](const unsigned int person)
+    {
+        return &indexes[person*numberBodyParts];
+    }
+
+    template <typename T>
+    const int* PeopleTable<T>::operator[](const unsigned int person) const
+    {
+        return &indexes[person*numberBodyParts];
+    }
+
+    COMPILE_TEMPLATE_FLOATING_TYPES_STRUCT(PeopleTable);
+
+    // Maximum number of points sampled in the line integral of getScoreAB
+    const auto MAX_POINTS_IN_LINE = 25;
+
     template <typename T>
     inline T getScoreAB(
         const int i, const int j, const T* const candidateAPtr, const T* const candidateBPtr, const T* const mapX,
         const T* const mapY, const Point<int>& heatMapSize, const T interThreshold, const T interMinAboveThreshold,
-        const T defaultNmsThreshold)
+        const T defaultNmsThreshold, const Point<int>& heatMapSourceSize)
     {
         try
         {
@@ -21,7 +122,7 @@ namespace op
             const auto vectorAToBY = candidateBPtr[3*j+1] - candidateAPtr[3*i+1];
             const auto vectorAToBMax = fastMax(std::abs(vectorAToBX), std::abs(vectorAToBY));
             const auto numberPointsInLine = fastMax(
-                5, fastMin(25, positiveIntRound(std::sqrt(5*vectorAToBMax))));
+                5, fastMin(MAX_POINTS_IN_LINE, positiveIntRound(std::sqrt(5*vectorAToBMax))));
             const auto vectorNorm = T(std::sqrt( vectorAToBX*vectorAToBX + vectorAToBY*vectorAToBY ));
             // If the peaksPtr are coincident. Don't connect them.
             if (vectorNorm > 1e-6)
@@ -31,8 +132,8 @@ namespace op
                 const auto vectorAToBNormX = vectorAToBX/vectorNorm;
                 const auto vectorAToBNormY = vectorAToBY/vectorNorm;
 
-                auto sum = T(0);
-                auto count = 0u;
+                // PAF scores along the line
+                T scores[MAX_POINTS_IN_LINE];
                 const auto vectorAToBXInLine = vectorAToBX/numberPointsInLine;
                 const auto vectorAToBYInLine = vectorAToBY/numberPointsInLine;
                 for (auto lm = 0; lm < numberPointsInLine; lm++)
@@ -41,13 +142,27 @@ namespace op
                         0, fastMin(heatMapSize.x-1, positiveIntRound(sX + lm*vectorAToBXInLine)));
                     const auto mY = fastMax(
                         0, fastMin(heatMapSize.y-1, positiveIntRound(sY + lm*vectorAToBYInLine)));
-                    const auto idx = mY * heatMapSize.x + mX;
-                    const auto score = (vectorAToBNormX*mapX[idx] + vectorAToBNormY*mapY[idx]);
-                    if (score > interThreshold)
+                    // PAFs at heatMapSize resolution
+                    if (heatMapSourceSize.x <= 0)
                     {
-                        sum += score;
-                        count++;
+                        const auto idx = mY * heatMapSize.x + mX;
+                        scores[lm] = (vectorAToBNormX*mapX[idx] + vectorAToBNormY*mapY[idx]);
                     }
+                    // Low-resolution PAFs: upsampled on demand
+                    else
+                        scores[lm] = vectorAToBNormX*resizeCubicPixelCpu(mapX, heatMapSourceSize, heatMapSize, mX, mY)
+                                   + vectorAToBNormY*resizeCubicPixelCpu(mapY, heatMapSourceSize, heatMapSize, mX, mY);
+                }
+                // Line integral (branchless so the compiler can vectorize it)
+                // Note: Adding 0 does not modify sum, so the result is the same than only adding the scores above
+                // the threshold
+                auto sum = T(0);
+                auto count = 0u;
+                for (auto lm = 0; lm < numberPointsInLine; lm++)
+                {
+                    const auto aboveThreshold = (scores[lm] > interThreshold);
+                    sum += (aboveThreshold ? scores[lm] : T(0));
+                    count += (unsigned int)aboveThreshold;
                 }
                 // Return PAF score
                 if (count/T(numberPointsInLine) > interMinAboveThreshold)
@@ -74,17 +189,75 @@ namespace op
         }
     }
 
+    template <typename T>
+    void getPairScoresCpu(
+        T* pairScoresPtr, const T* const heatMapPtr, const T* const peaksPtr, const PoseModel poseModel,
+        const Point<int>& heatMapSize, const int maxPeaks, const T interThreshold, const T interMinAboveThreshold,
+        const std::vector<unsigned int>& bodyPartPairs, const unsigned int numberBodyParts,
+        const unsigned int numberBodyPartPairs, const T defaultNmsThreshold, const Point<int>& heatMapSourceSize)
+    {
+        try
+        {
+            // Equivalent to the pafScoreKernel of the GPU version: pairScoresPtr is a
+            // [numberBodyPartPairs x maxPeaks x maxPeaks] array with the PAF score of each pair of candidates
+            const auto& mapIdx = getPoseMapIndex(poseModel);
+            const auto numberBodyPartsAndBkg = numberBodyParts + (addBkgChannel(poseModel) ? 1 : 0);
+            const auto peaksOffset = 3*(maxPeaks+1);
+            const auto heatMapOffset = (heatMapSourceSize.x <= 0 ? heatMapSize.area() : heatMapSourceSize.area());
+            // Parallel only if there are enough candidate pairs to compensate for the ThreadPool overhead
+            auto numberCandidatePairs = 0;
+            for (auto pairIndex = 0u; pairIndex < numberBodyPartPairs; pairIndex++)
+                numberCandidatePairs +=
+                    positiveIntRound(peaksPtr[bodyPartPairs[2*pairIndex]*peaksOffset])
+                    * positiveIntRound(peaksPtr[bodyPartPairs[2*pairIndex+1]*peaksOffset]);
+            const auto minCandidatePairsPerChunk = (heatMapSourceSize.x <= 0 ? 512 : 32);
+            // Chunks of 1 body part pair, so the threads take the next pair to score dynamically (they have very
+            // different number of candidates)
+            ThreadPool::parallelFor(
+                0, (int)numberBodyPartPairs,
+                [&](const int pairBegin, const int pairEnd)
+                {
+                    for (auto pairIndex = (unsigned int)pairBegin ; pairIndex < (unsigned int)pairEnd ; pairIndex++)
+                    {
+                        const auto* candidateAPtr = peaksPtr + bodyPartPairs[2*pairIndex]*peaksOffset;
+                        const auto* candidateBPtr = peaksPtr + bodyPartPairs[2*pairIndex+1]*peaksOffset;
+                        const auto numberPeaksA = positiveIntRound(candidateAPtr[0]);
+                        const auto numberPeaksB = positiveIntRound(candidateBPtr[0]);
+                        const auto* mapX = heatMapPtr
+                                         + (numberBodyPartsAndBkg + mapIdx[2*pairIndex]) * heatMapOffset;
+                        const auto* mapY = heatMapPtr
+                                         + (numberBodyPartsAndBkg + mapIdx[2*pairIndex+1]) * heatMapOffset;
+                        auto* pairScoresPairPtr = pairScoresPtr + pairIndex*maxPeaks*maxPeaks;
+                        // E.g., neck-nose connection. For each neck
+                        for (auto i = 1; i <= numberPeaksA; i++)
+                            // E.g., neck-nose connection. For each nose
+                            for (auto j = 1; j <= numberPeaksB; j++)
+                                // -1 because peaksPtr starts with counter
+                                pairScoresPairPtr[(i-1)*maxPeaks + j-1] = getScoreAB(
+                                    i, j, candidateAPtr, candidateBPtr, mapX, mapY, heatMapSize, interThreshold,
+                                    interMinAboveThreshold, defaultNmsThreshold, heatMapSourceSize);
+                    }
+                },
+                (numberCandidatePairs < 2*minCandidatePairsPerChunk ? (int)numberBodyPartPairs : 1));
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template <typename T>
     void getKeypointCounter(
-        int& personCounter, const std::vector<std::pair<std::vector<int>, T>>& peopleVector,
-        const unsigned int part, const int partFirst, const int partLast, const int minimum)
+        int& personCounter, const PeopleTable<T>& peopleVector, const unsigned int part, const int partFirst,
+        const int partLast, const int minimum)
     {
         try
         {
             // Count keypoints
             auto keypointCounter = 0;
+            const auto* personIndexes = peopleVector[part];
             for (auto i = partFirst ; i < partLast ; i++)
-                keypointCounter += (peopleVector[part].first.at(i) > 0);
+                keypointCounter += (personIndexes[i] > 0);
             // If enough keypoints --> subtract them and keep them at least as big as minimum
             if (keypointCounter > minimum)
                 personCounter += minimum-keypointCounter; // personCounter = non-considered keypoints + minimum
@@ -97,9 +270,8 @@ namespace op
 
     template <typename T>
     void getRoiDiameterAndBounds(
-        Rectangle<T>& roi, int& partFirstNon0, int& partLastNon0,
-        const std::vector<int>& personVector, const T* const peaksPtr,
-        const int partInit, const int partEnd, const T margin)
+        Rectangle<T>& roi, int& partFirstNon0, int& partLastNon0, const int* const personIndexes,
+        const T* const peaksPtr, const int partInit, const int partEnd, const T margin)
     {
         try
         {
@@ -109,11 +281,10 @@ namespace op
             partLastNon0 = -1;
             for (auto part = partInit ; part < partEnd ; part++)
             {
-                const auto x = peaksPtr[personVector[part]-2];
-                const auto y = peaksPtr[personVector[part]-1];
-                const auto score = peaksPtr[personVector[part]];
-                if (personVector[part] > 0 && score > 0)
+                if (personIndexes[part] > 0 && peaksPtr[personIndexes[part]] > 0)
                 {
+                    const auto x = peaksPtr[personIndexes[part]-2];
+                    const auto y = peaksPtr[personIndexes[part]-1];
                     // ROI
                     if (roi.x > x)
                         roi.x = x;
@@ -154,11 +325,12 @@ namespace op
     }
 
     template <typename T>
-    std::vector<std::pair<std::vector<int>, T>> createPeopleVector(
-        const T* const heatMapPtr, const T* const peaksPtr, const PoseModel poseModel, const Point<int>& heatMapSize,
-        const int maxPeaks, const T interThreshold, const T interMinAboveThreshold,
+    void createPeopleVector(
+        PeopleTable<T>& peopleVector, const T* const heatMapPtr, const T* const peaksPtr, const PoseModel poseModel,
+        const Point<int>& heatMapSize, const int maxPeaks, const T interThreshold, const T interMinAboveThreshold,
         const std::vector<unsigned int>& bodyPartPairs, const unsigned int numberBodyParts,
-        const unsigned int numberBodyPartPairs, const T defaultNmsThreshold, const Array<T>& pairScores)
+        const unsigned int numberBodyPartPairs, const T defaultNmsThreshold, const Array<T>& pairScores,
+        const Point<int>& heatMapSourceSize)
     {
         try
         {
@@ -166,15 +338,36 @@ namespace op
                 && poseModel != PoseModel::MPI_15 && poseModel != PoseModel::MPI_15_4)
                 error("Model not implemented for CPU body connector.", __LINE__, __FUNCTION__, __FILE__);
 
-            // std::vector<std::pair<std::vector<int>, double>> refers to:
-            //     - std::vector<int>: [body parts locations, #body parts found]
-            //     - double: person subset score
-            std::vector<std::pair<std::vector<int>, T>> peopleVector;
-            const auto& mapIdx = getPoseMapIndex(poseModel);
-            const auto numberBodyPartsAndBkg = numberBodyParts + (addBkgChannel(poseModel) ? 1 : 0);
-            const auto vectorSize = numberBodyParts+1;
+            // peopleVector: [body parts locations, #body parts found, person subset score] for each person
+            peopleVector.reset(numberBodyParts);
             const auto peaksOffset = 3*(maxPeaks+1);
-            const auto heatMapOffset = heatMapSize.area();
+            // Buffers kept across frames
+            thread_local std::vector<T> sPairScores;
+            thread_local std::vector<std::tuple<double, int, int>> sAllABConnections;
+            thread_local std::vector<std::tuple<int, int, double>> sABConnections;
+            thread_local std::vector<int> sOccurA;
+            thread_local std::vector<int> sOccurB;
+            // Score all the PAF connections at once (in parallel)
+            const T* pairScoresPtr = nullptr;
+            auto pairScoresSize1 = 0;
+            auto pairScoresSize2 = 0;
+            if (heatMapPtr != nullptr)
+            {
+                sPairScores.resize(numberBodyPartPairs*maxPeaks*maxPeaks);
+                getPairScoresCpu(
+                    sPairScores.data(), heatMapPtr, peaksPtr, poseModel, heatMapSize, maxPeaks, interThreshold,
+                    interMinAboveThreshold, bodyPartPairs, numberBodyParts, numberBodyPartPairs, defaultNmsThreshold,
+                    heatMapSourceSize);
+                pairScoresPtr = sPairScores.data();
+                pairScoresSize1 = maxPeaks;
+                pairScoresSize2 = maxPeaks;
+            }
+            else if (!pairScores.empty())
+            {
+                pairScoresPtr = pairScores.getConstPtr();
+                pairScoresSize1 = pairScores.getSize(1);
+                pairScoresSize2 = pairScores.getSize(2);
+            }
             // Iterate over it PAF connection, e.g., neck-nose, neck-Lshoulder, etc.
             for (auto pairIndex = 0u; pairIndex < numberBodyPartPairs; pairIndex++)
             {
@@ -189,101 +382,38 @@ namespace op
                 // Add the non-empty elements into the peopleVector
                 if (numberPeaksA == 0 || numberPeaksB == 0)
                 {
-                    // E.g., neck-nose connection. If no necks, add all noses
-                    // Change w.r.t. other
-                    if (numberPeaksA == 0) // numberPeaksB == 0 or not
-                    {
-                        // Non-MPI
-                        if (numberBodyParts != 15)
-                        {
-                            for (auto i = 1; i <= numberPeaksB; i++)
-                            {
-                                bool found = false;
-                                for (const auto& personVector : peopleVector)
-                                {
-                                    const auto off = (int)bodyPartB*peaksOffset + i*3 + 2;
-                                    if (personVector.first[bodyPartB] == off)
-                                    {
-                                        found = true;
-                                        break;
-                                    }
-                                }
-                                // Add new personVector with this element
-                                if (!found)
-                                {
-                                    std::vector<int> rowVector(vectorSize, 0);
-                                    // Store the index
-                                    rowVector[ bodyPartB ] = bodyPartB*peaksOffset + i*3 + 2;
-                                    // Last number in each row is the parts number of that person
-                                    rowVector.back() = 1;
-                                    const auto personScore = candidateBPtr[i*3+2];
-                                    // Second last number in each row is the total score
-                                    peopleVector.emplace_back(std::make_pair(rowVector, personScore));
-                                }
-                            }
-                        }
-                        // MPI
-                        else
-                        {
-                            for (auto i = 1; i <= numberPeaksB; i++)
-                            {
-                                std::vector<int> rowVector(vectorSize, 0);
-                                // Store the index
-                                rowVector[ bodyPartB ] = bodyPartB*peaksOffset + i*3 + 2;
-                                // Last number in each row is the parts number of that person
-                                rowVector.back() = 1;
-                                // Second last number in each row is the total score
-                                const auto personScore = candidateBPtr[i*3+2];
-                                peopleVector.emplace_back(std::make_pair(rowVector, personScore));
-                            }
-                        }
-                    }
+                    // E.g., neck-nose connection. If no necks, add all noses (numberPeaksB == 0 or not)
                     // E.g., neck-nose connection. If no noses, add all necks
-                    else // if (numberPeaksA != 0 && numberPeaksB == 0)
+                    const auto bodyPartNon0 = (numberPeaksA == 0 ? bodyPartB : bodyPartA);
+                    const auto* candidateNon0Ptr = (numberPeaksA == 0 ? candidateBPtr : candidateAPtr);
+                    const auto numberPeaksNon0 = (numberPeaksA == 0 ? numberPeaksB : numberPeaksA);
+                    const auto numberPeople = peopleVector.size();
+                    for (auto i = 1; i <= numberPeaksNon0; i++)
                     {
-                        // Non-MPI
+                        const auto off = (int)bodyPartNon0*peaksOffset + i*3 + 2;
+                        bool found = false;
+                        // Non-MPI: Only add it if not already in a person
+                        // Note: Only the people added before this pair need to be checked, the new ones contain
+                        // different candidates
                         if (numberBodyParts != 15)
                         {
-                            for (auto i = 1; i <= numberPeaksA; i++)
+                            for (auto person = 0u ; person < numberPeople ; person++)
                             {
-                                bool found = false;
-                                const auto indexA = bodyPartA;
-                                for (const auto& personVector : peopleVector)
+                                if (peopleVector[person][bodyPartNon0] == off)
                                 {
-                                    const auto off = (int)bodyPartA*peaksOffset + i*3 + 2;
-                                    if (personVector.first[indexA] == off)
-                                    {
-                                        found = true;
-                                        break;
-                                    }
-                                }
-                                if (!found)
-                                {
-                                    std::vector<int> rowVector(vectorSize, 0);
-                                    // Store the index
-                                    rowVector[ bodyPartA ] = bodyPartA*peaksOffset + i*3 + 2;
-                                    // Last number in each row is the parts number of that person
-                                    rowVector.back() = 1;
-                                    // Second last number in each row is the total score
-                                    const auto personScore = candidateAPtr[i*3+2];
-                                    peopleVector.emplace_back(std::make_pair(rowVector, personScore));
+                                    found = true;
+                                    break;
                                 }
                             }
                         }
-                        // MPI
-                        else
+                        // Add new personVector with this element
+                        if (!found)
                         {
-                            for (auto i = 1; i <= numberPeaksA; i++)
-                            {
-                                std::vector<int> rowVector(vectorSize, 0);
-                                // Store the index
-                                rowVector[ bodyPartA ] = bodyPartA*peaksOffset + i*3 + 2;
-                                // Last number in each row is the parts number of that person
-                                rowVector.back() = 1;
-                                // Second last number in each row is the total score
-                                const auto personScore = candidateAPtr[i*3+2];
-                                peopleVector.emplace_back(std::make_pair(rowVector, personScore));
-                            }
+                            // Last number in each row is the parts number of that person
+                            // Second last number in each row is the total score
+                            const auto person = peopleVector.emplaceBack(1, candidateNon0Ptr[i*3+2]);
+                            // Store the index
+                            peopleVector[person][bodyPartNon0] = off;
                         }
                     }
                 }
@@ -291,44 +421,21 @@ namespace op
                 else // if (numberPeaksA != 0 && numberPeaksB != 0)
                 {
                     // (score, indexA, indexB). Inverted order for easy std::sort
-                    std::vector<std::tuple<double, int, int>> allABConnections;
+                    auto& allABConnections = sAllABConnections;
+                    allABConnections.clear();
                     // Note: Problem of this function, if no right PAF between A and B, both elements are
                     // discarded. However, they should be added independently, not discarded
-                    if (heatMapPtr != nullptr)
+                    if (pairScoresPtr != nullptr)
                     {
-                        const auto* mapX = heatMapPtr
-                                         + (numberBodyPartsAndBkg + mapIdx[2*pairIndex]) * heatMapOffset;
-                        const auto* mapY = heatMapPtr
-                                         + (numberBodyPartsAndBkg + mapIdx[2*pairIndex+1]) * heatMapOffset;
-                        // E.g., neck-nose connection. For each neck
-                        for (auto i = 1; i <= numberPeaksA; i++)
-                        {
-                            // E.g., neck-nose connection. For each nose
-                            for (auto j = 1; j <= numberPeaksB; j++)
-                            {
-                                // Initial PAF
-                                auto scoreAB = getScoreAB(
-                                    i, j, candidateAPtr, candidateBPtr, mapX, mapY, heatMapSize, interThreshold,
-                                    interMinAboveThreshold, defaultNmsThreshold);
-
-                                // E.g., neck-nose connection. If possible PAF between neck i, nose j --> add
-                                // parts score + connection score
-                                if (scoreAB > 1e-6)
-                                    allABConnections.emplace_back(std::make_tuple(scoreAB, i, j));
-                            }
-                        }
-                    }
-                    else if (!pairScores.empty())
-                    {
-                        const auto firstIndex = (int)pairIndex*pairScores.getSize(1)*pairScores.getSize(2);
+                        const auto firstIndex = (int)pairIndex*pairScoresSize1*pairScoresSize2;
                         // E.g., neck-nose connection. For each neck
                         for (auto i = 0; i < numberPeaksA; i++)
                         {
-                            const auto iIndex = firstIndex + i*pairScores.getSize(2);
+                            const auto iIndex = firstIndex + i*pairScoresSize2;
                             // E.g., neck-nose connection. For each nose
                             for (auto j = 0; j < numberPeaksB; j++)
                             {
-                                const auto scoreAB = pairScores[iIndex + j];
+                                const auto scoreAB = pairScoresPtr[iIndex + j];
 
                                 // E.g., neck-nose connection. If possible PAF between neck i, nose j --> add
                                 // parts score + connection score
@@ -347,11 +454,14 @@ namespace op
                         std::sort(allABConnections.begin(), allABConnections.end(),
                                   std::greater<std::tuple<double, int, int>>());
 
-                    std::vector<std::tuple<int, int, double>> abConnections; // (x, y, score)
+                    auto& abConnections = sABConnections; // (x, y, score)
+                    abConnections.clear();
                     {
                         const auto minAB = fastMin(numberPeaksA, numberPeaksB);
-                        std::vector<int> occurA(numberPeaksA, 0);
-                        std::vector<int> occurB(numberPeaksB, 0);
+                        auto& occurA = sOccurA;
+                        auto& occurB = sOccurB;
+                        occurA.assign(numberPeaksA, 0);
+                        occurB.assign(numberPeaksB, 0);
                         auto counter = 0;
                         for (const auto& aBConnection : allABConnections)
                         {
@@ -379,16 +489,14 @@ namespace op
                         {
                             for (const auto& abConnection : abConnections)
                             {
-                                std::vector<int> rowVector(numberBodyParts+3, 0);
                                 const auto indexA = std::get<0>(abConnection);
                                 const auto indexB = std::get<1>(abConnection);
                                 const auto score = std::get<2>(abConnection);
-                                rowVector[bodyPartPairs[0]] = indexA;
-                                rowVector[bodyPartPairs[1]] = indexB;
-                                rowVector.back() = 2;
                                 // add the score of parts and the connection
                                 const auto personScore = T(peaksPtr[indexA] + peaksPtr[indexB] + score);
-                                peopleVector.emplace_back(std::make_pair(rowVector, personScore));
+                                const auto person = peopleVector.emplaceBack(2, personScore);
+                                peopleVector[person][bodyPartPairs[0]] = indexA;
+                                peopleVector[person][bodyPartPairs[1]] = indexB;
                             }
                         }
                         // Add ears connections (in case person is looking to opposite direction to camera)
@@ -407,21 +515,21 @@ namespace op
                             {
                                 const auto indexA = std::get<0>(abConnection);
                                 const auto indexB = std::get<1>(abConnection);
-                                for (auto& personVector : peopleVector)
+                                for (auto person = 0u ; person < peopleVector.size() ; person++)
                                 {
-                                    auto& personVectorA = personVector.first[bodyPartA];
-                                    auto& personVectorB = personVector.first[bodyPartB];
+                                    auto& personVectorA = peopleVector[person][bodyPartA];
+                                    auto& personVectorB = peopleVector[person][bodyPartB];
                                     if (personVectorA == indexA && personVectorB == 0)
                                     {
                                         personVectorB = indexB;
                                         // // This seems to harm acc 0.1% for BODY_25
-                                        // personVector.first.back()++;
+                                        // peopleVector.counters[person]++;
                                     }
                                     else if (personVectorB == indexB && personVectorA == 0)
                                     {
                                         personVectorA = indexA;
                                         // // This seems to harm acc 0.1% for BODY_25
-                                        // personVector.first.back()++;
+                                        // peopleVector.counters[person]++;
                                     }
                                 }
                             }
@@ -435,14 +543,14 @@ namespace op
                                 const auto indexB = std::get<1>(abConnection);
                                 const auto score = T(std::get<2>(abConnection));
                                 bool found = false;
-                                for (auto& personVector : peopleVector)
+                                for (auto person = 0u ; person < peopleVector.size() ; person++)
                                 {
                                     // Found partA in a peopleVector, add partB to same one.
-                                    if (personVector.first[bodyPartA] == indexA)
+                                    if (peopleVector[person][bodyPartA] == indexA)
                                     {
-                                        personVector.first[bodyPartB] = indexB;
-                                        personVector.first.back()++;
-                                        personVector.second += peaksPtr[indexB] + score;
+                                        peopleVector[person][bodyPartB] = indexB;
+                                        peopleVector.counters[person]++;
+                                        peopleVector.scores[person] += peaksPtr[indexB] + score;
                                         found = true;
                                         break;
                                     }
@@ -450,24 +558,20 @@ namespace op
                                 // Not found partA in peopleVector, add new peopleVector element
                                 if (!found)
                                 {
-                                    std::vector<int> rowVector(vectorSize, 0);
-                                    rowVector[bodyPartA] = indexA;
-                                    rowVector[bodyPartB] = indexB;
-                                    rowVector.back() = 2;
                                     const auto personScore = T(peaksPtr[indexA] + peaksPtr[indexB] + score);
-                                    peopleVector.emplace_back(std::make_pair(rowVector, personScore));
+                                    const auto person = peopleVector.emplaceBack(2, personScore);
+                                    peopleVector[person][bodyPartA] = indexA;
+                                    peopleVector[person][bodyPartB] = indexB;
                                 }
                             }
                         }
                     }
                 }
             }
-            return peopleVector;
         }
         catch (const std::exception& e)
         {
             error(e.what(), __LINE__, __FUNCTION__, __FILE__);
-            return {};
         }
     }
 
@@ -542,21 +646,24 @@ namespace op
     }
 
     template <typename T>
-    std::vector<std::pair<std::vector<int>, T>> pafVectorIntoPeopleVector(
-        const std::vector<std::tuple<T, T, int, int, int>>& pairConnections, const T* const peaksPtr,
-        const int maxPeaks, const std::vector<unsigned int>& bodyPartPairs, const unsigned int numberBodyParts)
+    void pafVectorIntoPeopleVector(
+        PeopleTable<T>& peopleVector, const std::vector<std::tuple<T, T, int, int, int>>& pairConnections,
+        const T* const peaksPtr, const int maxPeaks, const std::vector<unsigned int>& bodyPartPairs,
+        const unsigned int numberBodyParts)
     {
         try
         {
-            // std::vector<std::pair<std::vector<int>, double>> refers to:
-            //     - std::vector<int>: [body parts locations, #body parts found]
-            //     - double: person subset score
-            std::vector<std::pair<std::vector<int>, T>> peopleVector;
-            const auto vectorSize = numberBodyParts+1;
+            // peopleVector: [body parts locations, #body parts found, person subset score] for each person
+            peopleVector.reset(numberBodyParts);
             const auto peaksOffset = (maxPeaks+1);
             // Save which body parts have been already assigned
-            std::vector<int> personAssigned(numberBodyParts*maxPeaks, -1);
-            std::set<int, std::greater<int>> indexesToRemoveSortedSet;
+            thread_local std::vector<int> sPersonAssigned;
+            auto& personAssigned = sPersonAssigned;
+            personAssigned.assign(numberBodyParts*maxPeaks, -1);
+            // People merged into another one (removed at the very end)
+            thread_local std::vector<char> sPeopleRemoved;
+            auto& peopleRemoved = sPeopleRemoved;
+            peopleRemoved.clear();
             // Iterate over each PAF pair connection detected
             // E.g., neck1-nose2, neck5-Lshoulder0, etc.
             for (const auto& pairConnection : pairConnections)
@@ -598,19 +705,17 @@ namespace op
                 // 1. A & B not assigned yet: Create new person
                 if (aAssigned < 0 && bAssigned < 0)
                 {
-                    // Keypoint indexes
-                    std::vector<int> rowVector(vectorSize, 0);
-                    rowVector[bodyPartA] = indexScoreA;
-                    rowVector[bodyPartB] = indexScoreB;
-                    // Number keypoints
-                    rowVector.back() = 2;
                     // Score
                     const auto personScore = T(peaksPtr[indexScoreA] + peaksPtr[indexScoreB] + pafScore);
+                    // Create new personVector (with 2 keypoints)
+                    const auto person = peopleVector.emplaceBack(2, personScore);
+                    peopleRemoved.emplace_back(0);
+                    // Keypoint indexes
+                    peopleVector[person][bodyPartA] = indexScoreA;
+                    peopleVector[person][bodyPartB] = indexScoreB;
                     // Set associated personAssigned as assigned
-                    aAssigned = (int)peopleVector.size();
+                    aAssigned = person;
                     bAssigned = aAssigned;
-                    // Create new personVector
-                    peopleVector.emplace_back(std::make_pair(rowVector, personScore));
                 }
                 // 2. A assigned but not B: Add B to person with A (if no another B there)
                 // or
@@ -624,28 +729,28 @@ namespace op
                     const auto bodyPart2 = (aAssigned >= 0 ? bodyPartB : bodyPartA);
                     const auto indexScore2 = (aAssigned >= 0 ? indexScoreB : indexScoreA);
                     // Person index
-                    auto& personVector = peopleVector[assigned1];
+                    auto* personVector = peopleVector[assigned1];
                     // Debugging
                     #ifdef DEBUG
                         const auto bodyPart1 = (aAssigned >= 0 ? bodyPartA : bodyPartB);
                         const auto indexScore1 = (aAssigned >= 0 ? indexScoreA : indexScoreB);
                         const auto index1 = (aAssigned >= 0 ? indexA : indexB);
-                        if ((unsigned int)personVector.first.at(bodyPart1) != indexScore1)
+                        if ((unsigned int)personVector[bodyPart1] != indexScore1)
                             error("Something is wrong: "
-                                  + std::to_string((personVector.first[bodyPart1]-2)/3-bodyPart1*peaksOffset)
+                                  + std::to_string((personVector[bodyPart1]-2)/3-bodyPart1*peaksOffset)
                                   + " vs. " + std::to_string((indexScore1-2)/3-bodyPart1*peaksOffset) + " vs. "
                                   + std::to_string(index1) + ". Contact us.",
                                   __LINE__, __FUNCTION__, __FILE__);
                     #endif
                     // If person with 1 does not have a 2 yet
-                    if (personVector.first[bodyPart2] == 0)
+                    if (personVector[bodyPart2] == 0)
                     {
                         // Update keypoint indexes
-                        personVector.first[bodyPart2] = indexScore2;
+                        personVector[bodyPart2] = indexScore2;
                         // Update number keypoints
-                        personVector.first.back()++;
+                        peopleVector.counters[assigned1]++;
                         // Update score
-                        personVector.second += peaksPtr[indexScore2] + pafScore;
+                        peopleVector.scores[assigned1] += peaksPtr[indexScore2] + pafScore;
                         // Set associated personAssigned as assigned
                         assigned2 = assigned1;
                     }
@@ -653,7 +758,7 @@ namespace op
                 }
                 // 4. A & B already assigned to same person (circular/redundant PAF): Update person score
                 else if (aAssigned >=0 && bAssigned >=0 && aAssigned == bAssigned)
-                    peopleVector[aAssigned].second += pafScore;
+                    peopleVector.scores[aAssigned] += pafScore;
                 // 5. A & B already assigned to different people: Merge people if keypoint intersection is null
                 // I.e., that the keypoints in person A and B do not overlap
                 else if (aAssigned >=0 && bAssigned >=0 && aAssigned != bAssigned)
@@ -664,8 +769,8 @@ namespace op
                     //        whether person1 > person2 or not: element = aAssigned - (person2 > person1 ? 1 : 0)
                     const auto assigned1 = (aAssigned < bAssigned ? aAssigned : bAssigned);
                     const auto assigned2 = (aAssigned < bAssigned ? bAssigned : aAssigned);
-                    auto& person1 = peopleVector[assigned1].first;
-                    const auto& person2 = peopleVector[assigned2].first;
+                    auto* person1 = peopleVector[assigned1];
+                    const auto* person2 = peopleVector[assigned2];
                     // Check if complementary
                     // Defining found keypoint indexes in personA as kA, and analogously kB
                     // Complementary if and only if kA intersection kB = empty. I.e., no common keypoints
@@ -686,12 +791,12 @@ namespace op
                             if (person1[part] == 0)
                                 person1[part] = person2[part];
                         // Update number keypoints
-                        person1.back() += person2.back();
+                        peopleVector.counters[assigned1] += peopleVector.counters[assigned2];
                         // Update score
-                        peopleVector[assigned1].second += peopleVector[assigned2].second + pafScore;
+                        peopleVector.scores[assigned1] += peopleVector.scores[assigned2] + pafScore;
                         // Erase the non-merged person
-                        // peopleVector.erase(peopleVector.begin()+assigned2); // x2 slower when removing on-the-fly
-                        indexesToRemoveSortedSet.emplace(assigned2); // Add into set so we can remove them all at once
+                        // Removing on-the-fly is slower, so they are all removed at once at the end
+                        peopleRemoved[assigned2] = 1;
                         // Update associated personAssigned (person indexes have changed)
                         for (auto& element : personAssigned)
                         {
@@ -705,23 +810,19 @@ namespace op
                 }
             }
             // Remove unused people
-            for (const auto& index : indexesToRemoveSortedSet)
-                peopleVector.erase(peopleVector.begin()+index);
-            // Return result
-            return peopleVector;
+            peopleVector.erase(peopleRemoved);
         }
         catch (const std::exception& e)
         {
             error(e.what(), __LINE__, __FUNCTION__, __FILE__);
-            return {};
         }
     }
 
     template <typename T>
     void removePeopleBelowThresholdsAndFillFaces(
-        std::vector<int>& validSubsetIndexes, int& numberPeople,
-        std::vector<std::pair<std::vector<int>, T>>& peopleVector, const unsigned int numberBodyParts,
-        const int minSubsetCnt, const T minSubsetScore, const bool maximizePositives, const T* const peaksPtr)
+        std::vector<int>& validSubsetIndexes, int& numberPeople, PeopleTable<T>& peopleVector,
+        const unsigned int numberBodyParts, const int minSubsetCnt, const T minSubsetScore,
+        const bool maximizePositives, const T* const peaksPtr)
         // const int minSubsetCnt, const T minSubsetScore, const int maxPeaks, const bool maximizePositives)
     {
         try
@@ -735,16 +836,17 @@ namespace op
             // validSubsetIndexes.reserve(fastMin((size_t)maxPeaks, peopleVector.size())); // maxPeaks is not required
             validSubsetIndexes.reserve(peopleVector.size());
             // Face valid sets
-            std::vector<int> faceValidSubsetIndexes;
-            faceValidSubsetIndexes.reserve(peopleVector.size());
+            thread_local std::vector<int> sFaceValidSubsetIndexes;
+            auto& faceValidSubsetIndexes = sFaceValidSubsetIndexes;
+            faceValidSubsetIndexes.clear();
             // Face invalid sets
-            std::vector<int> faceInvalidSubsetIndexes;
-            if (numberBodyParts >= 135)
-                faceInvalidSubsetIndexes.reserve(peopleVector.size());
+            thread_local std::vector<int> sFaceInvalidSubsetIndexes;
+            auto& faceInvalidSubsetIndexes = sFaceInvalidSubsetIndexes;
+            faceInvalidSubsetIndexes.clear();
             // For each person candidate
             for (auto person = 0u ; person < peopleVector.size() ; person++)
             {
-                auto personCounter = peopleVector[person].first.back();
+                auto personCounter = peopleVector.counters[person];
                 // Analog for hand/face keypoints
                 if (numberBodyParts >= 135)
                 {
@@ -782,7 +884,7 @@ namespace op
                         continue;
                 }
                 // Add only valid people
-                const auto personScore = peopleVector[person].second;
+                const auto personScore = peopleVector.scores[person];
                 if (personCounter >= minSubsetCnt && (personScore/personCounter) >= minSubsetScore)
                 {
                     numberPeople++;
@@ -808,7 +910,7 @@ namespace op
                     int partLastNon0Invalid = -1;
                     getRoiDiameterAndBounds(
                         roiInvalid, partFirstNon0Invalid, partLastNon0Invalid,
-                        peopleVector[personInvalid].first, peaksPtr, 65, 135, T(0.2));
+                        peopleVector[personInvalid], peaksPtr, 65, 135, T(0.2));
                     // Check all valid faces to find best candidate
                     float keypointsRoiBest = 0.f;
                     auto keypointsRoiBestIndex = -1;
@@ -820,8 +922,8 @@ namespace op
                         int partFirstNon0Valid = -1;
                         int partLastNon0Valid = -1;
                         getRoiDiameterAndBounds(
-                            roiValid, partFirstNon0Valid, partLastNon0Valid, peopleVector[personValid].first,
-                            peaksPtr, 65, 135, T(0.1));
+                            roiValid, partFirstNon0Valid, partLastNon0Valid, peopleVector[personValid], peaksPtr,
+                            65, 135, T(0.1));
                         // Get ROI between both faces
                         const auto keypointsRoi = getKeypointsRoi(roiValid, roiInvalid);
                         // Update best so far
@@ -838,9 +940,9 @@ namespace op
                         // If it is from that face --> Combine invalid face keypoints into valid face
                         for (auto part = partFirstNon0Invalid ; part < partLastNon0Invalid ; part++)
                         {
-                            auto& personVectorValid = peopleVector[personValid].first;
+                            auto* personVectorValid = peopleVector[personValid];
                             const auto scoreValid = peaksPtr[personVectorValid[part]];
-                            const auto& personVectorInvalid = peopleVector[personInvalid].first;
+                            const auto* personVectorInvalid = peopleVector[personInvalid];
                             const auto scoreInvalid = peaksPtr[personVectorInvalid[part]];
                             // If the new one has a keypoint...
                             if (personVectorInvalid[part] != 0)
@@ -851,14 +953,14 @@ namespace op
                                     if (personVectorInvalid[part] != 0)
                                     {
                                         personVectorValid[part] = personVectorInvalid[part];
-                                        peopleVector[personValid].second += scoreInvalid;
+                                        peopleVector.scores[personValid] += scoreInvalid;
                                     }
                                 }
                                 // ... and its score is higher than the original one, then replace it
                                 else if (scoreValid < scoreInvalid)
                                 {
                                     personVectorValid[part] = personVectorInvalid[part];
-                                    peopleVector[personValid].second += scoreInvalid - scoreValid;
+                                    peopleVector.scores[personValid] += scoreInvalid - scoreValid;
                                 }
                             }
                         }
@@ -885,10 +987,9 @@ namespace op
 
     template <typename T>
     void peopleVectorToPeopleArray(
-        Array<T>& poseKeypoints, Array<T>& poseScores, const T scaleFactor,
-        const std::vector<std::pair<std::vector<int>, T>>& peopleVector, const std::vector<int>& validSubsetIndexes,
-        const T* const peaksPtr, const int numberPeople, const unsigned int numberBodyParts,
-        const unsigned int numberBodyPartPairs)
+        Array<T>& poseKeypoints, Array<T>& poseScores, const T scaleFactor, const PeopleTable<T>& peopleVector,
+        const std::vector<int>& validSubsetIndexes, const T* const peaksPtr, const int numberPeople,
+        const unsigned int numberBodyParts, const unsigned int numberBodyPartPairs)
     {
         try
         {
@@ -910,8 +1011,7 @@ namespace op
             // For each person
             for (auto person = 0u ; person < validSubsetIndexes.size() ; person++)
             {
-                const auto& personPair = peopleVector[validSubsetIndexes[person]];
-                const auto& personVector = personPair.first;
+                const auto* personVector = peopleVector[validSubsetIndexes[person]];
                 // For each body part
                 for (auto bodyPart = 0u; bodyPart < numberBodyParts; bodyPart++)
                 {
@@ -924,7 +1024,7 @@ namespace op
                         poseKeypoints[baseOffset + 2] = peaksPtr[bodyPartIndex];
                     }
                 }
-                poseScores[person] = personPair.second * oneOverNumberBodyPartsAndPAFs;
+                poseScores[person] = peopleVector.scores[validSubsetIndexes[person]] * oneOverNumberBodyPartsAndPAFs;
             }
         }
         catch (const std::exception& e)
@@ -1329,7 +1429,7 @@ namespace op
         Array<T>& poseKeypoints, Array<T>& poseScores, const T* const heatMapPtr, const T* const peaksPtr,
         const PoseModel poseModel, const Point<int>& heatMapSize, const int maxPeaks, const T interMinAboveThreshold,
         const T interThreshold, const int minSubsetCnt, const T minSubsetScore, const T defaultNmsThreshold,
-        const T scaleFactor, const bool maximizePositives)
+        const T scaleFactor, const bool maximizePositives, const Point<int>& heatMapSourceSize)
     {
         try
         {
@@ -1340,21 +1440,21 @@ namespace op
             if (numberBodyParts == 0)
                 error("Invalid value of numberBodyParts, it must be positive, not " + std::to_string(numberBodyParts),
                       __LINE__, __FUNCTION__, __FILE__);
-            // std::vector<std::pair<std::vector<int>, double>> refers to:
-            //     - std::vector<int>: [body parts locations, #body parts found]
-            //     - double: person subset score
-
-            auto peopleVector = createPeopleVector(
-                heatMapPtr, peaksPtr, poseModel, heatMapSize, maxPeaks, interThreshold, interMinAboveThreshold,
-                bodyPartPairs, numberBodyParts, numberBodyPartPairs, defaultNmsThreshold);
+            // Buffers kept across frames (no memory allocation once they are big enough)
+            thread_local PeopleTable<T> sPeopleVector;
+            thread_local std::vector<int> sValidSubsetIndexes;
+            auto& peopleVector = sPeopleVector;
+            auto& validSubsetIndexes = sValidSubsetIndexes;
+            // peopleVector: [body parts locations, #body parts found, person subset score] for each person
+            createPeopleVector(
+                peopleVector, heatMapPtr, peaksPtr, poseModel, heatMapSize, maxPeaks, interThreshold,
+                interMinAboveThreshold, bodyPartPairs, numberBodyParts, numberBodyPartPairs, defaultNmsThreshold,
+                Array<T>(), heatMapSourceSize);
             // Delete people below the following thresholds:
                 // a) minSubsetCnt: removed if less than minSubsetCnt body parts
                 // b) minSubsetScore: removed if global score smaller than this
                 // c) maxPeaks (POSE_MAX_PEOPLE): keep first maxPeaks people above thresholds
             int numberPeople;
-            std::vector<int> validSubsetIndexes;
-            // validSubsetIndexes.reserve(fastMin((size_t)maxPeaks, peopleVector.size()));
-            validSubsetIndexes.reserve(peopleVector.size());
             removePeopleBelowThresholdsAndFillFaces(
                 validSubsetIndexes, numberPeople, peopleVector, numberBodyParts, minSubsetCnt, minSubsetScore,
                 maximizePositives, peaksPtr);
@@ -1381,49 +1481,45 @@ namespace op
         const float* const peaksPtr, const PoseModel poseModel, const Point<int>& heatMapSize, const int maxPeaks,
         const float interMinAboveThreshold, const float interThreshold, const int minSubsetCnt,
         const float minSubsetScore, const float defaultNmsThreshold, const float scaleFactor,
-        const bool maximizePositives);
+        const bool maximizePositives, const Point<int>& heatMapSourceSize);
     template OP_API void connectBodyPartsCpu(
         Array<double>& poseKeypoints, Array<double>& poseScores, const double* const heatMapPtr,
         const double* const peaksPtr, const PoseModel poseModel, const Point<int>& heatMapSize, const int maxPeaks,
         const double interMinAboveThreshold, const double interThreshold, const int minSubsetCnt,
         const double minSubsetScore, const double defaultNmsThreshold, const double scaleFactor,
-        const bool maximizePositives);
+        const bool maximizePositives, const Point<int>& heatMapSourceSize);
 
-    template OP_API std::vector<std::pair<std::vector<int>, float>> createPeopleVector(
-        const float* const heatMapPtr, const float* const peaksPtr, const PoseModel poseModel,
-        const Point<int>& heatMapSize, const int maxPeaks, const float interThreshold,
+    template OP_API void createPeopleVector(
+        PeopleTable<float>& peopleVector, const float* const heatMapPtr, const float* const peaksPtr,
+        const PoseModel poseModel, const Point<int>& heatMapSize, const int maxPeaks, const float interThreshold,
         const float interMinAboveThreshold, const std::vector<unsigned int>& bodyPartPairs,
         const unsigned int numberBodyParts, const unsigned int numberBodyPartPairs,
-        const float defaultNmsThreshold, const Array<float>& precomputedPAFs);
-    template OP_API std::vector<std::pair<std::vector<int>, double>> createPeopleVector(
-        const double* const heatMapPtr, const double* const peaksPtr, const PoseModel poseModel,
-        const Point<int>& heatMapSize, const int maxPeaks, const double interThreshold,
+        const float defaultNmsThreshold, const Array<float>& precomputedPAFs, const Point<int>& heatMapSourceSize);
+    template OP_API void createPeopleVector(
+        PeopleTable<double>& peopleVector, const double* const heatMapPtr, const double* const peaksPtr,
+        const PoseModel poseModel, const Point<int>& heatMapSize, const int maxPeaks, const double interThreshold,
         const double interMinAboveThreshold, const std::vector<unsigned int>& bodyPartPairs,
         const unsigned int numberBodyParts, const unsigned int numberBodyPartPairs,
-        const double defaultNmsThreshold, const Array<double>& precomputedPAFs);
+        const double defaultNmsThreshold, const Array<double>& precomputedPAFs, const Point<int>& heatMapSourceSize);
 
     template OP_API void removePeopleBelowThresholdsAndFillFaces(
-        std::vector<int>& validSubsetIndexes, int& numberPeople,
-        std::vector<std::pair<std::vector<int>, float>>& peopleVector,
+        std::vector<int>& validSubsetIndexes, int& numberPeople, PeopleTable<float>& peopleVector,
         const unsigned int numberBodyParts, const int minSubsetCnt, const float minSubsetScore,
         const bool maximizePositives, const float* const peaksPtr);
     template OP_API void removePeopleBelowThresholdsAndFillFaces(
-        std::vector<int>& validSubsetIndexes, int& numberPeople,
-        std::vector<std::pair<std::vector<int>, double>>& peopleVector,
+        std::vector<int>& validSubsetIndexes, int& numberPeople, PeopleTable<double>& peopleVector,
         const unsigned int numberBodyParts, const int minSubsetCnt, const double minSubsetScore,
         const bool maximizePositives, const double* const peaksPtr);
 
     template OP_API void peopleVectorToPeopleArray(
         Array<float>& poseKeypoints, Array<float>& poseScores, const float scaleFactor,
-        const std::vector<std::pair<std::vector<int>, float>>& peopleVector,
-        const std::vector<int>& validSubsetIndexes, const float* const peaksPtr,
-        const int numberPeople, const unsigned int numberBodyParts,
+        const PeopleTable<float>& peopleVector, const std::vector<int>& validSubsetIndexes,
+        const float* const peaksPtr, const int numberPeople, const unsigned int numberBodyParts,
         const unsigned int numberBodyPartPairs);
     template OP_API void peopleVectorToPeopleArray(
         Array<double>& poseKeypoints, Array<double>& poseScores, const double scaleFactor,
-        const std::vector<std::pair<std::vector<int>, double>>& peopleVector,
-        const std::vector<int>& validSubsetIndexes, const double* const peaksPtr,
-        const int numberPeople, const unsigned int numberBodyParts,
+        const PeopleTable<double>& peopleVector, const std::vector<int>& validSubsetIndexes,
+        const double* const peaksPtr, const int numberPeople, const unsigned int numberBodyParts,
         const unsigned int numberBodyPartPairs);
 
     template OP_API std::vector<std::tuple<float, float, int, int, int>> pafPtrIntoVector(
@@ -1433,12 +1529,12 @@ namespace op
         const Array<double>& pairScores, const double* const peaksPtr, const int maxPeaks,
         const std::vector<unsigned int>& bodyPartPairs, const unsigned int numberBodyPartPairs);
 
-    template OP_API std::vector<std::pair<std::vector<int>, float>> pafVectorIntoPeopleVector(
-        const std::vector<std::tuple<float, float, int, int, int>>& pairConnections,
+    template OP_API void pafVectorIntoPeopleVector(
+        PeopleTable<float>& peopleVector, const std::vector<std::tuple<float, float, int, int, int>>& pairConnections,
         const float* const peaksPtr, const int maxPeaks, const std::vector<unsigned int>& bodyPartPairs,
         const unsigned int numberBodyParts);
-    template OP_API std::vector<std::pair<std::vector<int>, double>> pafVectorIntoPeopleVector(
-        const std::vector<std::tuple<double, double, int, int, int>>& pairConnections,
-        const double* const peaksPtr, const int maxPeaks, const std::vector<unsigned int>& bodyPartPairs,
-        const unsigned int numberBodyParts);
+    template OP_API void pafVectorIntoPeopleVector(
+        PeopleTable<double>& peopleVector,
+        const std::vector<std::tuple<double, double, int, int, int>>& pairConnections, const double* const peaksPtr,
+        const int maxPeaks, const std::vector<unsigned int>& bodyPartPairs, const unsigned int numberBodyParts);
 }
@@ -210,8 +210,9 @@ namespace op
             // Get pair connections and their scores
             const auto pairConnections = pafPtrIntoVector(
                 pairScoresCpu, peaksPtr, maxPeaks, bodyPartPairs, numberBodyPartPairs);
-            auto peopleVector = pafVectorIntoPeopleVector(
-                pairConnections, peaksPtr, maxPeaks, bodyPartPairs, numberBodyParts);
+            PeopleTable<T> peopleVector;
+            pafVectorIntoPeopleVector(
+                peopleVector, pairConnections, peaksPtr, maxPeaks, bodyPartPairs, numberBodyParts);
             // // Old code: Get pair connections and their scores
             // // std::vector<std::pair<std::vector<int>, double>> refers to:
             // //     - std::vector<int>: [body parts locations, #body parts found]
@@ -166,8 +166,9 @@ namespace op
                 // Get pair connections and their scores
                 const auto pairConnections = pafPtrIntoVector(
                     pairScoresCpu, peaksPtr, maxPeaks, bodyPartPairs, numberBodyPartPairs);
-                auto peopleVector = pafVectorIntoPeopleVector(
-                    pairConnections, peaksPtr, maxPeaks, bodyPartPairs, numberBodyParts);
+                PeopleTable<T> peopleVector;
+                pafVectorIntoPeopleVector(
+                    peopleVector, pairConnections, peaksPtr, maxPeaks, bodyPartPairs, numberBodyParts);
                 // // Old code
                 // // Get pair connections and their scores
                 // // std::vector<std::pair<std::vector<int>, double>> refers to:
@@ -183,7 +184,7 @@ namespace op
                     // c) maxPeaks (POSE_MAX_PEOPLE): keep first maxPeaks people above thresholds
                 int numberPeople;
                 std::vector<int> validSubsetIndexes;
-                validSubsetIndexes.reserve(fastMin((size_t)maxPeaks, peopleVector.size()));
+                validSubsetIndexes.reserve(fastMin((unsigned int)maxPeaks, peopleVector.size()));
                 removePeopleBelowThresholdsAndFillFaces(
                     validSubsetIndexes, numberPeople, peopleVector, numberBodyParts, minSubsetCnt, minSubsetScore,
                     maximizePositives, peaksPtr);
@@ -232,14 +232,19 @@ namespace op
         {
             #ifdef USE_CAFFE
                 const auto heatMapsBlob = bottom.at(0);
-                const auto* const heatMapsPtr = heatMapsBlob->cpu_data();                 // ~8.5 ms COCO, ~35ms BODY_135
                 const auto* const peaksPtr = bottom.at(1)->cpu_data();                    // ~0.02ms
                 const auto maxPeaks = mTopSize[1];
+                // Optional 3rd bottom: low-resolution heat maps (i.e., network output). If provided, the heat maps in
+                // bottom[0] are not accessed (only its size), and the PAFs are upsampled on demand
+                const auto* const heatMapsPtr = (bottom.size() > 2
+                    ? bottom[2]->cpu_data() : heatMapsBlob->cpu_data());                 // ~8.5 ms COCO, ~35ms BODY_135
+                const auto heatMapSourceSize = (bottom.size() > 2
+                    ? Point<int>{bottom[2]->shape(3), bottom[2]->shape(2)} : Point<int>{});
                 connectBodyPartsCpu(
                     poseKeypoints, poseScores, heatMapsPtr, peaksPtr, mPoseModel,
                     Point<int>{heatMapsBlob->shape(3), heatMapsBlob->shape(2)}, maxPeaks, mInterMinAboveThreshold,
                     mInterThreshold, mMinSubsetCnt, mMinSubsetScore, mDefaultNmsThreshold, mScaleNetToOutput,
-                    mMaximizePositives);
+                    mMaximizePositives, heatMapSourceSize);
             #else
                 UNUSED(bottom);
                 UNUSED(poseKeypoints);
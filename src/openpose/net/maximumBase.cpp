@@ -19,11 +19,11 @@ namespace op
             const auto numberParts = targetSize[2];
             const auto numberSubparts = targetSize[3];
 
-            // opLog("sourceSize[0]: " + std::to_string(sourceSize[0])); // = 1
+            // opLog("sourceSize[0]: " + std::to_string(sourceSize[0])); // = batch size = #crops
             // opLog("sourceSize[1]: " + std::to_string(sourceSize[1])); // = #body_parts+bck=22(hands) or 71(face)
             // opLog("sourceSize[2]: " + std::to_string(sourceSize[2])); // = 368 = height
             // opLog("sourceSize[3]: " + std::to_string(sourceSize[3])); // = 368 = width
-            // opLog("targetSize[0]: " + std::to_string(targetSize[0])); // = 1
+            // opLog("targetSize[0]: " + std::to_string(targetSize[0])); // = batch size = #crops
             // opLog("targetSize[1]: " + std::to_string(targetSize[1])); // = 1
             // opLog("targetSize[2]: " + std::to_string(targetSize[2])); // = 21(hands) or 70 (face)
             // opLog("targetSize[3]: " + std::to_string(targetSize[3])); // = 3 = [x, y, score]
@@ -37,8 +37,9 @@ namespace op
                     const auto offsetChannel = (n * channels + c);
                     for (auto part = 0; part < numberParts; part++)
                     {
-                        auto* targetPtrOffsetted = targetPtr + (offsetChannel + part) * numberSubparts;
-                        const auto* const sourcePtrOffsetted = sourcePtr + (offsetChannel + part) * imageOffset;
+                        auto* targetPtrOffsetted = targetPtr + (offsetChannel * numberParts + part) * numberSubparts;
+                        const auto* const sourcePtrOffsetted
+                            = sourcePtr + (n * sourceSize[1] + c * numberParts + part) * imageOffset;
                         cv::Mat source(cv::Size(width, height), CV_32FC1, const_cast<T*>(sourcePtrOffsetted));
                         double minVal, maxVal;
                         cv::Point minLoc, maxLoc;
@@ -2,6 +2,7 @@
 #include <numeric> // std::accumulate
 #ifdef USE_CAFFE
     #include <atomic>
+    #include <map>
     #include <mutex>
     #include <caffe/net.hpp>
     #include <glog/logging.h> // google::InitGoogleLogging
@@ -23,6 +24,11 @@ namespace op
     #ifdef USE_OPENCL
         std::atomic<bool> sOpenCLInitialized{false};
     #endif
+    #if defined USE_CAFFE && !defined USE_CUDA && !defined USE_OPENCL
+        // CPU nets loaded from the same prototxt and trained model share a single read-only copy of the weights (e.g.,
+        // with several CPU workers). Key: prototxt + trained model paths. Value: net that loaded them
+        std::map<std::string, caffe::Net<float>*> sCpuWeightNets;
+    #endif
 
     struct NetCaffe::ImplNetCaffe
     {
@@ -33,6 +39,8 @@ namespace op
             const std::string mCaffeTrainedModel;
             const std::string mLastBlobName;
             std::vector<int> mNetInputSize4D;
+            // Key of sCpuWeightNets if this net loaded the shared weights
+            std::string mCpuWeightKey;
             // Init with thread
             #ifdef NV_CAFFE
                 std::unique_ptr<caffe::Net> upCaffeNet;
@@ -149,6 +157,21 @@ namespace op
 
     NetCaffe::~NetCaffe()
     {
+        try
+        {
+            // The nets sharing its weights keep them alive, but new nets will load them again
+            #if defined USE_CAFFE && !defined USE_CUDA && !defined USE_OPENCL
+                if (!upImpl->mCpuWeightKey.empty())
+                {
+                    std::lock_guard<std::mutex> lock{sMutexNetCaffe};
+                    sCpuWeightNets.erase(upImpl->mCpuWeightKey);
+                }
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            errorDestructor(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
     }
 
     void NetCaffe::initializationOnThread()
@@ -182,9 +205,22 @@ namespace op
                             upImpl->upCaffeNet.reset(new caffe::Net<float>{upImpl->mCaffeProto, caffe::TEST});
                         #endif
                     #endif
-                    upImpl->upCaffeNet->CopyTrainedLayersFrom(upImpl->mCaffeTrainedModel);
                     #ifdef USE_CUDA
+                        upImpl->upCaffeNet->CopyTrainedLayersFrom(upImpl->mCaffeTrainedModel);
                         cudaCheck(__LINE__, __FUNCTION__, __FILE__);
+                    #else
+                        // Share the weights of a previous net with the same model (or load them from disk)
+                        std::lock_guard<std::mutex> lock{sMutexNetCaffe};
+                        const auto cpuWeightKey = upImpl->mCaffeProto + "|" + upImpl->mCaffeTrainedModel;
+                        const auto cpuWeightNet = sCpuWeightNets.find(cpuWeightKey);
+                        if (cpuWeightNet != sCpuWeightNets.end())
+                            upImpl->upCaffeNet->ShareTrainedLayersWith(cpuWeightNet->second);
+                        else
+                        {
+                            upImpl->upCaffeNet->CopyTrainedLayersFrom(upImpl->mCaffeTrainedModel);
+                            sCpuWeightNets[cpuWeightKey] = upImpl->upCaffeNet.get();
+                            upImpl->mCpuWeightKey = cpuWeightKey;
+                        }
                     #endif
                 #endif
                 // Set spOutputBlob
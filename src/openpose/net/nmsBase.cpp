@@ -1,5 +1,11 @@
 #include <openpose/net/nmsBase.hpp>
+#include <algorithm> // std::min
+#include <cmath> // std::ceil
 #include <opencv2/opencv.hpp>
+#include <openpose/net/resizeAndMergeBase.hpp>
+#include <openpose/utilities/fastMath.hpp>
+#include <openpose/utilities/threadPool.hpp>
+#include <openpose_private/utilities/avx.hpp>
 
 namespace op
 {
@@ -106,6 +112,205 @@ namespace op
         output[2] = sourcePtr[peakLocY*width + peakLocX];
     }
 
+    // Inner pixels (2 <= x < w-2, 2 <= y < h-2) of one row. It is equivalent to calling nmsRegisterKernelCPU on each
+    // pixel, but branchless so the compiler can auto-vectorize it. kernelPtr and sourcePtr point to the current row,
+    // the neighbour rows are at -w and +w.
+    template <typename T>
+    void nmsRegisterKernelRowInner(int* kernelPtr, const T* const sourcePtr, const int w, const T threshold,
+                                   const int xBegin, const int xEnd)
+    {
+        for (auto x = xBegin ; x < xEnd ; x++)
+        {
+            const auto* const top = &sourcePtr[x-w];
+            const auto* const center = &sourcePtr[x];
+            const auto* const bottom = &sourcePtr[x+w];
+            const auto value = *center;
+            kernelPtr[x] = int(value > threshold)
+                & int(value > top[-1]) & int(value > top[0]) & int(value > top[1])
+                & int(value > center[-1]) & int(value > center[1])
+                & int(value > bottom[-1]) & int(value > bottom[0]) & int(value > bottom[1]);
+        }
+    }
+
+    #ifdef OP_SIMD_X86
+        // SIMD versions of nmsRegisterKernelRowInner. They return the first x not processed
+        OP_TARGET_SSE4
+        int nmsRegisterKernelRowSse4(int* kernelPtr, const float* const sourcePtr, const int w,
+                                     const float threshold, const int xBegin, const int xEnd)
+        {
+            auto x = xBegin;
+            const auto thresholdV = _mm_set1_ps(threshold);
+            // Bit pattern of int(1), so (mask & one) is directly 0 or 1 as int
+            const auto oneV = _mm_castsi128_ps(_mm_set1_epi32(1));
+            for ( ; x + 4 <= xEnd ; x += 4)
+            {
+                const auto* const top = &sourcePtr[x-w];
+                const auto* const center = &sourcePtr[x];
+                const auto* const bottom = &sourcePtr[x+w];
+                const auto value = _mm_loadu_ps(center);
+                auto mask = _mm_cmpgt_ps(value, thresholdV);
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(value, _mm_loadu_ps(top-1)));
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(value, _mm_loadu_ps(top)));
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(value, _mm_loadu_ps(top+1)));
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(value, _mm_loadu_ps(center-1)));
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(value, _mm_loadu_ps(center+1)));
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(value, _mm_loadu_ps(bottom-1)));
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(value, _mm_loadu_ps(bottom)));
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(value, _mm_loadu_ps(bottom+1)));
+                _mm_storeu_si128((__m128i*)&kernelPtr[x], _mm_castps_si128(_mm_and_ps(mask, oneV)));
+            }
+            return x;
+        }
+
+        OP_TARGET_AVX2
+        int nmsRegisterKernelRowAvx2(int* kernelPtr, const float* const sourcePtr, const int w,
+                                     const float threshold, const int xBegin, const int xEnd)
+        {
+            auto x = xBegin;
+            const auto thresholdV = _mm256_set1_ps(threshold);
+            const auto oneV = _mm256_castsi256_ps(_mm256_set1_epi32(1));
+            for ( ; x + 8 <= xEnd ; x += 8)
+            {
+                const auto* const top = &sourcePtr[x-w];
+                const auto* const center = &sourcePtr[x];
+                const auto* const bottom = &sourcePtr[x+w];
+                const auto value = _mm256_loadu_ps(center);
+                auto mask = _mm256_cmp_ps(value, thresholdV, _CMP_GT_OQ);
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(value, _mm256_loadu_ps(top-1), _CMP_GT_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(value, _mm256_loadu_ps(top), _CMP_GT_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(value, _mm256_loadu_ps(top+1), _CMP_GT_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(value, _mm256_loadu_ps(center-1), _CMP_GT_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(value, _mm256_loadu_ps(center+1), _CMP_GT_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(value, _mm256_loadu_ps(bottom-1), _CMP_GT_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(value, _mm256_loadu_ps(bottom), _CMP_GT_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(value, _mm256_loadu_ps(bottom+1), _CMP_GT_OQ));
+                _mm256_storeu_si256((__m256i*)&kernelPtr[x], _mm256_castps_si256(_mm256_and_ps(mask, oneV)));
+            }
+            return x;
+        }
+
+        OP_TARGET_AVX512
+        int nmsRegisterKernelRowAvx512(int* kernelPtr, const float* const sourcePtr, const int w,
+                                       const float threshold, const int xBegin, const int xEnd)
+        {
+            auto x = xBegin;
+            const auto thresholdV = _mm512_set1_ps(threshold);
+            const auto oneV = _mm512_set1_epi32(1);
+            for ( ; x + 16 <= xEnd ; x += 16)
+            {
+                const auto* const top = &sourcePtr[x-w];
+                const auto* const center = &sourcePtr[x];
+                const auto* const bottom = &sourcePtr[x+w];
+                const auto value = _mm512_loadu_ps(center);
+                auto mask = _mm512_cmp_ps_mask(value, thresholdV, _CMP_GT_OQ);
+                mask = _mm512_mask_cmp_ps_mask(mask, value, _mm512_loadu_ps(top-1), _CMP_GT_OQ);
+                mask = _mm512_mask_cmp_ps_mask(mask, value, _mm512_loadu_ps(top), _CMP_GT_OQ);
+                mask = _mm512_mask_cmp_ps_mask(mask, value, _mm512_loadu_ps(top+1), _CMP_GT_OQ);
+                mask = _mm512_mask_cmp_ps_mask(mask, value, _mm512_loadu_ps(center-1), _CMP_GT_OQ);
+                mask = _mm512_mask_cmp_ps_mask(mask, value, _mm512_loadu_ps(center+1), _CMP_GT_OQ);
+                mask = _mm512_mask_cmp_ps_mask(mask, value, _mm512_loadu_ps(bottom-1), _CMP_GT_OQ);
+                mask = _mm512_mask_cmp_ps_mask(mask, value, _mm512_loadu_ps(bottom), _CMP_GT_OQ);
+                mask = _mm512_mask_cmp_ps_mask(mask, value, _mm512_loadu_ps(bottom+1), _CMP_GT_OQ);
+                _mm512_storeu_si512(&kernelPtr[x], _mm512_maskz_mov_epi32(mask, oneV));
+            }
+            return x;
+        }
+
+        template <>
+        void nmsRegisterKernelRowInner(int* kernelPtr, const float* const sourcePtr, const int w,
+                                       const float threshold, const int xBegin, const int xEnd)
+        {
+            // Best SIMD version supported by the CPU
+            auto x = xBegin;
+            const auto simdLevel = getSimdLevel();
+            if (simdLevel >= SimdLevel::Avx512)
+                x = nmsRegisterKernelRowAvx512(kernelPtr, sourcePtr, w, threshold, x, xEnd);
+            else if (simdLevel >= SimdLevel::Avx2)
+                x = nmsRegisterKernelRowAvx2(kernelPtr, sourcePtr, w, threshold, x, xEnd);
+            else if (simdLevel >= SimdLevel::Sse4)
+                x = nmsRegisterKernelRowSse4(kernelPtr, sourcePtr, w, threshold, x, xEnd);
+            // Remaining pixels
+            for ( ; x < xEnd ; x++)
+            {
+                const auto* const top = &sourcePtr[x-w];
+                const auto* const center = &sourcePtr[x];
+                const auto* const bottom = &sourcePtr[x+w];
+                const auto value = *center;
+                kernelPtr[x] = int(value > threshold)
+                    & int(value > top[-1]) & int(value > top[0]) & int(value > top[1])
+                    & int(value > center[-1]) & int(value > center[1])
+                    & int(value > bottom[-1]) & int(value > bottom[0]) & int(value > bottom[1]);
+            }
+        }
+    #endif
+
+    template <typename T>
+    void nmsCpuChannels(T* targetPtr, int* kernelPtr, const T* const sourcePtr, const T threshold,
+                        const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize,
+                        const Point<T>& offset, const int channelBegin, const int channelEnd)
+    {
+        try
+        {
+            // Params
+            const auto sourceHeight = sourceSize[2]; // 368
+            const auto sourceWidth = sourceSize[3]; // 496
+            const auto targetPeaks = targetSize[2]; // 97
+            const auto targetPeakVec = targetSize[3]; // 3
+            const auto sourceChannelOffset = sourceWidth * sourceHeight;
+            const auto targetChannelOffset = targetPeaks * targetPeakVec;
+
+            // Per channel operation
+            for (auto c = channelBegin ; c < channelEnd ; c++)
+            {
+                auto* currKernelPtr = &kernelPtr[c*sourceChannelOffset];
+                const T* currSourcePtr = &sourcePtr[c*sourceChannelOffset];
+                auto* currTargetPtr = &targetPtr[c*targetChannelOffset];
+                auto currentPeakCount = 1;
+                // Single pass: each row of the kernel is registered and immediately scanned for peaks, so peaks are
+                // found in the same (row-major) order than registering the whole channel first
+                for (auto y = 0; y < sourceHeight; y++)
+                {
+                    const auto rowOffset = y*sourceWidth;
+                    auto x = 0;
+                    // Rows far from the border: branchy borders + branchless (SIMD) inner part
+                    if (1 < y && y < (sourceHeight-2) && 4 < sourceWidth)
+                    {
+                        for ( ; x < 2 ; x++)
+                            nmsRegisterKernelCPU(currKernelPtr, currSourcePtr, sourceWidth, sourceHeight, threshold,
+                                                 x, y);
+                        nmsRegisterKernelRowInner(&currKernelPtr[rowOffset], &currSourcePtr[rowOffset],
+                                                  sourceWidth, threshold, x, sourceWidth-2);
+                        x = sourceWidth-2;
+                    }
+                    for ( ; x < sourceWidth; x++)
+                        nmsRegisterKernelCPU(currKernelPtr, currSourcePtr, sourceWidth, sourceHeight, threshold, x, y);
+                    // Find high intensity points
+                    if (currentPeakCount < targetPeaks)
+                    {
+                        const auto* const kernelRowPtr = &currKernelPtr[rowOffset];
+                        for (x = 0; x < sourceWidth; x++)
+                        {
+                            if (kernelRowPtr[x] == 1)
+                            {
+                                // Accurate Peak Position
+                                nmsAccuratePeakPosition(&currTargetPtr[currentPeakCount*3], currSourcePtr, x, y,
+                                                        sourceWidth, sourceHeight, offset);
+                                currentPeakCount++;
+                                if (currentPeakCount == targetPeaks)
+                                    break;
+                            }
+                        }
+                    }
+                }
+                currTargetPtr[0] = T(currentPeakCount-1);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template <typename T>
     void nmsCpu(T* targetPtr, int* kernelPtr, const T* const sourcePtr, const T threshold,
                 const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize,
@@ -123,41 +328,120 @@ namespace op
 
             // Params
             const auto channels = targetSize[1]; // 57
-            const auto sourceHeight = sourceSize[2]; // 368
-            const auto sourceWidth = sourceSize[3]; // 496
+            const auto sourceChannelOffset = sourceSize[2] * sourceSize[3];
+
+            // Channels are independent, so they are processed in parallel by the ThreadPool. Each chunk has at least
+            // 64K pixels, so small inputs (e.g., the face/hand crops) are not split
+            const auto minimumPixelsPerChunk = 64*1024;
+            ThreadPool::parallelFor(
+                0, channels,
+                [&](const int channelBegin, const int channelEnd)
+                {
+                    nmsCpuChannels(targetPtr, kernelPtr, sourcePtr, threshold, targetSize, sourceSize, offset,
+                                   channelBegin, channelEnd);
+                },
+                fastMax(1, minimumPixelsPerChunk / fastMax(1, sourceChannelOffset)));
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template <typename T>
+    void nmsLowResolutionCpuChannels(
+        T* targetPtr, const T* const sourcePtr, const T threshold, const std::array<int, 4>& targetSize,
+        const std::array<int, 4>& sourceSize, const Point<int>& upsampledSize, const Point<T>& offset,
+        const int channelBegin, const int channelEnd)
+    {
+        try
+        {
+            // Params
+            const auto sourceHeight = sourceSize[2]; // 46
+            const auto sourceWidth = sourceSize[3]; // 82
             const auto targetPeaks = targetSize[2]; // 97
             const auto targetPeakVec = targetSize[3]; // 3
             const auto sourceChannelOffset = sourceWidth * sourceHeight;
             const auto targetChannelOffset = targetPeaks * targetPeakVec;
+            const Point<int> sourceSizePoint{sourceWidth, sourceHeight};
+            const auto ratioX = upsampledSize.x / T(sourceWidth);
+            const auto ratioY = upsampledSize.y / T(sourceHeight);
+            // Search radius of the upsampled maximum around each low-resolution peak, plus 3 pixels for
+            // nmsAccuratePeakPosition
+            const auto searchX = int(std::ceil(ratioX));
+            const auto searchY = int(std::ceil(ratioY));
+            const auto radiusX = searchX + 3;
+            const auto radiusY = searchY + 3;
+            // Kept across calls (frames) in order to avoid re-allocating them every time
+            thread_local std::vector<int> sKernel;
+            thread_local std::vector<T> sWindow;
+            sKernel.resize(sourceChannelOffset);
+            sWindow.resize((2*radiusX+1) * (2*radiusY+1));
 
             // Per channel operation
-            for (auto c = 0 ; c < channels ; c++)
+            for (auto c = channelBegin ; c < channelEnd ; c++)
             {
-                auto* currKernelPtr = &kernelPtr[c*sourceChannelOffset];
                 const T* currSourcePtr = &sourcePtr[c*sourceChannelOffset];
-
-                for (auto y = 0; y < sourceHeight; y++)
-                    for (auto x = 0; x < sourceWidth; x++)
-                        nmsRegisterKernelCPU(currKernelPtr, currSourcePtr, sourceWidth, sourceHeight, threshold, x, y);
-
-                auto currentPeakCount = 1;
                 auto* currTargetPtr = &targetPtr[c*targetChannelOffset];
-                for (auto y = 0; y < sourceHeight; y++)
+                auto currentPeakCount = 1;
+                // Peaks candidates on the network output resolution
+                for (auto y = 0; y < sourceHeight && currentPeakCount < targetPeaks; y++)
                 {
                     for (auto x = 0; x < sourceWidth; x++)
+                        nmsRegisterKernelCPU(sKernel.data(), currSourcePtr, sourceWidth, sourceHeight, threshold, x, y);
+                    for (auto x = 0; x < sourceWidth && currentPeakCount < targetPeaks; x++)
                     {
-                        const auto index = y*sourceWidth + x;
-                        // Find high intensity points
-                        if (currentPeakCount < targetPeaks)
+                        if (sKernel[y*sourceWidth + x] != 1)
+                            continue;
+                        // Upsample only a small window around the candidate
+                        const auto centerX = positiveIntRound((x + T(0.5))*ratioX - T(0.5));
+                        const auto centerY = positiveIntRound((y + T(0.5))*ratioY - T(0.5));
+                        const auto windowX = fastMax(0, centerX - radiusX);
+                        const auto windowY = fastMax(0, centerY - radiusY);
+                        const auto windowWidth = fastMin(upsampledSize.x, centerX + radiusX + 1) - windowX;
+                        const auto windowHeight = fastMin(upsampledSize.y, centerY + radiusY + 1) - windowY;
+                        for (auto wy = 0 ; wy < windowHeight ; wy++)
+                            for (auto wx = 0 ; wx < windowWidth ; wx++)
+                                sWindow[wy*windowWidth + wx] = resizeCubicPixelCpu(
+                                    currSourcePtr, sourceSizePoint, upsampledSize, windowX + wx, windowY + wy);
+                        // Maximum of the upsampled window (excluding the nmsAccuratePeakPosition margin)
+                        auto peakX = -1;
+                        auto peakY = -1;
+                        auto peakValue = threshold;
+                        for (auto wy = fastMax(0, centerY - searchY - windowY) ;
+                             wy < fastMin(windowHeight, centerY + searchY + 1 - windowY) ; wy++)
                         {
-                            if (currKernelPtr[index] == 1)
+                            for (auto wx = fastMax(0, centerX - searchX - windowX) ;
+                                 wx < fastMin(windowWidth, centerX + searchX + 1 - windowX) ; wx++)
                             {
-                                // Accurate Peak Position
-                                nmsAccuratePeakPosition(&currTargetPtr[currentPeakCount*3], currSourcePtr, x, y,
-                                                        sourceWidth, sourceHeight, offset);
-                                currentPeakCount++;
+                                if (peakValue < sWindow[wy*windowWidth + wx])
+                                {
+                                    peakValue = sWindow[wy*windowWidth + wx];
+                                    peakX = wx;
+                                    peakY = wy;
+                                }
                             }
                         }
+                        if (peakX < 0)
+                            continue;
+                        // Accurate Peak Position (window coordinates --> upsampled coordinates)
+                        auto* peakPtr = &currTargetPtr[currentPeakCount*3];
+                        nmsAccuratePeakPosition(peakPtr, sWindow.data(), peakX, peakY, windowWidth, windowHeight,
+                                                offset);
+                        peakPtr[0] += windowX;
+                        peakPtr[1] += windowY;
+                        // Neighbour candidates might converge into the same upsampled maximum
+                        auto repeated = false;
+                        for (auto p = 1 ; p < currentPeakCount ; p++)
+                        {
+                            if (currTargetPtr[3*p] == peakPtr[0] && currTargetPtr[3*p+1] == peakPtr[1])
+                            {
+                                repeated = true;
+                                break;
+                            }
+                        }
+                        if (!repeated)
+                            currentPeakCount++;
                     }
                 }
                 currTargetPtr[0] = T(currentPeakCount-1);
@@ -169,10 +453,46 @@ namespace op
         }
     }
 
+    template <typename T>
+    void nmsLowResolutionCpu(
+        T* targetPtr, const T* const sourcePtr, const T threshold, const std::array<int, 4>& targetSize,
+        const std::array<int, 4>& sourceSize, const Point<int>& upsampledSize, const Point<T>& offset)
+    {
+        try
+        {
+            // Sanity checks
+            if (threshold < 0 || threshold > 1.0)
+                error("threshold value invalid.", __LINE__, __FUNCTION__, __FILE__);
+            if (upsampledSize.x < sourceSize[3] || upsampledSize.y < sourceSize[2])
+                error("upsampledSize must be equal or bigger than sourceSize.", __LINE__, __FUNCTION__, __FILE__);
+
+            // Channels are independent, so they are processed in parallel by the ThreadPool
+            const auto channels = targetSize[1]; // 57
+            ThreadPool::parallelFor(
+                0, channels,
+                [&](const int channelBegin, const int channelEnd)
+                {
+                    nmsLowResolutionCpuChannels(targetPtr, sourcePtr, threshold, targetSize, sourceSize,
+                                                upsampledSize, offset, channelBegin, channelEnd);
+                });
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template OP_API void nmsCpu(
         float* targetPtr, int* kernelPtr, const float* const sourcePtr, const float threshold,
         const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize, const Point<float>& offset);
     template OP_API void nmsCpu(
         double* targetPtr, int* kernelPtr, const double* const sourcePtr, const double threshold,
         const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize, const Point<double>& offset);
+    template OP_API void nmsLowResolutionCpu(
+        float* targetPtr, const float* const sourcePtr, const float threshold, const std::array<int, 4>& targetSize,
+        const std::array<int, 4>& sourceSize, const Point<int>& upsampledSize, const Point<float>& offset);
+    template OP_API void nmsLowResolutionCpu(
+        double* targetPtr, const double* const sourcePtr, const double threshold,
+        const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize, const Point<int>& upsampledSize,
+        const Point<double>& offset);
 }
@@ -1,10 +1,165 @@
 #include <openpose/net/resizeAndMergeBase.hpp>
+#include <algorithm> // std::min
+#include <cmath> // std::floor, std::lrint
+#include <memory> // std::shared_ptr
 #include <openpose/utilities/fastMath.hpp>
-#include <openpose/utilities/openCv.hpp>
-#include <openpose_private/utilities/openCvMultiversionHeaders.hpp>
+#include <openpose/utilities/threadPool.hpp>
+#include <openpose_private/utilities/avx.hpp>
 
 namespace op
 {
+    template <typename T>
+    inline void interpolateCubic(T* coeffs, const T x)
+    {
+        // Same coefficients than OpenCV (cv::resize with INTER_CUBIC)
+        const T A = T(-0.75);
+        coeffs[0] = ((A*(x + 1) - 5*A)*(x + 1) + 8*A)*(x + 1) - 4*A;
+        coeffs[1] = ((A + 2)*x - (A + 3))*x*x + 1;
+        coeffs[2] = ((A + 2)*(1 - x) - (A + 3))*(1 - x)*(1 - x) + 1;
+        coeffs[3] = T(1) - coeffs[0] - coeffs[1] - coeffs[2];
+    }
+
+    template <typename T>
+    inline void getCubicIndexesAndWeights(int* indexes, T* weights, const int sourceSize, const int targetSize,
+                                          const int t)
+    {
+        // 4 source indexes and weights for the target pixel t. Indexes are clamped to the image (OpenCV replicates
+        // the border for cubic resize)
+        const auto scale = sourceSize / (double)targetSize;
+        auto fx = (float)((t + 0.5)*scale - 0.5);
+        const auto sx = int(std::floor(fx));
+        fx -= sx;
+        interpolateCubic(weights, T(fx));
+        for (auto k = 0 ; k < 4 ; k++)
+            indexes[k] = fastTruncate(sx - 1 + k, 0, sourceSize-1);
+    }
+
+    template <typename T>
+    void fillCubicTable(std::vector<int>& indexes, std::vector<T>& weights, const int sourceSize,
+                        const int targetSize, const T weightScale)
+    {
+        indexes.resize(4*targetSize);
+        weights.resize(4*targetSize);
+        for (auto t = 0 ; t < targetSize ; t++)
+        {
+            getCubicIndexesAndWeights(&indexes[4*t], &weights[4*t], sourceSize, targetSize, t);
+            for (auto k = 0 ; k < 4 ; k++)
+                weights[4*t+k] *= weightScale;
+        }
+    }
+
+    template <typename T>
+    struct CubicTables
+    {
+        std::array<int, 4> targetSize;
+        std::vector<std::array<int, 4>> sourceSizes;
+        std::vector<std::vector<int>> xIndexes;
+        std::vector<std::vector<T>> xWeights;
+        std::vector<std::vector<int>> yIndexes;
+        std::vector<std::vector<T>> yWeights;
+    };
+
+    template <typename T>
+    std::shared_ptr<const CubicTables<T>> getCubicTables(const std::array<int, 4>& targetSize,
+                                                         const std::vector<std::array<int, 4>>& sourceSizes)
+    {
+        // Separable bicubic tables of each scale. The multi-scale average is folded into the vertical weights.
+        // They only depend on the sizes, which rarely change between frames, so each thread keeps the last ones. It
+        // returns a shared_ptr so a nested call with other sizes does not free the tables its caller is still using
+        thread_local std::shared_ptr<const CubicTables<T>> spCubicTables;
+        if (spCubicTables == nullptr || spCubicTables->targetSize != targetSize
+            || spCubicTables->sourceSizes != sourceSizes)
+        {
+            const auto nums = (signed)sourceSizes.size();
+            auto spNewCubicTables = std::make_shared<CubicTables<T>>();
+            spNewCubicTables->targetSize = targetSize;
+            spNewCubicTables->sourceSizes = sourceSizes;
+            spNewCubicTables->xIndexes.resize(nums);
+            spNewCubicTables->xWeights.resize(nums);
+            spNewCubicTables->yIndexes.resize(nums);
+            spNewCubicTables->yWeights.resize(nums);
+            for (auto n = 0 ; n < nums ; n++)
+            {
+                fillCubicTable(spNewCubicTables->xIndexes[n], spNewCubicTables->xWeights[n], sourceSizes[n][3],
+                               targetSize[3], T(1));
+                fillCubicTable(spNewCubicTables->yIndexes[n], spNewCubicTables->yWeights[n], sourceSizes[n][2],
+                               targetSize[2], T(1)/T(nums));
+            }
+            spCubicTables = spNewCubicTables;
+        }
+        return spCubicTables;
+    }
+
+    template <typename T>
+    void resizeAndMergeCpuChannels(T* targetPtr, const std::vector<const T*>& sourcePtrs,
+                                   const std::array<int, 4>& targetSize,
+                                   const std::vector<std::array<int, 4>>& sourceSizes,
+                                   const std::vector<std::vector<int>>& xIndexes,
+                                   const std::vector<std::vector<T>>& xWeights,
+                                   const std::vector<std::vector<int>>& yIndexes,
+                                   const std::vector<std::vector<T>>& yWeights,
+                                   const int channelBegin, const int channelEnd)
+    {
+        try
+        {
+            // Params
+            const auto targetHeight = targetSize[2]; // 368
+            const auto targetWidth = targetSize[3]; // 496
+            const auto targetChannelOffset = targetWidth * targetHeight;
+            // Horizontally resized source channel (sourceHeight x targetWidth). It is kept across calls (frames)
+            // in order to avoid re-allocating it every time
+            thread_local std::vector<T> sTempRows;
+
+            for (auto c = channelBegin ; c < channelEnd ; c++)
+            {
+                auto* currTargetPtr = &targetPtr[c*targetChannelOffset];
+                for (auto n = 0u ; n < sourceSizes.size() ; n++)
+                {
+                    const auto sourceHeight = sourceSizes[n][2]; // 368/8 ..
+                    const auto sourceWidth = sourceSizes[n][3]; // 496/8 ..
+                    const auto* sourcePtr = &sourcePtrs[n][c*sourceHeight*sourceWidth];
+                    sTempRows.resize(sourceHeight*targetWidth);
+                    // Horizontal pass (only on the source rows)
+                    const auto* const xIndex = xIndexes[n].data();
+                    const auto* const xWeight = xWeights[n].data();
+                    for (auto y = 0 ; y < sourceHeight ; y++)
+                    {
+                        const auto* sourceRow = &sourcePtr[y*sourceWidth];
+                        auto* tempRow = &sTempRows[y*targetWidth];
+                        for (auto x = 0 ; x < targetWidth ; x++)
+                        {
+                            const auto* const i = &xIndex[4*x];
+                            const auto* const w = &xWeight[4*x];
+                            tempRow[x] = sourceRow[i[0]]*w[0] + sourceRow[i[1]]*w[1]
+                                       + sourceRow[i[2]]*w[2] + sourceRow[i[3]]*w[3];
+                        }
+                    }
+                    // Vertical pass, accumulated into the target. The 1/nums average is already in the weights
+                    for (auto y = 0 ; y < targetHeight ; y++)
+                    {
+                        const auto* const i = &yIndexes[n][4*y];
+                        const auto* const w = &yWeights[n][4*y];
+                        const auto* const row0 = &sTempRows[i[0]*targetWidth];
+                        const auto* const row1 = &sTempRows[i[1]*targetWidth];
+                        const auto* const row2 = &sTempRows[i[2]*targetWidth];
+                        const auto* const row3 = &sTempRows[i[3]*targetWidth];
+                        auto* targetRow = &currTargetPtr[y*targetWidth];
+                        if (n == 0)
+                            for (auto x = 0 ; x < targetWidth ; x++)
+                                targetRow[x] = w[0]*row0[x] + w[1]*row1[x] + w[2]*row2[x] + w[3]*row3[x];
+                        else
+                            for (auto x = 0 ; x < targetWidth ; x++)
+                                targetRow[x] += w[0]*row0[x] + w[1]*row1[x] + w[2]*row2[x] + w[3]*row3[x];
+                    }
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template <typename T>
     void resizeAndMergeCpu(T* targetPtr, const std::vector<const T*>& sourcePtrs,
                            const std::array<int, 4>& targetSize,
@@ -20,91 +175,495 @@ namespace op
             // Sanity check
             if (sourceSizes.empty())
                 error("sourceSizes cannot be empty.", __LINE__, __FUNCTION__, __FILE__);
+            if (sourceSizes.size() != sourcePtrs.size())
+                error("sourceSizes.size() != sourcePtrs.size().", __LINE__, __FUNCTION__, __FILE__);
+            for (const auto& sourceSize : sourceSizes)
+                if (sourceSize[0] != 1)
+                    error("It should never reache this point. Notify us otherwise.",
+                          __LINE__, __FUNCTION__, __FILE__);
 
             // Params
             const auto nums = (signed)sourceSizes.size();
             const auto channels = targetSize[1]; // 57
             const auto targetHeight = targetSize[2]; // 368
             const auto targetWidth = targetSize[3]; // 496
-            const auto targetChannelOffset = targetWidth * targetHeight;
 
-            // No multi-scale merging or no merging required
-            if (sourceSizes.size() == 1)
-            {
-                // Params
-                const auto& sourceSize = sourceSizes[0];
-                const auto sourceHeight = sourceSize[2]; // 368/8 ..
-                const auto sourceWidth = sourceSize[3]; // 496/8 ..
-                const auto sourceChannelOffset = sourceHeight * sourceWidth;
-                if (sourceSize[0] != 1)
-                    error("It should never reache this point. Notify us otherwise.",
-                          __LINE__, __FUNCTION__, __FILE__);
+            // Separable bicubic tables of each scale (cached across calls)
+            const auto spCubicTables = getCubicTables<T>(targetSize, sourceSizes);
+            const auto& xIndexes = spCubicTables->xIndexes;
+            const auto& xWeights = spCubicTables->xWeights;
+            const auto& yIndexes = spCubicTables->yIndexes;
+            const auto& yWeights = spCubicTables->yWeights;
 
-                // Per channel resize
-                const T* sourcePtr = sourcePtrs[0];
-                for (auto c = 0 ; c < channels ; c++)
+            // Resize and merge all scales of each channel in one pass. Channels are processed in parallel by the
+            // ThreadPool, in chunks of at least 64K pixels
+            const auto minimumPixelsPerChunk = 64*1024;
+            ThreadPool::parallelFor(
+                0, channels,
+                [&](const int channelBegin, const int channelEnd)
                 {
-                    cv::Mat source(cv::Size(sourceWidth, sourceHeight), CV_32FC1,
-                                   const_cast<T*>(&sourcePtr[c*sourceChannelOffset]));
-                    cv::Mat target(cv::Size(targetWidth, targetHeight), CV_32FC1,
-                                   (&targetPtr[c*targetChannelOffset]));
-                    cv::resize(source, target, {targetWidth, targetHeight}, 0, 0, CV_INTER_CUBIC);
+                    resizeAndMergeCpuChannels(targetPtr, sourcePtrs, targetSize, sourceSizes, xIndexes, xWeights,
+                                              yIndexes, yWeights, channelBegin, channelEnd);
+                },
+                fastMax(1, minimumPixelsPerChunk / fastMax(1, nums * targetHeight * targetWidth)));
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template <typename T>
+    T resizeCubicPixelCpu(const T* const sourcePtr, const Point<int>& sourceSize, const Point<int>& targetSize,
+                          const int x, const int y)
+    {
+        // Same operations (and order) than resizeAndMergeCpuChannels, so the result matches its output
+        int xIndexes[4];
+        T xWeights[4];
+        int yIndexes[4];
+        T yWeights[4];
+        getCubicIndexesAndWeights(xIndexes, xWeights, sourceSize.x, targetSize.x, x);
+        getCubicIndexesAndWeights(yIndexes, yWeights, sourceSize.y, targetSize.y, y);
+        T rows[4];
+        for (auto k = 0 ; k < 4 ; k++)
+        {
+            const auto* sourceRow = &sourcePtr[yIndexes[k]*sourceSize.x];
+            rows[k] = sourceRow[xIndexes[0]]*xWeights[0] + sourceRow[xIndexes[1]]*xWeights[1]
+                    + sourceRow[xIndexes[2]]*xWeights[2] + sourceRow[xIndexes[3]]*xWeights[3];
+        }
+        return yWeights[0]*rows[0] + yWeights[1]*rows[1] + yWeights[2]*rows[2] + yWeights[3]*rows[3];
+    }
+
+    // cv::warpAffine fixed-point constants (INTER_BITS, AB_BITS and INTER_REMAP_COEF_BITS)
+    const auto WARP_INTER_BITS = 5;
+    const auto WARP_INTER_TAB_SIZE = 1 << WARP_INTER_BITS;
+    const auto WARP_AB_BITS = 10;
+    const auto WARP_COEF_BITS = 15;
+    // Fixed-point bilinear weights are separable: (32-fy)*(32-fx)*32 in 15 bits is (32-fy)*(32-fx) in 10 bits
+    const auto WARP_LINEAR_BITS = 2*WARP_INTER_BITS;
+
+    // Source sampling of each target column and row of one scale
+    struct WarpTable
+    {
+        bool cubic;
+        std::vector<int> xIndexes;
+        std::vector<int> xFractions;
+        std::vector<int> xOffsets; // Bilinear: 3*xIndexes, clamped to the zero padding of the vertical pass buffer
+        std::vector<int> yIndexes;
+        std::vector<int> yFractions;
+    };
+
+    void fillWarpIndexes(std::vector<int>& indexes, std::vector<int>& fractions, const double scaleFactor,
+                         const int targetSize)
+    {
+        // Same inverse matrix and fixed-point coordinates than cv::warpAffine (1/scaleFactor might differ in the last
+        // bit): 1/32 pixel precision, rounded from 1/1024
+        const auto inverseScale = scaleFactor * (1. / (scaleFactor*scaleFactor));
+        const auto roundDelta = 1 << (WARP_AB_BITS - WARP_INTER_BITS - 1);
+        indexes.resize(targetSize);
+        fractions.resize(targetSize);
+        for (auto t = 0 ; t < targetSize ; t++)
+        {
+            const auto coordinate = ((int)std::lrint(inverseScale*t*(1 << WARP_AB_BITS)) + roundDelta)
+                                  >> (WARP_AB_BITS - WARP_INTER_BITS);
+            indexes[t] = coordinate >> WARP_INTER_BITS;
+            fractions[t] = coordinate & (WARP_INTER_TAB_SIZE - 1);
+        }
+    }
+
+    std::vector<short> createCubicWarpKernels()
+    {
+        // Same fixed-point 4x4 kernels than cv::remap (INTER_CUBIC) for each 1/32 sub-pixel position, including its
+        // correction so that each kernel sums exactly 1 << WARP_COEF_BITS
+        std::vector<float> coefficients(4*WARP_INTER_TAB_SIZE);
+        for (auto i = 0 ; i < WARP_INTER_TAB_SIZE ; i++)
+            interpolateCubic(&coefficients[4*i], i*(1.f/WARP_INTER_TAB_SIZE));
+        std::vector<short> kernels(16*WARP_INTER_TAB_SIZE*WARP_INTER_TAB_SIZE);
+        for (auto fy = 0 ; fy < WARP_INTER_TAB_SIZE ; fy++)
+        {
+            for (auto fx = 0 ; fx < WARP_INTER_TAB_SIZE ; fx++)
+            {
+                auto* kernel = &kernels[16*(fy*WARP_INTER_TAB_SIZE + fx)];
+                auto sum = 0;
+                for (auto i = 0 ; i < 4 ; i++)
+                {
+                    for (auto j = 0 ; j < 4 ; j++)
+                    {
+                        // Saturated to short, as OpenCV does (e.g., 1 << WARP_COEF_BITS when fx = fy = 0)
+                        const float weight = coefficients[4*fy+i]*coefficients[4*fx+j];
+                        kernel[4*i+j] = (short)fastTruncate(
+                            (int)std::lrint(weight*float(1 << WARP_COEF_BITS)), -32768, 32767);
+                        sum += kernel[4*i+j];
+                    }
+                }
+                const auto difference = sum - (1 << WARP_COEF_BITS);
+                if (difference != 0)
+                {
+                    auto minIndex = 10;
+                    auto maxIndex = 10;
+                    for (auto i = 2 ; i < 4 ; i++)
+                    {
+                        for (auto j = 2 ; j < 4 ; j++)
+                        {
+                            if (kernel[4*i+j] < kernel[minIndex])
+                                minIndex = 4*i+j;
+                            else if (kernel[4*i+j] > kernel[maxIndex])
+                                maxIndex = 4*i+j;
+                        }
+                    }
+                    if (difference < 0)
+                        kernel[maxIndex] = (short)(kernel[maxIndex] - difference);
+                    else
+                        kernel[minIndex] = (short)(kernel[minIndex] - difference);
                 }
             }
-            // Multi-scale merging
-            else
+        }
+        return kernels;
+    }
+
+    #ifdef OP_SIMD_X86
+        // SIMD versions of resizeAndPadRbgVerticalPass and resizeAndPadRbgHorizontalPass. They return the first
+        // element not processed
+        OP_TARGET_SSE4
+        int resizeAndPadRbgVerticalPassSse4(short* verticalRow, const unsigned char* const sourceRow0,
+                                            const unsigned char* const sourceRow1, const int weight0,
+                                            const int weight1, const int size)
+        {
+            auto i = 0;
+            const auto weight0V = _mm_set1_epi16((short)weight0);
+            const auto weight1V = _mm_set1_epi16((short)weight1);
+            for ( ; i + 8 <= size ; i += 8)
             {
-                // Construct temp targets. We reuse targetPtr to store first scale
-                std::vector<std::unique_ptr<T>> tempTargetPtrs;
-                for (auto n = 1; n < nums; n++){
-                    tempTargetPtrs.emplace_back(std::unique_ptr<T>(new T[targetChannelOffset * channels]()));
-                }
+                const auto source0 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)&sourceRow0[i]));
+                const auto source1 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)&sourceRow1[i]));
+                _mm_storeu_si128((__m128i*)&verticalRow[i], _mm_add_epi16(
+                    _mm_mullo_epi16(source0, weight0V), _mm_mullo_epi16(source1, weight1V)));
+            }
+            return i;
+        }
 
-                // Resize and sum
-                for (auto n = 0; n < nums; n++){
+        OP_TARGET_AVX2
+        int resizeAndPadRbgVerticalPassAvx2(short* verticalRow, const unsigned char* const sourceRow0,
+                                            const unsigned char* const sourceRow1, const int weight0,
+                                            const int weight1, const int size)
+        {
+            auto i = 0;
+            const auto weight0V = _mm256_set1_epi16((short)weight0);
+            const auto weight1V = _mm256_set1_epi16((short)weight1);
+            for ( ; i + 16 <= size ; i += 16)
+            {
+                const auto source0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)&sourceRow0[i]));
+                const auto source1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)&sourceRow1[i]));
+                _mm256_storeu_si256((__m256i*)&verticalRow[i], _mm256_add_epi16(
+                    _mm256_mullo_epi16(source0, weight0V), _mm256_mullo_epi16(source1, weight1V)));
+            }
+            return i;
+        }
 
-                    // Params
-                    const auto& sourceSize = sourceSizes[n];
-                    const auto sourceHeight = sourceSize[2]; // 368/6 ..
-                    const auto sourceWidth = sourceSize[3]; // 496/8 ..
-                    const auto sourceChannelOffset = sourceHeight * sourceWidth;
+        OP_TARGET_AVX512
+        int resizeAndPadRbgVerticalPassAvx512(short* verticalRow, const unsigned char* const sourceRow0,
+                                              const unsigned char* const sourceRow1, const int weight0,
+                                              const int weight1, const int size)
+        {
+            auto i = 0;
+            const auto weight0V = _mm512_set1_epi16((short)weight0);
+            const auto weight1V = _mm512_set1_epi16((short)weight1);
+            for ( ; i + 32 <= size ; i += 32)
+            {
+                const auto source0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)&sourceRow0[i]));
+                const auto source1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)&sourceRow1[i]));
+                _mm512_storeu_si512(&verticalRow[i], _mm512_add_epi16(
+                    _mm512_mullo_epi16(source0, weight0V), _mm512_mullo_epi16(source1, weight1V)));
+            }
+            return i;
+        }
 
-                    // Access pointers
-                    const T* sourcePtr = sourcePtrs[n];
-                    T* tempTargetPtr;
-                    if (n != 0)
-                        tempTargetPtr = tempTargetPtrs[n-1].get();
-                    else
-                        tempTargetPtr = targetPtr;
+        // 32-bit gathers of the int16 vertical pass (low half kept), so it must be padded with 1 extra element
+        OP_TARGET_AVX2
+        int resizeAndPadRbgHorizontalPassAvx2(float* targetRow, const short* const verticalRow,
+                                              const int* const xOffsets, const int* const xFractions,
+                                              const int width, const float scale, const float bias)
+        {
+            const auto lowHalfV = _mm256_set1_epi32(0xFFFF);
+            const auto tabSizeV = _mm256_set1_epi32(WARP_INTER_TAB_SIZE);
+            const auto roundDeltaV = _mm256_set1_epi32(1 << (WARP_LINEAR_BITS - 1));
+            const auto scaleV = _mm256_set1_ps(scale);
+            const auto biasV = _mm256_set1_ps(bias);
+            auto x = 0;
+            for ( ; x + 8 <= width ; x += 8)
+            {
+                const auto offsets = _mm256_loadu_si256((const __m256i*)&xOffsets[x]);
+                const auto fractions = _mm256_loadu_si256((const __m256i*)&xFractions[x]);
+                const auto vertical0 = _mm256_and_si256(
+                    _mm256_i32gather_epi32((const int*)verticalRow, offsets, 2), lowHalfV);
+                const auto vertical1 = _mm256_and_si256(
+                    _mm256_i32gather_epi32((const int*)&verticalRow[3], offsets, 2), lowHalfV);
+                auto value = _mm256_add_epi32(
+                    _mm256_mullo_epi32(vertical0, _mm256_sub_epi32(tabSizeV, fractions)),
+                    _mm256_mullo_epi32(vertical1, fractions));
+                value = _mm256_srai_epi32(_mm256_add_epi32(value, roundDeltaV), WARP_LINEAR_BITS);
+                _mm256_storeu_ps(&targetRow[x], _mm256_fmadd_ps(_mm256_cvtepi32_ps(value), scaleV, biasV));
+            }
+            return x;
+        }
+
+        OP_TARGET_AVX512
+        int resizeAndPadRbgHorizontalPassAvx512(float* targetRow, const short* const verticalRow,
+                                                const int* const xOffsets, const int* const xFractions,
+                                                const int width, const float scale, const float bias)
+        {
+            const auto lowHalfV = _mm512_set1_epi32(0xFFFF);
+            const auto tabSizeV = _mm512_set1_epi32(WARP_INTER_TAB_SIZE);
+            const auto roundDeltaV = _mm512_set1_epi32(1 << (WARP_LINEAR_BITS - 1));
+            const auto scaleV = _mm512_set1_ps(scale);
+            const auto biasV = _mm512_set1_ps(bias);
+            auto x = 0;
+            for ( ; x + 16 <= width ; x += 16)
+            {
+                const auto offsets = _mm512_loadu_si512(&xOffsets[x]);
+                const auto fractions = _mm512_loadu_si512(&xFractions[x]);
+                const auto vertical0 = _mm512_and_si512(
+                    _mm512_i32gather_epi32(offsets, (const int*)verticalRow, 2), lowHalfV);
+                const auto vertical1 = _mm512_and_si512(
+                    _mm512_i32gather_epi32(offsets, (const int*)&verticalRow[3], 2), lowHalfV);
+                auto value = _mm512_add_epi32(
+                    _mm512_mullo_epi32(vertical0, _mm512_sub_epi32(tabSizeV, fractions)),
+                    _mm512_mullo_epi32(vertical1, fractions));
+                value = _mm512_srai_epi32(_mm512_add_epi32(value, roundDeltaV), WARP_LINEAR_BITS);
+                _mm512_storeu_ps(&targetRow[x], _mm512_fmadd_ps(_mm512_cvtepi32_ps(value), scaleV, biasV));
+            }
+            return x;
+        }
+    #endif
+
+    inline void resizeAndPadRbgVerticalPass(short* verticalRow, const unsigned char* const sourceRow0,
+                                            const unsigned char* const sourceRow1, const int weight0,
+                                            const int weight1, const int size)
+    {
+        // 8-bit x 5-bit weights, so int16 is enough (max: 32*255)
+        auto i = 0;
+        #ifdef OP_SIMD_X86
+            const auto simdLevel = getSimdLevel();
+            if (simdLevel >= SimdLevel::Avx512)
+                i = resizeAndPadRbgVerticalPassAvx512(verticalRow, sourceRow0, sourceRow1, weight0, weight1, size);
+            else if (simdLevel >= SimdLevel::Avx2)
+                i = resizeAndPadRbgVerticalPassAvx2(verticalRow, sourceRow0, sourceRow1, weight0, weight1, size);
+            else if (simdLevel >= SimdLevel::Sse4)
+                i = resizeAndPadRbgVerticalPassSse4(verticalRow, sourceRow0, sourceRow1, weight0, weight1, size);
+        #endif
+        for ( ; i < size ; i++)
+            verticalRow[i] = (short)(sourceRow0[i]*weight0 + sourceRow1[i]*weight1);
+    }
+
+    // Only float is vectorized. It returns the first x not processed
+    template <typename T>
+    inline int resizeAndPadRbgHorizontalPassSimd(T*, const short* const, const int* const, const int* const,
+                                                 const int, const T, const T)
+    {
+        return 0;
+    }
+
+    #ifdef OP_SIMD_X86
+        template <>
+        inline int resizeAndPadRbgHorizontalPassSimd(float* targetRow, const short* const verticalRow,
+                                                     const int* const xOffsets, const int* const xFractions,
+                                                     const int width, const float scale, const float bias)
+        {
+            const auto simdLevel = getSimdLevel();
+            if (simdLevel >= SimdLevel::Avx512)
+                return resizeAndPadRbgHorizontalPassAvx512(
+                    targetRow, verticalRow, xOffsets, xFractions, width, scale, bias);
+            else if (simdLevel >= SimdLevel::Avx2)
+                return resizeAndPadRbgHorizontalPassAvx2(
+                    targetRow, verticalRow, xOffsets, xFractions, width, scale, bias);
+            return 0;
+        }
+    #endif
+
+    template <typename T>
+    inline void resizeAndPadRbgHorizontalPass(T* targetRow, const short* const verticalRow, const int* const xOffsets,
+                                              const int* const xFractions, const int width, const T scale,
+                                              const T bias)
+    {
+        auto x = resizeAndPadRbgHorizontalPassSimd(targetRow, verticalRow, xOffsets, xFractions, width, scale, bias);
+        const auto roundDelta = 1 << (WARP_LINEAR_BITS - 1);
+        for ( ; x < width ; x++)
+        {
+            const auto* const vertical = &verticalRow[xOffsets[x]];
+            const auto value = (vertical[0]*(WARP_INTER_TAB_SIZE - xFractions[x]) + vertical[3]*xFractions[x]
+                                + roundDelta) >> WARP_LINEAR_BITS;
+            targetRow[x] = value*scale + bias;
+        }
+    }
+
+    template <typename T>
+    void resizeAndPadRbgCubicRow(T* const* targetRows, const unsigned char* const srcPtr, const int sourceWidth,
+                                 const int sourceHeight, const WarpTable& warpTable, const int y, const int width,
+                                 const T scale, const std::array<T, 3>& biases)
+    {
+        // Per-pixel 4x4 kernels (non-separable after the cv::remap rounding correction). Pixels out of the source
+        // are 0 (cv::BORDER_CONSTANT)
+        static const auto sKernels = createCubicWarpKernels();
+        const auto roundDelta = 1 << (WARP_COEF_BITS - 1);
+        const auto sourceY = warpTable.yIndexes[y] - 1;
+        const auto* const kernelsY = &sKernels[16*WARP_INTER_TAB_SIZE*warpTable.yFractions[y]];
+        for (auto x = 0 ; x < width ; x++)
+        {
+            const auto sourceX = warpTable.xIndexes[x] - 1;
+            const auto* const kernel = &kernelsY[16*warpTable.xFractions[x]];
+            int sums[3] = {0, 0, 0};
+            for (auto i = 0 ; i < 4 ; i++)
+            {
+                if ((unsigned int)(sourceY + i) >= (unsigned int)sourceHeight)
+                    continue;
+                const auto* const sourceRow = &srcPtr[3*(sourceY + i)*sourceWidth];
+                for (auto j = 0 ; j < 4 ; j++)
+                {
+                    if ((unsigned int)(sourceX + j) >= (unsigned int)sourceWidth)
+                        continue;
+                    const auto* const pixel = &sourceRow[3*(sourceX + j)];
+                    const auto weight = kernel[4*i+j];
+                    sums[0] += pixel[0]*weight;
+                    sums[1] += pixel[1]*weight;
+                    sums[2] += pixel[2]*weight;
+                }
+            }
+            for (auto c = 0 ; c < 3 ; c++)
+                targetRows[c][x] = fastTruncate((sums[c] + roundDelta) >> WARP_COEF_BITS, 0, 255)*scale + biases[c];
+        }
+    }
 
-                    T* firstTempTargetPtr = targetPtr;
-                    for (auto c = 0 ; c < channels ; c++)
+    template <typename T>
+    void resizeAndPadRbgCpuRows(const std::vector<T*>& targetPtrs, const unsigned char* const srcPtr,
+                                const int sourceWidth, const int sourceHeight,
+                                const std::vector<Point<int>>& targetSizes, const std::vector<WarpTable>& warpTables,
+                                const T scale, const std::array<T, 3>& biases, const int rowBegin, const int rowEnd)
+    {
+        try
+        {
+            // Vertical pass of the current row, plus zero padding for the target pixels out of the source. It is
+            // kept across calls (frames) in order to avoid re-allocating it every time
+            thread_local std::vector<short> sVerticalRow;
+            const auto sourceRowSize = 3*sourceWidth;
+            sVerticalRow.resize(sourceRowSize + 7);
+            std::fill(sVerticalRow.begin() + sourceRowSize, sVerticalRow.end(), short(0));
+            // Rows of all scales are consecutive
+            auto scaleRowBegin = 0;
+            for (auto n = 0u ; n < targetSizes.size() ; n++)
+            {
+                const auto width = targetSizes[n].x;
+                const auto height = targetSizes[n].y;
+                const auto& warpTable = warpTables[n];
+                const auto yBegin = fastMax(rowBegin - scaleRowBegin, 0);
+                const auto yEnd = fastMin(rowEnd - scaleRowBegin, height);
+                scaleRowBegin += height;
+                for (auto y = yBegin ; y < yEnd ; y++)
+                {
+                    T* targetRows[3];
+                    for (auto c = 0 ; c < 3 ; c++)
+                        targetRows[c] = &targetPtrs[n][(c*height + y)*width];
+                    // Bicubic
+                    if (warpTable.cubic)
+                        resizeAndPadRbgCubicRow(
+                            targetRows, srcPtr, sourceWidth, sourceHeight, warpTable, y, width, scale, biases);
+                    // Bilinear: vertical pass into sVerticalRow, then horizontal pass for each channel
+                    else
                     {
-                        // Resize
-                        cv::Mat source(cv::Size(sourceWidth, sourceHeight), CV_32FC1,
-                                       const_cast<T*>(&sourcePtr[c*sourceChannelOffset]));
-                        cv::Mat target(cv::Size(targetWidth, targetHeight), CV_32FC1,
-                                       (&tempTargetPtr[c*targetChannelOffset]));
-                        cv::resize(source, target, {targetWidth, targetHeight}, 0, 0, CV_INTER_CUBIC);
-
-                        // Add
-                        if (n != 0)
+                        const auto sourceY = warpTable.yIndexes[y];
+                        const auto fraction = warpTable.yFractions[y];
+                        // Row fully out of the source
+                        if (sourceY >= sourceHeight)
                         {
-                            cv::Mat addTarget(cv::Size(targetWidth, targetHeight), CV_32FC1,
-                                              (&firstTempTargetPtr[c*targetChannelOffset]));
-                            cv::add(target, addTarget, addTarget);
+                            for (auto c = 0 ; c < 3 ; c++)
+                                std::fill(targetRows[c], targetRows[c] + width, biases[c]);
+                            continue;
                         }
+                        const auto* const sourceRow0 = &srcPtr[sourceY*sourceRowSize];
+                        const auto hasRow1 = (sourceY + 1 < sourceHeight);
+                        resizeAndPadRbgVerticalPass(
+                            sVerticalRow.data(), sourceRow0, (hasRow1 ? sourceRow0 + sourceRowSize : sourceRow0),
+                            WARP_INTER_TAB_SIZE - fraction, (hasRow1 ? fraction : 0), sourceRowSize);
+                        for (auto c = 0 ; c < 3 ; c++)
+                            resizeAndPadRbgHorizontalPass(
+                                targetRows[c], &sVerticalRow[c], warpTable.xOffsets.data(),
+                                warpTable.xFractions.data(), width, scale, biases[c]);
                     }
                 }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
 
-                // Average
-                for (auto c = 0 ; c < channels ; c++)
-                {
-                    cv::Mat target(cv::Size(targetWidth, targetHeight), CV_32FC1, (&targetPtr[c*targetChannelOffset]));
-                    target /= (float)nums;
-                }
+    template <typename T>
+    void resizeAndPadRbgCpu(
+        const std::vector<T*>& targetPtrs, const unsigned char* const srcPtr, const int sourceWidth,
+        const int sourceHeight, const std::vector<Point<int>>& targetSizes, const std::vector<double>& scaleFactors,
+        const int normalize)
+    {
+        try
+        {
+            // Sanity checks
+            if (targetPtrs.size() != targetSizes.size() || targetPtrs.size() != scaleFactors.size())
+                error("targetPtrs, targetSizes, and scaleFactors must have the same size.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            if (sourceWidth < 1 || sourceHeight < 1)
+                error("Empty source image.", __LINE__, __FUNCTION__, __FILE__);
+
+            // Normalization (same than uCharCvMatToFloatPtr): target = value*scale + biases[channel]
+            auto scale = T(1);
+            std::array<T, 3> biases{T(0), T(0), T(0)};
+            // VGG
+            if (normalize == 1)
+            {
+                scale = T(1)/T(256);
+                biases = {T(-0.5), T(-0.5), T(-0.5)};
+            }
+            // DenseNet
+            else if (normalize == 2)
+            {
+                const auto scaleDenseNet = 0.017;
+                const std::array<float,3> means{103.94f, 116.78f, 123.68f};
+                scale = T(scaleDenseNet);
+                for (auto c = 0 ; c < 3 ; c++)
+                    biases[c] = T(-scaleDenseNet*means[c]);
+            }
+            // Unknown
+            else if (normalize != 0)
+                error("Unknown normalization value (" + std::to_string(normalize) + ").",
+                      __LINE__, __FUNCTION__, __FILE__);
 
+            // Source sampling tables. Same interpolation than resizeFixedAspectRatio (cv::warpAffine with
+            // INTER_CUBIC when upsampling, and INTER_AREA otherwise, which warpAffine runs as INTER_LINEAR)
+            std::vector<WarpTable> warpTables(targetSizes.size());
+            auto numberRows = 0;
+            auto numberPixels = 0ll;
+            for (auto n = 0u ; n < targetSizes.size() ; n++)
+            {
+                auto& warpTable = warpTables[n];
+                warpTable.cubic = (scaleFactors[n] > 1.);
+                fillWarpIndexes(warpTable.xIndexes, warpTable.xFractions, scaleFactors[n], targetSizes[n].x);
+                fillWarpIndexes(warpTable.yIndexes, warpTable.yFractions, scaleFactors[n], targetSizes[n].y);
+                warpTable.xOffsets.resize(warpTable.xIndexes.size());
+                for (auto x = 0u ; x < warpTable.xIndexes.size() ; x++)
+                    warpTable.xOffsets[x] = 3*fastMin(warpTable.xIndexes[x], sourceWidth);
+                numberRows += targetSizes[n].y;
+                numberPixels += targetSizes[n].area();
             }
+
+            // All scales in a single pass. Their rows are independent, so they are processed in parallel by the
+            // ThreadPool, in chunks of at least 64K pixels
+            const auto minimumPixelsPerChunk = 64*1024;
+            ThreadPool::parallelFor(
+                0, numberRows,
+                [&](const int rowBegin, const int rowEnd)
+                {
+                    resizeAndPadRbgCpuRows(targetPtrs, srcPtr, sourceWidth, sourceHeight, targetSizes, warpTables,
+                                           scale, biases, rowBegin, rowEnd);
+                },
+                (int)fastMax(1ll, minimumPixelsPerChunk * (long long)numberRows / fastMax(1ll, numberPixels)));
         }
         catch (const std::exception& e)
         {
@@ -118,4 +677,18 @@ namespace op
     template OP_API void resizeAndMergeCpu(
         double* targetPtr, const std::vector<const double*>& sourcePtrs, const std::array<int, 4>& targetSize,
         const std::vector<std::array<int, 4>>& sourceSizes, const std::vector<double>& scaleInputToNetInputs);
+    template OP_API float resizeCubicPixelCpu(
+        const float* const sourcePtr, const Point<int>& sourceSize, const Point<int>& targetSize, const int x,
+        const int y);
+    template OP_API double resizeCubicPixelCpu(
+        const double* const sourcePtr, const Point<int>& sourceSize, const Point<int>& targetSize, const int x,
+        const int y);
+    template OP_API void resizeAndPadRbgCpu(
+        const std::vector<float*>& targetPtrs, const unsigned char* const srcPtr, const int sourceWidth,
+        const int sourceHeight, const std::vector<Point<int>>& targetSizes, const std::vector<double>& scaleFactors,
+        const int normalize);
+    template OP_API void resizeAndPadRbgCpu(
+        const std::vector<double*>& targetPtrs, const unsigned char* const srcPtr, const int sourceWidth,
+        const int sourceHeight, const std::vector<Point<int>>& targetSizes, const std::vector<double>& scaleFactors,
+        const int normalize);
 }
@@ -54,6 +54,33 @@ namespace op
         }
     }
 
+    void PoseExtractor::forwardPassBatch(const std::vector<std::vector<Array<float>>>& inputNetData,
+                                         const std::vector<Point<int>>& inputDataSizes,
+                                         const std::vector<std::vector<double>>& scaleInputToNetInputs,
+                                         const std::vector<long long>& frameIds,
+                                         const std::function<void(const int)>& frameProcessed)
+    {
+        try
+        {
+            if (mTracking < 1)
+                spPoseExtractorNet->forwardPassBatch(
+                    inputNetData, inputDataSizes, scaleInputToNetInputs, frameProcessed);
+            else
+            {
+                for (auto i = 0u ; i < inputNetData.size() ; i++)
+                {
+                    forwardPass(inputNetData[i], inputDataSizes[i], scaleInputToNetInputs[i], Array<float>{},
+                                frameIds[i]);
+                    frameProcessed(int(i));
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     Array<float> PoseExtractor::getHeatMapsCopy() const
     {
         try
@@ -134,13 +161,14 @@ namespace op
     }
 
     Array<long long> PoseExtractor::extractIds(const Array<float>& poseKeypoints, const Matrix& cvMatInput,
-                                               const unsigned long long imageViewIndex)
+                                               const unsigned long long imageViewIndex,
+                                               const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
     {
         try
         {
             // Run person ID extractor
             return (spPersonIdExtractor
-                ? spPersonIdExtractor->extractIds(poseKeypoints, cvMatInput, imageViewIndex)
+                ? spPersonIdExtractor->extractIds(poseKeypoints, cvMatInput, imageViewIndex, imagePyramidCache)
                 : Array<long long>{poseKeypoints.getSize(0), -1});
         }
         catch (const std::exception& e)
@@ -153,13 +181,15 @@ namespace op
     Array<long long> PoseExtractor::extractIdsLockThread(const Array<float>& poseKeypoints,
                                                          const Matrix& cvMatInput,
                                                          const unsigned long long imageViewIndex,
-                                                         const long long frameId)
+                                                         const long long frameId,
+                                                         const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
     {
         try
         {
             // Run person ID extractor
             return (spPersonIdExtractor
-                ? spPersonIdExtractor->extractIdsLockThread(poseKeypoints, cvMatInput, imageViewIndex, frameId)
+                ? spPersonIdExtractor->extractIdsLockThread(
+                    poseKeypoints, cvMatInput, imageViewIndex, frameId, imagePyramidCache)
                 : Array<long long>{poseKeypoints.getSize(0), -1});
         }
         catch (const std::exception& e)
@@ -171,7 +201,8 @@ namespace op
 
     void PoseExtractor::track(Array<float>& poseKeypoints, Array<long long>& poseIds,
                               const Matrix& cvMatInput,
-                              const unsigned long long imageViewIndex)
+                              const unsigned long long imageViewIndex,
+                              const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
     {
         try
         {
@@ -189,9 +220,7 @@ namespace op
                     poseIds.reset();
                 // Run person tracker
                 if (spPersonTrackers->at(imageViewIndex))
-                    (*spPersonTrackers)[imageViewIndex]->track(poseKeypoints, poseIds, cvMatInput);
-                // Run person tracker
-                (*spPersonTrackers)[imageViewIndex]->track(poseKeypoints, poseIds, cvMatInput);
+                    (*spPersonTrackers)[imageViewIndex]->track(poseKeypoints, poseIds, cvMatInput, imagePyramidCache);
             }
         }
         catch (const std::exception& e)
@@ -202,7 +231,8 @@ namespace op
 
     void PoseExtractor::trackLockThread(Array<float>& poseKeypoints, Array<long long>& poseIds,
                                         const Matrix& cvMatInput,
-                                        const unsigned long long imageViewIndex, const long long frameId)
+                                        const unsigned long long imageViewIndex, const long long frameId,
+                                        const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
     {
         try
         {
@@ -221,7 +251,7 @@ namespace op
                 // Run person tracker
                 if (spPersonTrackers->at(imageViewIndex))
                     (*spPersonTrackers)[imageViewIndex]->trackLockThread(
-                        poseKeypoints, poseIds, cvMatInput, frameId);
+                        poseKeypoints, poseIds, cvMatInput, frameId, imagePyramidCache);
             }
         }
         catch (const std::exception& e)
@@ -1,6 +1,8 @@
 #include <openpose/pose/poseExtractorCaffe.hpp>
+#include <algorithm> // std::copy
 #include <limits> // std::numeric_limits
 #include <openpose/gpu/cuda.hpp>
+#include <openpose/net/nmsBase.hpp>
 #include <openpose/pose/poseParameters.hpp>
 #include <openpose/utilities/check.hpp>
 #include <openpose/utilities/fastMath.hpp>
@@ -112,7 +114,8 @@ namespace op
         const PoseModel poseModel, const std::string& modelFolder, const int gpuId,
         const std::vector<HeatMapType>& heatMapTypes, const ScaleMode heatMapScaleMode, const bool addPartCandidates,
         const bool maximizePositives, const std::string& protoTxtPath, const std::string& caffeModelPath,
-        const float upsamplingRatio, const bool enableNet, const bool enableGoogleLogging) :
+        const float upsamplingRatio, const bool enableNet, const bool enableGoogleLogging,
+        const bool lowResPostProcessing) :
         PoseExtractorNet{poseModel, heatMapTypes, heatMapScaleMode, addPartCandidates, maximizePositives},
         mPoseModel{poseModel},
         mGpuId{gpuId},
@@ -121,7 +124,8 @@ namespace op
         mCaffeModelPath{caffeModelPath},
         mUpsamplingRatio{upsamplingRatio},
         mEnableNet{enableNet},
-        mEnableGoogleLogging{enableGoogleLogging}
+        mEnableGoogleLogging{enableGoogleLogging},
+        mLowResPostProcessing{lowResPostProcessing && heatMapTypes.empty() && !TOP_DOWN_REFINEMENT}
         #ifdef USE_CAFFE
             ,
             spResizeAndMergeCaffe{std::make_shared<ResizeAndMergeCaffe<float>>()},
@@ -136,6 +140,18 @@ namespace op
                 // Layers parameters
                 spBodyPartConnectorCaffe->setPoseModel(mPoseModel);
                 spBodyPartConnectorCaffe->setMaximizePositives(maximizePositives);
+                // Low-resolution post-processing
+                if (lowResPostProcessing)
+                {
+                    #if defined USE_CUDA || defined USE_OPENCL
+                        error("Low-resolution post-processing (`--low_res_post_processing`) is only implemented for"
+                              " the CPU version of OpenPose.", __LINE__, __FUNCTION__, __FILE__);
+                    #endif
+                    if (!heatMapTypes.empty())
+                        opLog("Low-resolution post-processing (`--low_res_post_processing`) is disabled because"
+                              " heat maps were requested (`--heatmaps_add_X`), which requires the full-resolution"
+                              " ones.", Priority::High);
+                }
             #else
                 UNUSED(poseModel);
                 UNUSED(modelFolder);
@@ -147,6 +163,7 @@ namespace op
                 UNUSED(protoTxtPath);
                 UNUSED(caffeModelPath);
                 UNUSED(enableGoogleLogging);
+                UNUSED(lowResPostProcessing);
                 error("OpenPose must be compiled with the `USE_CAFFE` macro definition in order to use this"
                       " functionality.", __LINE__, __FUNCTION__, __FILE__);
             #endif
@@ -260,6 +277,95 @@ namespace op
                     spCaffeNetOutputBlobs.emplace_back(
                         std::make_shared<ArrayCpuGpu<float>>(poseNetOutput, copyFromGpu));
                 }
+                // Resize + NMS + body part connection
+                processNetOutput(inputNetData, inputDataSize, scaleInputToNetInputs);
+            #else
+                UNUSED(inputNetData);
+                UNUSED(inputDataSize);
+                UNUSED(scaleInputToNetInputs);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void PoseExtractorCaffe::forwardPassBatch(
+        const std::vector<std::vector<Array<float>>>& inputNetData, const std::vector<Point<int>>& inputDataSizes,
+        const std::vector<std::vector<double>>& scaleInputToNetInputs,
+        const std::function<void(const int)>& frameProcessed)
+    {
+        try
+        {
+            // OpenCL: No zero-copy view of each frame output, so one frame at a time
+            #if defined USE_CAFFE && !defined USE_OPENCL
+                // Batch only if all frames have a single scale of the same size (i.e., a N x 3 x H x W input). Not
+                // with TOP_DOWN_REFINEMENT, which re-runs the network on each frame
+                auto batchable = mEnableNet && !TOP_DOWN_REFINEMENT && inputNetData.size() > 1u
+                    && inputDataSizes.size() == inputNetData.size()
+                    && scaleInputToNetInputs.size() == inputNetData.size();
+                for (auto i = 0u ; i < inputNetData.size() && batchable ; i++)
+                    batchable = inputNetData[i].size() == 1u && scaleInputToNetInputs[i].size() == 1u
+                        && inputNetData[i][0].getNumberDimensions() == 4u && inputNetData[i][0].getSize(0) == 1
+                        && vectorsAreEqual(inputNetData[i][0].getSize(), inputNetData[0][0].getSize());
+                if (!batchable)
+                {
+                    PoseExtractorNet::forwardPassBatch(
+                        inputNetData, inputDataSizes, scaleInputToNetInputs, frameProcessed);
+                    return;
+                }
+                // Concatenate the frames into a single network input
+                const auto batchSize = (int)inputNetData.size();
+                const auto& frameInputSize = inputNetData[0][0].getSize();
+                const std::vector<int> batchInputSize{batchSize, frameInputSize[1], frameInputSize[2],
+                                                      frameInputSize[3]};
+                if (!vectorsAreEqual(mBatchInputData.getSize(), batchInputSize))
+                    mBatchInputData.reset(batchInputSize);
+                const auto frameInputVolume = inputNetData[0][0].getVolume();
+                for (auto i = 0 ; i < batchSize ; i++)
+                    std::copy(inputNetData[i][0].getConstPtr(), inputNetData[i][0].getConstPtr() + frameInputVolume,
+                              mBatchInputData.getPtr() + i*frameInputVolume);
+                // 1. Caffe deep network (a single forward pass for the whole batch)
+                spNets.at(0)->forwardPass(mBatchInputData);
+                // 2-4. Post-processing of each frame on a view of its network output (no copy)
+                const auto netOutputBlob = spCaffeNetOutputBlobs.at(0);
+                const auto frameOutputVolume = netOutputBlob->count(1);
+                if (spBatchFrameBlob == nullptr)
+                    spBatchFrameBlob = std::make_shared<ArrayCpuGpu<float>>(1,1,1,1);
+                spBatchFrameBlob->Reshape(
+                    1, netOutputBlob->shape(1), netOutputBlob->shape(2), netOutputBlob->shape(3));
+                spCaffeNetOutputBlobs[0] = spBatchFrameBlob;
+                mNetInput4DSizes.resize(1);
+                for (auto i = 0 ; i < batchSize ; i++)
+                {
+                    #ifdef USE_CUDA
+                        spBatchFrameBlob->set_gpu_data(netOutputBlob->mutable_gpu_data() + i*frameOutputVolume);
+                    #else
+                        spBatchFrameBlob->set_cpu_data(netOutputBlob->mutable_cpu_data() + i*frameOutputVolume);
+                    #endif
+                    processNetOutput(inputNetData[i], inputDataSizes[i], scaleInputToNetInputs[i]);
+                    frameProcessed(i);
+                }
+                spCaffeNetOutputBlobs[0] = netOutputBlob;
+            #else
+                PoseExtractorNet::forwardPassBatch(inputNetData, inputDataSizes, scaleInputToNetInputs, frameProcessed);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void PoseExtractorCaffe::processNetOutput(
+        const std::vector<Array<float>>& inputNetData, const Point<int>& inputDataSize,
+        const std::vector<double>& scaleInputToNetInputs)
+    {
+        try
+        {
+            #ifdef USE_CAFFE
+                const auto numberScales = inputNetData.size();
                 // Reshape blobs if required
                 for (auto i = 0u ; i < inputNetData.size(); i++)
                 {
@@ -288,9 +394,12 @@ namespace op
                 }
                 // OP_CUDA_PROFILE_END(timeNormalize1, 1e3, REPS);
                 // OP_CUDA_PROFILE_INIT(REPS);
+                const auto caffeNetOutputBlobs = arraySharedToPtr(spCaffeNetOutputBlobs);
+                // Low-resolution post-processing (CPU, single scale): The full-resolution heat maps are never
+                // computed, spHeatMapsBlob is only used for its size
+                const auto lowResPostProcessing = mLowResPostProcessing && numberScales == 1;
                 // 2. Resize heat maps + merge different scales
                 // ~5ms (GPU) / ~20ms (CPU)
-                const auto caffeNetOutputBlobs = arraySharedToPtr(spCaffeNetOutputBlobs);
                 // Set and fill floatScaleRatios
                     // Option 1/2 (warning for double-to-float conversion)
                 // const std::vector<float> floatScaleRatios(scaleInputToNetInputs.begin(), scaleInputToNetInputs.end());
@@ -300,7 +409,8 @@ namespace op
                     scaleInputToNetInputs.begin(), scaleInputToNetInputs.end(),
                     [&floatScaleRatios](const double value) { floatScaleRatios.emplace_back(float(value)); });
                 spResizeAndMergeCaffe->setScaleRatios(floatScaleRatios);
-                spResizeAndMergeCaffe->Forward(caffeNetOutputBlobs, {spHeatMapsBlob.get()});
+                if (!lowResPostProcessing)
+                    spResizeAndMergeCaffe->Forward(caffeNetOutputBlobs, {spHeatMapsBlob.get()});
                 // Get scale net to output (i.e., image input)
                 // Note: In order to resize to input size, (un)comment the following lines
                 const auto scaleProducerToNetInput = resizeGetScaleFactor(inputDataSize, mNetOutputSize);
@@ -317,7 +427,21 @@ namespace op
                 // OP_CUDA_PROFILE_INIT(REPS);
                 spNmsCaffe->setThreshold(nmsThreshold);
                 spNmsCaffe->setOffset(Point<float>{nmsOffset, nmsOffset});
-                spNmsCaffe->Forward({spHeatMapsBlob.get()}, {spPeaksBlob.get()});
+                if (!lowResPostProcessing)
+                    spNmsCaffe->Forward({spHeatMapsBlob.get()}, {spPeaksBlob.get()});
+                // NMS directly on the network output, only upsampling a small window around each candidate
+                else
+                {
+                    const auto& netOutputBlob = *caffeNetOutputBlobs.at(0);
+                    const auto& peaksShape = spPeaksBlob->shape();
+                    nmsLowResolutionCpu(
+                        spPeaksBlob->mutable_cpu_data(), netOutputBlob.cpu_data(), nmsThreshold,
+                        std::array<int, 4>{peaksShape[0], peaksShape[1], peaksShape[2], peaksShape[3]},
+                        std::array<int, 4>{netOutputBlob.shape(0), netOutputBlob.shape(1), netOutputBlob.shape(2),
+                                           netOutputBlob.shape(3)},
+                        Point<int>{spHeatMapsBlob->shape(3), spHeatMapsBlob->shape(2)},
+                        Point<float>{nmsOffset, nmsOffset});
+                }
                 // 4. Connecting body parts
                 // OP_CUDA_PROFILE_END(timeNormalize3, 1e3, REPS);
                 // OP_CUDA_PROFILE_INIT(REPS);
@@ -329,8 +453,14 @@ namespace op
                 spBodyPartConnectorCaffe->setMinSubsetCnt((int)get(PoseProperty::ConnectMinSubsetCnt));
                 spBodyPartConnectorCaffe->setMinSubsetScore((float)get(PoseProperty::ConnectMinSubsetScore));
                 // Note: BODY_25D will crash (only implemented for CPU version)
-                spBodyPartConnectorCaffe->Forward(
-                    {spHeatMapsBlob.get(), spPeaksBlob.get()}, mPoseKeypoints, mPoseScores);
+                if (!lowResPostProcessing)
+                    spBodyPartConnectorCaffe->Forward(
+                        {spHeatMapsBlob.get(), spPeaksBlob.get()}, mPoseKeypoints, mPoseScores);
+                // PAFs upsampled on demand from the network output
+                else
+                    spBodyPartConnectorCaffe->Forward(
+                        {spHeatMapsBlob.get(), spPeaksBlob.get(), caffeNetOutputBlobs.at(0)}, mPoseKeypoints,
+                        mPoseScores);
                 // OP_CUDA_PROFILE_END(timeNormalize4, 1e3, REPS);
                 // opLog("1(caf)= " + std::to_string(timeNormalize1) + "ms");
                 // opLog("2(res) = " + std::to_string(timeNormalize2) + " ms");
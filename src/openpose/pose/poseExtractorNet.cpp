@@ -103,6 +103,30 @@ namespace op
         }
     }
 
+    void PoseExtractorNet::forwardPassBatch(
+        const std::vector<std::vector<Array<float>>>& inputNetData, const std::vector<Point<int>>& inputDataSizes,
+        const std::vector<std::vector<double>>& scaleInputToNetInputs,
+        const std::function<void(const int)>& frameProcessed)
+    {
+        try
+        {
+            // Sanity check
+            if (inputNetData.size() != inputDataSizes.size() || inputNetData.size() != scaleInputToNetInputs.size())
+                error("Size(inputNetData) must be same than size(inputDataSizes) and size(scaleInputToNetInputs).",
+                      __LINE__, __FUNCTION__, __FILE__);
+            // One frame at a time
+            for (auto i = 0u ; i < inputNetData.size() ; i++)
+            {
+                forwardPass(inputNetData[i], inputDataSizes[i], scaleInputToNetInputs[i]);
+                frameProcessed(int(i));
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     Array<float> PoseExtractorNet::getHeatMapsCopy() const
     {
         try
@@ -1,4 +1,5 @@
 #include <openpose/producer/imageDirectoryReader.hpp>
+#include <fstream> // std::ifstream
 #include <openpose/filestream/fileStream.hpp>
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/fileSystem.hpp>
@@ -25,19 +26,141 @@ namespace op
         }
     }
 
+    Point<int> getJpegSize(const std::string& imagePath)
+    {
+        try
+        {
+            // Parse the JPEG markers until the frame header (SOFn), which contains the image size
+            std::ifstream imageFile{imagePath, std::ios::binary};
+            if (imageFile.get() != 0xFF || imageFile.get() != 0xD8)
+                return Point<int>{-1,-1};
+            while (imageFile)
+            {
+                // Marker (skipping fill bytes)
+                if (imageFile.get() != 0xFF)
+                    return Point<int>{-1,-1};
+                auto marker = imageFile.get();
+                while (marker == 0xFF)
+                    marker = imageFile.get();
+                // Markers without segment
+                if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+                    continue;
+                // End of image or start of scan reached before the frame header
+                if (marker == 0xD9 || marker == 0xDA || marker < 0)
+                    return Point<int>{-1,-1};
+                const auto segmentLength = (imageFile.get() << 8) + imageFile.get();
+                if (segmentLength < 2)
+                    return Point<int>{-1,-1};
+                // SOFn (excluding DHT, JPG and DAC) = [precision, height (2 bytes), width (2 bytes), ...]
+                if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+                {
+                    imageFile.get();
+                    const auto height = (imageFile.get() << 8) + imageFile.get();
+                    const auto width = (imageFile.get() << 8) + imageFile.get();
+                    if (!imageFile)
+                        return Point<int>{-1,-1};
+                    return Point<int>{width, height};
+                }
+                imageFile.seekg(segmentLength - 2, std::ios::cur);
+            }
+            return Point<int>{-1,-1};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Point<int>{-1,-1};
+        }
+    }
+
+    Matrix loadImageReduced(int& decodingScale, const std::string& imagePath, const Point<int>& reducedDecodingSize)
+    {
+        try
+        {
+            auto openCvFlags = (int)CV_LOAD_IMAGE_COLOR;
+            decodingScale = 1;
+            // JPEG reduced decoding (the DCT scaling makes it much faster than decoding and resizing)
+            if (reducedDecodingSize.x > 0 || reducedDecodingSize.y > 0)
+            {
+                const auto imageSize = getJpegSize(imagePath);
+                if (imageSize.x > 0 && imageSize.y > 0)
+                {
+                    // Both orientations, EXIF rotation is applied after decoding
+                    const auto minimumSize = fastMax(reducedDecodingSize.x, reducedDecodingSize.y);
+                    const auto maximumScale = fastMin(imageSize.x, imageSize.y) / minimumSize;
+                    if (maximumScale >= 8)
+                    {
+                        openCvFlags = cv::IMREAD_REDUCED_COLOR_8;
+                        decodingScale = 8;
+                    }
+                    else if (maximumScale >= 4)
+                    {
+                        openCvFlags = cv::IMREAD_REDUCED_COLOR_4;
+                        decodingScale = 4;
+                    }
+                    else if (maximumScale >= 2)
+                    {
+                        openCvFlags = cv::IMREAD_REDUCED_COLOR_2;
+                        decodingScale = 2;
+                    }
+                }
+            }
+            return loadImage(imagePath, openCvFlags);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Matrix();
+        }
+    }
+
     ImageDirectoryReader::ImageDirectoryReader(const std::string& imageDirectoryPath,
                                                const std::string& cameraParameterPath,
                                                const bool undistortImage,
-                                               const int numberViews) :
+                                               const int numberViews,
+                                               const int decoderThreads,
+                                               const int prefetchDepth,
+                                               const Point<int>& reducedDecodingSize) :
         Producer{ProducerType::ImageDirectory, cameraParameterPath, undistortImage, numberViews},
         mImageDirectoryPath{imageDirectoryPath},
         mFilePaths{getImagePathsOnDirectory(imageDirectoryPath)},
-        mFrameNameCounter{0ll}
+        mFrameNameCounter{0ll},
+        mReducedDecodingSize{reducedDecodingSize},
+        mPrefetchDepth{(unsigned long long)fastMax(1, prefetchDepth)},
+        mCloseDecoders{false},
+        mPrefetchGeneration{0ull},
+        mPrefetchNext{0ll},
+        mPrefetchStep{1ll}
     {
+        try
+        {
+            // Start decoder threads
+            for (auto i = 0 ; i < decoderThreads ; i++)
+                mDecoderThreads.emplace_back(std::thread{&ImageDirectoryReader::decoderThread, this});
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
     }
 
     ImageDirectoryReader::~ImageDirectoryReader()
     {
+        try
+        {
+            // Close and join threads
+            {
+                const std::lock_guard<std::mutex> lock{mPrefetchMutex};
+                mCloseDecoders = true;
+            }
+            mConditionDecoders.notify_all();
+            for (auto& decoderThread : mDecoderThreads)
+                if (decoderThread.joinable())
+                    decoderThread.join();
+        }
+        catch (const std::exception& e)
+        {
+            errorDestructor(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
     }
 
     std::string ImageDirectoryReader::getNextFrameName()
@@ -58,9 +181,15 @@ namespace op
         try
         {
             // Read frame
-            auto frame = loadImage(mFilePaths.at(mFrameNameCounter++).c_str(), CV_LOAD_IMAGE_COLOR);
-            // Skip frames if frame step > 1
             const auto frameStep = Producer::get(ProducerProperty::FrameStep);
+            auto decodingScale = 1;
+            auto frame = (mDecoderThreads.empty()
+                ? loadImageReduced(decodingScale, mFilePaths.at(mFrameNameCounter), mReducedDecodingSize)
+                : getPrefetchedFrame(decodingScale, mFrameNameCounter, (long long)fastMax(1., frameStep)));
+            mFrameNameCounter++;
+            // Scale of the last frame, so the keypoints can be rescaled to the original image resolution
+            Producer::set(ProducerProperty::DecodingScale, decodingScale);
+            // Skip frames if frame step > 1
             if (frameStep > 1)
                 set(CV_CAP_PROP_POS_FRAMES, mFrameNameCounter + frameStep-1);
             // Check frame integrity. This function also checks width/height changes. However, if it is performed
@@ -94,6 +223,92 @@ namespace op
         }
     }
 
+    Matrix ImageDirectoryReader::getPrefetchedFrame(int& decodingScale, const long long frameIndex,
+                                                    const long long frameStep)
+    {
+        try
+        {
+            if (frameIndex < 0 || frameIndex >= (long long)mFilePaths.size())
+                error("Frame index " + std::to_string(frameIndex) + " out of range.", __LINE__, __FUNCTION__, __FILE__);
+            std::unique_lock<std::mutex> lock{mPrefetchMutex};
+            mPrefetchStep = frameStep;
+            // Frames before this one will not be requested anymore
+            mFramesDecoded.erase(mFramesDecoded.begin(), mFramesDecoded.lower_bound(frameIndex));
+            // Frame not decoded nor scheduled (first frame or after seeking) -> restart prefetching from it. Frames
+            // being decoded for the previous generation will be discarded
+            if (frameIndex != mPrefetchNext && mFramesDecoded.count(frameIndex) == 0
+                && mFramesDecoding.count(frameIndex) == 0)
+            {
+                mFramesDecoded.clear();
+                mFramesDecoding.clear();
+                mPrefetchGeneration++;
+                mPrefetchNext = frameIndex;
+            }
+            mConditionDecoders.notify_all();
+            // Wait for it
+            mConditionFrames.wait(lock, [this, frameIndex]{ return mFramesDecoded.count(frameIndex) > 0; });
+            const auto frameAndScale = mFramesDecoded[frameIndex];
+            mFramesDecoded.erase(frameIndex);
+            lock.unlock();
+            // Free slot for the decoders
+            mConditionDecoders.notify_one();
+            decodingScale = frameAndScale.second;
+            return frameAndScale.first;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Matrix();
+        }
+    }
+
+    void ImageDirectoryReader::decoderThread()
+    {
+        try
+        {
+            std::unique_lock<std::mutex> lock{mPrefetchMutex};
+            while (!mCloseDecoders)
+            {
+                // Wait for a free slot and a frame to decode
+                if (mPrefetchNext >= (long long)mFilePaths.size()
+                    || mFramesDecoding.size() + mFramesDecoded.size() >= mPrefetchDepth)
+                {
+                    mConditionDecoders.wait(lock);
+                    continue;
+                }
+                // Decode next frame (without blocking the others)
+                const auto frameIndex = mPrefetchNext;
+                const auto generation = mPrefetchGeneration;
+                mPrefetchNext += mPrefetchStep;
+                mFramesDecoding.emplace(frameIndex);
+                lock.unlock();
+                Matrix frame;
+                auto decodingScale = 1;
+                try
+                {
+                    frame = loadImageReduced(decodingScale, mFilePaths[frameIndex], mReducedDecodingSize);
+                }
+                catch (const std::exception& e)
+                {
+                    // Empty frame, so getRawFrame() does not wait for it forever
+                    errorWorker(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                }
+                lock.lock();
+                // Move to buffer (unless prefetching was restarted meanwhile)
+                if (generation == mPrefetchGeneration)
+                {
+                    mFramesDecoding.erase(frameIndex);
+                    mFramesDecoded.emplace(frameIndex, std::make_pair(frame, decodingScale));
+                    mConditionFrames.notify_all();
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            errorWorker(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     double ImageDirectoryReader::get(const int capProperty)
     {
         try
@@ -7,8 +7,10 @@ namespace op
     // http://www.webcamxp.com/publicipcams.aspx
 
     IpCameraReader::IpCameraReader(const std::string & cameraPath, const std::string& cameraParameterPath,
-                                   const bool undistortImage) :
-        VideoCaptureReader{cameraPath, ProducerType::IPCamera, cameraParameterPath, undistortImage, 1},
+                                   const bool undistortImage, const int bufferSize,
+                                   const BackpressurePolicy bufferPolicy) :
+        VideoCaptureReader{cameraPath, ProducerType::IPCamera, cameraParameterPath, undistortImage, 1, bufferSize,
+                           bufferPolicy},
         mPathName{cameraPath}
     {
     }
@@ -37,6 +37,7 @@ namespace op
             mProperties[(unsigned int)ProducerProperty::Flip] = (double) false;
             mProperties[(unsigned int)ProducerProperty::Rotation] = 0.;
             mProperties[(unsigned int)ProducerProperty::NumberViews] = numberViews;
+            mProperties[(unsigned int)ProducerProperty::DecodingScale] = 1.;
             auto& mNumberViews = mProperties[(unsigned int)ProducerProperty::NumberViews];
             // Camera (distortion, intrinsic, and extrinsic) parameters
             if (mType != ProducerType::FlirCamera)
@@ -410,7 +411,9 @@ namespace op
 
     std::shared_ptr<Producer> createProducer(
         const ProducerType producerType, const std::string& producerString, const Point<int>& cameraResolution,
-        const std::string& cameraParameterPath, const bool undistortImage, const int numberViews)
+        const std::string& cameraParameterPath, const bool undistortImage, const int numberViews,
+        const int decoderThreads, const int prefetchDepth, const Point<int>& reducedDecodingSize,
+        const int captureBufferSize, const BackpressurePolicy captureBufferPolicy)
     {
         try
         {
@@ -419,14 +422,17 @@ namespace op
             // Directory of images
             if (producerType == ProducerType::ImageDirectory)
                 return std::make_shared<ImageDirectoryReader>(
-                    producerString, cameraParameterPath, undistortImage, numberViews);
+                    producerString, cameraParameterPath, undistortImage, numberViews, decoderThreads, prefetchDepth,
+                    reducedDecodingSize);
             // Video
             else if (producerType == ProducerType::Video)
                 return std::make_shared<VideoReader>(
-                    producerString, cameraParameterPath, undistortImage, numberViews);
+                    producerString, cameraParameterPath, undistortImage, numberViews, captureBufferSize,
+                    captureBufferPolicy);
             // IP camera
             else if (producerType == ProducerType::IPCamera)
-                return std::make_shared<IpCameraReader>(producerString, cameraParameterPath, undistortImage);
+                return std::make_shared<IpCameraReader>(
+                    producerString, cameraParameterPath, undistortImage, captureBufferSize, captureBufferPolicy);
             // Flir camera
             else if (producerType == ProducerType::FlirCamera)
                 return std::make_shared<FlirReader>(
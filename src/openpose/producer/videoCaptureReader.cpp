@@ -1,5 +1,10 @@
 #include <openpose/producer/videoCaptureReader.hpp>
+#include <algorithm> // std::remove_if
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/string.hpp>
 #include <openpose_private/utilities/openCvMultiversionHeaders.hpp>
@@ -9,17 +14,93 @@ namespace op
     struct VideoCaptureReader::ImplVideoCaptureReader
     {
         cv::VideoCapture mVideoCapture;
+        // Background decoding (only if mBufferSize > 0)
+        const unsigned int mBufferSize;
+        const BackpressurePolicy mBufferPolicy;
+        bool mDecoding;
+        std::thread mThread;
+        // cv::VideoCapture is not thread-safe
+        std::mutex mCaptureMutex;
+        // Frame ring
+        std::mutex mRingMutex;
+        std::condition_variable mConditionDecoder;
+        std::condition_variable mConditionFrames;
+        bool mCloseThread;
+        bool mEnded;
+        bool mReleaseAtEnd;
+        // Empty read of a live source (IP camera), returned once by getRawFrame() while decoding goes on
+        bool mEmptyFrame;
+        // Only modified with both mCaptureMutex and mRingMutex locked
+        std::atomic<unsigned long long> mGeneration;
+        // Read by the decoding thread together with mGeneration, so frames decoded after a seek use the new step
+        std::atomic<double> mFrameStep;
+        std::vector<cv::Mat> mRing;
+        std::vector<double> mRingPositions;
+        unsigned int mRingFirst;
+        unsigned int mRingSize;
+        unsigned long long mNumberDroppedFrames;
+        // Only accessed by the decoding thread
+        cv::Mat mDecodedFrame;
+        std::vector<cv::Mat> mRecycledFrames;
+        // Properties of the frames returned so far (so get() does not wait for the decoding thread)
+        double mPosition;
+        double mWidth;
+        double mHeight;
+        double mFps;
+        double mFrameCount;
 
-        ImplVideoCaptureReader()
+        ImplVideoCaptureReader(const std::string& path = "", const int bufferSize = 0,
+                               const BackpressurePolicy bufferPolicy = BackpressurePolicy::Block) :
+            mBufferSize{(unsigned int)fastMax(0, bufferSize)},
+            mBufferPolicy{bufferPolicy},
+            mDecoding{false},
+            mCloseThread{false},
+            mEnded{false},
+            mReleaseAtEnd{false},
+            mEmptyFrame{false},
+            mGeneration{0ull},
+            mFrameStep{1.},
+            mRing(mBufferSize),
+            mRingPositions(mBufferSize, 0.),
+            mRingFirst{0u},
+            mRingSize{0u},
+            mNumberDroppedFrames{0ull}
         {
+            if (!path.empty())
+                mVideoCapture.open(path);
         }
 
-        ImplVideoCaptureReader(const std::string& path) :
-            mVideoCapture{path}
+        double getProperty(const int capProperty)
         {
+            if (mDecoding)
+            {
+                if (capProperty == CV_CAP_PROP_POS_FRAMES)
+                    return mPosition;
+                else if (capProperty == CV_CAP_PROP_FRAME_WIDTH)
+                    return mWidth;
+                else if (capProperty == CV_CAP_PROP_FRAME_HEIGHT)
+                    return mHeight;
+                else if (capProperty == CV_CAP_PROP_FPS)
+                    return mFps;
+                else if (capProperty == CV_CAP_PROP_FRAME_COUNT)
+                    return mFrameCount;
+                const std::lock_guard<std::mutex> lock{mCaptureMutex};
+                return mVideoCapture.get(capProperty);
+            }
+            return mVideoCapture.get(capProperty);
         }
     };
 
+    // Whether the frame data is still referenced outside the ring (e.g., by a Datum)
+    bool isFrameShared(const cv::Mat& frame)
+    {
+        #if defined(CV_MAJOR_VERSION) && CV_MAJOR_VERSION > 2
+            return (frame.u != nullptr && frame.u->refcount > 1);
+        #else
+            return (frame.refcount != nullptr && *frame.refcount > 1);
+        #endif
+    }
+
     VideoCaptureReader::VideoCaptureReader(const int index, const bool throwExceptionIfNoOpened,
                                            const std::string& cameraParameterPath, const bool undistortImage,
                                            const int numberViews) :
@@ -38,12 +119,16 @@ namespace op
 
     VideoCaptureReader::VideoCaptureReader(const std::string& path, const ProducerType producerType,
                                            const std::string& cameraParameterPath, const bool undistortImage,
-                                           const int numberViews) :
+                                           const int numberViews, const int bufferSize,
+                                           const BackpressurePolicy bufferPolicy) :
         Producer{producerType, cameraParameterPath, undistortImage, numberViews},
-        upImpl{new ImplVideoCaptureReader{path}}
+        upImpl{new ImplVideoCaptureReader{path, bufferSize, bufferPolicy}}
     {
         try
         {
+            if (bufferPolicy == BackpressurePolicy::LatencyTarget)
+                error("BackpressurePolicy::LatencyTarget is not supported by the VideoCaptureReader frame buffer.",
+                      __LINE__, __FUNCTION__, __FILE__);
             // Make sure only video or IP camera
             if (producerType != ProducerType::IPCamera && producerType != ProducerType::Video)
                 error("VideoCapture with an input path must be IP camera or video.",
@@ -89,7 +174,8 @@ namespace op
     {
         try
         {
-            return upImpl->mVideoCapture.isOpened();
+            // While decoding, only release() can close it
+            return (upImpl->mDecoding || upImpl->mVideoCapture.isOpened());
         }
         catch (const std::exception& e)
         {
@@ -102,6 +188,42 @@ namespace op
     {
         try
         {
+            // Background decoding
+            if (upImpl->mBufferSize > 0u && (upImpl->mDecoding || upImpl->mVideoCapture.isOpened()))
+            {
+                // Frame step read before decoding starts, so the first frames already use it
+                if (!upImpl->mDecoding)
+                {
+                    upImpl->mFrameStep = Producer::get(ProducerProperty::FrameStep);
+                    startDecoding();
+                }
+                // Wait for a decoded frame
+                std::unique_lock<std::mutex> lock{upImpl->mRingMutex};
+                upImpl->mFrameStep = Producer::get(ProducerProperty::FrameStep);
+                upImpl->mConditionFrames.wait(lock, [this]{
+                    return upImpl->mRingSize > 0u || upImpl->mEmptyFrame || upImpl->mEnded; });
+                // Retrieve it (or an empty frame if the source ended or failed to read, analogously to
+                // cv::VideoCapture)
+                cv::Mat frame;
+                if (upImpl->mRingSize > 0u)
+                {
+                    frame = upImpl->mRing[upImpl->mRingFirst];
+                    upImpl->mPosition = upImpl->mRingPositions[upImpl->mRingFirst];
+                    upImpl->mRingFirst = (upImpl->mRingFirst + 1u) % upImpl->mBufferSize;
+                    upImpl->mRingSize--;
+                }
+                else
+                    upImpl->mEmptyFrame = false;
+                const auto releaseCapture = (upImpl->mRingSize == 0u && upImpl->mReleaseAtEnd);
+                lock.unlock();
+                upImpl->mConditionDecoder.notify_one();
+                // Close if end of video (frame step > 1)
+                if (releaseCapture)
+                    release();
+                // Return frame
+                Matrix opFrame = OP_CV2OPMAT(frame);
+                return opFrame;
+            }
             // Get frame
             cv::Mat frame;
             upImpl->mVideoCapture >> frame;
@@ -164,6 +286,7 @@ namespace op
     {
         try
         {
+            stopDecoding();
             if (upImpl->mVideoCapture.isOpened())
             {
                 upImpl->mVideoCapture.release();
@@ -187,13 +310,13 @@ namespace op
                     && Producer::get(ProducerProperty::Rotation) != 180.))
             {
                 if (capProperty == CV_CAP_PROP_FRAME_WIDTH)
-                    return upImpl->mVideoCapture.get(CV_CAP_PROP_FRAME_HEIGHT);
+                    return upImpl->getProperty(CV_CAP_PROP_FRAME_HEIGHT);
                 else
-                    return upImpl->mVideoCapture.get(CV_CAP_PROP_FRAME_WIDTH);
+                    return upImpl->getProperty(CV_CAP_PROP_FRAME_WIDTH);
             }
 
             // Generic cases
-            return upImpl->mVideoCapture.get(capProperty);
+            return upImpl->getProperty(capProperty);
         }
         catch (const std::exception& e)
         {
@@ -206,11 +329,232 @@ namespace op
     {
         try
         {
-            upImpl->mVideoCapture.set(capProperty, value);
+            if (upImpl->mDecoding)
+            {
+                const std::lock_guard<std::mutex> lockCapture{upImpl->mCaptureMutex};
+                upImpl->mVideoCapture.set(capProperty, value);
+                // Seek -> discard the frames decoded so far (and the one being decoded)
+                if (capProperty == CV_CAP_PROP_POS_FRAMES)
+                {
+                    {
+                        const std::lock_guard<std::mutex> lockRing{upImpl->mRingMutex};
+                        upImpl->mGeneration++;
+                        upImpl->mRingFirst = 0u;
+                        upImpl->mRingSize = 0u;
+                        upImpl->mEnded = false;
+                        upImpl->mReleaseAtEnd = false;
+                        upImpl->mEmptyFrame = false;
+                        upImpl->mFrameStep = Producer::get(ProducerProperty::FrameStep);
+                        upImpl->mPosition = upImpl->mVideoCapture.get(CV_CAP_PROP_POS_FRAMES);
+                    }
+                    upImpl->mConditionDecoder.notify_one();
+                }
+                else if (capProperty == CV_CAP_PROP_FRAME_WIDTH)
+                    upImpl->mWidth = upImpl->mVideoCapture.get(CV_CAP_PROP_FRAME_WIDTH);
+                else if (capProperty == CV_CAP_PROP_FRAME_HEIGHT)
+                    upImpl->mHeight = upImpl->mVideoCapture.get(CV_CAP_PROP_FRAME_HEIGHT);
+                else if (capProperty == CV_CAP_PROP_FPS)
+                    upImpl->mFps = upImpl->mVideoCapture.get(CV_CAP_PROP_FPS);
+            }
+            else
+                upImpl->mVideoCapture.set(capProperty, value);
         }
         catch (const std::exception& e)
         {
             error(e.what(), __LINE__, __FUNCTION__, __FILE__);
         }
     }
+
+    void VideoCaptureReader::startDecoding()
+    {
+        try
+        {
+            // Properties (constant while decoding, except the frame position)
+            upImpl->mPosition = upImpl->mVideoCapture.get(CV_CAP_PROP_POS_FRAMES);
+            upImpl->mWidth = upImpl->mVideoCapture.get(CV_CAP_PROP_FRAME_WIDTH);
+            upImpl->mHeight = upImpl->mVideoCapture.get(CV_CAP_PROP_FRAME_HEIGHT);
+            upImpl->mFps = upImpl->mVideoCapture.get(CV_CAP_PROP_FPS);
+            upImpl->mFrameCount = upImpl->mVideoCapture.get(CV_CAP_PROP_FRAME_COUNT);
+            // Preallocate ring (cv::VideoCapture reuses the memory of frames with the same size and type)
+            const auto width = positiveIntRound(upImpl->mWidth);
+            const auto height = positiveIntRound(upImpl->mHeight);
+            if (width > 0 && height > 0)
+            {
+                for (auto& frame : upImpl->mRing)
+                    frame.create(height, width, CV_8UC3);
+                upImpl->mDecodedFrame.create(height, width, CV_8UC3);
+            }
+            // Start decoding thread
+            upImpl->mCloseThread = false;
+            upImpl->mEnded = false;
+            upImpl->mReleaseAtEnd = false;
+            upImpl->mEmptyFrame = false;
+            upImpl->mDecoding = true;
+            upImpl->mThread = std::thread{&VideoCaptureReader::decodingThread, this};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void VideoCaptureReader::stopDecoding()
+    {
+        try
+        {
+            if (upImpl->mDecoding)
+            {
+                {
+                    const std::lock_guard<std::mutex> lock{upImpl->mRingMutex};
+                    upImpl->mCloseThread = true;
+                }
+                upImpl->mConditionDecoder.notify_all();
+                if (upImpl->mThread.joinable())
+                    upImpl->mThread.join();
+                upImpl->mDecoding = false;
+                upImpl->mRingSize = 0u;
+                if (upImpl->mNumberDroppedFrames > 0u)
+                    opLog("VideoCaptureReader dropped " + std::to_string(upImpl->mNumberDroppedFrames)
+                          + " frames (frame buffer full).", Priority::High);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void VideoCaptureReader::decodingThread()
+    {
+        try
+        {
+            auto& impl = *upImpl;
+            // An empty read only ends a video. Live sources (IP camera) might just have dropped the connection or a
+            // frame, so the empty frame is passed on and decoding is retried once getRawFrame() has returned it
+            const auto endAtEmptyRead = (getType() == ProducerType::Video);
+            std::unique_lock<std::mutex> lockRing{impl.mRingMutex};
+            while (true)
+            {
+                // Wait until there is something to decode (and, if Block, a free slot)
+                impl.mConditionDecoder.wait(lockRing, [&impl]{
+                    return impl.mCloseThread || (!impl.mEnded && !impl.mEmptyFrame
+                                                 && (impl.mBufferPolicy != BackpressurePolicy::Block
+                                                     || impl.mRingSize < impl.mBufferSize)); });
+                if (impl.mCloseThread)
+                    break;
+                lockRing.unlock();
+                // Decode into the memory of a frame already released by the pipeline (if any), so no allocation
+                if (impl.mDecodedFrame.empty())
+                {
+                    for (auto& recycledFrame : impl.mRecycledFrames)
+                    {
+                        if (!isFrameShared(recycledFrame))
+                        {
+                            std::swap(impl.mDecodedFrame, recycledFrame);
+                            break;
+                        }
+                    }
+                    impl.mRecycledFrames.erase(
+                        std::remove_if(impl.mRecycledFrames.begin(), impl.mRecycledFrames.end(),
+                                       [](const cv::Mat& frame) { return frame.empty(); }),
+                        impl.mRecycledFrames.end());
+                    // Bounded (the pipeline might keep some frames for long)
+                    if (impl.mRecycledFrames.size() > fastMax(2u * impl.mBufferSize, 16u))
+                        impl.mRecycledFrames.erase(impl.mRecycledFrames.begin());
+                }
+                // Decode frame
+                auto ended = false;
+                auto releaseAtEnd = false;
+                unsigned long long generation;
+                double position;
+                {
+                    const std::lock_guard<std::mutex> lockCapture{impl.mCaptureMutex};
+                    generation = impl.mGeneration;
+                    const double frameStep = impl.mFrameStep;
+                    impl.mVideoCapture >> impl.mDecodedFrame;
+                    ended = impl.mDecodedFrame.empty();
+                    // Skip frames if frame step > 1
+                    const auto frameCount = impl.mVideoCapture.get(CV_CAP_PROP_FRAME_COUNT);
+                    if (frameStep > 1 && !ended && impl.mVideoCapture.get(CV_CAP_PROP_POS_FRAMES) < frameCount-1)
+                    {
+                        // Close if end of video
+                        if (impl.mVideoCapture.get(CV_CAP_PROP_POS_FRAMES) + frameStep-1 >= frameCount)
+                        {
+                            ended = true;
+                            releaseAtEnd = true;
+                        }
+                        // Frame step usually more efficient if just reading sequentially (only the last frame is
+                        // returned, so the previous ones are grabbed but not decoded)
+                        else if (frameStep < 51)
+                        {
+                            for (auto i = 2 ; i < frameStep ; i++)
+                                impl.mVideoCapture.grab();
+                            impl.mVideoCapture >> impl.mDecodedFrame;
+                        }
+                        // Using set(CV_CAP_PROP_POS_FRAMES, value) is efficient only if step is big
+                        else
+                            impl.mVideoCapture.set(
+                                CV_CAP_PROP_POS_FRAMES,
+                                impl.mVideoCapture.get(CV_CAP_PROP_POS_FRAMES) + frameStep-1);
+                    }
+                    position = impl.mVideoCapture.get(CV_CAP_PROP_POS_FRAMES);
+                }
+                lockRing.lock();
+                // Discard it if seeking happened meanwhile
+                if (generation != impl.mGeneration)
+                    continue;
+                // Move it into the ring
+                if (!impl.mDecodedFrame.empty())
+                {
+                    // Ring full
+                    if (impl.mRingSize == impl.mBufferSize)
+                    {
+                        impl.mNumberDroppedFrames++;
+                        // Overwrite the oldest frame
+                        if (impl.mBufferPolicy == BackpressurePolicy::DropOldest)
+                        {
+                            std::swap(impl.mRing[impl.mRingFirst], impl.mDecodedFrame);
+                            impl.mRingPositions[impl.mRingFirst] = position;
+                            impl.mRingFirst = (impl.mRingFirst + 1u) % impl.mBufferSize;
+                        }
+                        // Otherwise (DropNewest) discard the new one
+                    }
+                    else
+                    {
+                        const auto index = (impl.mRingFirst + impl.mRingSize) % impl.mBufferSize;
+                        std::swap(impl.mRing[index], impl.mDecodedFrame);
+                        impl.mRingPositions[index] = position;
+                        impl.mRingSize++;
+                    }
+                    // Frame replaced in the ring (maybe still used by the pipeline) or discarded -> recycle it
+                    if (!impl.mDecodedFrame.empty())
+                    {
+                        impl.mRecycledFrames.emplace_back();
+                        std::swap(impl.mRecycledFrames.back(), impl.mDecodedFrame);
+                    }
+                }
+                if (ended)
+                {
+                    if (endAtEmptyRead || releaseAtEnd)
+                    {
+                        impl.mEnded = true;
+                        impl.mReleaseAtEnd = releaseAtEnd;
+                    }
+                    else
+                        impl.mEmptyFrame = true;
+                }
+                impl.mConditionFrames.notify_all();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            // Do not let getRawFrame() wait forever
+            {
+                const std::lock_guard<std::mutex> lock{upImpl->mRingMutex};
+                upImpl->mEnded = true;
+            }
+            upImpl->mConditionFrames.notify_all();
+            errorWorker(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
 }
@@ -6,8 +6,10 @@
 namespace op
 {
     VideoReader::VideoReader(const std::string& videoPath, const std::string& cameraParameterPath,
-                             const bool undistortImage, const int numberViews) :
-        VideoCaptureReader{videoPath, ProducerType::Video, cameraParameterPath, undistortImage, numberViews},
+                             const bool undistortImage, const int numberViews, const int bufferSize,
+                             const BackpressurePolicy bufferPolicy) :
+        VideoCaptureReader{videoPath, ProducerType::Video, cameraParameterPath, undistortImage, numberViews,
+                           bufferSize, bufferPolicy},
         mPathName{getFileNameNoExtension(videoPath)}
     {
     }
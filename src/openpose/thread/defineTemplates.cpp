@@ -3,6 +3,7 @@
 namespace op
 {
     // Queues
+    DEFINE_TEMPLATE_DATUM(LockFreeQueue);
     DEFINE_TEMPLATE_DATUM(PriorityQueue);
     DEFINE_TEMPLATE_DATUM(Queue);
     template class OP_API QueueBase<BASE_DATUMS_SH, std::queue<BASE_DATUMS_SH>>;
@@ -0,0 +1,215 @@
+#include <openpose/thread/pipelineStatistics.hpp>
+#include <cstdio> // std::rename, std::remove
+#include <cstdlib> // std::free
+#include <fstream>
+#include <functional>
+#include <sstream>
+#ifdef __GNUG__
+    #include <cxxabi.h> // abi::__cxa_demangle
+#endif
+#include <openpose/utilities/errorAndLog.hpp>
+
+namespace op
+{
+    QueueStatistics::QueueStatistics() :
+        queueId{0ull},
+        size{0ull},
+        maxSize{0ull},
+        highWaterMark{0ull},
+        pushed{0ull},
+        popped{0ull},
+        dropped{0ull},
+        pushBlockedSeconds{0.},
+        popBlockedSeconds{0.},
+        maxSizeDecreases{0ull},
+        maxSizeIncreases{0ull},
+        latencySeconds{0.}
+    {
+    }
+
+    WorkerStatistics::WorkerStatistics() :
+        threadId{0ull},
+        count{0ull},
+        serviceSeconds{0.}
+    {
+    }
+
+    const std::vector<double>& getServiceTimeBucketsSeconds()
+    {
+        static const std::vector<double> sServiceTimeBucketsSeconds{
+            1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1., 2.5};
+        return sServiceTimeBucketsSeconds;
+    }
+
+    std::string pipelineStatisticsToPrometheus(const PipelineStatistics& pipelineStatistics)
+    {
+        try
+        {
+            std::ostringstream text;
+            text.precision(9);
+            // Queues
+            const auto addQueueMetric = [&](
+                const std::string& name, const std::string& type, const std::string& help,
+                const std::function<double(const QueueStatistics&)>& getValue)
+            {
+                text << "# HELP openpose_queue_" << name << " " << help << "\n"
+                     << "# TYPE openpose_queue_" << name << " " << type << "\n";
+                for (const auto& queueStatistics : pipelineStatistics.queues)
+                    text << "openpose_queue_" << name << "{queue=\"" << queueStatistics.queueId << "\"} "
+                         << getValue(queueStatistics) << "\n";
+            };
+            addQueueMetric("size", "gauge", "Current number of elements in the queue.",
+                           [](const QueueStatistics& q) { return double(q.size); });
+            addQueueMetric("max_size", "gauge", "Maximum number of elements of the queue.",
+                           [](const QueueStatistics& q) { return double(q.maxSize); });
+            addQueueMetric("high_water_mark", "gauge", "Maximum number of elements the queue has held at once.",
+                           [](const QueueStatistics& q) { return double(q.highWaterMark); });
+            addQueueMetric("pushed_total", "counter", "Elements pushed into the queue.",
+                           [](const QueueStatistics& q) { return double(q.pushed); });
+            addQueueMetric("popped_total", "counter", "Elements popped from the queue.",
+                           [](const QueueStatistics& q) { return double(q.popped); });
+            addQueueMetric("dropped_total", "counter", "Elements discarded because the queue was full or cleared.",
+                           [](const QueueStatistics& q) { return double(q.dropped); });
+            addQueueMetric("push_blocked_seconds_total", "counter", "Time the pushers waited for a full queue.",
+                           [](const QueueStatistics& q) { return q.pushBlockedSeconds; });
+            addQueueMetric("pop_blocked_seconds_total", "counter", "Time the poppers waited for an empty queue.",
+                           [](const QueueStatistics& q) { return q.popBlockedSeconds; });
+            addQueueMetric("max_size_decreases_total", "counter", "Latency-target backpressure size decreases.",
+                           [](const QueueStatistics& q) { return double(q.maxSizeDecreases); });
+            addQueueMetric("max_size_increases_total", "counter", "Latency-target backpressure size increases.",
+                           [](const QueueStatistics& q) { return double(q.maxSizeIncreases); });
+            addQueueMetric("latency_seconds", "gauge", "Average time the elements wait in the queue (only measured"
+                           " with latency-target backpressure).",
+                           [](const QueueStatistics& q) { return q.latencySeconds; });
+            // Workers
+            const auto& bucketsSeconds = getServiceTimeBucketsSeconds();
+            text << "# HELP openpose_worker_service_seconds Time each worker spends processing a frame.\n"
+                 << "# TYPE openpose_worker_service_seconds histogram\n";
+            for (const auto& workerStatistics : pipelineStatistics.workers)
+            {
+                const auto labels = "thread=\"" + std::to_string(workerStatistics.threadId) + "\",worker=\""
+                                  + workerStatistics.name + "\"";
+                auto cumulativeCount = 0ull;
+                for (auto bucket = 0u ; bucket < workerStatistics.histogram.size() ; bucket++)
+                {
+                    cumulativeCount += workerStatistics.histogram[bucket];
+                    text << "openpose_worker_service_seconds_bucket{" << labels << ",le=\"";
+                    if (bucket < bucketsSeconds.size())
+                        text << bucketsSeconds[bucket];
+                    else
+                        text << "+Inf";
+                    text << "\"} " << cumulativeCount << "\n";
+                }
+                text << "openpose_worker_service_seconds_sum{" << labels << "} " << workerStatistics.serviceSeconds
+                     << "\n"
+                     << "openpose_worker_service_seconds_count{" << labels << "} " << workerStatistics.count << "\n";
+            }
+            return text.str();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return "";
+        }
+    }
+
+    void savePipelineStatistics(const PipelineStatistics& pipelineStatistics, const std::string& filePath)
+    {
+        try
+        {
+            const auto temporaryFilePath = filePath + ".tmp";
+            {
+                std::ofstream file{temporaryFilePath};
+                file << pipelineStatisticsToPrometheus(pipelineStatistics);
+                if (!file)
+                    error("Could not write " + temporaryFilePath + ".", __LINE__, __FUNCTION__, __FILE__);
+            }
+            // std::rename does not overwrite existing files on Windows
+            #ifdef _WIN32
+                std::remove(filePath.c_str());
+            #endif
+            if (std::rename(temporaryFilePath.c_str(), filePath.c_str()) != 0)
+                error("Could not rename " + temporaryFilePath + " into " + filePath + ".",
+                      __LINE__, __FUNCTION__, __FILE__);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    std::string getClassName(const std::type_info& typeInfo)
+    {
+        try
+        {
+            std::string className = typeInfo.name();
+            #ifdef __GNUG__
+                auto status = -1;
+                char* const demangledName = abi::__cxa_demangle(typeInfo.name(), nullptr, nullptr, &status);
+                if (status == 0 && demangledName != nullptr)
+                    className = demangledName;
+                std::free(demangledName);
+            #endif
+            // Remove template arguments, namespaces, and MSVC "class " or "struct " prefix
+            className = className.substr(0, className.find('<'));
+            const auto namespaceEnd = className.rfind("::");
+            if (namespaceEnd != std::string::npos)
+                className = className.substr(namespaceEnd+2);
+            const auto prefixEnd = className.rfind(' ');
+            if (prefixEnd != std::string::npos)
+                className = className.substr(prefixEnd+1);
+            return className;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return "";
+        }
+    }
+
+    ServiceTimeRecorder::ServiceTimeRecorder() :
+        mCount{0ull},
+        mNanoseconds{0ull}
+    {
+        for (auto& bucket : mHistogram)
+            bucket = 0ull;
+    }
+
+    void ServiceTimeRecorder::record(const std::chrono::nanoseconds& serviceTime)
+    {
+        try
+        {
+            const auto seconds = 1e-9 * serviceTime.count();
+            const auto& bucketsSeconds = getServiceTimeBucketsSeconds();
+            auto bucket = 0u;
+            while (bucket < bucketsSeconds.size() && seconds > bucketsSeconds[bucket])
+                bucket++;
+            // Single writer, so load + store is enough (and cheaper than fetch_add)
+            mHistogram[bucket].store(mHistogram[bucket].load(std::memory_order_relaxed) + 1ull,
+                                     std::memory_order_relaxed);
+            mNanoseconds.store(mNanoseconds.load(std::memory_order_relaxed) + (unsigned long long)serviceTime.count(),
+                               std::memory_order_relaxed);
+            mCount.store(mCount.load(std::memory_order_relaxed) + 1ull, std::memory_order_relaxed);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void ServiceTimeRecorder::fill(WorkerStatistics& workerStatistics) const
+    {
+        try
+        {
+            workerStatistics.count = mCount.load(std::memory_order_relaxed);
+            workerStatistics.serviceSeconds = 1e-9 * mNanoseconds.load(std::memory_order_relaxed);
+            workerStatistics.histogram.resize(getServiceTimeBucketsSeconds().size()+1);
+            for (auto bucket = 0u ; bucket < workerStatistics.histogram.size() ; bucket++)
+                workerStatistics.histogram[bucket] = mHistogram[bucket].load(std::memory_order_relaxed);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+}
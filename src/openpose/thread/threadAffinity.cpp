@@ -0,0 +1,167 @@
+#include <openpose/thread/threadAffinity.hpp>
+#include <fstream>
+#include <stdexcept> // std::invalid_argument
+#ifdef __linux__
+    #include <pthread.h> // pthread_setaffinity_np, pthread_setname_np
+    #include <sys/syscall.h> // SYS_set_mempolicy
+    #include <unistd.h> // syscall
+#endif
+#include <openpose/utilities/errorAndLog.hpp>
+#include <openpose/utilities/string.hpp>
+#include <openpose/utilities/tracer.hpp>
+
+namespace op
+{
+    // std::stoi, but the whole string must be a number (e.g., "1x" is rejected rather than read as 1)
+    inline int stringToInt(const std::string& string)
+    {
+        std::size_t numberCharacters = 0;
+        const auto value = std::stoi(string, &numberCharacters);
+        if (numberCharacters != string.size())
+            throw std::invalid_argument{"Invalid integer \"" + string + "\"."};
+        return value;
+    }
+
+    ThreadAffinity::ThreadAffinity(const std::vector<int>& cores_, const int numaNode_) :
+        cores{cores_},
+        numaNode{numaNode_}
+    {
+    }
+
+    bool ThreadAffinity::enabled() const
+    {
+        return !cores.empty() || numaNode >= 0;
+    }
+
+    std::vector<int> stringToCores(const std::string& coreList)
+    {
+        try
+        {
+            std::vector<int> cores;
+            for (const auto& range : splitString(coreList, ","))
+            {
+                if (range.empty())
+                    continue;
+                const auto dash = range.find('-');
+                const auto first = stringToInt(range.substr(0, dash));
+                const auto last = (dash == std::string::npos ? first : stringToInt(range.substr(dash+1)));
+                if (first < 0 || last < first)
+                    error("Invalid core range \"" + range + "\" in \"" + coreList + "\" (expected format: e.g.,"
+                          " \"0-3,8\").", __LINE__, __FUNCTION__, __FILE__);
+                for (auto core = first ; core <= last ; core++)
+                    cores.emplace_back(core);
+            }
+            return cores;
+        }
+        catch (const std::invalid_argument&)
+        {
+            error("Invalid core list \"" + coreList + "\" (expected format: e.g., \"0-3,8\").",
+                  __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
+    int stringToNumaNode(const std::string& numaNode)
+    {
+        try
+        {
+            const auto numaNodeIndex = stringToInt(numaNode);
+            if (numaNodeIndex < 0)
+                error("Invalid NUMA node \"" + numaNode + "\" (expected a non-negative integer).",
+                      __LINE__, __FUNCTION__, __FILE__);
+            return numaNodeIndex;
+        }
+        catch (const std::invalid_argument&)
+        {
+            error("Invalid NUMA node \"" + numaNode + "\" (expected a non-negative integer).",
+                  __LINE__, __FUNCTION__, __FILE__);
+            return -1;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return -1;
+        }
+    }
+
+    std::vector<int> getNumaNodeCores(const int numaNode)
+    {
+        try
+        {
+            std::ifstream cpuListFile{"/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist"};
+            std::string cpuList;
+            if (!std::getline(cpuListFile, cpuList))
+                return {};
+            return stringToCores(cpuList);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
+    void setCurrentThreadAffinity(const ThreadAffinity& threadAffinity)
+    {
+        try
+        {
+            if (!threadAffinity.enabled())
+                return;
+            #ifdef __linux__
+                auto cores = threadAffinity.cores;
+                // NUMA memory binding (set_mempolicy rather than libnuma to avoid the extra dependency)
+                if (threadAffinity.numaNode >= 0)
+                {
+                    const auto bitsPerLong = 8 * sizeof(unsigned long);
+                    std::vector<unsigned long> nodeMask(threadAffinity.numaNode / bitsPerLong + 1, 0ul);
+                    nodeMask[threadAffinity.numaNode / bitsPerLong] |= 1ul << (threadAffinity.numaNode % bitsPerLong);
+                    const auto mpolBind = 2; // MPOL_BIND in linux/mempolicy.h
+                    if (syscall(SYS_set_mempolicy, mpolBind, nodeMask.data(), nodeMask.size() * bitsPerLong + 1) != 0)
+                        opLog("Could not bind the memory of this thread to NUMA node "
+                              + std::to_string(threadAffinity.numaNode) + ".", Priority::High);
+                    if (cores.empty())
+                        cores = getNumaNodeCores(threadAffinity.numaNode);
+                }
+                // Core pinning
+                if (!cores.empty())
+                {
+                    cpu_set_t cpuSet;
+                    CPU_ZERO(&cpuSet);
+                    for (const auto core : cores)
+                        if (core < CPU_SETSIZE)
+                            CPU_SET(core, &cpuSet);
+                    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) != 0)
+                        opLog("Could not pin this thread to cores " + std::to_string(cores.front()) + "..."
+                              + std::to_string(cores.back()) + " (do they exist?).", Priority::High);
+                }
+            #else
+                opLog("Thread affinity is only available on Linux, ignored.", Priority::High);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void setCurrentThreadName(const std::string& threadName)
+    {
+        try
+        {
+            Tracer::setThreadName(threadName);
+            #ifdef __linux__
+                // Linux limit: 16 characters including the null terminator
+                pthread_setname_np(pthread_self(), threadName.substr(0, 15).c_str());
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+}
@@ -0,0 +1,160 @@
+#include <openpose/tracking/imagePyramidCache.hpp>
+#include <algorithm> // std::min
+#include <atomic>
+#include <mutex>
+#include <opencv2/video/video.hpp> // cv::buildOpticalFlowPyramid
+#include <openpose_private/utilities/openCvMultiversionHeaders.hpp>
+
+namespace op
+{
+    struct ImagePyramid
+    {
+        cv::Size size;
+        int maxLevel;
+        int border;
+        std::vector<cv::Mat> images;
+    };
+
+    struct ImagePyramidCache::ImplImagePyramidCache
+    {
+        const cv::Mat mCvMatInput;
+        std::mutex mMutex;
+        cv::Mat mGrayImage;
+        std::vector<std::pair<cv::Size, cv::Mat>> mGrayImagesResized;
+        std::vector<ImagePyramid> mPyramids;
+        std::atomic<unsigned long long> mNumberPyramidsBuilt;
+
+        ImplImagePyramidCache(const cv::Mat& cvMatInput) :
+            mCvMatInput{cvMatInput},
+            mNumberPyramidsBuilt{0ull}
+        {
+        }
+
+        // It must be called with mMutex locked
+        const cv::Mat& getGrayImage(const cv::Size& size)
+        {
+            // Original size
+            if (mGrayImage.empty())
+            {
+                if (mCvMatInput.empty())
+                    error("Empty input image.", __LINE__, __FUNCTION__, __FILE__);
+                else if (mCvMatInput.channels() == 3)
+                    cv::cvtColor(mCvMatInput, mGrayImage, CV_BGR2GRAY);
+                else if (mCvMatInput.channels() == 1)
+                    mGrayImage = mCvMatInput;
+                else
+                    error("Only implemented for 1- and 3-channel images.", __LINE__, __FUNCTION__, __FILE__);
+            }
+            if (size.area() == 0 || size == mGrayImage.size())
+                return mGrayImage;
+            // Resized
+            for (const auto& sizeAndImage : mGrayImagesResized)
+                if (sizeAndImage.first == size)
+                    return sizeAndImage.second;
+            cv::Mat grayImageResized;
+            cv::resize(mGrayImage, grayImageResized, size, 0, 0, cv::INTER_CUBIC);
+            mGrayImagesResized.emplace_back(size, grayImageResized);
+            return mGrayImagesResized.back().second;
+        }
+    };
+
+    ImagePyramidCache::ImagePyramidCache(const Matrix& cvMatInput)
+    {
+        try
+        {
+            const cv::Mat cvMat = OP_OP2CVCONSTMAT(cvMatInput);
+            spImpl.reset(new ImplImagePyramidCache{cvMat});
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    ImagePyramidCache::~ImagePyramidCache()
+    {
+    }
+
+    Point<int> ImagePyramidCache::getSize() const
+    {
+        try
+        {
+            return Point<int>{spImpl->mCvMatInput.cols, spImpl->mCvMatInput.rows};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Point<int>{};
+        }
+    }
+
+    Matrix ImagePyramidCache::getGrayImage(const Point<int>& size)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{spImpl->mMutex};
+            const auto& grayImage = spImpl->getGrayImage(cv::Size{size.x, size.y});
+            return OP_CV2OPCONSTMAT(grayImage);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Matrix{};
+        }
+    }
+
+    std::vector<Matrix> ImagePyramidCache::getPyramid(const Point<int>& size, const int maxLevel, const int border)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{spImpl->mMutex};
+            const auto& grayImage = spImpl->getGrayImage(cv::Size{size.x, size.y});
+            // Already built (with at least the same number of levels and border)
+            const ImagePyramid* imagePyramid = nullptr;
+            for (const auto& pyramid : spImpl->mPyramids)
+            {
+                if (pyramid.size == grayImage.size() && pyramid.maxLevel >= maxLevel && pyramid.border >= border)
+                {
+                    imagePyramid = &pyramid;
+                    break;
+                }
+            }
+            // Build it otherwise
+            if (imagePyramid == nullptr)
+            {
+                ImagePyramid pyramid;
+                pyramid.size = grayImage.size();
+                pyramid.border = border;
+                pyramid.maxLevel = maxLevel;
+                cv::buildOpticalFlowPyramid(grayImage, pyramid.images, cv::Size{border, border}, maxLevel, false);
+                spImpl->mPyramids.emplace_back(pyramid);
+                spImpl->mNumberPyramidsBuilt++;
+                imagePyramid = &spImpl->mPyramids.back();
+            }
+            // Return the desired levels
+            std::vector<Matrix> pyramidImages;
+            const auto numberImages = std::min((int)imagePyramid->images.size(), maxLevel + 1);
+            for (auto level = 0 ; level < numberImages ; level++)
+                pyramidImages.emplace_back(OP_CV2OPCONSTMAT(imagePyramid->images[level]));
+            return pyramidImages;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
+    unsigned long long ImagePyramidCache::getNumberPyramidsBuilt() const
+    {
+        try
+        {
+            return spImpl->mNumberPyramidsBuilt;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0ull;
+        }
+    }
+}
@@ -0,0 +1,218 @@
+#include <openpose/tracking/keyframeTracker.hpp>
+#include <cmath> // std::abs, std::sqrt
+#include <openpose_private/tracking/pyramidalLK.hpp>
+#include <openpose_private/utilities/openCvMultiversionHeaders.hpp>
+
+namespace op
+{
+    struct KeyframeTrackerView
+    {
+        int framesSinceKeyframe;
+        std::vector<std::vector<Rectangle<float>>> keyframeRectangles;
+        unsigned long long keyframeNumberKeypoints;
+        std::vector<Array<float>> keypoints;
+        std::shared_ptr<ImagePyramidCache> spImagePyramidCache;
+
+        KeyframeTrackerView() :
+            framesSinceKeyframe{0},
+            keyframeNumberKeypoints{0ull}
+        {
+        }
+    };
+
+    struct KeyframeTracker::ImplKeyframeTracker
+    {
+        const int mKeyframeInterval;
+        const float mMaxRoiMotion;
+        const float mMaxKeypointLoss;
+        const int mLevels;
+        const int mPatchSize;
+        std::vector<KeyframeTrackerView> mViews;
+        unsigned long long mNumberFramesTracked;
+
+        ImplKeyframeTracker(const int keyframeInterval, const float maxRoiMotion, const float maxKeypointLoss,
+                            const int levels, const int patchSize) :
+            mKeyframeInterval{keyframeInterval},
+            mMaxRoiMotion{maxRoiMotion},
+            mMaxKeypointLoss{maxKeypointLoss},
+            mLevels{levels},
+            mPatchSize{patchSize},
+            mNumberFramesTracked{0ull}
+        {
+        }
+    };
+
+    unsigned long long getNumberKeypoints(const std::vector<Array<float>>& keypoints)
+    {
+        auto numberKeypoints = 0ull;
+        for (const auto& keypointsGroup : keypoints)
+            for (auto i = 2 ; i < (int)keypointsGroup.getVolume() ; i += 3)
+                if (keypointsGroup[i] > 0.f)
+                    numberKeypoints++;
+        return numberKeypoints;
+    }
+
+    bool roisMatch(const std::vector<std::vector<Rectangle<float>>>& keyframeRectangles,
+                   const std::vector<std::vector<Rectangle<float>>>& rectangles, const float maxRoiMotion)
+    {
+        if (keyframeRectangles.size() != rectangles.size())
+            return false;
+        for (auto group = 0u ; group < rectangles.size() ; group++)
+        {
+            if (keyframeRectangles[group].size() != rectangles[group].size())
+                return false;
+            for (auto roi = 0u ; roi < rectangles[group].size() ; roi++)
+            {
+                const auto& keyframeRectangle = keyframeRectangles[group][roi];
+                const auto& rectangle = rectangles[group][roi];
+                // ROI appeared or disappeared
+                if ((keyframeRectangle.area() > 0) != (rectangle.area() > 0))
+                    return false;
+                // ROI moved or resized
+                if (rectangle.area() > 0)
+                {
+                    const auto maxMotion = maxRoiMotion * keyframeRectangle.width;
+                    const auto keyframeCenter = keyframeRectangle.center();
+                    const auto center = rectangle.center();
+                    const auto dx = center.x - keyframeCenter.x;
+                    const auto dy = center.y - keyframeCenter.y;
+                    if (std::sqrt(dx*dx + dy*dy) > maxMotion
+                        || std::abs(rectangle.width - keyframeRectangle.width) > maxMotion)
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    KeyframeTracker::KeyframeTracker(const int keyframeInterval, const float maxRoiMotion,
+                                     const float maxKeypointLoss, const int levels, const int patchSize) :
+        spImpl{std::make_shared<ImplKeyframeTracker>(
+            keyframeInterval, maxRoiMotion, maxKeypointLoss, levels, patchSize)}
+    {
+    }
+
+    KeyframeTracker::~KeyframeTracker()
+    {
+    }
+
+    bool KeyframeTracker::track(
+        std::vector<Array<float>>& keypoints, const std::vector<std::vector<Rectangle<float>>>& rectangles,
+        const unsigned long long imageViewIndex, const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
+    {
+        try
+        {
+            // Keyframe required if: never tracked, keyframe interval reached, or ROIs changed
+            if (imageViewIndex >= spImpl->mViews.size() || imagePyramidCache == nullptr)
+                return false;
+            auto& view = spImpl->mViews[imageViewIndex];
+            if (view.spImagePyramidCache == nullptr || view.framesSinceKeyframe + 1 >= spImpl->mKeyframeInterval
+                || !roisMatch(view.keyframeRectangles, rectangles, spImpl->mMaxRoiMotion))
+                return false;
+            // Keypoints of the previous frame (with score > 0)
+            std::vector<cv::Point2f> coordinatesPrevious;
+            for (const auto& keypointsGroup : view.keypoints)
+                for (auto i = 0 ; i < (int)keypointsGroup.getVolume() ; i += 3)
+                    if (keypointsGroup[i+2] > 0.f)
+                        coordinatesPrevious.emplace_back(cv::Point2f{keypointsGroup[i], keypointsGroup[i+1]});
+            // Track them with pyramidal LK (pyramids shared with the other LK consumers of these frames)
+            std::vector<cv::Point2f> coordinatesCurrent;
+            std::vector<char> status(coordinatesPrevious.size(), 1);
+            if (!coordinatesPrevious.empty())
+            {
+                const auto imageSize = imagePyramidCache->getSize();
+                const auto pyramidPrevious = view.spImagePyramidCache->getPyramid(
+                    imageSize, spImpl->mLevels, spImpl->mPatchSize);
+                const auto pyramidCurrent = imagePyramidCache->getPyramid(
+                    imageSize, spImpl->mLevels, spImpl->mPatchSize);
+                OP_OP2CVVECTORMAT(pyramidImagesPrevious, pyramidPrevious);
+                OP_OP2CVVECTORMAT(pyramidImagesCurrent, pyramidCurrent);
+                pyramidalLKOcv(coordinatesPrevious, coordinatesCurrent, pyramidImagesPrevious, pyramidImagesCurrent,
+                               status, pyramidImagesPrevious[0], pyramidImagesCurrent[0], spImpl->mLevels,
+                               spImpl->mPatchSize);
+            }
+            // Propagated keypoints (the lost ones are removed)
+            std::vector<Array<float>> keypointsCurrent(view.keypoints.size());
+            auto index = 0u;
+            for (auto group = 0u ; group < view.keypoints.size() ; group++)
+            {
+                keypointsCurrent[group] = view.keypoints[group].clone();
+                auto& keypointsGroup = keypointsCurrent[group];
+                for (auto i = 0 ; i < (int)keypointsGroup.getVolume() ; i += 3)
+                {
+                    if (keypointsGroup[i+2] > 0.f)
+                    {
+                        if (status[index])
+                        {
+                            keypointsGroup[i] = coordinatesCurrent[index].x;
+                            keypointsGroup[i+1] = coordinatesCurrent[index].y;
+                        }
+                        else
+                        {
+                            keypointsGroup[i] = 0.f;
+                            keypointsGroup[i+1] = 0.f;
+                            keypointsGroup[i+2] = 0.f;
+                        }
+                        index++;
+                    }
+                }
+            }
+            // Keyframe required if LK lost too many keypoints
+            if (getNumberKeypoints(keypointsCurrent)
+                < (1.f - spImpl->mMaxKeypointLoss) * view.keyframeNumberKeypoints)
+                return false;
+            // Update view and return the propagated keypoints
+            view.framesSinceKeyframe++;
+            view.keypoints = keypointsCurrent;
+            view.spImagePyramidCache = imagePyramidCache;
+            spImpl->mNumberFramesTracked++;
+            keypoints.resize(keypointsCurrent.size());
+            for (auto group = 0u ; group < keypointsCurrent.size() ; group++)
+                keypoints[group] = keypointsCurrent[group].clone();
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    void KeyframeTracker::setKeyframe(
+        const std::vector<Array<float>>& keypoints, const std::vector<std::vector<Rectangle<float>>>& rectangles,
+        const unsigned long long imageViewIndex, const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
+    {
+        try
+        {
+            // Resize if required
+            if (spImpl->mViews.size() <= imageViewIndex)
+                spImpl->mViews.resize(imageViewIndex+1);
+            // Store keyframe
+            auto& view = spImpl->mViews[imageViewIndex];
+            view.framesSinceKeyframe = 0;
+            view.keyframeRectangles = rectangles;
+            view.keypoints.resize(keypoints.size());
+            for (auto group = 0u ; group < keypoints.size() ; group++)
+                view.keypoints[group] = keypoints[group].clone();
+            view.keyframeNumberKeypoints = getNumberKeypoints(keypoints);
+            view.spImagePyramidCache = imagePyramidCache;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    unsigned long long KeyframeTracker::getNumberFramesTracked() const
+    {
+        try
+        {
+            return spImpl->mNumberFramesTracked;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0ull;
+        }
+    }
+}
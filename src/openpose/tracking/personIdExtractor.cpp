@@ -3,8 +3,10 @@
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <openpose/tracking/imagePyramidCache.hpp>
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose_private/tracking/pyramidalLK.hpp>
+#include <openpose_private/utilities/openCvMultiversionHeaders.hpp>
 
 // #define LK_CUDA
 
@@ -80,9 +82,8 @@ namespace op
         }
     }
 
-    void updateLK(std::unordered_map<int,PersonEntry>& personEntries, std::vector<cv::Mat>& pyramidImagesPrevious,
-                  std::vector<cv::Mat>& pyramidImagesCurrent, const cv::Mat& imagePrevious,
-                  const cv::Mat& imageCurrent, const int numberFramesToDeletePerson)
+    void updateLK(std::unordered_map<int,PersonEntry>& personEntries, ImagePyramidCache& imagePyramidCachePrevious,
+                  ImagePyramidCache& imagePyramidCacheCurrent, const int numberFramesToDeletePerson)
     {
         try
         {
@@ -92,30 +93,57 @@ namespace op
             keyValues.reserve(personEntries.size());
             for (const auto& entry : personEntries)
                 keyValues.emplace_back(entry.first);
-            // Update or remove elements
+            // Remove old elements
+            std::vector<PersonEntry*> elements;
+            elements.reserve(keyValues.size());
             for (auto& key : keyValues)
             {
                 auto& element = personEntries[key];
-
-                // Remove keypoint
                 if (element.counterLastDetection++ > numberFramesToDeletePerson)
                     personEntries.erase(key);
-                // Update all keypoints for that entry
                 else
+                    elements.emplace_back(&element);
+            }
+            // Update all keypoints of all remaining elements with a single LK call
+            std::vector<cv::Point2f> keypointsPrevious;
+            std::vector<cv::Point2f> keypointsCurrent;
+            std::vector<char> status;
+            for (const auto* element : elements)
+            {
+                keypointsPrevious.insert(keypointsPrevious.end(), element->keypoints.begin(), element->keypoints.end());
+                status.insert(status.end(), element->status.begin(), element->status.end());
+            }
+            const auto levels = 3;
+            const auto patchSize = 21;
+            #ifdef LK_CUDA
+                cv::Mat imagePrevious;
+                cv::Mat imageCurrent;
+                OP_OP2CVCONSTMAT(imagePyramidCachePrevious.getGrayImage()).convertTo(imagePrevious, CV_32F);
+                OP_OP2CVCONSTMAT(imagePyramidCacheCurrent.getGrayImage()).convertTo(imageCurrent, CV_32F);
+                pyramidalLKGpu(keypointsPrevious, keypointsCurrent, status, imagePrevious, imageCurrent,
+                               levels, patchSize);
+            #else
+                // Pyramids shared with the other LK consumers of these frames (e.g., PersonTracker)
+                const auto pyramidPrevious = imagePyramidCachePrevious.getPyramid(
+                    imagePyramidCachePrevious.getSize(), levels-1, patchSize);
+                const auto pyramidCurrent = imagePyramidCacheCurrent.getPyramid(
+                    imagePyramidCacheCurrent.getSize(), levels-1, patchSize);
+                OP_OP2CVVECTORMAT(pyramidImagesPrevious, pyramidPrevious);
+                OP_OP2CVVECTORMAT(pyramidImagesCurrent, pyramidCurrent);
+                pyramidalLKCpu(keypointsPrevious, keypointsCurrent, pyramidImagesPrevious, pyramidImagesCurrent,
+                               status, pyramidImagesPrevious[0], pyramidImagesCurrent[0], levels, patchSize);
+            #endif
+            // Split the results back into each element
+            if (!keypointsPrevious.empty())
+            {
+                auto offset = 0u;
+                for (auto* element : elements)
                 {
-                    PersonEntry personEntry;
-                    personEntry.counterLastDetection = element.counterLastDetection;
-                    #ifdef LK_CUDA
-                        UNUSED(pyramidImagesPrevious);
-                        UNUSED(pyramidImagesCurrent);
-                        pyramidalLKGpu(element.keypoints, personEntry.keypoints, element.status,
-                                       imagePrevious, imageCurrent, 3, 21);
-                    #else
-                        pyramidalLKCpu(element.keypoints, personEntry.keypoints, pyramidImagesPrevious,
-                                       pyramidImagesCurrent, element.status, imagePrevious, imageCurrent, 3, 21);
-                    #endif
-                    personEntry.status = element.status;
-                    element = personEntry;
+                    const auto numberKeypoints = element->keypoints.size();
+                    element->keypoints.assign(
+                        keypointsCurrent.begin() + offset, keypointsCurrent.begin() + offset + numberKeypoints);
+                    element->status.assign(status.begin() + offset, status.begin() + offset + numberKeypoints);
+                    offset += (unsigned int)numberKeypoints;
                 }
             }
         }
@@ -168,7 +196,7 @@ namespace op
     Array<long long> matchLKAndOPGreedy(std::unordered_map<int,PersonEntry>& personEntries,
                                         long long& nextPersonId,
                                         const std::vector<PersonEntry>& openposePersonEntries,
-                                        const cv::Mat& imagePrevious,
+                                        const Point<int>& imageSize,
                                         const float inlierRatioThreshold,
                                         const float distanceThreshold)
     {
@@ -194,7 +222,7 @@ namespace op
 
                     const auto& openposePersonEntry = openposePersonEntries.at(i);
                     const auto personDistanceThreshold = fastMax(10.f,
-                        distanceThreshold*float(std::sqrt(imagePrevious.cols*imagePrevious.rows)) / 960.f);
+                        distanceThreshold*float(std::sqrt(imageSize.area())) / 960.f);
 
                     // Find best correspondence in the LK set
                     for (const auto& personEntry : personEntries)
@@ -387,8 +415,7 @@ namespace op
         const float mDistanceThreshold;
         const int mNumberFramesToDeletePerson;
         long long mNextPersonId;
-        cv::Mat mImagePrevious;
-        std::vector<cv::Mat> mPyramidImagesPrevious;
+        std::shared_ptr<ImagePyramidCache> spImagePyramidCachePrevious;
         std::unordered_map<int, PersonEntry> mPersonEntries;
         // Thread-safe variables
         std::atomic<long long> mLastFrameId;
@@ -426,8 +453,9 @@ namespace op
     {
     }
 
-    Array<long long> PersonIdExtractor::extractIds(const Array<float>& poseKeypoints, const Matrix& cvMatInput,
-                                                   const unsigned long long imageViewIndex)
+    Array<long long> PersonIdExtractor::extractIds(
+        const Array<float>& poseKeypoints, const Matrix& cvMatInput, const unsigned long long imageViewIndex,
+        const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
     {
         try
         {
@@ -439,32 +467,27 @@ namespace op
             Array<long long> poseIds;
             const auto openposePersonEntries = captureKeypoints(poseKeypoints, spImpl->mConfidenceThreshold);
 
+            // Frame pyramids (shared with the other LK consumers of this frame, if any)
+            const auto spImagePyramidCacheCurrent = (imagePyramidCache != nullptr
+                ? imagePyramidCache : std::make_shared<ImagePyramidCache>(cvMatInput));
             // First frame
-            const cv::Mat cvMatcvMatInput = OP_OP2CVCONSTMAT(cvMatInput);
-            if (spImpl->mImagePrevious.empty())
+            if (spImpl->spImagePyramidCachePrevious == nullptr)
             {
                 // Add first persons to the LK set
                 initializeLK(spImpl->mPersonEntries, spImpl->mNextPersonId, poseKeypoints, spImpl->mConfidenceThreshold);
-                // Capture current frame as floating point
-                cvMatcvMatInput.convertTo(spImpl->mImagePrevious, CV_32F);
             }
             // Rest
             else
-            {
-                cv::Mat imageCurrent;
-                std::vector<cv::Mat> pyramidImagesCurrent;
-                cvMatcvMatInput.convertTo(imageCurrent, CV_32F);
-                updateLK(spImpl->mPersonEntries, spImpl->mPyramidImagesPrevious, pyramidImagesCurrent, spImpl->mImagePrevious, imageCurrent,
+                updateLK(spImpl->mPersonEntries, *spImpl->spImagePyramidCachePrevious, *spImagePyramidCacheCurrent,
                          spImpl->mNumberFramesToDeletePerson);
-                spImpl->mImagePrevious = imageCurrent;
-                spImpl->mPyramidImagesPrevious = pyramidImagesCurrent;
-            }
+            // Keep the current frame (and its pyramids) for the next one
+            spImpl->spImagePyramidCachePrevious = spImagePyramidCacheCurrent;
 
             // Get poseIds and update LKset according to OpenPose set
             // poseIds = matchLKAndOP(
             poseIds = matchLKAndOPGreedy(
-                spImpl->mPersonEntries, spImpl->mNextPersonId, openposePersonEntries, spImpl->mImagePrevious, spImpl->mInlierRatioThreshold,
-                spImpl->mDistanceThreshold);
+                spImpl->mPersonEntries, spImpl->mNextPersonId, openposePersonEntries,
+                spImagePyramidCacheCurrent->getSize(), spImpl->mInlierRatioThreshold, spImpl->mDistanceThreshold);
 
             return poseIds;
         }
@@ -478,7 +501,8 @@ namespace op
     Array<long long> PersonIdExtractor::extractIdsLockThread(const Array<float>& poseKeypoints,
                                                              const Matrix& cvMatInput,
                                                              const unsigned long long imageViewIndex,
-                                                             const long long frameId)
+                                                             const long long frameId,
+                                                             const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
     {
         try
         {
@@ -489,7 +513,7 @@ namespace op
             while (spImpl->mLastFrameId < frameId - 1)
                 std::this_thread::sleep_for(std::chrono::microseconds{100});
             // Extract IDs
-            const auto ids = extractIds(poseKeypoints, cvMatInput, imageViewIndex);
+            const auto ids = extractIds(poseKeypoints, cvMatInput, imageViewIndex, imagePyramidCache);
             // Update last frame id
             spImpl->mLastFrameId = frameId;
             // Return person ids
@@ -1,7 +1,9 @@
 #include <openpose/tracking/personTracker.hpp>
 #include <atomic>
 #include <iostream>
+#include <map>
 #include <unordered_map>
+#include <openpose/tracking/imagePyramidCache.hpp>
 #include <openpose/utilities/fastMath.hpp>
 #include <openpose_private/tracking/pyramidalLK.hpp>
 #include <openpose_private/utilities/openCvMultiversionHeaders.hpp>
@@ -39,7 +41,7 @@ namespace op
         return numToRound + multiple - remainder;
     }
 
-    int computePersonScale(const PersonTrackerEntry& personEntry, const cv::Mat& imageCurrent)
+    int computePersonScale(const PersonTrackerEntry& personEntry, const Point<int>& imageSize)
     {
         int layerCount = 0;
         if (personEntry.status[0] || personEntry.status[14] ||
@@ -54,9 +56,9 @@ namespace op
             personEntry.status[12] || personEntry.status[13])
             layerCount++;
 
-        float minX = (float)imageCurrent.size().width;
+        float minX = (float)imageSize.x;
         float maxX = 0.f;
-        float minY = (float)imageCurrent.size().height;
+        float minY = (float)imageSize.y;
         float maxY = 0.f;
         int totalKp = 0;
         for (size_t i=0; i<personEntry.keypoints.size(); i++)
@@ -86,38 +88,59 @@ namespace op
     }
 
     void updateLK(std::unordered_map<int,PersonTrackerEntry>& personEntries,
-                  std::vector<cv::Mat>& pyramidImagesPrevious, std::vector<cv::Mat>& pyramidImagesCurrent,
-                  const cv::Mat& imagePrevious, const cv::Mat& imageCurrent,
-                  const int levels, const int patchSize, const bool trackVelocity, const bool scaleVarying)
+                  ImagePyramidCache& imagePyramidCachePrevious, ImagePyramidCache& imagePyramidCacheCurrent,
+                  const Point<int>& imageSize, const int levels, const int patchSize, const bool trackVelocity,
+                  const bool scaleVarying)
     {
         try
         {
-            // Inefficient version, do it per person
+            // All the people sharing the same LK patch size are tracked with a single pyramidalLKOcv call (i.e., all
+            // of them unless scaleVarying is enabled)
+            std::map<int, std::vector<PersonTrackerEntry*>> personEntriesPerPatchSize;
             for (auto& kv : personEntries)
             {
-                PersonTrackerEntry newPersonEntry;
-                PersonTrackerEntry& oldPersonEntry = kv.second;
-                int lkSize = patchSize;
-                if (scaleVarying)
+                const auto lkSize = (scaleVarying && !trackVelocity
+                    ? computePersonScale(kv.second, imageSize) : patchSize);
+                personEntriesPerPatchSize[lkSize].emplace_back(&kv.second);
+            }
+            for (auto& patchSizeAndEntries : personEntriesPerPatchSize)
+            {
+                const auto lkSize = patchSizeAndEntries.first;
+                auto& oldPersonEntries = patchSizeAndEntries.second;
+                // Concatenate keypoints of all people
+                std::vector<cv::Point2f> keypoints;
+                std::vector<cv::Point2f> newKeypoints;
+                std::vector<char> status;
+                for (const auto* oldPersonEntry : oldPersonEntries)
                 {
-                    pyramidImagesPrevious.clear();
-                    lkSize = computePersonScale(oldPersonEntry, imageCurrent);
+                    keypoints.insert(
+                        keypoints.end(), oldPersonEntry->keypoints.begin(), oldPersonEntry->keypoints.end());
+                    status.insert(status.end(), oldPersonEntry->status.begin(), oldPersonEntry->status.end());
+                    if (trackVelocity)
+                    {
+                        const auto predictedKeypoints = oldPersonEntry->getPredicted();
+                        newKeypoints.insert(newKeypoints.end(), predictedKeypoints.begin(), predictedKeypoints.end());
+                    }
                 }
-                if (trackVelocity)
+                // Pyramids with a border of at least lkSize pixels, shared with the other LK consumers of these
+                // frames and with the next frame (i.e., no rebuild for a patch size already used)
+                const auto pyramidPrevious = imagePyramidCachePrevious.getPyramid(imageSize, levels, lkSize);
+                const auto pyramidCurrent = imagePyramidCacheCurrent.getPyramid(imageSize, levels, lkSize);
+                OP_OP2CVVECTORMAT(pyramidImagesPrevious, pyramidPrevious);
+                OP_OP2CVVECTORMAT(pyramidImagesCurrent, pyramidCurrent);
+                pyramidalLKOcv(keypoints, newKeypoints, pyramidImagesPrevious, pyramidImagesCurrent, status,
+                               pyramidImagesPrevious[0], pyramidImagesCurrent[0], levels, lkSize, trackVelocity);
+                // Split the results back into each person
+                auto offset = 0u;
+                for (auto* oldPersonEntry : oldPersonEntries)
                 {
-                    newPersonEntry.keypoints = oldPersonEntry.getPredicted();
-                    pyramidalLKOcv(oldPersonEntry.keypoints, newPersonEntry.keypoints, pyramidImagesPrevious,
-                                   pyramidImagesCurrent, oldPersonEntry.status, imagePrevious, imageCurrent, levels,
-                                   patchSize, true);
+                    const auto numberKeypoints = (unsigned int)oldPersonEntry->keypoints.size();
+                    oldPersonEntry->lastKeypoints = oldPersonEntry->keypoints;
+                    oldPersonEntry->keypoints.assign(
+                        newKeypoints.begin() + offset, newKeypoints.begin() + offset + numberKeypoints);
+                    oldPersonEntry->status.assign(status.begin() + offset, status.begin() + offset + numberKeypoints);
+                    offset += numberKeypoints;
                 }
-                else
-                    pyramidalLKOcv(oldPersonEntry.keypoints, newPersonEntry.keypoints, pyramidImagesPrevious,
-                                   pyramidImagesCurrent, oldPersonEntry.status, imagePrevious, imageCurrent, levels,
-                                   lkSize, false);
-
-                newPersonEntry.lastKeypoints = oldPersonEntry.keypoints;
-                newPersonEntry.status = oldPersonEntry.status;
-                oldPersonEntry = newPersonEntry;
             }
         }
         catch (const std::exception& e)
@@ -374,8 +397,7 @@ namespace op
         const bool mScaleVarying;
         const float mRescale;
 
-        cv::Mat mImagePrevious;
-        std::vector<cv::Mat> mPyramidImagesPrevious;
+        std::shared_ptr<ImagePyramidCache> spImagePyramidCachePrevious;
         std::unordered_map<int, PersonTrackerEntry> mPersonEntries;
         Array<long long> mLastPoseIds;
 
@@ -418,8 +440,8 @@ namespace op
     {
     }
 
-    void PersonTracker::track(Array<float>& poseKeypoints, Array<long long>& poseIds,
-                              const Matrix& cvMatInput)
+    void PersonTracker::track(Array<float>& poseKeypoints, Array<long long>& poseIds, const Matrix& cvMatInput,
+                              const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
     {
         try
         {
@@ -458,22 +480,24 @@ namespace op
                  error("poseKeypoints and poseIds should have the same number of people",
                        __LINE__, __FUNCTION__, __FILE__);
 
+            // Frame pyramids (shared with the other LK consumers of this frame, if any)
+            const auto spImagePyramidCacheCurrent = (imagePyramidCache != nullptr
+                ? imagePyramidCache : std::make_shared<ImagePyramidCache>(cvMatInput));
+            // LK image size (rescaled)
+            const auto imageSize = spImagePyramidCacheCurrent->getSize();
+            auto lkImageSize = imageSize;
+            if (spImpl->mRescale)
+                lkImageSize = Point<int>{
+                    positiveIntRound(spImpl->mRescale),
+                    positiveIntRound(imageSize.y/(imageSize.x/ spImpl->mRescale))};
+
             // First frame
-            const cv::Mat cvMatcvMatInput = OP_OP2CVCONSTMAT(cvMatInput);
-            if (spImpl->mImagePrevious.empty())
+            if (spImpl->spImagePyramidCachePrevious == nullptr)
             {
                 // Create mPersonEntries
                 personEntriesFromOP(spImpl->mPersonEntries, poseKeypoints, poseIds, spImpl->mConfidenceThreshold);
-                // Capture current frame as floating point
-                cvMatcvMatInput.convertTo(spImpl->mImagePrevious, CV_8UC3);
-                // Rescale
-                if (spImpl->mRescale)
-                {
-                    cv::Size rescaleSize{
-                        positiveIntRound(spImpl->mRescale),
-                        positiveIntRound(spImpl->mImagePrevious.size().height/(spImpl->mImagePrevious.size().width/ spImpl->mRescale))};
-                    cv::resize(spImpl->mImagePrevious, spImpl->mImagePrevious, rescaleSize, 0, 0, cv::INTER_CUBIC);
-                }
+                // Keep the current frame (and its pyramids) for the next one
+                spImpl->spImagePyramidCachePrevious = spImagePyramidCacheCurrent;
                 // Save Last Ids
                 spImpl->mLastPoseIds = poseIds.clone();
             }
@@ -484,25 +508,14 @@ namespace op
                 const bool newOPData = !poseKeypoints.empty() && !poseIds.empty();
                 if ((newOPData && mergeResults) || (!newOPData))
                 {
-                    cv::Mat imageCurrent;
-                    std::vector<cv::Mat> pyramidImagesCurrent;
-                    cvMatcvMatInput.convertTo(imageCurrent, CV_8UC3);
-                    float xScale = 1., yScale = 1.;
-                    if (spImpl->mRescale)
-                    {
-                        cv::Size rescaleSize{
-                            positiveIntRound(spImpl->mRescale),
-                            positiveIntRound(imageCurrent.size().height/(imageCurrent.size().width/ spImpl->mRescale))};
-                        xScale = imageCurrent.size().width / (float)rescaleSize.width;
-                        yScale = imageCurrent.size().height / (float)rescaleSize.height;
-                        cv::resize(imageCurrent, imageCurrent, rescaleSize, 0, 0, cv::INTER_CUBIC);
-                    }
+                    const auto xScale = imageSize.x / (float)lkImageSize.x;
+                    const auto yScale = imageSize.y / (float)lkImageSize.y;
                     scaleKeypoints(spImpl->mPersonEntries, 1.f/xScale, 1.f/yScale);
-                    updateLK(spImpl->mPersonEntries, spImpl->mPyramidImagesPrevious, pyramidImagesCurrent, spImpl->mImagePrevious,
-                             imageCurrent, spImpl->mLevels, spImpl->mPatchSize, spImpl->mTrackVelocity, spImpl->mScaleVarying);
+                    updateLK(spImpl->mPersonEntries, *spImpl->spImagePyramidCachePrevious, *spImagePyramidCacheCurrent,
+                             lkImageSize, spImpl->mLevels, spImpl->mPatchSize, spImpl->mTrackVelocity,
+                             spImpl->mScaleVarying);
                     scaleKeypoints(spImpl->mPersonEntries, xScale, yScale);
-                    spImpl->mImagePrevious = imageCurrent;
-                    spImpl->mPyramidImagesPrevious = pyramidImagesCurrent;
+                    spImpl->spImagePyramidCachePrevious = spImagePyramidCacheCurrent;
                 }
 
                 // There is new OP Data
@@ -533,7 +546,8 @@ namespace op
     }
 
     void PersonTracker::trackLockThread(Array<float>& poseKeypoints, Array<long long>& poseIds,
-                                        const Matrix& cvMatInput, const long long frameId)
+                                        const Matrix& cvMatInput, const long long frameId,
+                                        const std::shared_ptr<ImagePyramidCache>& imagePyramidCache)
     {
         try
         {
@@ -541,7 +555,7 @@ namespace op
             while (spImpl->mLastFrameId < frameId - 1)
                 std::this_thread::sleep_for(std::chrono::microseconds{100});
             // Extract IDs
-            track(poseKeypoints, poseIds, cvMatInput);
+            track(poseKeypoints, poseIds, cvMatInput, imagePyramidCache);
             // Update last frame id
             spImpl->mLastFrameId = frameId;
         }
@@ -1,18 +1,11 @@
 #include <openpose_private/tracking/pyramidalLK.hpp>
-#ifdef WITH_SSE4
-    #include <emmintrin.h>
-    #include "smmintrin.h"
-#endif
-
-#ifdef WITH_AVX
-    #include <immintrin.h>
-#endif
-
+#include <algorithm> // std::fill
 #include <iostream>
 #include <opencv2/core/core.hpp> // cv::Point2f, cv::Mat
 #include <opencv2/imgproc/imgproc.hpp> // cv::pyrDown
 #include <opencv2/video/video.hpp> // cv::buildOpticalFlowPyramid
 #include <openpose/utilities/profiler.hpp>
+#include <openpose_private/utilities/avx.hpp>
 
 //#define DEBUG
 // #ifdef DEBUG
@@ -31,108 +24,152 @@
 
 namespace op
 {
-#ifdef WITH_SSE4
-    float sse_dot_product(std::vector<float> &av, std::vector<float> &bv)
-    {
-
-      /* Get SIMD-vector pointers to the start of each vector */
-      unsigned int niters = av.size() / 4;
-      float zeros[] = {0.0, 0.0, 0.0, 0.0};
-
-      float *a = (float *) aligned_alloc(16, av.size()*sizeof(float));
-      float *b = (float *) aligned_alloc(16, av.size()*sizeof(float));
-      memcpy(a,&av[0],av.size()*sizeof(float));
-      memcpy(b,&bv[0],bv.size()*sizeof(float));
-
-      __m128 *ptrA = (__m128*) &a[0], *ptrB = (__m128*) &b[0];
-      __m128 res = _mm_load_ps(zeros);
-
-      /* Do SIMD dot product */
-      for (unsigned int i = 0; i < niters; i++, ptrA++,ptrB++)
-        res = _mm_add_ps(_mm_dp_ps(*ptrA, *ptrB, 255), res);
-
-
-      /* Get result back from the SIMD vector */
-      float fres[4];
-      _mm_store_ps (fres, res);
-      int q = 4 * niters;
-
-      for (unsigned int i = 0; i < av.size() % 4; i++)
-        fres[0] += (a[i+q]*b[i+q]);
-
-      free(a);
-      free(b);
-
-      return fres[0];
-    }
-#endif
+    // Sums of the LK normal equations over a patch (ix, iy and it are contiguous buffers of `size` elements):
+    // sums = {ix*ix, iy*iy, ix*iy, ix*it, iy*it}
+    typedef void (*LKSumsFunction)(float*, const float*, const float*, const float*, const int);
 
-// Function aligned_alloc requires C++17 in VS
-#if defined (WITH_AVX) && !defined (_WIN32)
-    float avx_dot_product(std::vector<float> &av, std::vector<float> &bv)
+    void lkSumsScalar(float* sums, const float* ix, const float* iy, const float* it, const int size)
     {
-        /* Get SIMD-vector pointers to the start of each vector */
-        const size_t niters = av.size() / 8;
-
-        float *a = (float *)aligned_alloc(32, av.size() * sizeof(float));
-        float *b = (float *)aligned_alloc(32, av.size() * sizeof(float));
-        memcpy(a, &av[0], av.size() * sizeof(float));
-        memcpy(b, &bv[0], bv.size() * sizeof(float));
+        auto sumXX = 0.f;
+        auto sumYY = 0.f;
+        auto sumXY = 0.f;
+        auto sumXT = 0.f;
+        auto sumYT = 0.f;
+        for (auto i = 0; i < size; i++)
+        {
+            sumXX += ix[i] * ix[i];
+            sumYY += iy[i] * iy[i];
+            sumXY += ix[i] * iy[i];
+            sumXT += ix[i] * it[i];
+            sumYT += iy[i] * it[i];
+        }
+        sums[0] = sumXX;
+        sums[1] = sumYY;
+        sums[2] = sumXY;
+        sums[3] = sumXT;
+        sums[4] = sumYT;
+    }
 
-        __m256 *ptrA = (__m256*) &a[0], *ptrB = (__m256*) &b[0];
-        __m256 res = _mm256_set1_ps(0.0);
+    #ifdef OP_SIMD_X86
+        OP_TARGET_SSE4 inline float horizontalSumSse4(const __m128 mmValue)
+        {
+            const __m128 mmSum = _mm_add_ps(mmValue, _mm_movehl_ps(mmValue, mmValue));
+            return _mm_cvtss_f32(_mm_add_ss(mmSum, _mm_shuffle_ps(mmSum, mmSum, 1)));
+        }
 
-        for (size_t i = 0; i < niters; i++, ptrA++, ptrB++)
-            res = _mm256_add_ps(_mm256_dp_ps(*ptrA, *ptrB, 255), res);
+        OP_TARGET_SSE4 void lkSumsSse4(float* sums, const float* ix, const float* iy, const float* it, const int size)
+        {
+            __m128 mmSumXX = _mm_setzero_ps();
+            __m128 mmSumYY = _mm_setzero_ps();
+            __m128 mmSumXY = _mm_setzero_ps();
+            __m128 mmSumXT = _mm_setzero_ps();
+            __m128 mmSumYT = _mm_setzero_ps();
+            auto i = 0;
+            for (; i < size-3; i += 4)
+            {
+                const __m128 mmIx = _mm_loadu_ps(&ix[i]);
+                const __m128 mmIy = _mm_loadu_ps(&iy[i]);
+                const __m128 mmIt = _mm_loadu_ps(&it[i]);
+                mmSumXX = _mm_add_ps(mmSumXX, _mm_mul_ps(mmIx, mmIx));
+                mmSumYY = _mm_add_ps(mmSumYY, _mm_mul_ps(mmIy, mmIy));
+                mmSumXY = _mm_add_ps(mmSumXY, _mm_mul_ps(mmIx, mmIy));
+                mmSumXT = _mm_add_ps(mmSumXT, _mm_mul_ps(mmIx, mmIt));
+                mmSumYT = _mm_add_ps(mmSumYT, _mm_mul_ps(mmIy, mmIt));
+            }
+            lkSumsScalar(sums, &ix[i], &iy[i], &it[i], size-i);
+            sums[0] += horizontalSumSse4(mmSumXX);
+            sums[1] += horizontalSumSse4(mmSumYY);
+            sums[2] += horizontalSumSse4(mmSumXY);
+            sums[3] += horizontalSumSse4(mmSumXT);
+            sums[4] += horizontalSumSse4(mmSumYT);
+        }
 
-        /* Get result back from the SIMD vector */
-        float fres[8];
-        _mm256_storeu_ps(fres, res);
-        const size_t q = 8 * niters;
+        OP_TARGET_AVX2 inline float horizontalSumAvx2(const __m256 mmValue)
+        {
+            const __m128 mmSum = _mm_add_ps(_mm256_castps256_ps128(mmValue), _mm256_extractf128_ps(mmValue, 1));
+            const __m128 mmSum2 = _mm_add_ps(mmSum, _mm_movehl_ps(mmSum, mmSum));
+            return _mm_cvtss_f32(_mm_add_ss(mmSum2, _mm_shuffle_ps(mmSum2, mmSum2, 1)));
+        }
 
-        for (size_t i = 0; i < av.size() % 8; i++)
-            fres[0] += (a[i + q] * b[i + q]);
+        OP_TARGET_AVX2 void lkSumsAvx2(float* sums, const float* ix, const float* iy, const float* it, const int size)
+        {
+            __m256 mmSumXX = _mm256_setzero_ps();
+            __m256 mmSumYY = _mm256_setzero_ps();
+            __m256 mmSumXY = _mm256_setzero_ps();
+            __m256 mmSumXT = _mm256_setzero_ps();
+            __m256 mmSumYT = _mm256_setzero_ps();
+            auto i = 0;
+            for (; i < size-7; i += 8)
+            {
+                const __m256 mmIx = _mm256_loadu_ps(&ix[i]);
+                const __m256 mmIy = _mm256_loadu_ps(&iy[i]);
+                const __m256 mmIt = _mm256_loadu_ps(&it[i]);
+                mmSumXX = _mm256_fmadd_ps(mmIx, mmIx, mmSumXX);
+                mmSumYY = _mm256_fmadd_ps(mmIy, mmIy, mmSumYY);
+                mmSumXY = _mm256_fmadd_ps(mmIx, mmIy, mmSumXY);
+                mmSumXT = _mm256_fmadd_ps(mmIx, mmIt, mmSumXT);
+                mmSumYT = _mm256_fmadd_ps(mmIy, mmIt, mmSumYT);
+            }
+            lkSumsScalar(sums, &ix[i], &iy[i], &it[i], size-i);
+            sums[0] += horizontalSumAvx2(mmSumXX);
+            sums[1] += horizontalSumAvx2(mmSumYY);
+            sums[2] += horizontalSumAvx2(mmSumXY);
+            sums[3] += horizontalSumAvx2(mmSumXT);
+            sums[4] += horizontalSumAvx2(mmSumYT);
+        }
 
-        free(a);
-        free(b);
+        OP_TARGET_AVX512 void lkSumsAvx512(
+            float* sums, const float* ix, const float* iy, const float* it, const int size)
+        {
+            __m512 mmSumXX = _mm512_setzero_ps();
+            __m512 mmSumYY = _mm512_setzero_ps();
+            __m512 mmSumXY = _mm512_setzero_ps();
+            __m512 mmSumXT = _mm512_setzero_ps();
+            __m512 mmSumYT = _mm512_setzero_ps();
+            // The last (partial) vector is masked, so there is no scalar tail
+            for (auto i = 0; i < size; i += 16)
+            {
+                const __mmask16 mask = (size-i >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (size-i)) - 1u));
+                const __m512 mmIx = _mm512_maskz_loadu_ps(mask, &ix[i]);
+                const __m512 mmIy = _mm512_maskz_loadu_ps(mask, &iy[i]);
+                const __m512 mmIt = _mm512_maskz_loadu_ps(mask, &it[i]);
+                mmSumXX = _mm512_fmadd_ps(mmIx, mmIx, mmSumXX);
+                mmSumYY = _mm512_fmadd_ps(mmIy, mmIy, mmSumYY);
+                mmSumXY = _mm512_fmadd_ps(mmIx, mmIy, mmSumXY);
+                mmSumXT = _mm512_fmadd_ps(mmIx, mmIt, mmSumXT);
+                mmSumYT = _mm512_fmadd_ps(mmIy, mmIt, mmSumYT);
+            }
+            sums[0] = _mm512_reduce_add_ps(mmSumXX);
+            sums[1] = _mm512_reduce_add_ps(mmSumYY);
+            sums[2] = _mm512_reduce_add_ps(mmSumXY);
+            sums[3] = _mm512_reduce_add_ps(mmSumXT);
+            sums[4] = _mm512_reduce_add_ps(mmSumYT);
+        }
+    #endif
 
-        return fres[0] + fres[4];
+    LKSumsFunction getLKSumsFunction()
+    {
+        #ifdef OP_SIMD_X86
+            const auto simdLevel = getSimdLevel();
+            if (simdLevel >= SimdLevel::Avx512)
+                return &lkSumsAvx512;
+            else if (simdLevel >= SimdLevel::Avx2)
+                return &lkSumsAvx2;
+            else if (simdLevel >= SimdLevel::Sse4)
+                return &lkSumsSse4;
+        #endif
+        return &lkSumsScalar;
     }
-#endif
 
-    char computeLK(cv::Point2f& delta,  std::vector<float>& ix,
-                  std::vector<float>& iy, std::vector<float>& it)
+    char computeLK(cv::Point2f& delta, const float* const sums)
     {
         try
         {
-            // Calculate sums
-#if defined (WITH_AVX) && !defined (_WIN32)
-            const float sumXX = avx_dot_product(ix,ix);
-            const float sumYY = avx_dot_product(iy,iy);
-            const float sumXY = avx_dot_product(ix,iy);
-            const float sumXT = avx_dot_product(ix,it);
-            const float sumYT = avx_dot_product(iy,it);
-#elif defined (WITH_SSE4)
-            const float sumXX = sse_dot_product(ix,ix);
-            const float sumYY = sse_dot_product(iy,iy);
-            const float sumXY = sse_dot_product(ix,iy);
-            const float sumXT = sse_dot_product(ix,it);
-            const float sumYT = sse_dot_product(iy,it);
-#else
-            auto sumXX = 0.f;
-            auto sumYY = 0.f;
-            auto sumXT = 0.f;
-            auto sumYT = 0.f;
-            auto sumXY = 0.f;
-            for (auto i = 0u; i < ix.size(); i++)
-            {
-                sumXX += ix[i] * ix[i];
-                sumYY += iy[i] * iy[i];
-                sumXY += ix[i] * iy[i];
-                sumXT += ix[i] * it[i];
-                sumYT += iy[i] * it[i];
-            }
-#endif
+            const auto sumXX = sums[0];
+            const auto sumYY = sums[1];
+            const auto sumXY = sums[2];
+            const auto sumXT = sums[3];
+            const auto sumYT = sums[4];
 
             // Get numerator and denominator of u and v
             const auto den = (sumXX*sumYY) - (sumXY * sumXY);
@@ -155,34 +192,59 @@ namespace op
         }
     }
 
-    void getVectors(std::vector<float>& ix, std::vector<float>& iy, std::vector<float>& it,
-                    const std::vector<std::vector<float>>& patch, const std::vector<std::vector<float>>& patchIt,
-                    const int patchSize)
+    inline bool isPatchInFrame(const int x, const int y, const int radix, const cv::Mat& image)
+    {
+        return (x - radix >= 0 && x + radix < image.cols && y - radix >= 0 && y + radix < image.rows);
+    }
+
+    // It fills the contiguous buffers `ix` and `iy` (spatial gradient of I around pointI) and `it` (temporal
+    // difference between the patches of J around pointJ and I around pointI), patchSize x patchSize elements each.
+    // If the patch of I is out of frame, the gradients are 0 (i.e., ZERO_DENOMINATOR). If the one of J is, `it` is 0
+    // (i.e., the point does not move)
+    template <typename T>
+    void getVectors(float* ix, float* iy, float* it, const int xI, const int yI, const int xJ, const int yJ,
+                    const cv::Mat& I, const cv::Mat& J, const int patchSize)
     {
         try
         {
-            // Performance: resize faster than emplace_back/push_back
             const auto numberElements = patchSize*patchSize;
-            // Get `ix` and `iy`
-            ix.resize(numberElements);
-            iy.resize(numberElements);
-            for (auto i = 1; i <= patchSize; i++)
+            const auto radix = patchSize / 2;
+            // Get `ix` and `iy` (the gradient needs 1 extra pixel on each side)
+            if (isPatchInFrame(xI, yI, (patchSize+2)/2, I))
             {
-                const auto baseIndex = (i-1)*patchSize;
-                for (auto j = 1; j <= patchSize; j++)
+                for (auto i = 0; i < patchSize; i++)
                 {
-                    ix[baseIndex+j-1] = (patch[i][j+1] - patch[i][j-1])/2.f;
-                    iy[baseIndex+j-1] = (patch[i+1][j] - patch[i-1][j])/2.f;
+                    const auto* const rowPrevious = I.ptr<T>(yI - radix + i - 1) + xI - radix;
+                    const auto* const row = I.ptr<T>(yI - radix + i) + xI - radix;
+                    const auto* const rowNext = I.ptr<T>(yI - radix + i + 1) + xI - radix;
+                    auto* const ixRow = &ix[i*patchSize];
+                    auto* const iyRow = &iy[i*patchSize];
+                    for (auto j = 0; j < patchSize; j++)
+                    {
+                        ixRow[j] = (float(row[j+1]) - float(row[j-1]))/2.f;
+                        iyRow[j] = (float(rowNext[j]) - float(rowPrevious[j]))/2.f;
+                    }
                 }
             }
+            else
+            {
+                std::fill(ix, ix + numberElements, 0.f);
+                std::fill(iy, iy + numberElements, 0.f);
+            }
             // Get `it`
-            it.resize(numberElements);
-            for (auto i = 0; i < patchSize; i++)
+            if (isPatchInFrame(xI, yI, radix, I) && isPatchInFrame(xJ, yJ, radix, J))
             {
-                const auto baseIndex = i*patchSize;
-                for (auto j = 0; j < patchSize; j++)
-                    it[baseIndex+j] = patchIt[i][j];
+                for (auto i = 0; i < patchSize; i++)
+                {
+                    const auto* const rowI = I.ptr<T>(yI - radix + i) + xI - radix;
+                    const auto* const rowJ = J.ptr<T>(yJ - radix + i) + xJ - radix;
+                    auto* const itRow = &it[i*patchSize];
+                    for (auto j = 0; j < patchSize; j++)
+                        itRow[j] = float(rowJ[j]) - float(rowI[j]);
+                }
             }
+            else
+                std::fill(it, it + numberElements, 0.f);
         }
         catch (const std::exception& e)
         {
@@ -190,64 +252,6 @@ namespace op
         }
     }
 
-    char extractPatch(std::vector< std::vector<float>>& patch, const int x, const int y, const int patchSize,
-                      const cv::Mat& image)
-    {
-        try
-        {
-            int radix = patchSize / 2;
-
-            if ( ((x - radix) < 0) ||
-                 ((x + radix) >= image.cols) ||
-                 ((y - radix) < 0) ||
-                 ((y + radix) >= image.rows))
-                return OUT_OF_FRAME;
-
-            for (auto i = -radix; i <= radix; i++)
-                for (auto j = -radix; j <= radix; j++)
-                    patch[i+radix][j+radix] = image.at<float>(y+i,x+j);
-
-            return SUCCESS;
-        }
-        catch (const std::exception& e)
-        {
-            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
-            return UNDEFINED_ERROR;
-        }
-    }
-
-    char extractPatchIt(std::vector<std::vector<float>>& patch, const int xI, const int yI, const int xJ,
-                        const int yJ, const cv::Mat& I, const cv::Mat& J, const int patchSize)
-    {
-        try
-        {
-            const int radix = patchSize / 2;
-
-            if (((xI - radix) < 0) ||
-                 ((xI + radix) >= I.cols) ||
-                 ((yI - radix) < 0) ||
-                 ((yI + radix) >= I.rows))
-                return OUT_OF_FRAME;
-
-            if (((xJ - radix) < 0) ||
-                 ((xJ + radix) >= J.cols) ||
-                 ((yJ - radix) < 0) ||
-                 ((yJ + radix) >= J.rows))
-                return OUT_OF_FRAME;
-
-            for (auto i = -radix; i <= radix; i++)
-                for (auto j = -radix; j <= radix; j++)
-                    patch[i+radix][j+radix] = J.at<float>(yJ+i,xJ+j) - I.at<float>(yI+i,xI+j);
-
-            return SUCCESS;
-        }
-        catch (const std::exception& e)
-        {
-            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
-            return UNDEFINED_ERROR;
-        }
-    }
-
     // Given an OpenCV image, build a gaussian pyramid of size 'levels'
     void buildGaussianPyramid(std::vector<cv::Mat>& pyramidImages, const cv::Mat& image, const int levels)
     {
@@ -269,48 +273,6 @@ namespace op
         }
     }
 
-    cv::Point2f pyramidIteration(char& status, const cv::Point2f& pointI, const cv::Point2f& pointJ, const cv::Mat& I,
-                                 const cv::Mat& J, const int patchSize = 5)
-    {
-        try
-        {
-            cv::Point2f result;
-
-            // Extract a patch around the image
-            std::vector<std::vector<float>> patch(patchSize + 2, std::vector<float>(patchSize + 2));
-            std::vector<std::vector<float>> patchIt(patchSize, std::vector<float>(patchSize));
-
-            status = extractPatch(patch, (int)pointI.x,(int)pointI.y, patchSize + 2, I);
-            // if (status)
-            //     return result;
-
-            status = extractPatchIt(patchIt, int(pointI.x), int(pointI.y), int(pointJ.x), int(pointJ.y), I, J, patchSize);
-
-            // if (status)
-            //     return result;
-
-            // Get the Ix, Iy and It vectors
-            std::vector<float> ix, iy, it;
-            getVectors(ix, iy, it, patch, patchIt, patchSize);
-
-            // Calculate optical flow
-            cv::Point2f delta;
-            status = computeLK(delta, ix, iy, it);
-
-            // if (status)
-            //     return result;
-
-            result = pointJ + delta;
-
-            return result;
-        }
-        catch (const std::exception& e)
-        {
-            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
-            return cv::Point2f{};
-        }
-    }
-
     void pyramidalLKCpu(std::vector<cv::Point2f>& coordI, std::vector<cv::Point2f>& coordJ,
                         std::vector<cv::Mat>& pyramidImagesPrevious, std::vector<cv::Mat>& pyramidImagesCurrent,
                         std::vector<char>& status, const cv::Mat& imagePrevious,
@@ -322,6 +284,10 @@ namespace op
             if (coordI.size() == 0)
                 return;
 
+            // Sanity check
+            if (status.size() != coordI.size())
+                error("status.size() != coordI.size().", __LINE__, __FUNCTION__, __FILE__);
+
             std::vector<cv::Point2f> I;
             I.assign(coordI.begin(), coordI.end());
 
@@ -337,21 +303,47 @@ namespace op
             if (pyramidImagesCurrent.empty())
                 buildGaussianPyramid(pyramidImagesCurrent, imageCurrent, levels);
 
+            // Sanity checks
+            const auto type = pyramidImagesPrevious[0].type();
+            if (type != CV_8UC1 && type != CV_32FC1)
+                error("Only implemented for 1-channel images (CV_8UC1 or CV_32FC1).", __LINE__, __FUNCTION__, __FILE__);
+            if (pyramidImagesCurrent[0].type() != type)
+                error("Both pyramids must have the same type.", __LINE__, __FUNCTION__, __FILE__);
+            if ((int)pyramidImagesPrevious.size() < levels || (int)pyramidImagesCurrent.size() < levels)
+                error("The pyramids have less than `levels` images.", __LINE__, __FUNCTION__, __FILE__);
 
-            // Process all pixel requests
+            // Patch buffers (ix, iy and it contiguous), reused between points, levels and calls
+            const auto numberElements = patchSize*patchSize;
+            thread_local std::vector<float> tPatchBuffer;
+            tPatchBuffer.resize(3*numberElements);
+            auto* ix = tPatchBuffer.data();
+            auto* iy = ix + numberElements;
+            auto* it = iy + numberElements;
+            const auto lkSums = getLKSumsFunction();
+
+            // Process all pixel requests (all the keypoints of all people at once)
             for (auto i = 0u; i < coordI.size(); i++)
             {
                 for (auto l = levels - 1; l >= 0; l--)
                 {
-                    char status_point = 0;
-                    cv::Point2f result;
-
-                    result = pyramidIteration(status_point, I[i], coordJ[i],pyramidImagesPrevious[l],
-                                              pyramidImagesCurrent[l], patchSize);
-                    if (status_point)
-                        status[i] = status_point;
-
-                    coordJ[i] = result;
+                    if (type == CV_8UC1)
+                        getVectors<unsigned char>(
+                            ix, iy, it, int(I[i].x), int(I[i].y), int(coordJ[i].x), int(coordJ[i].y),
+                            pyramidImagesPrevious[l], pyramidImagesCurrent[l], patchSize);
+                    else
+                        getVectors<float>(
+                            ix, iy, it, int(I[i].x), int(I[i].y), int(coordJ[i].x), int(coordJ[i].y),
+                            pyramidImagesPrevious[l], pyramidImagesCurrent[l], patchSize);
+
+                    // Calculate optical flow
+                    float sums[5];
+                    lkSums(sums, ix, iy, it, numberElements);
+                    cv::Point2f delta;
+                    const auto statusPoint = computeLK(delta, sums);
+                    if (statusPoint)
+                        status[i] = statusPoint;
+
+                    coordJ[i] += delta;
 
                     if (l == 0)
                         break;
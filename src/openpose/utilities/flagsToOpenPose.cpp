@@ -1,6 +1,7 @@
 #include <openpose/utilities/flagsToOpenPose.hpp>
 #include <cstdio> // sscanf
 #include <openpose/utilities/check.hpp>
+#include <openpose/utilities/string.hpp>
 
 namespace op
 {
@@ -161,6 +162,87 @@ namespace op
         }
     }
 
+    BackpressurePolicy flagsToBackpressurePolicy(const int backpressure)
+    {
+        try
+        {
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            if (backpressure >= 0 && backpressure <= (int)BackpressurePolicy::LatencyTarget)
+                return (BackpressurePolicy)backpressure;
+            else
+            {
+                error("Value (" + std::to_string(backpressure) + ") does not correspond with any"
+                      " BackpressurePolicy.", __LINE__, __FUNCTION__, __FILE__);
+                return BackpressurePolicy::Block;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return BackpressurePolicy::Block;
+        }
+    }
+
+    BackpressurePolicy flagsToCaptureBackpressurePolicy(
+        const int captureBackpressure, const ProducerType producerType)
+    {
+        try
+        {
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            // Auto
+            if (captureBackpressure < 0)
+                return (producerType == ProducerType::IPCamera
+                    ? BackpressurePolicy::DropOldest : BackpressurePolicy::Block);
+            // Only lossless or dropping policies
+            else if (captureBackpressure == (int)BackpressurePolicy::LatencyTarget)
+            {
+                error("`--capture_backpressure` cannot be " + std::to_string(captureBackpressure) + ".",
+                      __LINE__, __FUNCTION__, __FILE__);
+                return BackpressurePolicy::Block;
+            }
+            else
+                return flagsToBackpressurePolicy(captureBackpressure);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return BackpressurePolicy::Block;
+        }
+    }
+
+    std::vector<ThreadAffinity> flagsToThreadAffinities(const String& threadCores, const String& threadNumaNodes)
+    {
+        try
+        {
+            opLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            std::vector<ThreadAffinity> threadAffinities;
+            // Cores
+            if (!threadCores.empty())
+            {
+                const auto coreLists = splitString(threadCores.getStdString(), ";");
+                threadAffinities.resize(coreLists.size());
+                for (auto threadId = 0u ; threadId < coreLists.size() ; threadId++)
+                    threadAffinities[threadId].cores = stringToCores(coreLists[threadId]);
+            }
+            // NUMA nodes
+            if (!threadNumaNodes.empty())
+            {
+                const auto numaNodes = splitString(threadNumaNodes.getStdString(), ";");
+                if (threadAffinities.size() < numaNodes.size())
+                    threadAffinities.resize(numaNodes.size());
+                for (auto threadId = 0u ; threadId < numaNodes.size() ; threadId++)
+                    if (!numaNodes[threadId].empty())
+                        threadAffinities[threadId].numaNode = stringToNumaNode(numaNodes[threadId]);
+            }
+            return threadAffinities;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
     ProducerType flagsToProducerType(
         const String& imageDirectory, const String& videoPath, const String& ipCameraPath,
         const int webcamIndex, const bool flirCamera)
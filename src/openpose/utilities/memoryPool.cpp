@@ -0,0 +1,314 @@
+#include <openpose/utilities/memoryPool.hpp>
+#include <atomic>
+#include <cstdint> // std::uintptr_t
+#include <cstdlib> // std::malloc, std::free
+#include <mutex>
+#include <new> // std::bad_alloc
+#include <openpose/utilities/errorAndLog.hpp>
+
+namespace op
+{
+    namespace MemoryPool
+    {
+        // Blocks are aligned to the cache line size (enough for AVX and AVX-512 loads too)
+        const std::size_t ALIGNMENT = 64;
+        // Size classes: powers of 2 from 64 B (2^6) to 256 MB (2^28). Bigger blocks are not cached
+        const int MIN_CLASS = 6;
+        const int MAX_CLASS = 28;
+        const int NUMBER_CLASSES = MAX_CLASS - MIN_CLASS + 1;
+        const int NO_CLASS = -1;
+        // Free blocks kept by each thread for each size class, the rest is moved to the shared free lists
+        const unsigned int MAX_THREAD_BLOCKS = 8;
+        // Maximum bytes kept in the shared free lists, the rest is returned to the system
+        const unsigned long long MAX_SHARED_BYTES = 1ull << 30;
+        // Maximum bytes kept by each thread (over all its size classes), the rest is moved to the shared free lists.
+        // Otherwise, 8 blocks of each big size class could keep hundreds of MB per thread
+        const unsigned long long MAX_THREAD_BYTES = MAX_SHARED_BYTES / 8;
+
+        // Each block is preceded by this header (padded to ALIGNMENT bytes so the data stays aligned). Free blocks
+        // are linked through it, so the pool itself never allocates memory
+        struct BlockHeader
+        {
+            void* mallocPtr;
+            std::size_t bytes;
+            int sizeClass;
+            BlockHeader* next;
+        };
+        static_assert(sizeof(BlockHeader) <= ALIGNMENT, "BlockHeader must fit in the block alignment padding.");
+
+        struct FreeLists
+        {
+            BlockHeader* heads[NUMBER_CLASSES];
+            unsigned int counts[NUMBER_CLASSES];
+            unsigned long long bytes;
+        };
+
+        std::atomic<bool> sEnabled{false};
+        std::atomic<unsigned long long> sAllocations{0};
+        std::atomic<unsigned long long> sDeallocations{0};
+        std::atomic<unsigned long long> sSystemAllocations{0};
+        std::atomic<unsigned long long> sBytesInUse{0};
+        std::atomic<unsigned long long> sBytesCached{0};
+        // Per-frame counters (updated by markFrame())
+        std::atomic<unsigned long long> sFrames{0};
+        std::atomic<unsigned long long> sAllocationsFrameBegin{0};
+        std::atomic<unsigned long long> sSystemAllocationsFrameBegin{0};
+        std::atomic<unsigned long long> sAllocationsLastFrame{0};
+        std::atomic<unsigned long long> sSystemAllocationsLastFrame{0};
+        FreeLists sSharedFreeLists{}; // Zero-initialized, so it is safe to use during static (de)initialization
+
+        // Never destroyed, blocks might be released by threads exiting after the static destructors
+        std::mutex& getSharedMutex()
+        {
+            static auto* sharedMutex = new std::mutex;
+            return *sharedMutex;
+        }
+
+        inline unsigned long long getClassBytes(const int sizeClass)
+        {
+            return 1ull << (sizeClass + MIN_CLASS);
+        }
+
+        inline int getSizeClass(const std::size_t bytes)
+        {
+            auto sizeClass = 0;
+            while (getClassBytes(sizeClass) < bytes)
+                if (++sizeClass == NUMBER_CLASSES)
+                    return NO_CLASS;
+            return sizeClass;
+        }
+
+        inline BlockHeader* getHeader(void* ptr)
+        {
+            return (BlockHeader*)((unsigned char*)ptr - ALIGNMENT);
+        }
+
+        inline void* getData(BlockHeader* blockHeader)
+        {
+            return (unsigned char*)blockHeader + ALIGNMENT;
+        }
+
+        inline BlockHeader* pop(FreeLists& freeLists, const int sizeClass)
+        {
+            auto* blockHeader = freeLists.heads[sizeClass];
+            if (blockHeader != nullptr)
+            {
+                freeLists.heads[sizeClass] = blockHeader->next;
+                freeLists.counts[sizeClass]--;
+                freeLists.bytes -= blockHeader->bytes;
+            }
+            return blockHeader;
+        }
+
+        inline void push(FreeLists& freeLists, BlockHeader* blockHeader)
+        {
+            blockHeader->next = freeLists.heads[blockHeader->sizeClass];
+            freeLists.heads[blockHeader->sizeClass] = blockHeader;
+            freeLists.counts[blockHeader->sizeClass]++;
+            freeLists.bytes += blockHeader->bytes;
+        }
+
+        BlockHeader* systemAllocate(const std::size_t bytes, const int sizeClass)
+        {
+            // Header + data + padding to align the header
+            void* mallocPtr = std::malloc(bytes + 2*ALIGNMENT - 1);
+            if (mallocPtr == nullptr)
+                throw std::bad_alloc{};
+            sSystemAllocations.fetch_add(1, std::memory_order_relaxed);
+            auto* blockHeader = (BlockHeader*)(((std::uintptr_t)mallocPtr + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+            blockHeader->mallocPtr = mallocPtr;
+            blockHeader->bytes = bytes;
+            blockHeader->sizeClass = sizeClass;
+            blockHeader->next = nullptr;
+            return blockHeader;
+        }
+
+        void releaseToShared(BlockHeader* blockHeader)
+        {
+            const auto bytes = blockHeader->bytes;
+            {
+                std::lock_guard<std::mutex> lock{getSharedMutex()};
+                if (sSharedFreeLists.bytes + bytes <= MAX_SHARED_BYTES)
+                {
+                    push(sSharedFreeLists, blockHeader);
+                    return;
+                }
+            }
+            // Shared free lists full
+            sBytesCached.fetch_sub(bytes, std::memory_order_relaxed);
+            std::free(blockHeader->mallocPtr);
+        }
+
+        // Free blocks of each thread. The trivial thread_local state flags whether the cache can still be used while
+        // the thread is exiting (after its destruction, blocks go directly to the shared free lists)
+        thread_local int tThreadCacheState = 0; // 0 = not created yet, 1 = alive, 2 = destroyed
+        struct ThreadCache
+        {
+            FreeLists freeLists{};
+
+            ThreadCache()
+            {
+                tThreadCacheState = 1;
+            }
+
+            ~ThreadCache()
+            {
+                tThreadCacheState = 2;
+                for (auto sizeClass = 0 ; sizeClass < NUMBER_CLASSES ; sizeClass++)
+                    while (auto* blockHeader = pop(freeLists, sizeClass))
+                        releaseToShared(blockHeader);
+            }
+        };
+
+        FreeLists* getThreadFreeLists()
+        {
+            if (tThreadCacheState == 2)
+                return nullptr;
+            thread_local ThreadCache threadCache;
+            return &threadCache.freeLists;
+        }
+
+        bool getEnabled()
+        {
+            return sEnabled;
+        }
+
+        void setEnabled(const bool enabled)
+        {
+            sEnabled = enabled;
+        }
+
+        std::size_t getAlignment()
+        {
+            return ALIGNMENT;
+        }
+
+        void* allocate(const std::size_t bytes)
+        {
+            try
+            {
+                sAllocations.fetch_add(1, std::memory_order_relaxed);
+                const auto sizeClass = getSizeClass(bytes);
+                // Too big to be cached
+                if (sizeClass == NO_CLASS)
+                {
+                    sBytesInUse.fetch_add(bytes, std::memory_order_relaxed);
+                    return getData(systemAllocate(bytes, NO_CLASS));
+                }
+                const auto classBytes = getClassBytes(sizeClass);
+                sBytesInUse.fetch_add(classBytes, std::memory_order_relaxed);
+                // Thread free list
+                auto* threadFreeLists = getThreadFreeLists();
+                BlockHeader* blockHeader = (threadFreeLists != nullptr ? pop(*threadFreeLists, sizeClass) : nullptr);
+                // Shared free list
+                if (blockHeader == nullptr)
+                {
+                    std::lock_guard<std::mutex> lock{getSharedMutex()};
+                    blockHeader = pop(sSharedFreeLists, sizeClass);
+                }
+                // Pool hit or system allocation
+                if (blockHeader != nullptr)
+                    sBytesCached.fetch_sub(classBytes, std::memory_order_relaxed);
+                else
+                    blockHeader = systemAllocate(classBytes, sizeClass);
+                return getData(blockHeader);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return nullptr;
+            }
+        }
+
+        void deallocate(void* ptr)
+        {
+            try
+            {
+                if (ptr == nullptr)
+                    return;
+                sDeallocations.fetch_add(1, std::memory_order_relaxed);
+                auto* blockHeader = getHeader(ptr);
+                // Too big to be cached
+                if (blockHeader->sizeClass == NO_CLASS)
+                {
+                    sBytesInUse.fetch_sub(blockHeader->bytes, std::memory_order_relaxed);
+                    std::free(blockHeader->mallocPtr);
+                    return;
+                }
+                const auto classBytes = blockHeader->bytes;
+                sBytesInUse.fetch_sub(classBytes, std::memory_order_relaxed);
+                sBytesCached.fetch_add(classBytes, std::memory_order_relaxed);
+                // Thread free list (if it has room for it) or shared one
+                auto* threadFreeLists = getThreadFreeLists();
+                if (threadFreeLists != nullptr && threadFreeLists->counts[blockHeader->sizeClass] < MAX_THREAD_BLOCKS
+                    && threadFreeLists->bytes + classBytes <= MAX_THREAD_BYTES)
+                    push(*threadFreeLists, blockHeader);
+                else
+                    releaseToShared(blockHeader);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        void releaseCachedMemory()
+        {
+            try
+            {
+                // Free lists of this thread
+                auto* threadFreeLists = getThreadFreeLists();
+                if (threadFreeLists != nullptr)
+                    for (auto sizeClass = 0 ; sizeClass < NUMBER_CLASSES ; sizeClass++)
+                        while (auto* blockHeader = pop(*threadFreeLists, sizeClass))
+                        {
+                            sBytesCached.fetch_sub(getClassBytes(sizeClass), std::memory_order_relaxed);
+                            std::free(blockHeader->mallocPtr);
+                        }
+                // Shared free lists
+                std::lock_guard<std::mutex> lock{getSharedMutex()};
+                for (auto sizeClass = 0 ; sizeClass < NUMBER_CLASSES ; sizeClass++)
+                    while (auto* blockHeader = pop(sSharedFreeLists, sizeClass))
+                    {
+                        sBytesCached.fetch_sub(getClassBytes(sizeClass), std::memory_order_relaxed);
+                        std::free(blockHeader->mallocPtr);
+                    }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        void markFrame()
+        {
+            const auto allocations = sAllocations.load(std::memory_order_relaxed);
+            const auto systemAllocations = sSystemAllocations.load(std::memory_order_relaxed);
+            sAllocationsLastFrame = allocations - sAllocationsFrameBegin.exchange(allocations);
+            sSystemAllocationsLastFrame = systemAllocations - sSystemAllocationsFrameBegin.exchange(systemAllocations);
+            sFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        MemoryPoolStats getStats()
+        {
+            return MemoryPoolStats{
+                sAllocations.load(std::memory_order_relaxed), sDeallocations.load(std::memory_order_relaxed),
+                sSystemAllocations.load(std::memory_order_relaxed), sBytesInUse.load(std::memory_order_relaxed),
+                sBytesCached.load(std::memory_order_relaxed), sFrames.load(std::memory_order_relaxed),
+                sAllocationsLastFrame.load(std::memory_order_relaxed),
+                sSystemAllocationsLastFrame.load(std::memory_order_relaxed)};
+        }
+
+        void resetStats()
+        {
+            sAllocations = 0;
+            sDeallocations = 0;
+            sSystemAllocations = 0;
+            sFrames = 0;
+            sAllocationsFrameBegin = 0;
+            sSystemAllocationsFrameBegin = 0;
+            sAllocationsLastFrame = 0;
+            sSystemAllocationsLastFrame = 0;
+        }
+    }
+}
@@ -54,6 +54,31 @@ namespace op
         }
     }
 
+    #ifdef OP_SIMD_X86
+        // VGG normalization (x/256 - 0.5). They return the first pixel not processed
+        OP_TARGET_AVX2 int normalizeVggAvx2(float* floatPtrImage, const int volume)
+        {
+            const __m256 mmRatio = _mm256_set1_ps(1.f/256.f);
+            const __m256 mmBias = _mm256_set1_ps(-0.5f);
+            auto pixel = 0;
+            for (; pixel < volume-7 ; pixel += 8)
+                _mm256_storeu_ps(
+                    &floatPtrImage[pixel], _mm256_fmadd_ps(_mm256_loadu_ps(&floatPtrImage[pixel]), mmRatio, mmBias));
+            return pixel;
+        }
+
+        OP_TARGET_AVX512 int normalizeVggAvx512(float* floatPtrImage, const int volume)
+        {
+            const __m512 mmRatio = _mm512_set1_ps(1.f/256.f);
+            const __m512 mmBias = _mm512_set1_ps(-0.5f);
+            auto pixel = 0;
+            for (; pixel < volume-15 ; pixel += 16)
+                _mm512_storeu_ps(
+                    &floatPtrImage[pixel], _mm512_fmadd_ps(_mm512_loadu_ps(&floatPtrImage[pixel]), mmRatio, mmBias));
+            return pixel;
+        }
+    #endif
+
     void uCharCvMatToFloatPtr(float* floatPtrImage, const Matrix& matImage, const int normalize)
     {
         try
@@ -82,68 +107,33 @@ namespace op
             // VGG
             if (normalize == 1)
             {
-                #ifdef WITH_AVX
-                    // // To check results are the same (norm(x1-x2) = 0)
-                    // cv::Mat floatPtrImageCvWrapper(height, width, CV_32FC3, floatPtrImage);
-                    // cv::Mat floatPtrImageCvWrapperTest = floatPtrImageCvWrapper*(1/256.f) - 0.5f;
-                    // // Speed profiling
-                    // const auto REPS = 2000;
-                    // double timeNormalize0 = 0.;
-                    // double timeNormalize1 = 0.;
-                    // double timeNormalize2 = 0.;
-                    // double timeNormalize3 = 0.;
-                    // // OpenCV wrapper
-                    // OP_PROFILE_INIT(REPS);
-                    // cv::Mat floatPtrImageCvWrapper(height, width, CV_32FC3, floatPtrImage);
-                    // floatPtrImageCvWrapper = floatPtrImageCvWrapper*(1/256.f) - 0.5f;
-                    // OP_PROFILE_END(timeNormalize0, 1e6, REPS);
-                    // // C++ sequential code
-                    // OP_PROFILE_INIT(REPS);
-                    // const auto ratio = 1.f/256.f;
-                    // for (auto pixel = 0 ; pixel < width*height*channels ; ++pixel)
-                    //     floatPtrImage[pixel] = floatPtrImage[pixel]*ratio - 0.5f;
-                    // OP_PROFILE_END(timeNormalize1, 1e6, REPS);
-                    // // OpenCV wrapper
-                    // OP_PROFILE_INIT(REPS);
-                    // cv::Mat floatPtrImageCvWrapper(height, width, CV_32FC3, floatPtrImage);
-                    // floatPtrImageCvWrapper = floatPtrImageCvWrapper*(1/256.f) - 0.5f;
-                    // OP_PROFILE_END(timeNormalize2, 1e6, REPS);
-                    // OP_PROFILE_INIT(REPS);
-                    // AVX code
-                    const auto volume = width*height*channels;
-                    int pixel;
-                    const __m256 mmRatio = _mm256_set1_ps(1.f/256.f);
-                    const __m256 mmBias = _mm256_set1_ps(-0.5f);
-                    for (pixel = 0 ; pixel < volume-7 ; pixel += 8)
-                    {
-                        const __m256 input = _mm256_load_ps(&floatPtrImage[pixel]);
-                        // const __m256 input = _mm256_loadu_ps(&floatPtrImage[pixel]); // If non-aligned pointer
-                        const __m256 output = _mm256_fmadd_ps(input, mmRatio, mmBias);
-                        _mm256_store_ps(&floatPtrImage[pixel], output);
-                        // _mm256_storeu_ps(&floatPtrImage[pixel], output); // If non-aligned pointer
-                    }
-                    const auto ratio = 1.f/256.f;
-                    for (; pixel < volume ; ++pixel)
-                        floatPtrImage[pixel] = floatPtrImage[pixel]*ratio - 0.5f;
-                    // OP_PROFILE_END(timeNormalize3, 1e6, REPS);
-                    // std::cout
-                    //     << "TN1: " << timeNormalize0 << " us\n"
-                    //     << "TN1: " << timeNormalize1 << " us\n"
-                    //     << "TN2: " << timeNormalize2 << " us\n"
-                    //     << "TN3: " << timeNormalize3 << " us\n"
-                    //     << std::endl;
-                    // std::cout
-                    //     << "Norm: " << cv::norm(floatPtrImageCvWrapper-floatPtrImageCvWrapperTest) << "\n"
-                    //     << std::endl;
+                // SIMD code (unaligned loads, the pointer might come from an Array<float> wrapping external memory)
+                const auto volume = width*height*channels;
+                auto pixel = 0;
+                #ifdef OP_SIMD_X86
+                    const auto simdLevel = getSimdLevel();
+                    if (simdLevel >= SimdLevel::Avx512)
+                        pixel = normalizeVggAvx512(floatPtrImage, volume);
+                    else if (simdLevel >= SimdLevel::Avx2)
+                        pixel = normalizeVggAvx2(floatPtrImage, volume);
+                #endif
                 // Non optimized code
-                #else
+                if (pixel == 0)
+                {
                     // floatPtrImage wrapped as cv::Mat
                         // Empirically tested - OpenCV is more efficient normalizing a whole matrix/image (it uses AVX and
                         // other optimized instruction sets).
                         // In addition, the following if statement does not copy the pointer to a cv::Mat, just wraps it.
-                    cv::Mat floatPtrImageCvWrapper(height*width*3, 1, CV_32FC1, floatPtrImage); // CV_32FC3 warns about https://github.com/opencv/opencv/issues/16739
+                    cv::Mat floatPtrImageCvWrapper(volume, 1, CV_32FC1, floatPtrImage); // CV_32FC3 warns about https://github.com/opencv/opencv/issues/16739
                     floatPtrImageCvWrapper = floatPtrImageCvWrapper*(1/256.f) - 0.5f;
-                #endif
+                }
+                // Remaining pixels
+                else
+                {
+                    const auto ratio = 1.f/256.f;
+                    for (; pixel < volume ; ++pixel)
+                        floatPtrImage[pixel] = floatPtrImage[pixel]*ratio - 0.5f;
+                }
             }
             // // ResNet
             // else if (normalize == 2)
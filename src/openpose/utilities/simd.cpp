@@ -0,0 +1,100 @@
+#include <openpose/utilities/simd.hpp>
+#include <atomic>
+#include <openpose/utilities/errorAndLog.hpp>
+#include <openpose_private/utilities/avx.hpp>
+#if defined(OP_SIMD_X86) && defined(_MSC_VER)
+    #include <intrin.h> // __cpuid, __cpuidex, _xgetbv
+#endif
+
+namespace op
+{
+    std::atomic<SimdLevel> sMaxSimdLevel{SimdLevel::Avx512};
+
+    SimdLevel detectCpuSimdLevel()
+    {
+        #ifdef OP_SIMD_X86
+            #if defined(__GNUC__) || defined(__clang__)
+                // It also checks that the OS saves the AVX/AVX-512 registers
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+                    return SimdLevel::Avx512;
+                if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                    return SimdLevel::Avx2;
+                if (__builtin_cpu_supports("sse4.1"))
+                    return SimdLevel::Sse4;
+            #elif defined(_MSC_VER)
+                int info[4];
+                __cpuid(info, 0);
+                const auto maxId = info[0];
+                __cpuid(info, 1);
+                const auto sse4 = (info[2] & (1 << 19)) != 0;
+                const auto fma = (info[2] & (1 << 12)) != 0;
+                const auto osxsave = (info[2] & (1 << 27)) != 0;
+                // Registers saved by the OS: XMM + YMM (AVX), plus opmask + ZMM (AVX-512)
+                const auto xcr0 = (osxsave ? _xgetbv(0) : 0ull);
+                const auto osAvx = (xcr0 & 0x06) == 0x06;
+                const auto osAvx512 = (xcr0 & 0xe6) == 0xe6;
+                auto avx2 = false;
+                auto avx512 = false;
+                if (maxId >= 7)
+                {
+                    __cpuidex(info, 7, 0);
+                    avx2 = (info[1] & (1 << 5)) != 0;
+                    avx512 = (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0; // F + BW
+                }
+                if (avx512 && avx2 && fma && osAvx512)
+                    return SimdLevel::Avx512;
+                if (avx2 && fma && osAvx)
+                    return SimdLevel::Avx2;
+                if (sse4)
+                    return SimdLevel::Sse4;
+            #endif
+        #endif
+        return SimdLevel::None;
+    }
+
+    SimdLevel getCpuSimdLevel()
+    {
+        try
+        {
+            static const auto sCpuSimdLevel = detectCpuSimdLevel();
+            return sCpuSimdLevel;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return SimdLevel::None;
+        }
+    }
+
+    SimdLevel getSimdLevel()
+    {
+        const auto cpuSimdLevel = getCpuSimdLevel();
+        const auto maxSimdLevel = sMaxSimdLevel.load(std::memory_order_relaxed);
+        return (cpuSimdLevel < maxSimdLevel ? cpuSimdLevel : maxSimdLevel);
+    }
+
+    void setMaxSimdLevel(const SimdLevel simdLevel)
+    {
+        sMaxSimdLevel = simdLevel;
+    }
+
+    std::string simdLevelToString(const SimdLevel simdLevel)
+    {
+        try
+        {
+            if (simdLevel == SimdLevel::Avx512)
+                return "AVX-512";
+            else if (simdLevel == SimdLevel::Avx2)
+                return "AVX2";
+            else if (simdLevel == SimdLevel::Sse4)
+                return "SSE4.1";
+            return "None";
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return "";
+        }
+    }
+}
@@ -0,0 +1,363 @@
+#include <openpose/utilities/threadPool.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception> // std::exception_ptr
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+    #include <pthread.h> // pthread_setaffinity_np
+#endif
+#include <openpose/utilities/errorAndLog.hpp>
+#include <openpose/utilities/fastMath.hpp>
+#include <openpose/utilities/tracer.hpp>
+
+namespace op
+{
+    namespace ThreadPool
+    {
+        struct TaskDeque
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        class Pool
+        {
+        public:
+            Pool(const int numberThreads, const bool pinThreads) :
+                mRunning{true},
+                mPendingTasks{0ll},
+                mNextDeque{0u}
+            {
+                try
+                {
+                    for (auto i = 0 ; i < numberThreads ; i++)
+                        mTaskDeques.emplace_back(new TaskDeque);
+                    for (auto i = 0 ; i < numberThreads ; i++)
+                        mThreads.emplace_back(&Pool::threadFunction, this, i, pinThreads);
+                }
+                catch (const std::exception& e)
+                {
+                    error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                }
+            }
+
+            ~Pool()
+            {
+                try
+                {
+                    {
+                        const std::lock_guard<std::mutex> lock{mSleepMutex};
+                        mRunning = false;
+                    }
+                    mConditionVariable.notify_all();
+                    for (auto& thread : mThreads)
+                        if (thread.joinable())
+                            thread.join();
+                }
+                catch (const std::exception& e)
+                {
+                    errorDestructor(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                }
+            }
+
+            int getNumberThreads() const
+            {
+                return (int)mThreads.size();
+            }
+
+            // The task is copied numberCopies times. Pool threads push into their own deque (so nested loops stay
+            // local), any other thread distributes them round-robin
+            void submit(const std::function<void()>& task, const int numberCopies)
+            {
+                const auto numberDeques = (unsigned int)mTaskDeques.size();
+                for (auto i = 0 ; i < numberCopies ; i++)
+                {
+                    const auto index = (sPool == this ? (unsigned int)sThreadIndex : mNextDeque++ % numberDeques);
+                    auto& taskDeque = *mTaskDeques[index];
+                    const std::lock_guard<std::mutex> lock{taskDeque.mutex};
+                    taskDeque.tasks.emplace_back(task);
+                }
+                {
+                    const std::lock_guard<std::mutex> lock{mSleepMutex};
+                    mPendingTasks += numberCopies;
+                }
+                mConditionVariable.notify_all();
+            }
+
+            // It runs 1 pending task (if any), used by the threads waiting for their loops to finish
+            bool runPendingTask()
+            {
+                std::function<void()> task;
+                if (!popTask((sPool == this ? sThreadIndex : 0), task))
+                    return false;
+                task();
+                return true;
+            }
+
+        private:
+            // Current thread (if it belongs to a Pool)
+            static thread_local Pool* sPool;
+            static thread_local int sThreadIndex;
+
+            std::vector<std::unique_ptr<TaskDeque>> mTaskDeques;
+            std::vector<std::thread> mThreads;
+            bool mRunning;
+            std::atomic<long long> mPendingTasks;
+            std::atomic<unsigned int> mNextDeque;
+            std::mutex mSleepMutex;
+            std::condition_variable mConditionVariable;
+
+            // Own deque from the back (LIFO, hot in cache), then steal from the front of the others (FIFO, the
+            // oldest and usually biggest ones), from the nearest index to the furthest
+            bool popTask(const int index, std::function<void()>& task)
+            {
+                const auto numberDeques = (int)mTaskDeques.size();
+                for (auto distance = 0 ; distance < numberDeques ; distance++)
+                {
+                    const auto offset = (distance % 2 == 1 ? (distance+1)/2 : -distance/2);
+                    auto& taskDeque = *mTaskDeques[((index + offset) % numberDeques + numberDeques) % numberDeques];
+                    const std::lock_guard<std::mutex> lock{taskDeque.mutex};
+                    if (!taskDeque.tasks.empty())
+                    {
+                        if (distance == 0)
+                        {
+                            task = std::move(taskDeque.tasks.back());
+                            taskDeque.tasks.pop_back();
+                        }
+                        else
+                        {
+                            task = std::move(taskDeque.tasks.front());
+                            taskDeque.tasks.pop_front();
+                        }
+                        mPendingTasks--;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void threadFunction(const int index, const bool pinThreads)
+            {
+                try
+                {
+                    sPool = this;
+                    sThreadIndex = index;
+                    Tracer::setThreadName("ThreadPool " + std::to_string(index));
+                    #ifdef __linux__
+                        if (pinThreads)
+                        {
+                            const auto numberCores = fastMax(1u, std::thread::hardware_concurrency());
+                            cpu_set_t cpuSet;
+                            CPU_ZERO(&cpuSet);
+                            CPU_SET((index+1) % numberCores, &cpuSet);
+                            if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) != 0)
+                                opLog("ThreadPool: Could not pin thread " + std::to_string(index) + ".",
+                                      Priority::High);
+                        }
+                    #else
+                        UNUSED(pinThreads);
+                    #endif
+                    while (true)
+                    {
+                        std::function<void()> task;
+                        if (popTask(index, task))
+                        {
+                            task();
+                            continue;
+                        }
+                        std::unique_lock<std::mutex> lock{mSleepMutex};
+                        mConditionVariable.wait(lock, [this]{ return !mRunning || mPendingTasks > 0; });
+                        if (!mRunning && mPendingTasks == 0)
+                            break;
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    errorWorker(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                }
+            }
+        };
+
+        thread_local Pool* Pool::sPool = nullptr;
+        thread_local int Pool::sThreadIndex = -1;
+
+        // Chunks of 1 parallelFor() call. The pool tasks only keep a pointer to it, so they can safely finish after
+        // the call returns (they will not find any chunk left)
+        struct Loop
+        {
+            std::atomic<long long> nextChunk;
+            std::atomic<long long> chunksDone;
+            std::mutex exceptionMutex;
+            std::exception_ptr exceptionPtr;
+            // Notified when the last chunk is done
+            std::mutex doneMutex;
+            std::condition_variable doneConditionVariable;
+        };
+
+        std::atomic<bool> sEnabled{true};
+        std::mutex sPoolMutex;
+        int sNumberThreads = -1;
+        bool sPinThreads = false;
+        std::shared_ptr<Pool> spPool;
+
+        int getResolvedNumberThreads()
+        {
+            return (sNumberThreads >= 0
+                ? sNumberThreads : fastMax(0, (int)std::thread::hardware_concurrency() - 1));
+        }
+
+        std::shared_ptr<Pool> getPool()
+        {
+            const std::lock_guard<std::mutex> lock{sPoolMutex};
+            if (spPool == nullptr)
+                spPool = std::make_shared<Pool>(getResolvedNumberThreads(), sPinThreads);
+            return spPool;
+        }
+
+        bool getEnabled()
+        {
+            return sEnabled;
+        }
+
+        void setEnabled(const bool enabled)
+        {
+            sEnabled = enabled;
+        }
+
+        int getNumberThreads()
+        {
+            try
+            {
+                const std::lock_guard<std::mutex> lock{sPoolMutex};
+                return getResolvedNumberThreads();
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return 0;
+            }
+        }
+
+        void setNumberThreads(const int numberThreads)
+        {
+            try
+            {
+                std::shared_ptr<Pool> spPoolOld;
+                {
+                    const std::lock_guard<std::mutex> lock{sPoolMutex};
+                    sNumberThreads = numberThreads;
+                    std::swap(spPoolOld, spPool);
+                }
+                // Its threads are joined once its last parallelFor() (if any) finishes
+                spPoolOld.reset();
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        bool getPinThreads()
+        {
+            try
+            {
+                const std::lock_guard<std::mutex> lock{sPoolMutex};
+                return sPinThreads;
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return false;
+            }
+        }
+
+        void setPinThreads(const bool pinThreads)
+        {
+            try
+            {
+                std::shared_ptr<Pool> spPoolOld;
+                {
+                    const std::lock_guard<std::mutex> lock{sPoolMutex};
+                    sPinThreads = pinThreads;
+                    std::swap(spPoolOld, spPool);
+                }
+                spPoolOld.reset();
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        void parallelFor(
+            const int begin, const int end, const std::function<void(const int, const int)>& function,
+            const int grainSize)
+        {
+            try
+            {
+                if (end <= begin)
+                    return;
+                const auto grain = (long long)fastMax(1, grainSize);
+                const auto numberChunks = ((long long)end - begin + grain - 1) / grain;
+                // Serial
+                const auto spPoolCurrent = (numberChunks > 1 && sEnabled ? getPool() : nullptr);
+                if (spPoolCurrent == nullptr || spPoolCurrent->getNumberThreads() == 0)
+                {
+                    function(begin, end);
+                    return;
+                }
+                // Parallel: The calling thread and up to (numberChunks-1) pool threads take chunks until none is left
+                const auto spLoop = std::make_shared<Loop>();
+                spLoop->nextChunk = 0ll;
+                spLoop->chunksDone = 0ll;
+                const auto* const functionPtr = &function;
+                const std::function<void()> runChunks = [spLoop, functionPtr, begin, end, grain, numberChunks]()
+                {
+                    OP_TRACE_SCOPE("ThreadPool::parallelFor");
+                    for (auto chunk = spLoop->nextChunk++ ; chunk < numberChunks ; chunk = spLoop->nextChunk++)
+                    {
+                        const auto chunkBegin = (int)(begin + chunk*grain);
+                        try
+                        {
+                            (*functionPtr)(chunkBegin, (int)fastMin((long long)end, chunkBegin + grain));
+                        }
+                        catch (...)
+                        {
+                            const std::lock_guard<std::mutex> lock{spLoop->exceptionMutex};
+                            if (!spLoop->exceptionPtr)
+                                spLoop->exceptionPtr = std::current_exception();
+                        }
+                        if (++spLoop->chunksDone == numberChunks)
+                        {
+                            const std::lock_guard<std::mutex> lock{spLoop->doneMutex};
+                            spLoop->doneConditionVariable.notify_all();
+                        }
+                    }
+                };
+                spPoolCurrent->submit(
+                    runChunks, (int)fastMin(numberChunks-1, (long long)spPoolCurrent->getNumberThreads()));
+                runChunks();
+                // Chunks still being processed by other threads: help with other pending tasks meanwhile, and sleep
+                // once there are none left. The remaining chunks are already running, so they do not need this thread
+                while (spLoop->chunksDone < numberChunks && spPoolCurrent->runPendingTask())
+                    ;
+                if (spLoop->chunksDone < numberChunks)
+                {
+                    std::unique_lock<std::mutex> lock{spLoop->doneMutex};
+                    spLoop->doneConditionVariable.wait(
+                        lock, [&spLoop, numberChunks]{ return spLoop->chunksDone == numberChunks; });
+                }
+                if (spLoop->exceptionPtr)
+                    std::rethrow_exception(spLoop->exceptionPtr);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+    }
+}
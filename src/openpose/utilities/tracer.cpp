@@ -0,0 +1,345 @@
+#include <openpose/utilities/tracer.hpp>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define OP_TRACER_USE_TSC
+    #ifdef _MSC_VER
+        #include <intrin.h> // __rdtsc
+    #else
+        #include <x86intrin.h> // __rdtsc
+    #endif
+#endif
+#include <openpose/utilities/errorAndLog.hpp>
+
+namespace op
+{
+    namespace Tracer
+    {
+        // Relaxed atomics (plain stores on x86), so saveChromeTrace() can read them while they are being written
+        struct Event
+        {
+            std::atomic<unsigned int> probeId;
+            std::atomic<unsigned long long> frameId;
+            std::atomic<unsigned long long> beginTicks;
+            std::atomic<unsigned long long> endTicks;
+        };
+
+        // Single-producer ring buffer. Event i is stored in events[i % capacity]:
+        // - The owner thread increments writing before overwriting an event and written after it.
+        // - A reader copies the events in [written - capacity, written) and then keeps the ones not overwritten
+        //   meanwhile (i.e., i >= writing - capacity).
+        struct ThreadBuffer
+        {
+            std::unique_ptr<Event[]> events;
+            unsigned long long capacity;
+            std::atomic<unsigned long long> writing;
+            std::atomic<unsigned long long> written;
+            std::atomic<unsigned long long> cleared;
+            std::string threadName; // Protected by sRegistryMutex
+        };
+
+        struct Probe
+        {
+            std::string name;
+            std::string category;
+        };
+
+        std::atomic<bool> sEnabled{false};
+        std::atomic<unsigned int> sBufferSize{65536u};
+        std::mutex sRegistryMutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> sThreadBuffers;
+        std::vector<Probe> sProbes;
+        std::map<std::pair<std::string, std::string>, unsigned int> sProbeIds;
+        // Owned by sThreadBuffers, so its events can still be saved after the thread finishes
+        thread_local ThreadBuffer* spThreadBuffer = nullptr;
+        thread_local std::string sThreadName;
+
+        unsigned long long getSteadyNs()
+        {
+            return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // Reference point to convert now() ticks into nanoseconds
+        const unsigned long long sOriginTicks = now();
+        const unsigned long long sOriginNs = getSteadyNs();
+
+        unsigned int roundUpToPowerOf2(const unsigned int value)
+        {
+            auto powerOf2 = 1u;
+            while (powerOf2 < value && powerOf2 < (1u << 31))
+                powerOf2 <<= 1;
+            return powerOf2;
+        }
+
+        ThreadBuffer& getThreadBuffer()
+        {
+            if (spThreadBuffer == nullptr)
+            {
+                auto threadBuffer = std::make_shared<ThreadBuffer>();
+                threadBuffer->capacity = roundUpToPowerOf2(sBufferSize);
+                threadBuffer->events.reset(new Event[threadBuffer->capacity]);
+                threadBuffer->writing = 0ull;
+                threadBuffer->written = 0ull;
+                threadBuffer->cleared = 0ull;
+                const std::lock_guard<std::mutex> lock{sRegistryMutex};
+                sThreadBuffers.emplace_back(threadBuffer);
+                threadBuffer->threadName = (sThreadName.empty()
+                    ? "Thread " + std::to_string(sThreadBuffers.size()) : sThreadName);
+                spThreadBuffer = threadBuffer.get();
+            }
+            return *spThreadBuffer;
+        }
+
+        std::string escapeJson(const std::string& text)
+        {
+            std::string escapedText;
+            for (const auto character : text)
+            {
+                if (character == '"' || character == '\\')
+                    escapedText += '\\';
+                if ((unsigned char)character >= 0x20)
+                    escapedText += character;
+            }
+            return escapedText;
+        }
+
+        bool getEnabled()
+        {
+            return sEnabled.load(std::memory_order_relaxed);
+        }
+
+        void setEnabled(const bool enabled)
+        {
+            sEnabled = enabled;
+        }
+
+        unsigned int getBufferSize()
+        {
+            return roundUpToPowerOf2(sBufferSize);
+        }
+
+        void setBufferSize(const unsigned int bufferSize)
+        {
+            sBufferSize = (bufferSize > 0u ? bufferSize : 1u);
+        }
+
+        unsigned int registerProbe(const std::string& name, const std::string& category)
+        {
+            try
+            {
+                const std::lock_guard<std::mutex> lock{sRegistryMutex};
+                const auto key = std::make_pair(name, category);
+                const auto probeIdIterator = sProbeIds.find(key);
+                if (probeIdIterator != sProbeIds.end())
+                    return probeIdIterator->second;
+                const auto probeId = (unsigned int)sProbes.size();
+                sProbes.emplace_back(Probe{name, category});
+                sProbeIds.emplace(key, probeId);
+                return probeId;
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return 0u;
+            }
+        }
+
+        unsigned long long now()
+        {
+            // The invariant TSC is about twice faster to read than steady_clock, which dominates the probe cost
+            #ifdef OP_TRACER_USE_TSC
+                return (unsigned long long)__rdtsc();
+            #else
+                return getSteadyNs();
+            #endif
+        }
+
+        double getNsPerTick()
+        {
+            #ifdef OP_TRACER_USE_TSC
+                // Calibrated against steady_clock since the program started
+                const auto ticks = now();
+                const auto ns = getSteadyNs();
+                return (ticks > sOriginTicks && ns > sOriginNs ? double(ns - sOriginNs) / (ticks - sOriginTicks) : 1.);
+            #else
+                return 1.;
+            #endif
+        }
+
+        void record(
+            const unsigned int probeId, const unsigned long long beginTicks, const unsigned long long endTicks,
+            const unsigned long long frameId)
+        {
+            try
+            {
+                auto& threadBuffer = getThreadBuffer();
+                const auto index = threadBuffer.written.load(std::memory_order_relaxed);
+                threadBuffer.writing.store(index+1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                auto& event = threadBuffer.events[index & (threadBuffer.capacity-1)];
+                event.probeId.store(probeId, std::memory_order_relaxed);
+                event.frameId.store(frameId, std::memory_order_relaxed);
+                event.beginTicks.store(beginTicks, std::memory_order_relaxed);
+                event.endTicks.store(endTicks, std::memory_order_relaxed);
+                threadBuffer.written.store(index+1, std::memory_order_release);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        void setThreadName(const std::string& threadName)
+        {
+            try
+            {
+                // The buffer is not allocated until the thread records its first event
+                sThreadName = threadName;
+                if (spThreadBuffer != nullptr)
+                {
+                    const std::lock_guard<std::mutex> lock{sRegistryMutex};
+                    spThreadBuffer->threadName = threadName;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        void clear()
+        {
+            try
+            {
+                const std::lock_guard<std::mutex> lock{sRegistryMutex};
+                for (auto& threadBuffer : sThreadBuffers)
+                    threadBuffer->cleared = threadBuffer->written.load(std::memory_order_acquire);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        void saveChromeTrace(const std::string& filePath)
+        {
+            try
+            {
+                // Copy of the registry
+                std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+                std::vector<std::string> threadNames;
+                std::vector<Probe> probes;
+                {
+                    const std::lock_guard<std::mutex> lock{sRegistryMutex};
+                    threadBuffers = sThreadBuffers;
+                    for (const auto& threadBuffer : threadBuffers)
+                        threadNames.emplace_back(threadBuffer->threadName);
+                    probes = sProbes;
+                }
+                // Copy of the events of each thread
+                struct EventCopy
+                {
+                    unsigned int probeId;
+                    unsigned long long frameId;
+                    unsigned long long beginTicks;
+                    unsigned long long endTicks;
+                };
+                std::vector<std::vector<EventCopy>> threadEvents(threadBuffers.size());
+                auto originTicks = ~0ull;
+                for (auto thread = 0u ; thread < threadBuffers.size() ; thread++)
+                {
+                    auto& threadBuffer = *threadBuffers[thread];
+                    const auto written = threadBuffer.written.load(std::memory_order_acquire);
+                    const auto capacity = threadBuffer.capacity;
+                    auto first = (written > capacity ? written - capacity : 0ull);
+                    first = (first > threadBuffer.cleared ? first : threadBuffer.cleared.load());
+                    std::vector<EventCopy> events;
+                    events.reserve(written - first);
+                    for (auto index = first ; index < written ; index++)
+                    {
+                        const auto& event = threadBuffer.events[index & (capacity-1)];
+                        events.emplace_back(EventCopy{
+                            event.probeId.load(std::memory_order_relaxed),
+                            event.frameId.load(std::memory_order_relaxed),
+                            event.beginTicks.load(std::memory_order_relaxed),
+                            event.endTicks.load(std::memory_order_relaxed)});
+                    }
+                    // Discard the events overwritten while copying them
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    const auto writing = threadBuffer.writing.load(std::memory_order_relaxed);
+                    const auto firstValid = (writing > capacity ? writing - capacity : 0ull);
+                    if (firstValid > first)
+                        events.erase(events.begin(), events.begin() + (std::ptrdiff_t)(
+                            firstValid - first < events.size() ? firstValid - first : events.size()));
+                    for (const auto& event : events)
+                        originTicks = (event.beginTicks < originTicks ? event.beginTicks : originTicks);
+                    threadEvents[thread] = std::move(events);
+                }
+                // Chrome trace-event format (timestamps in microseconds)
+                const auto usPerTick = 1e-3*getNsPerTick();
+                std::ostringstream json;
+                json.setf(std::ios::fixed);
+                json.precision(3);
+                json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+                auto firstEvent = true;
+                for (auto thread = 0u ; thread < threadEvents.size() ; thread++)
+                {
+                    json << (firstEvent ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+                         << thread+1 << ",\"args\":{\"name\":\"" << escapeJson(threadNames[thread]) << "\"}}";
+                    firstEvent = false;
+                    for (const auto& event : threadEvents[thread])
+                    {
+                        if (event.probeId >= probes.size())
+                            continue;
+                        const auto& probe = probes[event.probeId];
+                        json << ",\n{\"name\":\"" << escapeJson(probe.name) << "\"";
+                        if (!probe.category.empty())
+                            json << ",\"cat\":\"" << escapeJson(probe.category) << "\"";
+                        json << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread+1
+                             << ",\"ts\":" << usPerTick*double(event.beginTicks - originTicks)
+                             << ",\"dur\":" << usPerTick*double(event.endTicks - event.beginTicks);
+                        if (event.frameId != NO_FRAME)
+                            json << ",\"args\":{\"frame\":" << event.frameId << "}";
+                        json << "}";
+                    }
+                }
+                json << "\n]}\n";
+                std::ofstream file{filePath};
+                file << json.str();
+                if (!file)
+                    error("Could not write the trace file " + filePath + ".", __LINE__, __FUNCTION__, __FILE__);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+    }
+
+    TraceScope::TraceScope(const unsigned int probeId, const unsigned long long frameId) :
+        mProbeId{probeId},
+        mFrameId{frameId},
+        mBeginTicks{Tracer::getEnabled() ? Tracer::now() : 0ull}
+    {
+    }
+
+    TraceScope::~TraceScope()
+    {
+        try
+        {
+            if (mBeginTicks != 0ull)
+                Tracer::record(mProbeId, mBeginTicks, Tracer::now(), mFrameId);
+        }
+        catch (const std::exception& e)
+        {
+            errorDestructor(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+}
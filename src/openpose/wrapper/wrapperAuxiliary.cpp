@@ -149,6 +149,10 @@ namespace op
                 if (wrapperStructPose.gpuNumber > 0)
                     error("GPU number must be negative or 0 if CPU_ONLY is enabled.",
                           __LINE__, __FUNCTION__, __FILE__);
+            // If GPU mode, CPU workers are not used
+            if (getGpuMode() != GpuMode::NoGpu && wrapperStructPose.cpuWorkerNumber > 1)
+                opLog("The number of CPU workers (`--num_cpu_workers`) only applies to the CPU-only version, it will"
+                      " be ignored (use `--num_gpu` instead).", Priority::High);
             // If num_gpu 0 --> output_resolution has no effect
             if (wrapperStructPose.gpuNumber == 0 &&
                 (wrapperStructPose.outputSize.x > 0 || wrapperStructPose.outputSize.y > 0))
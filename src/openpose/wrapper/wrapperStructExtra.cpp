@@ -4,12 +4,18 @@ namespace op
 {
     WrapperStructExtra::WrapperStructExtra(
         const bool reconstruct3d_, const int minViews3d_, const bool identification_, const int tracking_,
-        const int ikThreads_) :
+        const int ikThreads_, const BackpressurePolicy backpressurePolicy_, const double latencyTarget_,
+        const bool unorderedOutput_, const std::vector<ThreadAffinity>& threadAffinities_, const bool memoryPool_) :
         reconstruct3d{reconstruct3d_},
         minViews3d{minViews3d_},
         identification{identification_},
         tracking{tracking_},
-        ikThreads{ikThreads_}
+        ikThreads{ikThreads_},
+        backpressurePolicy{backpressurePolicy_},
+        latencyTarget{latencyTarget_},
+        unorderedOutput{unorderedOutput_},
+        threadAffinities(threadAffinities_),
+        memoryPool{memoryPool_}
     {
     }
 }
@@ -5,7 +5,8 @@ namespace op
     WrapperStructHand::WrapperStructHand(
         const bool enable_, const Detector detector_, const Point<int>& netInputSize_, const int scalesNumber_,
         const float scaleRange_, const RenderMode renderMode_, const float alphaKeypoint_, const float alphaHeatMap_,
-        const float renderThreshold_) :
+        const float renderThreshold_, const int batchSize_, const int keyframeInterval_,
+        const float keyframeMaxRoiMotion_, const float keyframeMaxKeypointLoss_) :
         enable{enable_},
         detector{detector_},
         netInputSize{netInputSize_},
@@ -14,7 +15,11 @@ namespace op
         renderMode{renderMode_},
         alphaKeypoint{alphaKeypoint_},
         alphaHeatMap{alphaHeatMap_},
-        renderThreshold{renderThreshold_}
+        renderThreshold{renderThreshold_},
+        batchSize{batchSize_},
+        keyframeInterval{keyframeInterval_},
+        keyframeMaxRoiMotion{keyframeMaxRoiMotion_},
+        keyframeMaxKeypointLoss{keyframeMaxKeypointLoss_}
     {
     }
 }
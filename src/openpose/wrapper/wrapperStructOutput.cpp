@@ -9,7 +9,7 @@ namespace op
         const String& writeVideo_, const double writeVideoFps_, const bool writeVideoWithAudio_,
         const String& writeHeatMaps_, const String& writeHeatMapsFormat_, const String& writeVideo3D_,
         const String& writeVideoAdam_, const String& writeBvh_, const String& udpHost_,
-        const String& udpPort_) :
+        const String& udpPort_, const String& writeMetrics_, const double writeMetricsSeconds_) :
         verbose{verbose_},
         writeKeypoint{writeKeypoint_},
         writeKeypointFormat{writeKeypointFormat_},
@@ -28,13 +28,18 @@ namespace op
         writeVideoAdam{writeVideoAdam_},
         writeBvh{writeBvh_},
         udpHost{udpHost_},
-        udpPort{udpPort_}
+        udpPort{udpPort_},
+        writeMetrics{writeMetrics_},
+        writeMetricsSeconds{writeMetricsSeconds_}
     {
         try
         {
             if (!writeBvh.empty())
                 error("BVH writing is experimental and not available yet (flag `--write_bvh`). Please, disable this"
                       " flag and do not open a GitHub issue asking for it.", __LINE__, __FUNCTION__, __FILE__);
+            if (!writeMetrics.empty() && writeMetricsSeconds <= 0.)
+                error("The metrics period (flag `--write_metrics_seconds`) must be positive.",
+                      __LINE__, __FUNCTION__, __FILE__);
         }
         catch (const std::exception& e)
         {